@@ -1,23 +1,27 @@
+// protocol/packets.schema   .  ġ  Ű ģ 
+// python protocol/gen_protocol.py  ٽ .
 using System;
 using System.Runtime.InteropServices;
 using System.Text;
 
-// [Ŷ ID]  PacketId enum /ȣ  ƾ մϴ.
+// [Ŷ ID]  PacketId enum   Ű .
 public enum PacketId : ushort
 {
-    // [α/]
-    REGISTER_REQ = 1,
-    REGISTER_RES = 2,
-    LOGIN_REQ = 3,
-    LOGIN_RES = 4,
+    // [α/ ]
+    REGISTER_REQ = 1,   // ȸ û
+    REGISTER_RES = 2,   // ȸ 
+    LOGIN_REQ = 3,      // α û
+    LOGIN_RES = 4,      // α 
 
-    // [ΰ/κ]
-    ENTER_ROOM = 5,
-    LEAVE_ROOM = 6,
+    // [ΰ/κ ]
+    ENTER_ROOM = 5,     //   û (α  )
+    LEAVE_ROOM = 6,     //  
 
-    // [÷]
+    // [ ÷]
     CHAT = 7,
     MOVE = 8,
+    //  . Ŭ̾Ʈ  SNAPSHOT_ACK  ƽ(baseTick) ٲ ÷̾ ´.
+    // entries İ ȭ server/SnapshotCodec.h  (baseTick 0 ̸ ü ).
     SNAPSHOT = 9,
 
     ROOM_LIST_REQ = 10,
@@ -27,6 +31,33 @@ public enum PacketId : ushort
     CREATE_ROOM_RES = 13,
 
     LOGOUT_REQ = 14,
+
+    // [ӼӸ]       
+    WHISPER_REQ = 15,   //  ( ̸ + ޽)
+    WHISPER = 16,       // ޱ (  ̸ + ޽)
+    WHISPER_RES = 17,   //    
+
+    // [ ] Ŭ̾Ʈ ֱ     ״ ش.
+    //  ð (SessionTimeoutConfig::idleTimeoutMs) ª ֱ   ʴ´.
+    HEARTBEAT_REQ = 18,
+    HEARTBEAT_RES = 19,
+
+    // [ Ȯ]  SNAPSHOT  tick ( ȣ)  ش.     ȣ  Ÿ .
+    //  ƽ   ʾ Ÿ Ǯ   tick 0   ü  ٽ ޴´.
+    SNAPSHOT_ACK = 20,
+}
+
+// Ű  Ŷ  Ѵ
+public interface IPacketElement
+{
+    int GetSize();
+    void Write(ref PacketWriter writer);
+    bool Read(ref PacketReader reader);
+}
+
+public interface IPacket : IPacketElement
+{
+    PacketId Id { get; }
 }
 
 // []
@@ -37,113 +68,710 @@ public struct GameHeader
     public ushort packetId;
 }
 
-// --------------------------------------------------
-// [1]   Ŷ
-// --------------------------------------------------
+public static class PacketCodec
+{
+    public const int HeaderSize = 4;
+
+    //   Ŷ ϳ  ũ⸸ŭ 
+    public static byte[] Serialize<T>(T packet) where T : struct, IPacket
+    {
+        byte[] buffer = new byte[HeaderSize + packet.GetSize()];
+        Serialize(packet, buffer, 0);
+        return buffer;
+    }
+
+    // ̸   ۿ .  Ʈ  ( ) ش.
+    public static int Serialize<T>(T packet, byte[] buffer, int offset) where T : struct, IPacket
+    {
+        int size = HeaderSize + packet.GetSize();
+        PacketWriter writer = new PacketWriter(buffer, offset);
+        writer.Write((ushort)size);
+        writer.Write((ushort)packet.Id);
+        packet.Write(ref writer);
+        return size;
+    }
+
+    //    д´. ߷Ȱų ̰   false.
+    public static bool TryDeserialize<T>(byte[] body, int offset, int count, out T packet) where T : struct, IPacket
+    {
+        packet = default(T);
+        PacketReader reader = new PacketReader(body, offset, count);
+        return packet.Read(ref reader);
+    }
+
+    public static bool TryDeserialize<T>(byte[] body, out T packet) where T : struct, IPacket
+    {
+        return TryDeserialize(body, 0, body.Length, out packet);
+    }
+}
+
+// Ʋ ,  
+public struct PacketWriter
+{
+    private readonly byte[] _buffer;
+    private int _position;
+
+    public PacketWriter(byte[] buffer, int offset)
+    {
+        _buffer = buffer;
+        _position = offset;
+    }
+
+    public int Position { get { return _position; } }
+
+    public void Write(bool value) { _buffer[_position++] = (byte)(value ? 1 : 0); }
+    public void Write(byte value) { _buffer[_position++] = value; }
+
+    public void Write(ushort value)
+    {
+        _buffer[_position++] = (byte)value;
+        _buffer[_position++] = (byte)(value >> 8);
+    }
+
+    public void Write(uint value)
+    {
+        _buffer[_position++] = (byte)value;
+        _buffer[_position++] = (byte)(value >> 8);
+        _buffer[_position++] = (byte)(value >> 16);
+        _buffer[_position++] = (byte)(value >> 24);
+    }
+
+    public void Write(int value) { Write((uint)value); }
+    public void Write(float value) { Write((uint)BitConverter.SingleToInt32Bits(value)); }
+
+    public void WriteString(string value, int maxLength)
+    {
+        int length = StringSize(value, maxLength) - 2;
+        Write((ushort)length);
+        if (length > 0)
+        {
+            byte[] bytes = Encoding.UTF8.GetBytes(value);
+            Array.Copy(bytes, 0, _buffer, _position, length);
+            _position += length;
+        }
+    }
+
+    public void WriteBytes(ArraySegment<byte> value, int maxLength)
+    {
+        int length = Math.Min(value.Count, maxLength);
+        Write((ushort)length);
+        if (length > 0 && value.Array != null)
+        {
+            Array.Copy(value.Array, value.Offset, _buffer, _position, length);
+            _position += length;
+        }
+    }
+
+    public void WriteArray<T>(T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        if (items == null)
+        {
+            Write((ushort)0);
+            return;
+        }
+
+        int count = Math.Min(items.Length, maxCount);
+        Write((ushort)count);
+        for (int i = 0; i < count; i++)
+            items[i].Write(ref this);
+    }
+
+    // u16  + UTF-8. ִ ̸   ߰ ƴ  ڸ.
+    public static int StringSize(string value, int maxLength)
+    {
+        if (string.IsNullOrEmpty(value)) return 2;
+
+        int length = Encoding.UTF8.GetByteCount(value);
+        if (length <= maxLength) return 2 + length;
+
+        byte[] bytes = Encoding.UTF8.GetBytes(value);
+        length = maxLength;
+        while (length > 0 && (bytes[length] & 0xC0) == 0x80) length--;
+        return 2 + length;
+    }
+
+    public static int BytesSize(ArraySegment<byte> value, int maxLength)
+    {
+        return 2 + Math.Min(value.Count, maxLength);
+    }
+
+    public static int ArraySize<T>(T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        if (items == null) return 2;
+
+        int size = 2;
+        int count = Math.Min(items.Length, maxCount);
+        for (int i = 0; i < count; i++)
+            size += items[i].GetSize();
+        return size;
+    }
+}
+
+public struct PacketReader
+{
+    private readonly byte[] _buffer;
+    private int _position;
+    private readonly int _end;
+
+    public PacketReader(byte[] buffer, int offset, int count)
+    {
+        _buffer = buffer;
+        _position = offset;
+        _end = offset + count;
+    }
+
+    public int Remaining { get { return _end - _position; } }
+
+    public bool Read(out bool value)
+    {
+        value = false;
+        if (Remaining < 1) return false;
+        value = _buffer[_position++] != 0;
+        return true;
+    }
+
+    public bool Read(out byte value)
+    {
+        value = 0;
+        if (Remaining < 1) return false;
+        value = _buffer[_position++];
+        return true;
+    }
+
+    public bool Read(out ushort value)
+    {
+        value = 0;
+        if (Remaining < 2) return false;
+        value = (ushort)(_buffer[_position] | (_buffer[_position + 1] << 8));
+        _position += 2;
+        return true;
+    }
+
+    public bool Read(out uint value)
+    {
+        value = 0;
+        if (Remaining < 4) return false;
+        value = (uint)(_buffer[_position] | (_buffer[_position + 1] << 8) | (_buffer[_position + 2] << 16) | (_buffer[_position + 3] << 24));
+        _position += 4;
+        return true;
+    }
+
+    public bool Read(out int value)
+    {
+        bool ok = Read(out uint bits);
+        value = (int)bits;
+        return ok;
+    }
+
+    public bool Read(out float value)
+    {
+        bool ok = Read(out uint bits);
+        value = BitConverter.Int32BitsToSingle((int)bits);
+        return ok;
+    }
+
+    public bool ReadString(out string value, int maxLength)
+    {
+        value = string.Empty;
+        if (!Read(out ushort length) || length > maxLength || Remaining < length) return false;
+        value = Encoding.UTF8.GetString(_buffer, _position, length);
+        _position += length;
+        return true;
+    }
+
+    // ڿ  ʰ   ġ ش ( Ŭ̾Ʈó Ҵ  )
+    public bool ReadStringRange(out int offset, out int length, int maxLength)
+    {
+        offset = _position;
+        length = 0;
+        if (!Read(out ushort size) || size > maxLength || Remaining < size) return false;
+        offset = _position;
+        length = size;
+        _position += size;
+        return true;
+    }
+
+    //  ʰ    ش (۸ ٽ   ȿ)
+    public bool ReadBytes(out ArraySegment<byte> value, int maxLength)
+    {
+        value = default(ArraySegment<byte>);
+        if (!Read(out ushort length) || length > maxLength || Remaining < length) return false;
+        value = new ArraySegment<byte>(_buffer, _position, length);
+        _position += length;
+        return true;
+    }
+
+    public bool ReadArray<T>(out T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        items = Array.Empty<T>();
+        if (!Read(out ushort count) || count > maxCount) return false;
+
+        items = new T[count];
+        for (int i = 0; i < count; i++)
+        {
+            if (!items[i].Read(ref this)) return false;
+        }
+        return true;
+    }
+}
+
+public struct RoomInfo : IPacketElement
+{
+    public const int MaxSize = 41;
+
+    public int roomId;
+    public int userCount;
+    public string title;   // ִ 31 Ʈ
+
+    public int GetSize() { return 8 + PacketWriter.StringSize(title, 31); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(roomId);
+        writer.Write(userCount);
+        writer.WriteString(title, 31);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out roomId)
+            && reader.Read(out userCount)
+            && reader.ReadString(out title, 31);
+    }
+}
 
+// [α/ ]
 // ȸ û
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketRegisterReq
+public struct PacketRegisterReq : IPacket
 {
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] username;
+    public const int MaxSize = 102;
+    public PacketId Id { get { return PacketId.REGISTER_REQ; } }
+
+    public string username;   // ִ 49 Ʈ
+    public string password;   // ִ 49 Ʈ
 
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] password;
+    public int GetSize() { return PacketWriter.StringSize(username, 49) + PacketWriter.StringSize(password, 49); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(username, 49);
+        writer.WriteString(password, 49);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out username, 49)
+            && reader.ReadString(out password, 49);
+    }
 }
 
-// ȸ 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketRegisterRes
+// ȸ 
+public struct PacketRegisterRes : IPacket
 {
-    [MarshalAs(UnmanagedType.I1)] // C++ bool (1byte) 
+    public const int MaxSize = 1;
+    public PacketId Id { get { return PacketId.REGISTER_RES; } }
+
     public bool success;
+
+    public int GetSize() { return 1; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success);
+    }
 }
 
 // α û
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketLoginReq
+public struct PacketLoginReq : IPacket
 {
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] username;
+    public const int MaxSize = 102;
+    public PacketId Id { get { return PacketId.LOGIN_REQ; } }
+
+    public string username;   // ִ 49 Ʈ
+    public string password;   // ִ 49 Ʈ
+
+    public int GetSize() { return PacketWriter.StringSize(username, 49) + PacketWriter.StringSize(password, 49); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(username, 49);
+        writer.WriteString(password, 49);
+    }
 
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] password;
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out username, 49)
+            && reader.ReadString(out password, 49);
+    }
 }
 
-// α 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketLoginRes
+// α 
+public struct PacketLoginRes : IPacket
 {
-    [MarshalAs(UnmanagedType.I1)]
+    public const int MaxSize = 5;
+    public PacketId Id { get { return PacketId.LOGIN_RES; } }
+
     public bool success;
     public uint playerId;
-}
 
-// --------------------------------------------------
-// [2]  /
-// --------------------------------------------------
+    public int GetSize() { return 5; }
 
-//   û
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketEnterRoom
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+        writer.Write(playerId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success)
+            && reader.Read(out playerId);
+    }
+}
+
+// [ΰ/κ ]
+//   û (α  )
+public struct PacketEnterRoom : IPacket
 {
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.ENTER_ROOM; } }
+
     public int roomId;
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(roomId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out roomId);
+    }
 }
 
-//   ˸
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketLeaveRoom
+//  
+public struct PacketLeaveRoom : IPacket
 {
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.LEAVE_ROOM; } }
+
     public uint playerId;
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(playerId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out playerId);
+    }
 }
 
-// --------------------------------------------------
-// [3] ΰ ÷
-// --------------------------------------------------
+// [ ÷]
+public struct PacketChat : IPacket
+{
+    public const int MaxSize = 261;
+    public PacketId Id { get { return PacketId.CHAT; } }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketMove
+    public uint playerId;
+    public string msg;   // ִ 255 Ʈ
+
+    public int GetSize() { return 4 + PacketWriter.StringSize(msg, 255); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(playerId);
+        writer.WriteString(msg, 255);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out playerId)
+            && reader.ReadString(out msg, 255);
+    }
+}
+
+public struct PacketMove : IPacket
 {
+    public const int MaxSize = 8;
+    public PacketId Id { get { return PacketId.MOVE; } }
+
     public float vx;
     public float vy;
+
+    public int GetSize() { return 8; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(vx);
+        writer.Write(vy);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out vx)
+            && reader.Read(out vy);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketChat
+//  . Ŭ̾Ʈ  SNAPSHOT_ACK  ƽ(baseTick) ٲ ÷̾ ´.
+// entries İ ȭ server/SnapshotCodec.h  (baseTick 0 ̸ ü ).
+public struct PacketSnapshot : IPacket
 {
-    public uint playerId;
+    public const int MaxSize = 65010;
+    public PacketId Id { get { return PacketId.SNAPSHOT; } }
+
+    public uint tick;                    //  ȣ (Ǹ 1  ϳ þ.  Űܵ ̾)
+    public uint baseTick;                //  ƽ. 0: ü ( ,  Ҿ )
+    public ArraySegment<byte> entries;   // ִ 65000 Ʈ
+
+    public int GetSize() { return 8 + PacketWriter.BytesSize(entries, 65000); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(tick);
+        writer.Write(baseTick);
+        writer.WriteBytes(entries, 65000);
+    }
 
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 256)]
-    public byte[] msg;
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out tick)
+            && reader.Read(out baseTick)
+            && reader.ReadBytes(out entries, 65000);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct RoomInfo
+public struct PacketRoomListReq : IPacket
 {
-    public int roomId;
-    public int userCount;
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)]
-    public byte[] title;
+    public const int MaxSize = 0;
+    public PacketId Id { get { return PacketId.ROOM_LIST_REQ; } }
+
+    public int GetSize() { return 0; }
+
+    public void Write(ref PacketWriter writer) { }
+
+    public bool Read(ref PacketReader reader) { return true; }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketRoomListRes
+public struct PacketRoomListRes : IPacket
 {
-    public int count;
+    public const int MaxSize = 41986;
+    public PacketId Id { get { return PacketId.ROOM_LIST_RES; } }
+
+    public RoomInfo[] rooms;   // ִ 1024 
+
+    public int GetSize() { return PacketWriter.ArraySize(rooms, 1024); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteArray(rooms, 1024);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadArray(out rooms, 1024);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketCreateRoomReq
+public struct PacketCreateRoomReq : IPacket
 {
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)]
-    public byte[] title;
+    public const int MaxSize = 33;
+    public PacketId Id { get { return PacketId.CREATE_ROOM_REQ; } }
+
+    public string title;   // ִ 31 Ʈ
+
+    public int GetSize() { return PacketWriter.StringSize(title, 31); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(title, 31);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out title, 31);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketCreateRoomRes
+public struct PacketCreateRoomRes : IPacket
 {
-    [MarshalAs(UnmanagedType.I1)]
+    public const int MaxSize = 5;
+    public PacketId Id { get { return PacketId.CREATE_ROOM_RES; } }
+
     public bool success;
     public int roomId;
-}
\ No newline at end of file
+
+    public int GetSize() { return 5; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+        writer.Write(roomId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success)
+            && reader.Read(out roomId);
+    }
+}
+
+public struct PacketLogoutReq : IPacket
+{
+    public const int MaxSize = 0;
+    public PacketId Id { get { return PacketId.LOGOUT_REQ; } }
+
+    public int GetSize() { return 0; }
+
+    public void Write(ref PacketWriter writer) { }
+
+    public bool Read(ref PacketReader reader) { return true; }
+}
+
+// [ӼӸ]       
+//  ( ̸ + ޽)
+public struct PacketWhisperReq : IPacket
+{
+    public const int MaxSize = 308;
+    public PacketId Id { get { return PacketId.WHISPER_REQ; } }
+
+    public string target;   // ִ 49 Ʈ
+    public string msg;      // ִ 255 Ʈ
+
+    public int GetSize() { return PacketWriter.StringSize(target, 49) + PacketWriter.StringSize(msg, 255); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(target, 49);
+        writer.WriteString(msg, 255);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out target, 49)
+            && reader.ReadString(out msg, 255);
+    }
+}
+
+// ޱ (  ̸ + ޽)
+public struct PacketWhisper : IPacket
+{
+    public const int MaxSize = 308;
+    public PacketId Id { get { return PacketId.WHISPER; } }
+
+    public string sender;   // ִ 49 Ʈ
+    public string msg;      // ִ 255 Ʈ
+
+    public int GetSize() { return PacketWriter.StringSize(sender, 49) + PacketWriter.StringSize(msg, 255); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(sender, 49);
+        writer.WriteString(msg, 255);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out sender, 49)
+            && reader.ReadString(out msg, 255);
+    }
+}
+
+//    
+public struct PacketWhisperRes : IPacket
+{
+    public const int MaxSize = 52;
+    public PacketId Id { get { return PacketId.WHISPER_RES; } }
+
+    public bool success;    // false:    ƴ
+    public string target;   // ִ 49 Ʈ
+
+    public int GetSize() { return 1 + PacketWriter.StringSize(target, 49); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+        writer.WriteString(target, 49);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success)
+            && reader.ReadString(out target, 49);
+    }
+}
+
+// [ ] Ŭ̾Ʈ ֱ     ״ ش.
+//  ð (SessionTimeoutConfig::idleTimeoutMs) ª ֱ   ʴ´.
+public struct PacketHeartbeatReq : IPacket
+{
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.HEARTBEAT_REQ; } }
+
+    public uint clientTime;   // Ŭ̾Ʈ ð (ms).  ؼ ʰ ֹǷ RTT  .
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(clientTime);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out clientTime);
+    }
+}
+
+public struct PacketHeartbeatRes : IPacket
+{
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.HEARTBEAT_RES; } }
+
+    public uint clientTime;   // Ŭ̾Ʈ ð (ms).  ؼ ʰ ֹǷ RTT  .
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(clientTime);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out clientTime);
+    }
+}
+
+// [ Ȯ]  SNAPSHOT  tick ( ȣ)  ش.     ȣ  Ÿ .
+//  ƽ   ʾ Ÿ Ǯ   tick 0   ü  ٽ ޴´.
+public struct PacketSnapshotAck : IPacket
+{
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.SNAPSHOT_ACK; } }
+
+    public uint tick;
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(tick);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out tick);
+    }
+}
@@ -54,7 +54,7 @@ public class PlayerController : MonoBehaviour
                     vy = currentVelocity.y
                 };
 
-                NetworkManager.Instance.SendPacket(PacketId.MOVE, movePkt);
+                NetworkManager.Instance.SendPacket(movePkt);
                 _lastSentVelocity = currentVelocity; //  ӵ 
 
                 //  α (Ȯο)
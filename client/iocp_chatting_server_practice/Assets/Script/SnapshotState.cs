@@ -0,0 +1,197 @@
+using System;
+using System.Collections.Generic;
+
+// SNAPSHOT Ŷ entries  Ǭ ( server/SnapshotCodec.h  ).
+// -   ƽ HistorySize   ΰ,   baseTick ӿ Ÿ    .
+// - Apply  true  pkt.tick , false  0  SNAPSHOT_ACK   (0:   ü ٽ ޶).
+// -   ϳ .
+public struct SnapshotEntity
+{
+    public uint id;
+    public int x;   // ȭ ġ (SnapshotState.PositionScale )
+    public int y;
+
+    public float X { get { return x / SnapshotState.PositionScale; } }
+    public float Y { get { return y / SnapshotState.PositionScale; } }
+}
+
+public class SnapshotState
+{
+    public const float PositionScale = 100.0f;
+    public const int HistorySize = 64;   //  SnapshotHistory  
+
+    private readonly uint[] _ticks = new uint[HistorySize];
+    private readonly List<SnapshotEntity>[] _frames = new List<SnapshotEntity>[HistorySize];
+    private List<SnapshotEntity> _scratch = new List<SnapshotEntity>();
+    private static readonly List<SnapshotEntity> s_emptyFrame = new List<SnapshotEntity>();
+
+    //   ¿,   ¿ ؼ  ų  /  ÷̾
+    public uint LastTick { get; private set; }
+    public readonly List<SnapshotEntity> Current = new List<SnapshotEntity>();
+    public readonly List<SnapshotEntity> Changed = new List<SnapshotEntity>();
+    public readonly List<uint> Removed = new List<uint>();
+
+    public SnapshotState()
+    {
+        for (int i = 0; i < HistorySize; i++)
+            _frames[i] = new List<SnapshotEntity>();
+    }
+
+    public bool Apply(PacketSnapshot pkt)
+    {
+        List<SnapshotEntity> baseFrame = s_emptyFrame;
+        if (pkt.baseTick != 0)
+        {
+            int baseSlot = (int)(pkt.baseTick % HistorySize);
+            if (_ticks[baseSlot] != pkt.baseTick) return false;
+            baseFrame = _frames[baseSlot];
+        }
+
+        if (!Decode(pkt.entries, baseFrame, _scratch)) return false;
+
+        int slot = (int)(pkt.tick % HistorySize);
+        List<SnapshotEntity> frame = _scratch;
+        _scratch = _frames[slot];
+        _frames[slot] = frame;
+        _ticks[slot] = pkt.tick;
+
+        Diff(Current, frame);
+        Current.Clear();
+        Current.AddRange(frame);
+        LastTick = pkt.tick;
+        return true;
+    }
+
+    private void Diff(List<SnapshotEntity> before, List<SnapshotEntity> after)
+    {
+        Changed.Clear();
+        Removed.Clear();
+
+        int i = 0;
+        foreach (SnapshotEntity now in after)
+        {
+            while (i < before.Count && before[i].id < now.id)
+                Removed.Add(before[i++].id);
+
+            if (i < before.Count && before[i].id == now.id)
+            {
+                SnapshotEntity old = before[i++];
+                if (old.x == now.x && old.y == now.y) continue;
+            }
+            Changed.Add(now);
+        }
+        while (i < before.Count)
+            Removed.Add(before[i++].id);
+    }
+
+    // server/SnapshotCodec.cpp  Decode    base  ģ
+    private static bool Decode(ArraySegment<byte> entries, List<SnapshotEntity> baseFrame, List<SnapshotEntity> output)
+    {
+        output.Clear();
+        if (entries.Array == null) return false;
+
+        byte[] buffer = entries.Array;
+        int end = entries.Offset + entries.Count;
+
+        int removedPos = entries.Offset;
+        if (!ReadCount(buffer, ref removedPos, end, out int removedCount)) return false;
+
+        int updatedPos = removedPos;
+        uint scanId = 0;
+        for (int k = 0; k < removedCount; k++)
+        {
+            if (!ReadId(buffer, ref updatedPos, end, ref scanId, k == 0)) return false;
+        }
+        if (!ReadCount(buffer, ref updatedPos, end, out int updatedCount)) return false;
+
+        uint removedId = 0;
+        int removedLeft = removedCount;
+        if (removedLeft > 0 && !ReadId(buffer, ref removedPos, end, ref removedId, true)) return false;
+
+        uint nextId = 0;
+        uint dx = 0;
+        uint dy = 0;
+        int updatedLeft = updatedCount;
+        if (updatedLeft > 0 && !ReadUpdate(buffer, ref updatedPos, end, ref nextId, out dx, out dy, true)) return false;
+
+        int i = 0;
+        while (i < baseFrame.Count || updatedLeft > 0)
+        {
+            if (updatedLeft > 0 && (i == baseFrame.Count || nextId < baseFrame[i].id))
+            {
+                // ؿ  ÷̾
+                output.Add(new SnapshotEntity { id = nextId, x = UnZigZag(dx), y = UnZigZag(dy) });
+            }
+            else if (removedLeft > 0 && removedId == baseFrame[i].id)
+            {
+                i++;
+                if (--removedLeft > 0 && !ReadId(buffer, ref removedPos, end, ref removedId, false)) return false;
+                continue;
+            }
+            else if (updatedLeft > 0 && nextId == baseFrame[i].id)
+            {
+                SnapshotEntity old = baseFrame[i++];
+                output.Add(new SnapshotEntity { id = old.id, x = unchecked(old.x + UnZigZag(dx)), y = unchecked(old.y + UnZigZag(dy)) });
+            }
+            else
+            {
+                output.Add(baseFrame[i++]);
+                continue;
+            }
+
+            if (--updatedLeft > 0 && !ReadUpdate(buffer, ref updatedPos, end, ref nextId, out dx, out dy, false)) return false;
+        }
+
+        return removedLeft == 0 && updatedPos == end;
+    }
+
+    private static bool ReadUpdate(byte[] buffer, ref int pos, int end, ref uint id, out uint dx, out uint dy, bool first)
+    {
+        dx = 0;
+        dy = 0;
+        return ReadId(buffer, ref pos, end, ref id, first)
+            && ReadVarint(buffer, ref pos, end, out dx)
+            && ReadVarint(buffer, ref pos, end, out dy);
+    }
+
+    private static bool ReadCount(byte[] buffer, ref int pos, int end, out int count)
+    {
+        count = 0;
+        if (end - pos < 2) return false;
+        count = buffer[pos] | (buffer[pos + 1] << 8);
+        pos += 2;
+        return true;
+    }
+
+    private static bool ReadVarint(byte[] buffer, ref int pos, int end, out uint value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (pos == end) return false;
+            byte b = buffer[pos++];
+            value |= (uint)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    //  ID ( ID  ). ù ID   0  Ѵ.
+    private static bool ReadId(byte[] buffer, ref int pos, int end, ref uint id, bool first)
+    {
+        if (!ReadVarint(buffer, ref pos, end, out uint gap)) return false;
+        if (first)
+        {
+            id = gap;
+            return true;
+        }
+        if (gap == 0 || gap > uint.MaxValue - id) return false;
+        id += gap;
+        return true;
+    }
+
+    private static int UnZigZag(uint value)
+    {
+        return (int)(value >> 1) ^ -(int)(value & 1);
+    }
+}
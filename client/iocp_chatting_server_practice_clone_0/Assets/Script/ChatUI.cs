@@ -43,8 +43,18 @@ public class ChatUI : MonoBehaviour
             return;
         }
 
-        //  
-        NetworkManager.Instance.SendChat(inputField.text);
+        //   ("/w ̸ ޽"  ӼӸ)
+        string text = inputField.text;
+        string[] parts = text.Split(new[] { ' ' }, 3);
+        if (parts.Length == 3 && parts[0] == "/w")
+        {
+            NetworkManager.Instance.SendWhisper(parts[1], parts[2]);
+            AddSystemMessage($"[ӼӸ -> {parts[1]}] {parts[2]}", Color.magenta);
+        }
+        else
+        {
+            NetworkManager.Instance.SendChat(text);
+        }
 
         // UI ʱȭ
         inputField.text = "";
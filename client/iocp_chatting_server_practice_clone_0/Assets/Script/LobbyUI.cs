@@ -125,7 +125,7 @@ public class LobbyUI : MonoBehaviour
     void OnRefreshClicked()
     {
         //   û
-        NetworkManager.Instance.SendPacket(PacketId.ROOM_LIST_REQ, new byte[0]);
+        NetworkManager.Instance.SendPacket(new PacketRoomListReq());
     }
 
     void OnLogoutClicked()
@@ -12,6 +12,7 @@ public class NetworkManager : MonoBehaviour
     [Header("Connection Settings")]
     public string serverIp = "127.0.0.1";
     public int serverPort = 9190;
+    public float heartbeatInterval = 5f; //   (30)  ª
 
     private TcpClient client;
     private NetworkStream stream;
@@ -19,6 +20,9 @@ public class NetworkManager : MonoBehaviour
     private bool isConnected = false;
 
     public uint MyPlayerId { get; set; } // α   Ҵ
+    public int LastRttMs { get; set; }   //  ƮƮ պ ð
+
+    private float lastHeartbeatTime;
 
     void Awake()
     {
@@ -38,6 +42,16 @@ public class NetworkManager : MonoBehaviour
        
     }
 
+    void Update()
+    {
+        //  ־      ʵ ֱ 
+        if (isConnected && Time.unscaledTime - lastHeartbeatTime >= heartbeatInterval)
+        {
+            lastHeartbeatTime = Time.unscaledTime;
+            SendHeartbeat();
+        }
+    }
+
     public void ConnectToServer()
     {
         try
@@ -64,36 +78,14 @@ public class NetworkManager : MonoBehaviour
     }
 
     // ܺ(GameManager, ChatUI) Ŷ   ϴ Լ
-    public void SendPacket(PacketId id, object packetStruct)
+    //  +  PacketDefine.cs ڵ  ũ⸸ŭ ȭѴ
+    public void SendPacket<T>(T packet) where T : struct, IPacket
     {
         if (!isConnected) return;
 
         try
         {
-            byte[] bodyData;
-
-            // [ ٽ] Էµ  'Ʈ 迭'̸ ȯ  ״ 
-            if (packetStruct is byte[])
-            {
-                bodyData = (byte[])packetStruct;
-            }
-            else
-            {
-                // Էµ  'ü' Ʈ ȯ ( )
-                bodyData = StructureToByteArray(packetStruct);
-            }
-
-            //  
-            GameHeader header = new GameHeader();
-            header.packetId = (ushort)id;
-            header.packetSize = (ushort)(Marshal.SizeOf(typeof(GameHeader)) + bodyData.Length);
-
-            byte[] headerData = StructureToByteArray(header);
-
-            //  Ŷ ġ ( + ٵ)
-            byte[] packetData = new byte[header.packetSize];
-            Array.Copy(headerData, 0, packetData, 0, headerData.Length);
-            Array.Copy(bodyData, 0, packetData, headerData.Length, bodyData.Length);
+            byte[] packetData = PacketCodec.Serialize(packet);
 
             lock (stream)
             {
@@ -171,17 +163,6 @@ public class NetworkManager : MonoBehaviour
     }
 
     // ƿƼ Լ
-    public static byte[] StructureToByteArray(object obj)
-    {
-        int len = Marshal.SizeOf(obj);
-        byte[] arr = new byte[len];
-        IntPtr ptr = Marshal.AllocHGlobal(len);
-        Marshal.StructureToPtr(obj, ptr, true);
-        Marshal.Copy(ptr, arr, 0, len);
-        Marshal.FreeHGlobal(ptr);
-        return arr;
-    }
-
     public static T ByteArrayToStructure<T>(byte[] bytearray) where T : struct
     {
         T str = default(T);
@@ -194,21 +175,6 @@ public class NetworkManager : MonoBehaviour
         return str;
     }
 
-    // -------------------------------------------------------------
-    // [1] ڿ ȯ  (ݺǴ ڵ带 ̱  ߰)
-    // -------------------------------------------------------------
-    private byte[] ToBytes(string str, int size)
-    {
-        byte[] buffer = new byte[size];
-        if (string.IsNullOrEmpty(str)) return buffer;
-
-        byte[] strBytes = System.Text.Encoding.UTF8.GetBytes(str);
-        int copyLen = Math.Min(strBytes.Length, size); //  null    ص  (C++ ˾Ƽ ) or size-1
-        Array.Copy(strBytes, 0, buffer, 0, copyLen);
-
-        return buffer;
-    }
-
     // -------------------------------------------------------------
     // [2] ȸ û
     // -------------------------------------------------------------
@@ -216,11 +182,10 @@ public class NetworkManager : MonoBehaviour
     {
         PacketRegisterReq packet = new PacketRegisterReq();
 
-        //  Լ Ἥ ϰ Ҵ (SizeConst = 50)
-        packet.username = ToBytes(username, 50);
-        packet.password = ToBytes(password, 50);
+        packet.username = username;
+        packet.password = password;
 
-        SendPacket(PacketId.REGISTER_REQ, packet);
+        SendPacket(packet);
         Debug.Log($"[Send] Register Request: {username}");
     }
 
@@ -231,10 +196,10 @@ public class NetworkManager : MonoBehaviour
     {
         PacketLoginReq packet = new PacketLoginReq();
 
-        packet.username = ToBytes(username, 50);
-        packet.password = ToBytes(password, 50);
+        packet.username = username;
+        packet.password = password;
 
-        SendPacket(PacketId.LOGIN_REQ, packet);
+        SendPacket(packet);
         Debug.Log($"[Send] Login Request: {username}");
     }
 
@@ -246,7 +211,7 @@ public class NetworkManager : MonoBehaviour
         PacketEnterRoom packet = new PacketEnterRoom();
         packet.roomId = roomId;
 
-        SendPacket(PacketId.ENTER_ROOM, packet);
+        SendPacket(packet);
         Debug.Log($"[Send] Enter Room Request: {roomId}");
     }
 
@@ -255,25 +220,51 @@ public class NetworkManager : MonoBehaviour
         PacketChat packet = new PacketChat();
         packet.playerId = this.MyPlayerId;
 
-        packet.msg = ToBytes(text, 256);
+        packet.msg = text;
 
-        SendPacket(PacketId.CHAT, packet);
+        SendPacket(packet);
+    }
+
+    public void SendWhisper(string target, string text)
+    {
+        PacketWhisperReq packet = new PacketWhisperReq();
+        packet.target = target;
+        packet.msg = text;
+
+        SendPacket(packet);
     }
 
     public void SendCreateRoom(string title)
     {
         PacketCreateRoomReq packet = new PacketCreateRoomReq();
-        packet.title = ToBytes(title, 32); //    Լ 
+        packet.title = title;
+
+        SendPacket(packet);
+    }
+
+    public void SendHeartbeat()
+    {
+        PacketHeartbeatReq packet = new PacketHeartbeatReq();
+        packet.clientTime = (uint)Environment.TickCount;
+
+        SendPacket(packet);
+    }
+
+    //   ƽ (0: Ÿ Ǯ   ü  ٽ ޶)
+    public void SendSnapshotAck(uint tick)
+    {
+        PacketSnapshotAck packet = new PacketSnapshotAck();
+        packet.tick = tick;
 
-        SendPacket(PacketId.CREATE_ROOM_REQ, packet);
+        SendPacket(packet);
     }
 
     public void SendLogout()
     {
         if (!isConnected) return;
 
-        // ٵ    ǹǷ  Ʈ 迭 
-        SendPacket(PacketId.LOGOUT_REQ, new byte[0]);
+        //   Ŷ ( )
+        SendPacket(new PacketLogoutReq());
         Debug.Log("[Network] α׾ƿ û ");
     }
 
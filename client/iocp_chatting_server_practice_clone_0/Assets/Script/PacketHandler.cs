@@ -1,6 +1,5 @@
 using PimDeWitte.UnityMainThreadDispatcher;
 using System;
-using System.Text;
 using UnityEngine;
 
 public class PacketHandler
@@ -9,12 +8,9 @@ public class PacketHandler
     {
         UnityMainThreadDispatcher.Instance().Enqueue(() =>
         {
-            // 1. Ʈ 迭 -> ڿ ȯ
-            string msg = Encoding.UTF8.GetString(pkt.msg).TrimEnd('\0');
-
             if (ChatUI.Instance != null)
             {
-                ChatUI.Instance.AddChatMessage(msg);
+                ChatUI.Instance.AddChatMessage(pkt.msg);
             }
         });
     }
@@ -25,51 +21,45 @@ public class PacketHandler
         Debug.Log($"Recv Move Packet: {pkt.vx}, {pkt.vy}");
     }
 
-    public static void HandleSnapshot(byte[] data)
-    {
-        // data ̹  Ƿ 0Ͱ ٷ (Count)Դϴ.
-        int offset = 0;
+    //  忡  (Ÿ Ǯ    ִ)
+    private static readonly SnapshotState snapshotState = new SnapshotState();
 
-        // 1.   (ּ Count 4Ʈ ־ )
-        if (data.Length < 4) return;
+    public static void HandleSnapshot(PacketSnapshot pkt)
+    {
+        // Ÿ   Ǯ ACK Ѵ.    0   ü  ٽ ޴´.
+        if (!snapshotState.Apply(pkt))
+        {
+            NetworkManager.Instance.SendSnapshotAck(0);
+            return;
+        }
+        NetworkManager.Instance.SendSnapshotAck(pkt.tick);
 
-        // 2. ÷̾  б
-        int count = BitConverter.ToInt32(data, offset);
-        offset += 4;
+        // ٲ ͸   ѱ
+        SnapshotEntity[] changed = snapshotState.Changed.ToArray();
+        uint[] removed = snapshotState.Removed.ToArray();
 
         UnityMainThreadDispatcher.Instance().Enqueue(() =>
         {
             if (GameManager.Instance == null) return;
 
-            for (int i = 0; i < count; i++)
+            if (LobbyUI.Instance != null && !LobbyUI.Instance.gamePanel.activeSelf)
             {
-                //    üũ (ID(4) + X(4) + Y(4) = 12Ʈ)
-                if (offset + 12 > data.Length) break;
-
-                // 3.  Ľ ( GameRoom.cpp  : ID -> X -> Y)
-                uint playerId = BitConverter.ToUInt32(data, offset);
-                offset += 4;
-                
-                float x = BitConverter.ToSingle(data, offset);
-                offset += 4;
-                
-                float y = BitConverter.ToSingle(data, offset);
-                offset += 4;
-
-                if (LobbyUI.Instance != null && !LobbyUI.Instance.gamePanel.activeSelf)
-                {
-                    LobbyUI.Instance.OnEnterRoomSuccess();
-                }
+                LobbyUI.Instance.OnEnterRoomSuccess();
+            }
 
-                if (GameManager.Instance == null) return;
+            foreach (uint playerId in removed)
+            {
+                GameManager.Instance.DespawnPlayer(playerId);
+            }
 
-                // 4. ġ Ʈ
-                GameManager.Instance.UpdatePlayerPosition(playerId, x, y);
+            // ġ Ʈ ( ÷̾ ȴ)
+            foreach (SnapshotEntity player in changed)
+            {
+                GameManager.Instance.UpdatePlayerPosition(player.id, player.X, player.Y);
             }
         });
-
-
     }
+
     public static void HandleLeavePacket(PacketLeaveRoom pkt)
     {
         UnityMainThreadDispatcher.Instance().Enqueue(() =>
@@ -127,13 +117,8 @@ public class PacketHandler
         });
     }
 
-    public static void HandleRoomList(byte[] data)
+    public static void HandleRoomList(PacketRoomListRes pkt)
     {
-        // 1.   б
-        int offset = 0;
-        int count = BitConverter.ToInt32(data, offset);
-        offset += 4; // sizeof(int)
-
         UnityMainThreadDispatcher.Instance().Enqueue(() =>
         {
             if (LobbyUI.Instance != null)
@@ -141,24 +126,9 @@ public class PacketHandler
                 // UI ʱȭ (  )
                 LobbyUI.Instance.ClearRoomList();
 
-                // 2.  ŭ ݺ Ľ
-                for (int i = 0; i < count; i++)
+                foreach (RoomInfo room in pkt.rooms)
                 {
-                    // RoomInfo ü ũ⸸ŭ б
-                    // int(4) + int(4) + char(32) = 40Ʈ
-
-                    int rId = BitConverter.ToInt32(data, offset);
-                    offset += 4;
-
-                    int uCount = BitConverter.ToInt32(data, offset);
-                    offset += 4;
-
-                    // ڿ Ľ (32Ʈ )
-                    string title = Encoding.UTF8.GetString(data, offset, 32).TrimEnd('\0');
-                    offset += 32;
-
-                    // UI ߰
-                    LobbyUI.Instance.AddRoomItem(rId, title, uCount);
+                    LobbyUI.Instance.AddRoomItem(room.roomId, room.title, room.userCount);
                 }
             }
         });
@@ -181,4 +151,35 @@ public class PacketHandler
             }
         });
     }
+
+    public static void HandleWhisper(PacketWhisper pkt)
+    {
+        UnityMainThreadDispatcher.Instance().Enqueue(() =>
+        {
+            if (ChatUI.Instance != null)
+            {
+                ChatUI.Instance.AddSystemMessage($"[ӼӸ] {pkt.sender}: {pkt.msg}", Color.magenta);
+            }
+        });
+    }
+
+    public static void HandleWhisperRes(PacketWhisperRes pkt)
+    {
+        //    ˷ش (   ȭ鿡 ̹ ǥõ)
+        if (pkt.success) return;
+
+        UnityMainThreadDispatcher.Instance().Enqueue(() =>
+        {
+            if (ChatUI.Instance != null)
+            {
+                ChatUI.Instance.AddSystemMessage($"{pkt.target}    ƴմϴ.", Color.gray);
+            }
+        });
+    }
+
+    public static void HandleHeartbeatRes(PacketHeartbeatRes pkt)
+    {
+        //  忡 ٷ  (UI  )
+        NetworkManager.Instance.LastRttMs = (int)((uint)Environment.TickCount - pkt.clientTime);
+    }
 }
\ No newline at end of file
@@ -1,6 +1,5 @@
 using System;
 using System.Collections.Generic;
-using System.Runtime.InteropServices;
 // using UnityEditor; //      Ƿ ʿ   õ
 using UnityEngine;
 // using UnityEngine.LightTransport; // ʿ  
@@ -42,8 +41,7 @@ public class PacketManager
                 break;
 
             case PacketId.ROOM_LIST_RES:
-                //     (迭)̹Ƿ ü ȯ  Raw Data ٷ ѱϴ.
-                PacketHandler.HandleRoomList(bodyData);
+                HandlePacket<PacketRoomListRes>(bodyData, PacketHandler.HandleRoomList);
                 break;
 
             // --------------------------------------------------------
@@ -58,39 +56,35 @@ public class PacketManager
                 break;
 
             case PacketId.SNAPSHOT:
-                //   (÷̾   ٸ)̹Ƿ Raw Data 
-                PacketHandler.HandleSnapshot(bodyData);
+                HandlePacket<PacketSnapshot>(bodyData, PacketHandler.HandleSnapshot);
                 break;
 
             case PacketId.LEAVE_ROOM:
                 HandlePacket<PacketLeaveRoom>(bodyData, PacketHandler.HandleLeavePacket);
                 break;
-        }
-    }
 
-    // ׸  Լ: Ʈ 迭 -> ü ȯ  ڵ鷯 ȣ
-    void HandlePacket<T>(byte[] data, Action<T> handler) where T : struct
-    {
-        T pkt = ByteArrayToStructure<T>(data);
-        handler.Invoke(pkt);
-    }
+            case PacketId.WHISPER:
+                HandlePacket<PacketWhisper>(bodyData, PacketHandler.HandleWhisper);
+                break;
 
-    // Ʈ 迭 -> ü ȯ
-    public static T ByteArrayToStructure<T>(byte[] bytearray) where T : struct
-    {
-        int len = Marshal.SizeOf(typeof(T));
-        if (len > bytearray.Length) return default(T); // ġ
+            case PacketId.WHISPER_RES:
+                HandlePacket<PacketWhisperRes>(bodyData, PacketHandler.HandleWhisperRes);
+                break;
 
-        IntPtr ptr = Marshal.AllocHGlobal(len);
-        try
-        {
-            Marshal.Copy(bytearray, 0, ptr, len);
-            return (T)Marshal.PtrToStructure(ptr, typeof(T));
+            case PacketId.HEARTBEAT_RES:
+                HandlePacket<PacketHeartbeatRes>(bodyData, PacketHandler.HandleHeartbeatRes);
+                break;
         }
-        finally
+    }
+
+    // ׸  Լ:  ڵ (PacketDefine.cs ڵ)  ڵ鷯 ȣ
+    void HandlePacket<T>(byte[] data, Action<T> handler) where T : struct, IPacket
+    {
+        if (!PacketCodec.TryDeserialize(data, out T pkt))
         {
-            // [߿] ޸    finally Ͽ  õ
-            Marshal.FreeHGlobal(ptr);
+            Debug.LogWarning($"[Packet] Malformed {typeof(T).Name} ({data.Length} bytes)");
+            return;
         }
+        handler.Invoke(pkt);
     }
 }
\ No newline at end of file
@@ -0,0 +1,239 @@
+﻿using System;
+using System.Diagnostics;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace TestClient
+{
+    // ==================================================================================
+    // 처리량 측정용 채팅 부하 클라이언트
+    //  - clientCount 개 접속 -> 로그인 -> roomSize 명씩 같은 방에 입장
+    //  - 각 클라이언트가 sendIntervalMs 마다 채팅 전송 (0 이면 쉬지 않고 전송)
+    //  - 서버 I/O 엔진(IOCP / epoll / io_uring)을 바꿔 가며 같은 부하로 비교한다
+    //  - 채팅 본문에 보낸 시각을 넣어, 같은 방 클라이언트가 받을 때까지의 지연 분포(p50/p99/p99.9)를 잰다
+    //    (서버 스레드 배치 CHAT_PIN_THREADS=0/1 비교 등 꼬리 지연 확인용)
+    // ==================================================================================
+
+    public class ChatBench
+    {
+        private const int HeaderSize = PacketCodec.HeaderSize;
+        private const int MaxLatencySamples = 1 << 22;
+
+        private static readonly Stopwatch Clock = Stopwatch.StartNew();
+
+        private readonly string _ip;
+        private readonly int _port;
+        private readonly int _clientCount;
+        private readonly int _seconds;
+        private readonly int _roomSize;
+        private readonly int _sendIntervalMs;
+
+        private long _sentChats;
+        private long _recvChats;
+        private long _recvBytes;
+        private int _loggedIn;
+        private int _failed;
+        private volatile bool _running = true;
+        private volatile bool _sending = false;
+
+        private readonly long[] _latencyTicks = new long[MaxLatencySamples];
+        private long _latencyCount;
+
+        public ChatBench(string ip, int port, int clientCount, int seconds, int roomSize, int sendIntervalMs)
+        {
+            _ip = ip;
+            _port = port;
+            _clientCount = clientCount;
+            _seconds = seconds;
+            _roomSize = Math.Max(1, roomSize);
+            _sendIntervalMs = sendIntervalMs;
+        }
+
+        public async Task RunAsync()
+        {
+            Console.WriteLine($"[Bench] clients={_clientCount} seconds={_seconds} roomSize={_roomSize} interval={_sendIntervalMs}ms");
+
+            Task[] clients = new Task[_clientCount];
+            for (int i = 0; i < _clientCount; i++)
+            {
+                int id = i;
+                clients[i] = Task.Run(() => RunClientAsync(id));
+                if (i % 50 == 0) await Task.Delay(10);
+            }
+
+            // 전원 로그인(또는 실패)까지 대기
+            Stopwatch wait = Stopwatch.StartNew();
+            while (_loggedIn + _failed < _clientCount && wait.ElapsedMilliseconds < 10000)
+                await Task.Delay(50);
+
+            Console.WriteLine($"[Bench] logged in: {_loggedIn}, failed: {_failed}");
+            await Task.Delay(500); // 방 입장 처리 대기
+
+            long baseSent = Interlocked.Read(ref _sentChats);
+            long baseRecv = Interlocked.Read(ref _recvChats);
+            long baseBytes = Interlocked.Read(ref _recvBytes);
+
+            _sending = true;
+            Stopwatch sw = Stopwatch.StartNew();
+            long lastRecv = baseRecv;
+
+            for (int sec = 1; sec <= _seconds; sec++)
+            {
+                await Task.Delay(1000);
+                long recv = Interlocked.Read(ref _recvChats);
+                Console.WriteLine($"[Bench] {sec,3}s recv {recv - lastRecv,10} chats/s");
+                lastRecv = recv;
+            }
+
+            _sending = false;
+            double elapsed = sw.Elapsed.TotalSeconds;
+
+            long sent = Interlocked.Read(ref _sentChats) - baseSent;
+            long received = Interlocked.Read(ref _recvChats) - baseRecv;
+            long bytes = Interlocked.Read(ref _recvBytes) - baseBytes;
+
+            Console.WriteLine("[Bench] ---------------- result ----------------");
+            Console.WriteLine($"[Bench] sent     : {sent / elapsed,12:F0} chats/s");
+            Console.WriteLine($"[Bench] delivered: {received / elapsed,12:F0} chats/s (expected x{_roomSize} fan-out)");
+            Console.WriteLine($"[Bench] recv     : {bytes / elapsed / (1024 * 1024),12:F2} MB/s");
+            PrintLatency();
+
+            _running = false;
+            await Task.WhenAny(Task.WhenAll(clients), Task.Delay(2000));
+        }
+
+        private void PrintLatency()
+        {
+            int count = (int)Math.Min(Interlocked.Read(ref _latencyCount), MaxLatencySamples);
+            double[] ms = new double[count];
+            for (int i = 0; i < count; i++)
+                ms[i] = _latencyTicks[i] * 1000.0 / Stopwatch.Frequency;
+            Array.Sort(ms);
+
+            Console.WriteLine($"[Bench] latency  : p50 {ReconnectStorm.Percentile(ms, 0.50):F2}ms p99 {ReconnectStorm.Percentile(ms, 0.99):F2}ms " +
+                              $"p99.9 {ReconnectStorm.Percentile(ms, 0.999):F2}ms max {ReconnectStorm.Percentile(ms, 1.0):F2}ms ({count} deliveries)");
+        }
+
+        private async Task RunClientAsync(int id)
+        {
+            TcpClient client = new TcpClient();
+            try
+            {
+                client.NoDelay = true;
+                await client.ConnectAsync(_ip, _port);
+                NetworkStream stream = client.GetStream();
+
+                var loginDone = new TaskCompletionSource<bool>(TaskCreationOptions.RunContinuationsAsynchronously);
+                _ = Task.Run(() => ReceiveLoop(stream, loginDone));
+
+                await ChurnStress.SendLoginAsync(stream, $"bench_{id}");
+
+                if (await Task.WhenAny(loginDone.Task, Task.Delay(5000)) != loginDone.Task || !loginDone.Task.Result)
+                {
+                    Interlocked.Increment(ref _failed);
+                    return;
+                }
+                Interlocked.Increment(ref _loggedIn);
+
+                byte[] enter = PacketCodec.Serialize(new PacketEnterRoom { roomId = id / _roomSize + 1 });
+                await stream.WriteAsync(enter, 0, enter.Length);
+
+                byte[] chat = new byte[HeaderSize + PacketChat.MaxSize];
+
+                while (_running)
+                {
+                    if (!_sending)
+                    {
+                        await Task.Delay(10);
+                        continue;
+                    }
+
+                    // "#<보낸 시각>" (서버는 "이름: " 을 앞에 붙여 방에 뿌린다)
+                    int length = PacketCodec.Serialize(new PacketChat { msg = $"#{Clock.ElapsedTicks}" }, chat, 0);
+
+                    await stream.WriteAsync(chat, 0, length);
+                    Interlocked.Increment(ref _sentChats);
+
+                    if (_sendIntervalMs > 0)
+                        await Task.Delay(_sendIntervalMs);
+                }
+            }
+            catch (Exception e)
+            {
+                if (_running)
+                {
+                    Interlocked.Increment(ref _failed);
+                    Console.WriteLine($"[Bench {id}] Error: {e.Message}");
+                }
+            }
+            finally
+            {
+                client.Close();
+            }
+        }
+
+        private async Task ReceiveLoop(NetworkStream stream, TaskCompletionSource<bool> loginDone)
+        {
+            byte[] buffer = new byte[64 * 1024];
+            int filled = 0;
+
+            try
+            {
+                while (true)
+                {
+                    int read = await stream.ReadAsync(buffer, filled, buffer.Length - filled);
+                    if (read == 0) break;
+                    filled += read;
+                    Interlocked.Add(ref _recvBytes, read);
+
+                    // 완성된 패킷만 소비하고 나머지는 앞으로 당긴다
+                    int offset = 0;
+                    while (filled - offset >= HeaderSize)
+                    {
+                        ushort size = BitConverter.ToUInt16(buffer, offset);
+                        ushort packetId = BitConverter.ToUInt16(buffer, offset + 2);
+                        if (size < HeaderSize || filled - offset < size) break;
+
+                        if (packetId == (ushort)PacketId.CHAT)
+                        {
+                            Interlocked.Increment(ref _recvChats);
+                            if (_sending) RecordLatency(buffer, offset + HeaderSize, size - HeaderSize);
+                        }
+                        else if (packetId == (ushort)PacketId.LOGIN_RES)
+                        {
+                            PacketCodec.TryDeserialize(buffer, offset + HeaderSize, size - HeaderSize, out PacketLoginRes res);
+                            loginDone.TrySetResult(res.success);
+                        }
+
+                        offset += size;
+                    }
+
+                    Buffer.BlockCopy(buffer, offset, buffer, 0, filled - offset);
+                    filled -= offset;
+                }
+            }
+            catch (Exception) { }
+
+            loginDone.TrySetResult(false);
+        }
+
+        // 받은 채팅마다 문자열을 만들지 않도록 msg 의 버퍼 위치만 읽는다
+        private void RecordLatency(byte[] buffer, int bodyOffset, int bodySize)
+        {
+            PacketReader reader = new PacketReader(buffer, bodyOffset, bodySize);
+            if (!reader.Read(out uint playerId) || !reader.ReadStringRange(out int msgOffset, out int msgSize, 255)) return;
+
+            int mark = Array.IndexOf(buffer, (byte)'#', msgOffset, msgSize);
+            if (mark < 0) return;
+
+            long sent = 0;
+            for (int i = mark + 1; i < msgOffset + msgSize && buffer[i] >= '0' && buffer[i] <= '9'; i++)
+                sent = sent * 10 + (buffer[i] - '0');
+
+            long index = Interlocked.Increment(ref _latencyCount) - 1;
+            if (index < MaxLatencySamples)
+                _latencyTicks[index] = Clock.ElapsedTicks - sent;
+        }
+    }
+}
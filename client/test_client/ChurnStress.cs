@@ -0,0 +1,307 @@
+﻿using System;
+using System.Diagnostics;
+using System.Net;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace TestClient
+{
+    // ==================================================================================
+    // 접속/끊김 반복 스트레스 (세션 지연 해제 검증용)
+    //  - steadyCount 개가 계속 접속해 있으면서 roomSize 명씩 방에 들어가 이동 패킷을 보낸다 (스냅샷 부하)
+    //  - churnerCount 개는 seconds 동안 접속 -> 로그인 -> 방 입장 -> 이동/채팅 -> 끊기를 쉬지 않고 반복한다
+    //  - 끊는 방식을 돌아가며 바꾼다: 정상 종료 / LOGOUT_REQ / RST / 패킷 중간에서 끊기 / 로그인 응답 전에 끊기
+    //  - 끝나면 상시 접속 클라이언트가 모두 살아서 스냅샷을 받고 있는지, 새 로그인이 되는지 확인한다
+    //  - 서버 콘솔의 mem 명령으로 retired / reclaimed / pending 이 맞는지 함께 본다
+    // ==================================================================================
+
+    public class ChurnStress
+    {
+        private const int HeaderSize = PacketCodec.HeaderSize;
+        private const int ChurnModeCount = 5;
+
+        private readonly string _ip;
+        private readonly int _port;
+        private readonly int _steadyCount;
+        private readonly int _churnerCount;
+        private readonly int _seconds;
+        private readonly int _roomSize;
+
+        private long _cycles;
+        private long _connectFailed;
+        private long _loginFailed;
+        private readonly long[] _modeCounts = new long[ChurnModeCount];
+
+        private int _steadyLoggedIn;
+        private int _steadyLoginFailed;
+        private int _steadyDropped;
+        private long _steadySnapshots;
+        private volatile bool _running = true;
+
+        public ChurnStress(string ip, int port, int steadyCount, int churnerCount, int seconds, int roomSize)
+        {
+            _ip = ip;
+            _port = port;
+            _steadyCount = steadyCount;
+            _churnerCount = churnerCount;
+            _seconds = seconds;
+            _roomSize = Math.Max(1, roomSize);
+        }
+
+        public async Task RunAsync()
+        {
+            Console.WriteLine($"[Churn] steady={_steadyCount} churners={_churnerCount} seconds={_seconds} roomSize={_roomSize}");
+
+            Task[] steady = new Task[_steadyCount];
+            for (int i = 0; i < _steadyCount; i++)
+            {
+                int id = i;
+                steady[i] = Task.Run(() => RunSteadyAsync(id));
+                if (i % 50 == 0) await Task.Delay(10);
+            }
+
+            Stopwatch wait = Stopwatch.StartNew();
+            while (_steadyLoggedIn + _steadyLoginFailed < _steadyCount && wait.ElapsedMilliseconds < 10000)
+                await Task.Delay(50);
+            Console.WriteLine($"[Churn] steady logged in: {_steadyLoggedIn}, failed: {_steadyLoginFailed}");
+
+            Stopwatch sw = Stopwatch.StartNew();
+            Task[] churners = new Task[_churnerCount];
+            for (int i = 0; i < _churnerCount; i++)
+            {
+                int id = i;
+                churners[i] = Task.Run(() => RunChurnerAsync(id, sw));
+            }
+
+            long lastCycles = 0;
+            long lastSnapshots = Interlocked.Read(ref _steadySnapshots);
+            for (int sec = 1; sec <= _seconds; sec++)
+            {
+                await Task.Delay(1000);
+                long cycles = Interlocked.Read(ref _cycles);
+                long snapshots = Interlocked.Read(ref _steadySnapshots);
+                Console.WriteLine($"[Churn] {sec,3}s {cycles - lastCycles,7} cycles/s, steady snapshots {snapshots - lastSnapshots,8}/s, steady dropped {_steadyDropped}");
+                lastCycles = cycles;
+                lastSnapshots = snapshots;
+            }
+
+            await Task.WhenAll(churners);
+
+            // 반복이 끝난 뒤에도 상시 접속 클라이언트가 스냅샷을 계속 받는지
+            long before = Interlocked.Read(ref _steadySnapshots);
+            await Task.Delay(1000);
+            long after = Interlocked.Read(ref _steadySnapshots);
+
+            bool freshLogin = await TryFreshLoginAsync();
+
+            Console.WriteLine("[Churn] ---------------- result ----------------");
+            Console.WriteLine($"[Churn] cycles      : {Interlocked.Read(ref _cycles)} ({Interlocked.Read(ref _cycles) / sw.Elapsed.TotalSeconds:F0}/s)");
+            Console.WriteLine($"[Churn] by mode     : close {_modeCounts[0]}, logout {_modeCounts[1]}, reset {_modeCounts[2]}, " +
+                              $"half-packet {_modeCounts[3]}, before-login-res {_modeCounts[4]}");
+            Console.WriteLine($"[Churn] failures    : connect {_connectFailed}, login {_loginFailed}");
+            Console.WriteLine($"[Churn] steady alive: {_steadyLoggedIn - _steadyDropped}/{_steadyCount}, snapshots after churn {after - before}/s");
+            Console.WriteLine($"[Churn] fresh login : {(freshLogin ? "ok" : "FAILED")}");
+
+            _running = false;
+            await Task.WhenAny(Task.WhenAll(steady), Task.Delay(2000));
+        }
+
+        private async Task RunSteadyAsync(int id)
+        {
+            TcpClient client = new TcpClient { NoDelay = true };
+            bool loggedIn = false;
+            try
+            {
+                await client.ConnectAsync(_ip, _port);
+                NetworkStream stream = client.GetStream();
+
+                await SendLoginAsync(stream, $"steady_{id}");
+                if (!await ReadLoginResAsync(stream))
+                {
+                    Interlocked.Increment(ref _steadyLoginFailed);
+                    return;
+                }
+                loggedIn = true;
+                Interlocked.Increment(ref _steadyLoggedIn);
+
+                await SendEnterRoomAsync(stream, id / _roomSize + 1);
+                _ = Task.Run(() => CountSnapshotsAsync(stream));
+
+                byte[] move = new byte[HeaderSize + PacketMove.MaxSize];
+                Random random = new Random(id);
+
+                while (_running)
+                {
+                    PacketMove packet = new PacketMove
+                    {
+                        vx = (float)(random.NextDouble() * 2 - 1),
+                        vy = (float)(random.NextDouble() * 2 - 1)
+                    };
+                    int length = PacketCodec.Serialize(packet, move, 0);
+                    await stream.WriteAsync(move, 0, length);
+                    await Task.Delay(50);
+                }
+            }
+            catch (Exception e)
+            {
+                if (_running)
+                {
+                    if (loggedIn) Interlocked.Increment(ref _steadyDropped);
+                    else Interlocked.Increment(ref _steadyLoginFailed);
+                    Console.WriteLine($"[Churn steady {id}] Error: {e.Message}");
+                }
+            }
+            finally
+            {
+                client.Close();
+            }
+        }
+
+        private async Task CountSnapshotsAsync(NetworkStream stream)
+        {
+            byte[] buffer = new byte[64 * 1024];
+            int filled = 0;
+
+            try
+            {
+                while (true)
+                {
+                    int read = await stream.ReadAsync(buffer, filled, buffer.Length - filled);
+                    if (read == 0) break;
+                    filled += read;
+
+                    int offset = 0;
+                    while (filled - offset >= HeaderSize)
+                    {
+                        ushort size = BitConverter.ToUInt16(buffer, offset);
+                        ushort packetId = BitConverter.ToUInt16(buffer, offset + 2);
+                        if (size < HeaderSize || filled - offset < size) break;
+
+                        if (packetId == (ushort)PacketId.SNAPSHOT)
+                            Interlocked.Increment(ref _steadySnapshots);
+
+                        offset += size;
+                    }
+
+                    Buffer.BlockCopy(buffer, offset, buffer, 0, filled - offset);
+                    filled -= offset;
+                }
+            }
+            catch (Exception) { }
+        }
+
+        // 한 사이클 = 접속 -> 로그인 -> 방 입장 -> 이동/채팅 몇 개 -> 끊기
+        private async Task RunChurnerAsync(int id, Stopwatch sw)
+        {
+            byte[] chat = PacketCodec.Serialize(new PacketChat { msg = "churn" });
+            byte[] move = PacketCodec.Serialize(new PacketMove { vx = 1.0f });
+
+            long cycle = 0;
+            while (sw.Elapsed.TotalSeconds < _seconds)
+            {
+                int mode = (int)((id + cycle) % ChurnModeCount);
+                TcpClient client = new TcpClient { NoDelay = true };
+                try
+                {
+                    await client.ConnectAsync(_ip, _port);
+                }
+                catch (Exception)
+                {
+                    Interlocked.Increment(ref _connectFailed);
+                    client.Close();
+                    await Task.Delay(10);
+                    continue;
+                }
+
+                try
+                {
+                    NetworkStream stream = client.GetStream();
+                    // 같은 이름이 앞 사이클의 로그아웃 처리와 겹치지 않도록 사이클마다 이름을 바꾼다
+                    await SendLoginAsync(stream, $"churn_{id}_{cycle}");
+
+                    if (mode != 4)
+                    {
+                        if (!await ReadLoginResAsync(stream))
+                            Interlocked.Increment(ref _loginFailed);
+
+                        // 상시 접속 클라이언트와 같은 방에 들어가 스냅샷/채팅 브로드캐스트에 섞인다
+                        await SendEnterRoomAsync(stream, (int)((id + cycle) % Math.Max(1, _steadyCount / _roomSize)) + 1);
+                        for (int i = 0; i < 3; i++)
+                        {
+                            await stream.WriteAsync(move, 0, move.Length);
+                            await stream.WriteAsync(chat, 0, chat.Length);
+                        }
+                    }
+
+                    switch (mode)
+                    {
+                        case 1:
+                            byte[] logout = PacketCodec.Serialize(new PacketLogoutReq());
+                            await stream.WriteAsync(logout, 0, logout.Length);
+                            break;
+                        case 2:
+                            client.LingerState = new LingerOption(true, 0);   // close 가 RST 로 나간다
+                            break;
+                        case 3:
+                            await stream.WriteAsync(chat, 0, chat.Length / 2);
+                            break;
+                    }
+                }
+                catch (Exception) { }
+
+                client.Close();
+                Interlocked.Increment(ref _modeCounts[mode]);
+                Interlocked.Increment(ref _cycles);
+                cycle++;
+            }
+        }
+
+        private async Task<bool> TryFreshLoginAsync()
+        {
+            try
+            {
+                using TcpClient client = new TcpClient { NoDelay = true };
+                await client.ConnectAsync(_ip, _port);
+                NetworkStream stream = client.GetStream();
+                await SendLoginAsync(stream, "churn_fresh");
+                return await ReadLoginResAsync(stream);
+            }
+            catch (Exception)
+            {
+                return false;
+            }
+        }
+
+        internal static async Task SendLoginAsync(NetworkStream stream, string name)
+        {
+            byte[] login = PacketCodec.Serialize(new PacketLoginReq { username = name, password = "1234" });
+            await stream.WriteAsync(login, 0, login.Length);
+        }
+
+        private static async Task SendEnterRoomAsync(NetworkStream stream, int roomId)
+        {
+            byte[] enter = PacketCodec.Serialize(new PacketEnterRoom { roomId = roomId });
+            await stream.WriteAsync(enter, 0, enter.Length);
+        }
+
+        // 로그인 직후에는 LOGIN_RES 만 온다 (방 입장 전이라 스냅샷이 섞이지 않는다)
+        internal static async Task<bool> ReadLoginResAsync(NetworkStream stream)
+        {
+            byte[] buffer = new byte[HeaderSize + PacketLoginRes.MaxSize];
+            int filled = 0;
+            using var timeout = new CancellationTokenSource(5000);
+            while (filled < buffer.Length)
+            {
+                int read = await stream.ReadAsync(buffer, filled, buffer.Length - filled, timeout.Token);
+                if (read == 0) return false;
+                filled += read;
+            }
+
+            ushort packetId = BitConverter.ToUInt16(buffer, 2);
+            return packetId == (ushort)PacketId.LOGIN_RES
+                && PacketCodec.TryDeserialize(buffer, HeaderSize, PacketLoginRes.MaxSize, out PacketLoginRes res)
+                && res.success;
+        }
+    }
+}
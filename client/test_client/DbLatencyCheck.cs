@@ -0,0 +1,216 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace TestClient
+{
+    // ==================================================================================
+    // 느린 DB 에서 틱이 밀리지 않는지 확인 (서버를 CHAT_DB_DELAY_MS=200 으로 띄운다)
+    //  - watchers 개는 1 번 방에서 이동 패킷을 보내며 스냅샷 도착 간격을 잰다 (서버 틱이 막히면 간격이 벌어진다)
+    //  - loginers 개는 seconds 동안 접속 -> 로그인 -> 1 번 방 입장 (최근 채팅 조회) -> 채팅 -> 끊기를 반복한다
+    //    로그인 / 최근 채팅 조회가 DB 워커에서 도는 동안 같은 방의 스냅샷 간격은 그대로여야 한다
+    //  - 로그인 응답 시간은 주입한 지연만큼 늘어난다. 서버 콘솔의 ticks 로 틱 시간 / 늦음 분포를 함께 본다
+    // ==================================================================================
+
+    public class DbLatencyCheck
+    {
+        private const int HeaderSize = PacketCodec.HeaderSize;
+        private const int RoomId = 1;
+
+        private readonly string _ip;
+        private readonly int _port;
+        private readonly int _watcherCount;
+        private readonly int _loginerCount;
+        private readonly int _seconds;
+
+        private readonly List<double> _snapshotGapsMs = new List<double>();
+        private readonly List<double> _loginMs = new List<double>();
+        private long _cycles;
+        private long _loginFailed;
+        private int _watchersReady;
+        private volatile bool _measuring;
+        private volatile bool _running = true;
+
+        public DbLatencyCheck(string ip, int port, int watcherCount, int loginerCount, int seconds)
+        {
+            _ip = ip;
+            _port = port;
+            _watcherCount = Math.Max(1, watcherCount);
+            _loginerCount = loginerCount;
+            _seconds = seconds;
+        }
+
+        public async Task RunAsync()
+        {
+            Console.WriteLine($"[DbLatency] watchers={_watcherCount} loginers={_loginerCount} seconds={_seconds}");
+
+            Task[] watchers = new Task[_watcherCount];
+            for (int i = 0; i < _watcherCount; i++)
+            {
+                int id = i;
+                watchers[i] = Task.Run(() => RunWatcherAsync(id));
+            }
+
+            // 주입한 지연 때문에 로그인도 늦게 끝난다
+            Stopwatch wait = Stopwatch.StartNew();
+            while (_watchersReady < _watcherCount && wait.ElapsedMilliseconds < 15000)
+                await Task.Delay(50);
+            Console.WriteLine($"[DbLatency] watchers in room: {_watchersReady}/{_watcherCount}");
+            await Task.Delay(500);
+
+            _measuring = true;
+            Stopwatch sw = Stopwatch.StartNew();
+            Task[] loginers = new Task[_loginerCount];
+            for (int i = 0; i < _loginerCount; i++)
+            {
+                int id = i;
+                loginers[i] = Task.Run(() => RunLoginerAsync(id, sw));
+            }
+
+            await Task.WhenAll(loginers);
+            _measuring = false;
+
+            Console.WriteLine("[DbLatency] ---------------- result ----------------");
+            Console.WriteLine($"[DbLatency] login cycles : {Interlocked.Read(ref _cycles)}, failed {Interlocked.Read(ref _loginFailed)}");
+            lock (_loginMs) Console.WriteLine($"[DbLatency] login ms    : {Describe(_loginMs)}");
+            lock (_snapshotGapsMs) Console.WriteLine($"[DbLatency] snapshot gap: {Describe(_snapshotGapsMs)} ms");
+
+            _running = false;
+            await Task.WhenAny(Task.WhenAll(watchers), Task.Delay(2000));
+        }
+
+        private static string Describe(List<double> values)
+        {
+            if (values.Count == 0) return "no samples";
+
+            values.Sort();
+            double Percentile(double p) => values[Math.Min(values.Count - 1, (int)(p * values.Count))];
+            return $"n {values.Count}, p50 {Percentile(0.5):F1}, p99 {Percentile(0.99):F1}, p99.9 {Percentile(0.999):F1}, max {values[values.Count - 1]:F1}";
+        }
+
+        private async Task RunWatcherAsync(int id)
+        {
+            TcpClient client = new TcpClient { NoDelay = true };
+            try
+            {
+                await client.ConnectAsync(_ip, _port);
+                NetworkStream stream = client.GetStream();
+
+                await ChurnStress.SendLoginAsync(stream, $"dblat_watch_{id}");
+                if (!await ChurnStress.ReadLoginResAsync(stream)) return;
+
+                byte[] enter = PacketCodec.Serialize(new PacketEnterRoom { roomId = RoomId });
+                await stream.WriteAsync(enter, 0, enter.Length);
+                Interlocked.Increment(ref _watchersReady);
+
+                _ = Task.Run(() => MeasureSnapshotsAsync(stream));
+
+                byte[] move = new byte[HeaderSize + PacketMove.MaxSize];
+                Random random = new Random(id);
+                while (_running)
+                {
+                    PacketMove packet = new PacketMove
+                    {
+                        vx = (float)(random.NextDouble() * 2 - 1),
+                        vy = (float)(random.NextDouble() * 2 - 1)
+                    };
+                    int length = PacketCodec.Serialize(packet, move, 0);
+                    await stream.WriteAsync(move, 0, length);
+                    await Task.Delay(50);
+                }
+            }
+            catch (Exception e)
+            {
+                if (_running) Console.WriteLine($"[DbLatency watcher {id}] Error: {e.Message}");
+            }
+            finally
+            {
+                client.Close();
+            }
+        }
+
+        // 스냅샷이 올 때마다 앞 스냅샷과의 간격을 남긴다 (측정 중일 때만)
+        private async Task MeasureSnapshotsAsync(NetworkStream stream)
+        {
+            byte[] buffer = new byte[64 * 1024];
+            int filled = 0;
+            Stopwatch sw = Stopwatch.StartNew();
+            double last = -1;
+
+            try
+            {
+                while (true)
+                {
+                    int read = await stream.ReadAsync(buffer, filled, buffer.Length - filled);
+                    if (read == 0) break;
+                    filled += read;
+
+                    int offset = 0;
+                    while (filled - offset >= HeaderSize)
+                    {
+                        ushort size = BitConverter.ToUInt16(buffer, offset);
+                        ushort packetId = BitConverter.ToUInt16(buffer, offset + 2);
+                        if (size < HeaderSize || filled - offset < size) break;
+
+                        if (packetId == (ushort)PacketId.SNAPSHOT)
+                        {
+                            double now = sw.Elapsed.TotalMilliseconds;
+                            if (_measuring && last >= 0)
+                                lock (_snapshotGapsMs) _snapshotGapsMs.Add(now - last);
+                            last = now;
+                        }
+
+                        offset += size;
+                    }
+
+                    Buffer.BlockCopy(buffer, offset, buffer, 0, filled - offset);
+                    filled -= offset;
+                }
+            }
+            catch (Exception) { }
+        }
+
+        private async Task RunLoginerAsync(int id, Stopwatch sw)
+        {
+            byte[] enter = PacketCodec.Serialize(new PacketEnterRoom { roomId = RoomId });
+            byte[] chat = PacketCodec.Serialize(new PacketChat { msg = "dblat" });
+
+            long cycle = 0;
+            while (sw.Elapsed.TotalSeconds < _seconds)
+            {
+                using TcpClient client = new TcpClient { NoDelay = true };
+                try
+                {
+                    await client.ConnectAsync(_ip, _port);
+                    NetworkStream stream = client.GetStream();
+
+                    Stopwatch login = Stopwatch.StartNew();
+                    await ChurnStress.SendLoginAsync(stream, $"dblat_{id}_{cycle}");
+                    if (!await ChurnStress.ReadLoginResAsync(stream))
+                    {
+                        Interlocked.Increment(ref _loginFailed);
+                        continue;
+                    }
+                    lock (_loginMs) _loginMs.Add(login.Elapsed.TotalMilliseconds);
+
+                    // 입장하면 서버가 최근 채팅을 조회한다 (지연 주입 대상). 채팅은 DB 저장 요청을 만든다.
+                    await stream.WriteAsync(enter, 0, enter.Length);
+                    await stream.WriteAsync(chat, 0, chat.Length);
+                    await Task.Delay(100);
+                }
+                catch (Exception)
+                {
+                    Interlocked.Increment(ref _loginFailed);
+                }
+                finally
+                {
+                    cycle++;
+                    Interlocked.Increment(ref _cycles);
+                }
+            }
+        }
+    }
+}
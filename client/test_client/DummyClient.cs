@@ -3,109 +3,12 @@ using System.Net.Sockets;
 using System.Threading;
 using System.Threading.Tasks;
 using System.Runtime.InteropServices;
-using System.Text;
 using System.Collections.Generic;
 
 namespace TestClient
 {
     // ==================================================================================
-    // [1] 패킷 구조체 정의
-    // ==================================================================================
-
-    public enum PacketId : ushort
-    {
-        REGISTER_REQ = 1, REGISTER_RES = 2,
-        LOGIN_REQ = 3, LOGIN_RES = 4,
-        ENTER_ROOM = 5, LEAVE_ROOM = 6,
-        CHAT = 7, MOVE = 8, SNAPSHOT = 9,
-        ROOM_LIST_REQ = 10, ROOM_LIST_RES = 11,
-        CREATE_ROOM_REQ = 12, CREATE_ROOM_RES = 13,
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct GameHeader
-    {
-        public ushort packetSize;
-        public ushort packetId;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketRegisterReq
-    {
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-        public byte[] username;
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-        public byte[] password;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketRegisterRes
-    {
-        [MarshalAs(UnmanagedType.I1)]
-        public bool success;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketLoginReq
-    {
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-        public byte[] username;
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-        public byte[] password;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketLoginRes
-    {
-        [MarshalAs(UnmanagedType.I1)]
-        public bool success;
-        public uint playerId;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketRoomListRes
-    {
-        public int count;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketCreateRoomReq
-    {
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)]
-        public byte[] title;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketCreateRoomRes
-    {
-        [MarshalAs(UnmanagedType.I1)]
-        public bool success;
-        public int roomId;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketEnterRoom
-    {
-        public int roomId;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketMove
-    {
-        public float vx;
-        public float vy;
-    }
-
-    [StructLayout(LayoutKind.Sequential, Pack = 1)]
-    public struct PacketChat
-    {
-        public uint playerId;
-        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 256)]
-        public byte[] msg;
-    }
-
-    // ==================================================================================
-    // [2] 더미 클라이언트 클래스
+    // 더미 클라이언트 클래스 (패킷 정의/코덱은 protocol/packets.schema 에서 생성한 PacketDefine.cs)
     // ==================================================================================
 
     public class DummyClient
@@ -125,6 +28,7 @@ namespace TestClient
 
         private bool _isInRoom = false;
         private uint _myPlayerId = 0;
+        private readonly SnapshotState _snapshots = new SnapshotState(); // 수신 루프에서만 쓴다
 
         // 시나리오 진행을 위한 데이터
         private int _lastRoomCount = -1;
@@ -180,15 +84,12 @@ namespace TestClient
             string username = $"User_{_dummyId}";
             string password = "1234";
 
-            var userBytes = StringToBytes(username, 50);
-            var passBytes = StringToBytes(password, 50);
-
             // [1단계] 로그인 시도
             Console.WriteLine($"[{_dummyId}] Try Login...");
-            PacketLoginReq loginReq = new PacketLoginReq { username = userBytes, password = passBytes };
+            PacketLoginReq loginReq = new PacketLoginReq { username = username, password = password };
 
             _loginReqDone = false;
-            SendPacket(PacketId.LOGIN_REQ, loginReq);
+            SendPacket(loginReq);
 
             // 응답 대기
             await WaitUntil(() => _loginReqDone, 2000); // 2초 대기
@@ -200,10 +101,10 @@ namespace TestClient
 
             // [2단계] 로그인 실패 -> 회원가입 시도
             Console.WriteLine($"[{_dummyId}] Login Failed. Try Register...");
-            PacketRegisterReq regReq = new PacketRegisterReq { username = userBytes, password = passBytes };
+            PacketRegisterReq regReq = new PacketRegisterReq { username = username, password = password };
 
             _registerReqDone = false;
-            SendPacket(PacketId.REGISTER_REQ, regReq);
+            SendPacket(regReq);
 
             // 회원가입 응답 대기
             await WaitUntil(() => _registerReqDone, 2000);
@@ -215,7 +116,7 @@ namespace TestClient
                 // [3단계] 재로그인
                 _loginReqDone = false;
                 _isLoginSuccess = false;
-                SendPacket(PacketId.LOGIN_REQ, loginReq);
+                SendPacket(loginReq);
 
                 await WaitUntil(() => _loginReqDone, 2000);
             }
@@ -228,7 +129,7 @@ namespace TestClient
         private async Task RoomScenario()
         {
             // 방 리스트 요청
-            SendPacket(PacketId.ROOM_LIST_REQ, new byte[0]);
+            SendPacket(new PacketRoomListReq());
 
             // 리스트 응답 대기
             while (_lastRoomCount == -1) await Task.Delay(50);
@@ -239,9 +140,9 @@ namespace TestClient
                 Console.WriteLine($"[{_dummyId}] No rooms. Creating one...");
                 PacketCreateRoomReq createReq = new PacketCreateRoomReq
                 {
-                    title = StringToBytes($"Room_{_dummyId}", 32)
+                    title = $"Room_{_dummyId}"
                 };
-                SendPacket(PacketId.CREATE_ROOM_REQ, createReq);
+                SendPacket(createReq);
 
                 // 생성 응답 대기
                 while (_createdRoomId == -1) await Task.Delay(50);
@@ -264,7 +165,7 @@ namespace TestClient
         private void SendEnterRoom(int roomId)
         {
             PacketEnterRoom enterReq = new PacketEnterRoom { roomId = roomId };
-            SendPacket(PacketId.ENTER_ROOM, enterReq);
+            SendPacket(enterReq);
         }
 
         private async Task ActionLoop()
@@ -282,16 +183,16 @@ namespace TestClient
                             vx = (float)(_rand.NextDouble() * 2 - 1),
                             vy = (float)(_rand.NextDouble() * 2 - 1)
                         };
-                        SendPacket(PacketId.MOVE, moveReq);
+                        SendPacket(moveReq);
                     }
                     else
                     {
                         PacketChat chatReq = new PacketChat
                         {
                             playerId = _myPlayerId,
-                            msg = StringToBytes($"Hello from {_dummyId}", 256)
+                            msg = $"Hello from {_dummyId}"
                         };
-                        SendPacket(PacketId.CHAT, chatReq);
+                        SendPacket(chatReq);
                     }
 
                     // 0.2 ~ 1.0초 간격
@@ -305,66 +206,11 @@ namespace TestClient
         // 네트워크 / 마샬링 헬퍼
         // -----------------------------------------------------------
 
-        private void SendPacket<T>(PacketId id, T payload) where T : struct
+        private void SendPacket<T>(T packet) where T : struct, IPacket
         {
             if (!_isConnected) return;
 
-            int headerSize = Marshal.SizeOf(typeof(GameHeader));
-            int payloadSize = Marshal.SizeOf(typeof(T));
-            int totalSize = headerSize + payloadSize;
-
-            byte[] buffer = new byte[totalSize];
-
-            GameHeader header = new GameHeader
-            {
-                packetSize = (ushort)totalSize,
-                packetId = (ushort)id
-            };
-
-            IntPtr ptr = Marshal.AllocHGlobal(totalSize);
-            try
-            {
-                Marshal.StructureToPtr(header, ptr, false);
-                Marshal.StructureToPtr(payload, ptr + headerSize, false);
-                Marshal.Copy(ptr, buffer, 0, totalSize);
-            }
-            finally
-            {
-                Marshal.FreeHGlobal(ptr);
-            }
-
-            try
-            {
-                lock (_stream)
-                {
-                    _stream.Write(buffer, 0, buffer.Length);
-                }
-            }
-            catch { Disconnect(); }
-        }
-
-        private void SendPacket(PacketId id, byte[] emptyPayload)
-        {
-            if (!_isConnected) return;
-            int headerSize = Marshal.SizeOf(typeof(GameHeader));
-            byte[] buffer = new byte[headerSize];
-
-            GameHeader header = new GameHeader
-            {
-                packetSize = (ushort)headerSize,
-                packetId = (ushort)id
-            };
-
-            IntPtr ptr = Marshal.AllocHGlobal(headerSize);
-            try
-            {
-                Marshal.StructureToPtr(header, ptr, false);
-                Marshal.Copy(ptr, buffer, 0, headerSize);
-            }
-            finally
-            {
-                Marshal.FreeHGlobal(ptr);
-            }
+            byte[] buffer = PacketCodec.Serialize(packet);
 
             try
             {
@@ -426,7 +272,7 @@ namespace TestClient
             {
                 case PacketId.REGISTER_RES:
                     {
-                        var res = BytesToStruct<PacketRegisterRes>(payload);
+                        if (!PacketCodec.TryDeserialize(payload, out PacketRegisterRes res)) break;
                         _isRegisterSuccess = res.success;
                         _registerReqDone = true;
                         Console.WriteLine($"[{_dummyId}] Register Response: {res.success}");
@@ -435,7 +281,7 @@ namespace TestClient
 
                 case PacketId.LOGIN_RES:
                     {
-                        var res = BytesToStruct<PacketLoginRes>(payload);
+                        if (!PacketCodec.TryDeserialize(payload, out PacketLoginRes res)) break;
                         _isLoginSuccess = res.success;
                         if (res.success)
                         {
@@ -452,15 +298,15 @@ namespace TestClient
 
                 case PacketId.ROOM_LIST_RES:
                     {
-                        var res = BytesToStruct<PacketRoomListRes>(payload);
-                        _lastRoomCount = res.count;
-                        Console.WriteLine($"[{_dummyId}] Room Count Received: {res.count}");
+                        if (!PacketCodec.TryDeserialize(payload, out PacketRoomListRes res)) break;
+                        _lastRoomCount = res.rooms.Length;
+                        Console.WriteLine($"[{_dummyId}] Room Count Received: {res.rooms.Length}");
                     }
                     break;
 
                 case PacketId.CREATE_ROOM_RES:
                     {
-                        var res = BytesToStruct<PacketCreateRoomRes>(payload);
+                        if (!PacketCodec.TryDeserialize(payload, out PacketCreateRoomRes res)) break;
                         if (res.success)
                         {
                             _createdRoomId = res.roomId;
@@ -468,6 +314,15 @@ namespace TestClient
                         }
                     }
                     break;
+
+                case PacketId.SNAPSHOT:
+                    {
+                        // 델타를 풀어 적용하고 ACK (기준이 없으면 0 -> 서버가 전체 스냅샷을 다시 보낸다)
+                        if (!PacketCodec.TryDeserialize(payload, out PacketSnapshot pkt)) break;
+                        bool applied = _snapshots.Apply(pkt);
+                        SendPacket(new PacketSnapshotAck { tick = applied ? pkt.tick : 0 });
+                    }
+                    break;
             }
         }
 
@@ -487,14 +342,6 @@ namespace TestClient
             return false;
         }
 
-        private byte[] StringToBytes(string str, int size)
-        {
-            byte[] buffer = new byte[size];
-            byte[] strBytes = Encoding.UTF8.GetBytes(str);
-            Array.Copy(strBytes, buffer, Math.Min(strBytes.Length, size));
-            return buffer;
-        }
-
         private T BytesToStruct<T>(byte[] buffer) where T : struct
         {
             int size = Marshal.SizeOf(typeof(T));
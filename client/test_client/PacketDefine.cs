@@ -1,23 +1,27 @@
-﻿using System;
+﻿// protocol/packets.schema 에서 생성한 파일. 직접 고치지 말고 스키마를 고친 뒤
+// python protocol/gen_protocol.py 로 다시 만든다.
+using System;
 using System.Runtime.InteropServices;
 using System.Text;
 
-// [패킷 ID] 서버의 PacketId enum과 순서/번호가 완전히 같아야 합니다.
+// [패킷 ID] 서버의 PacketId enum 과 같은 스키마에서 만든다.
 public enum PacketId : ushort
 {
-    // [로그인/계정]
-    REGISTER_REQ = 1,
-    REGISTER_RES = 2,
-    LOGIN_REQ = 3,
-    LOGIN_RES = 4,
+    // [로그인/계정 관련]
+    REGISTER_REQ = 1,   // 회원가입 요청
+    REGISTER_RES = 2,   // 회원가입 결과
+    LOGIN_REQ = 3,      // 로그인 요청
+    LOGIN_RES = 4,      // 로그인 결과
 
-    // [인게임/로비]
-    ENTER_ROOM = 5,
-    LEAVE_ROOM = 6,
+    // [인게임/로비 관련]
+    ENTER_ROOM = 5,     // 방 입장 요청 (로그인 성공 후)
+    LEAVE_ROOM = 6,     // 방 퇴장
 
-    // [플레이]
+    // [게임 플레이]
     CHAT = 7,
     MOVE = 8,
+    // 방 상태. 클라이언트가 마지막으로 SNAPSHOT_ACK 한 틱(baseTick)에서 바뀐 플레이어만 담는다.
+    // entries 형식과 양자화는 server/SnapshotCodec.h 참고 (baseTick 0 이면 전체 스냅샷).
     SNAPSHOT = 9,
 
     ROOM_LIST_REQ = 10,
@@ -25,6 +29,35 @@ public enum PacketId : ushort
 
     CREATE_ROOM_REQ = 12,
     CREATE_ROOM_RES = 13,
+
+    LOGOUT_REQ = 14,
+
+    // [귓속말] 방과 상관없이 접속 중인 유저 한 명에게
+    WHISPER_REQ = 15,   // 보내기 (대상 이름 + 메시지)
+    WHISPER = 16,       // 받기 (보낸 사람 이름 + 메시지)
+    WHISPER_RES = 17,   // 보낸 사람에게 전달 결과
+
+    // [연결 유지] 클라이언트가 주기적으로 보내면 서버가 같은 내용을 그대로 돌려준다.
+    // 유휴 시간 제한(SessionTimeoutConfig::idleTimeoutMs)보다 짧은 주기로 보내야 끊기지 않는다.
+    HEARTBEAT_REQ = 18,
+    HEARTBEAT_RES = 19,
+
+    // [스냅샷 확인] 적용한 SNAPSHOT 의 tick (스냅샷 번호) 을 돌려준다. 서버는 다음 스냅샷을 이 번호 기준 델타로 만든다.
+    // 기준 틱을 갖고 있지 않아 델타를 풀 수 없으면 tick 0 을 보내 전체 스냅샷을 다시 받는다.
+    SNAPSHOT_ACK = 20,
+}
+
+// 스키마로 만든 패킷이 공통으로 구현한다
+public interface IPacketElement
+{
+    int GetSize();
+    void Write(ref PacketWriter writer);
+    bool Read(ref PacketReader reader);
+}
+
+public interface IPacket : IPacketElement
+{
+    PacketId Id { get; }
 }
 
 // [헤더]
@@ -35,113 +68,710 @@ public struct GameHeader
     public ushort packetId;
 }
 
-// --------------------------------------------------
-// [1] 계정 관련 패킷
-// --------------------------------------------------
+public static class PacketCodec
+{
+    public const int HeaderSize = 4;
+
+    // 헤더를 포함한 패킷 하나를 실제 크기만큼 만든다
+    public static byte[] Serialize<T>(T packet) where T : struct, IPacket
+    {
+        byte[] buffer = new byte[HeaderSize + packet.GetSize()];
+        Serialize(packet, buffer, 0);
+        return buffer;
+    }
+
+    // 미리 잡아 둔 버퍼에 쓴다. 쓴 바이트 수 (헤더 포함)를 돌려준다.
+    public static int Serialize<T>(T packet, byte[] buffer, int offset) where T : struct, IPacket
+    {
+        int size = HeaderSize + packet.GetSize();
+        PacketWriter writer = new PacketWriter(buffer, offset);
+        writer.Write((ushort)size);
+        writer.Write((ushort)packet.Id);
+        packet.Write(ref writer);
+        return size;
+    }
+
+    // 헤더를 뺀 본문에서 읽는다. 잘렸거나 길이가 맞지 않으면 false.
+    public static bool TryDeserialize<T>(byte[] body, int offset, int count, out T packet) where T : struct, IPacket
+    {
+        packet = default(T);
+        PacketReader reader = new PacketReader(body, offset, count);
+        return packet.Read(ref reader);
+    }
+
+    public static bool TryDeserialize<T>(byte[] body, out T packet) where T : struct, IPacket
+    {
+        return TryDeserialize(body, 0, body.Length, out packet);
+    }
+}
+
+// 리틀 엔디언, 정렬 없음
+public struct PacketWriter
+{
+    private readonly byte[] _buffer;
+    private int _position;
+
+    public PacketWriter(byte[] buffer, int offset)
+    {
+        _buffer = buffer;
+        _position = offset;
+    }
+
+    public int Position { get { return _position; } }
+
+    public void Write(bool value) { _buffer[_position++] = (byte)(value ? 1 : 0); }
+    public void Write(byte value) { _buffer[_position++] = value; }
+
+    public void Write(ushort value)
+    {
+        _buffer[_position++] = (byte)value;
+        _buffer[_position++] = (byte)(value >> 8);
+    }
+
+    public void Write(uint value)
+    {
+        _buffer[_position++] = (byte)value;
+        _buffer[_position++] = (byte)(value >> 8);
+        _buffer[_position++] = (byte)(value >> 16);
+        _buffer[_position++] = (byte)(value >> 24);
+    }
+
+    public void Write(int value) { Write((uint)value); }
+    public void Write(float value) { Write((uint)BitConverter.SingleToInt32Bits(value)); }
+
+    public void WriteString(string value, int maxLength)
+    {
+        int length = StringSize(value, maxLength) - 2;
+        Write((ushort)length);
+        if (length > 0)
+        {
+            byte[] bytes = Encoding.UTF8.GetBytes(value);
+            Array.Copy(bytes, 0, _buffer, _position, length);
+            _position += length;
+        }
+    }
+
+    public void WriteBytes(ArraySegment<byte> value, int maxLength)
+    {
+        int length = Math.Min(value.Count, maxLength);
+        Write((ushort)length);
+        if (length > 0 && value.Array != null)
+        {
+            Array.Copy(value.Array, value.Offset, _buffer, _position, length);
+            _position += length;
+        }
+    }
+
+    public void WriteArray<T>(T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        if (items == null)
+        {
+            Write((ushort)0);
+            return;
+        }
+
+        int count = Math.Min(items.Length, maxCount);
+        Write((ushort)count);
+        for (int i = 0; i < count; i++)
+            items[i].Write(ref this);
+    }
+
+    // u16 길이 + UTF-8. 최대 길이를 넘으면 글자 중간이 아닌 곳에서 자른다.
+    public static int StringSize(string value, int maxLength)
+    {
+        if (string.IsNullOrEmpty(value)) return 2;
+
+        int length = Encoding.UTF8.GetByteCount(value);
+        if (length <= maxLength) return 2 + length;
+
+        byte[] bytes = Encoding.UTF8.GetBytes(value);
+        length = maxLength;
+        while (length > 0 && (bytes[length] & 0xC0) == 0x80) length--;
+        return 2 + length;
+    }
+
+    public static int BytesSize(ArraySegment<byte> value, int maxLength)
+    {
+        return 2 + Math.Min(value.Count, maxLength);
+    }
+
+    public static int ArraySize<T>(T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        if (items == null) return 2;
+
+        int size = 2;
+        int count = Math.Min(items.Length, maxCount);
+        for (int i = 0; i < count; i++)
+            size += items[i].GetSize();
+        return size;
+    }
+}
+
+public struct PacketReader
+{
+    private readonly byte[] _buffer;
+    private int _position;
+    private readonly int _end;
+
+    public PacketReader(byte[] buffer, int offset, int count)
+    {
+        _buffer = buffer;
+        _position = offset;
+        _end = offset + count;
+    }
+
+    public int Remaining { get { return _end - _position; } }
+
+    public bool Read(out bool value)
+    {
+        value = false;
+        if (Remaining < 1) return false;
+        value = _buffer[_position++] != 0;
+        return true;
+    }
+
+    public bool Read(out byte value)
+    {
+        value = 0;
+        if (Remaining < 1) return false;
+        value = _buffer[_position++];
+        return true;
+    }
+
+    public bool Read(out ushort value)
+    {
+        value = 0;
+        if (Remaining < 2) return false;
+        value = (ushort)(_buffer[_position] | (_buffer[_position + 1] << 8));
+        _position += 2;
+        return true;
+    }
+
+    public bool Read(out uint value)
+    {
+        value = 0;
+        if (Remaining < 4) return false;
+        value = (uint)(_buffer[_position] | (_buffer[_position + 1] << 8) | (_buffer[_position + 2] << 16) | (_buffer[_position + 3] << 24));
+        _position += 4;
+        return true;
+    }
+
+    public bool Read(out int value)
+    {
+        bool ok = Read(out uint bits);
+        value = (int)bits;
+        return ok;
+    }
+
+    public bool Read(out float value)
+    {
+        bool ok = Read(out uint bits);
+        value = BitConverter.Int32BitsToSingle((int)bits);
+        return ok;
+    }
+
+    public bool ReadString(out string value, int maxLength)
+    {
+        value = string.Empty;
+        if (!Read(out ushort length) || length > maxLength || Remaining < length) return false;
+        value = Encoding.UTF8.GetString(_buffer, _position, length);
+        _position += length;
+        return true;
+    }
+
+    // 문자열을 만들지 않고 버퍼 안의 위치만 돌려준다 (부하 클라이언트처럼 할당을 피할 때)
+    public bool ReadStringRange(out int offset, out int length, int maxLength)
+    {
+        offset = _position;
+        length = 0;
+        if (!Read(out ushort size) || size > maxLength || Remaining < size) return false;
+        offset = _position;
+        length = size;
+        _position += size;
+        return true;
+    }
+
+    // 복사하지 않고 받은 버퍼의 범위를 돌려준다 (버퍼를 다시 쓰기 전까지만 유효)
+    public bool ReadBytes(out ArraySegment<byte> value, int maxLength)
+    {
+        value = default(ArraySegment<byte>);
+        if (!Read(out ushort length) || length > maxLength || Remaining < length) return false;
+        value = new ArraySegment<byte>(_buffer, _position, length);
+        _position += length;
+        return true;
+    }
+
+    public bool ReadArray<T>(out T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        items = Array.Empty<T>();
+        if (!Read(out ushort count) || count > maxCount) return false;
+
+        items = new T[count];
+        for (int i = 0; i < count; i++)
+        {
+            if (!items[i].Read(ref this)) return false;
+        }
+        return true;
+    }
+}
+
+public struct RoomInfo : IPacketElement
+{
+    public const int MaxSize = 41;
+
+    public int roomId;
+    public int userCount;
+    public string title;   // 최대 31 바이트
+
+    public int GetSize() { return 8 + PacketWriter.StringSize(title, 31); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(roomId);
+        writer.Write(userCount);
+        writer.WriteString(title, 31);
+    }
 
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out roomId)
+            && reader.Read(out userCount)
+            && reader.ReadString(out title, 31);
+    }
+}
+
+// [로그인/계정 관련]
 // 회원가입 요청
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketRegisterReq
+public struct PacketRegisterReq : IPacket
 {
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] username;
+    public const int MaxSize = 102;
+    public PacketId Id { get { return PacketId.REGISTER_REQ; } }
 
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] password;
+    public string username;   // 최대 49 바이트
+    public string password;   // 최대 49 바이트
+
+    public int GetSize() { return PacketWriter.StringSize(username, 49) + PacketWriter.StringSize(password, 49); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(username, 49);
+        writer.WriteString(password, 49);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out username, 49)
+            && reader.ReadString(out password, 49);
+    }
 }
 
-// 회원가입 응답
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketRegisterRes
+// 회원가입 결과
+public struct PacketRegisterRes : IPacket
 {
-    [MarshalAs(UnmanagedType.I1)] // C++ bool (1byte) 대응
+    public const int MaxSize = 1;
+    public PacketId Id { get { return PacketId.REGISTER_RES; } }
+
     public bool success;
+
+    public int GetSize() { return 1; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success);
+    }
 }
 
 // 로그인 요청
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketLoginReq
+public struct PacketLoginReq : IPacket
 {
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] username;
+    public const int MaxSize = 102;
+    public PacketId Id { get { return PacketId.LOGIN_REQ; } }
+
+    public string username;   // 최대 49 바이트
+    public string password;   // 최대 49 바이트
+
+    public int GetSize() { return PacketWriter.StringSize(username, 49) + PacketWriter.StringSize(password, 49); }
 
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 50)]
-    public byte[] password;
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(username, 49);
+        writer.WriteString(password, 49);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out username, 49)
+            && reader.ReadString(out password, 49);
+    }
 }
 
-// 로그인 응답
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketLoginRes
+// 로그인 결과
+public struct PacketLoginRes : IPacket
 {
-    [MarshalAs(UnmanagedType.I1)]
+    public const int MaxSize = 5;
+    public PacketId Id { get { return PacketId.LOGIN_RES; } }
+
     public bool success;
     public uint playerId;
-}
 
-// --------------------------------------------------
-// [2] 룸 입장/퇴장
-// --------------------------------------------------
+    public int GetSize() { return 5; }
 
-// 방 입장 요청
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketEnterRoom
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+        writer.Write(playerId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success)
+            && reader.Read(out playerId);
+    }
+}
+
+// [인게임/로비 관련]
+// 방 입장 요청 (로그인 성공 후)
+public struct PacketEnterRoom : IPacket
 {
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.ENTER_ROOM; } }
+
     public int roomId;
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(roomId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out roomId);
+    }
 }
 
-// 방 퇴장 알림
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketLeaveRoom
+// 방 퇴장
+public struct PacketLeaveRoom : IPacket
 {
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.LEAVE_ROOM; } }
+
     public uint playerId;
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(playerId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out playerId);
+    }
 }
 
-// --------------------------------------------------
-// [3] 인게임 플레이
-// --------------------------------------------------
+// [게임 플레이]
+public struct PacketChat : IPacket
+{
+    public const int MaxSize = 261;
+    public PacketId Id { get { return PacketId.CHAT; } }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketMove
+    public uint playerId;
+    public string msg;   // 최대 255 바이트
+
+    public int GetSize() { return 4 + PacketWriter.StringSize(msg, 255); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(playerId);
+        writer.WriteString(msg, 255);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out playerId)
+            && reader.ReadString(out msg, 255);
+    }
+}
+
+public struct PacketMove : IPacket
 {
+    public const int MaxSize = 8;
+    public PacketId Id { get { return PacketId.MOVE; } }
+
     public float vx;
     public float vy;
+
+    public int GetSize() { return 8; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(vx);
+        writer.Write(vy);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out vx)
+            && reader.Read(out vy);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketChat
+// 방 상태. 클라이언트가 마지막으로 SNAPSHOT_ACK 한 틱(baseTick)에서 바뀐 플레이어만 담는다.
+// entries 형식과 양자화는 server/SnapshotCodec.h 참고 (baseTick 0 이면 전체 스냅샷).
+public struct PacketSnapshot : IPacket
 {
-    public uint playerId;
+    public const int MaxSize = 65010;
+    public PacketId Id { get { return PacketId.SNAPSHOT; } }
+
+    public uint tick;                    // 스냅샷 번호 (세션마다 1 부터 하나씩 늘어난다. 방을 옮겨도 이어진다)
+    public uint baseTick;                // 기준 틱. 0: 전체 (입장 직후, 기준을 잃었을 때)
+    public ArraySegment<byte> entries;   // 최대 65000 바이트
+
+    public int GetSize() { return 8 + PacketWriter.BytesSize(entries, 65000); }
 
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 256)]
-    public byte[] msg;
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(tick);
+        writer.Write(baseTick);
+        writer.WriteBytes(entries, 65000);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out tick)
+            && reader.Read(out baseTick)
+            && reader.ReadBytes(out entries, 65000);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct RoomInfo
+public struct PacketRoomListReq : IPacket
 {
-    public int roomId;
-    public int userCount;
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)]
-    public byte[] title;
+    public const int MaxSize = 0;
+    public PacketId Id { get { return PacketId.ROOM_LIST_REQ; } }
+
+    public int GetSize() { return 0; }
+
+    public void Write(ref PacketWriter writer) { }
+
+    public bool Read(ref PacketReader reader) { return true; }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketRoomListRes
+public struct PacketRoomListRes : IPacket
 {
-    public int count;
+    public const int MaxSize = 41986;
+    public PacketId Id { get { return PacketId.ROOM_LIST_RES; } }
+
+    public RoomInfo[] rooms;   // 최대 1024 개
+
+    public int GetSize() { return PacketWriter.ArraySize(rooms, 1024); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteArray(rooms, 1024);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadArray(out rooms, 1024);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketCreateRoomReq
+public struct PacketCreateRoomReq : IPacket
 {
-    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 32)]
-    public byte[] title;
+    public const int MaxSize = 33;
+    public PacketId Id { get { return PacketId.CREATE_ROOM_REQ; } }
+
+    public string title;   // 최대 31 바이트
+
+    public int GetSize() { return PacketWriter.StringSize(title, 31); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(title, 31);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out title, 31);
+    }
 }
 
-[StructLayout(LayoutKind.Sequential, Pack = 1)]
-public struct PacketCreateRoomRes
+public struct PacketCreateRoomRes : IPacket
 {
-    [MarshalAs(UnmanagedType.I1)]
+    public const int MaxSize = 5;
+    public PacketId Id { get { return PacketId.CREATE_ROOM_RES; } }
+
     public bool success;
     public int roomId;
-}
\ No newline at end of file
+
+    public int GetSize() { return 5; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+        writer.Write(roomId);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success)
+            && reader.Read(out roomId);
+    }
+}
+
+public struct PacketLogoutReq : IPacket
+{
+    public const int MaxSize = 0;
+    public PacketId Id { get { return PacketId.LOGOUT_REQ; } }
+
+    public int GetSize() { return 0; }
+
+    public void Write(ref PacketWriter writer) { }
+
+    public bool Read(ref PacketReader reader) { return true; }
+}
+
+// [귓속말] 방과 상관없이 접속 중인 유저 한 명에게
+// 보내기 (대상 이름 + 메시지)
+public struct PacketWhisperReq : IPacket
+{
+    public const int MaxSize = 308;
+    public PacketId Id { get { return PacketId.WHISPER_REQ; } }
+
+    public string target;   // 최대 49 바이트
+    public string msg;      // 최대 255 바이트
+
+    public int GetSize() { return PacketWriter.StringSize(target, 49) + PacketWriter.StringSize(msg, 255); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(target, 49);
+        writer.WriteString(msg, 255);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out target, 49)
+            && reader.ReadString(out msg, 255);
+    }
+}
+
+// 받기 (보낸 사람 이름 + 메시지)
+public struct PacketWhisper : IPacket
+{
+    public const int MaxSize = 308;
+    public PacketId Id { get { return PacketId.WHISPER; } }
+
+    public string sender;   // 최대 49 바이트
+    public string msg;      // 최대 255 바이트
+
+    public int GetSize() { return PacketWriter.StringSize(sender, 49) + PacketWriter.StringSize(msg, 255); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.WriteString(sender, 49);
+        writer.WriteString(msg, 255);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.ReadString(out sender, 49)
+            && reader.ReadString(out msg, 255);
+    }
+}
+
+// 보낸 사람에게 전달 결과
+public struct PacketWhisperRes : IPacket
+{
+    public const int MaxSize = 52;
+    public PacketId Id { get { return PacketId.WHISPER_RES; } }
+
+    public bool success;    // false: 대상이 접속 중이 아님
+    public string target;   // 최대 49 바이트
+
+    public int GetSize() { return 1 + PacketWriter.StringSize(target, 49); }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(success);
+        writer.WriteString(target, 49);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out success)
+            && reader.ReadString(out target, 49);
+    }
+}
+
+// [연결 유지] 클라이언트가 주기적으로 보내면 서버가 같은 내용을 그대로 돌려준다.
+// 유휴 시간 제한(SessionTimeoutConfig::idleTimeoutMs)보다 짧은 주기로 보내야 끊기지 않는다.
+public struct PacketHeartbeatReq : IPacket
+{
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.HEARTBEAT_REQ; } }
+
+    public uint clientTime;   // 클라이언트 시각 (ms). 서버는 해석하지 않고 돌려주므로 RTT 측정에 쓴다.
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(clientTime);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out clientTime);
+    }
+}
+
+public struct PacketHeartbeatRes : IPacket
+{
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.HEARTBEAT_RES; } }
+
+    public uint clientTime;   // 클라이언트 시각 (ms). 서버는 해석하지 않고 돌려주므로 RTT 측정에 쓴다.
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(clientTime);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out clientTime);
+    }
+}
+
+// [스냅샷 확인] 적용한 SNAPSHOT 의 tick (스냅샷 번호) 을 돌려준다. 서버는 다음 스냅샷을 이 번호 기준 델타로 만든다.
+// 기준 틱을 갖고 있지 않아 델타를 풀 수 없으면 tick 0 을 보내 전체 스냅샷을 다시 받는다.
+public struct PacketSnapshotAck : IPacket
+{
+    public const int MaxSize = 4;
+    public PacketId Id { get { return PacketId.SNAPSHOT_ACK; } }
+
+    public uint tick;
+
+    public int GetSize() { return 4; }
+
+    public void Write(ref PacketWriter writer)
+    {
+        writer.Write(tick);
+    }
+
+    public bool Read(ref PacketReader reader)
+    {
+        return reader.Read(out tick);
+    }
+}
@@ -9,10 +9,71 @@ namespace TestClient
     {
         static void Main(string[] args)
         {
-            Console.WriteLine("Starting Test Clients...");
-
             string serverIp = "127.0.0.1"; // 서버 IP
             int serverPort = 9190;         // 서버 포트
+
+            // 처리량 측정: test_client bench [clients] [seconds] [roomSize] [intervalMs]
+            if (args.Length > 0 && args[0] == "bench")
+            {
+                int benchClients = args.Length > 1 ? int.Parse(args[1]) : 1000;
+                int benchSeconds = args.Length > 2 ? int.Parse(args[2]) : 10;
+                int benchRoomSize = args.Length > 3 ? int.Parse(args[3]) : 10;
+                int benchInterval = args.Length > 4 ? int.Parse(args[4]) : 50;
+
+                new ChatBench(serverIp, serverPort, benchClients, benchSeconds, benchRoomSize, benchInterval)
+                    .RunAsync().GetAwaiter().GetResult();
+                return;
+            }
+
+            // 재접속 폭주: test_client storm [clients] [rounds]
+            if (args.Length > 0 && args[0] == "storm")
+            {
+                int stormClients = args.Length > 1 ? int.Parse(args[1]) : 2000;
+                int stormRounds = args.Length > 2 ? int.Parse(args[2]) : 3;
+
+                new ReconnectStorm(serverIp, serverPort, stormClients, stormRounds)
+                    .RunAsync().GetAwaiter().GetResult();
+                return;
+            }
+
+            // 접속/끊김 반복: test_client churn [steadyClients] [churners] [seconds] [roomSize]
+            if (args.Length > 0 && args[0] == "churn")
+            {
+                int steadyClients = args.Length > 1 ? int.Parse(args[1]) : 200;
+                int churners = args.Length > 2 ? int.Parse(args[2]) : 50;
+                int churnSeconds = args.Length > 3 ? int.Parse(args[3]) : 20;
+                int churnRoomSize = args.Length > 4 ? int.Parse(args[4]) : 10;
+
+                new ChurnStress(serverIp, serverPort, steadyClients, churners, churnSeconds, churnRoomSize)
+                    .RunAsync().GetAwaiter().GetResult();
+                return;
+            }
+
+            // 시간 제한 확인: test_client timeout [clientsPerGroup] [seconds]
+            if (args.Length > 0 && args[0] == "timeout")
+            {
+                int timeoutClients = args.Length > 1 ? int.Parse(args[1]) : 50;
+                int timeoutSeconds = args.Length > 2 ? int.Parse(args[2]) : 45;
+
+                new TimeoutCheck(serverIp, serverPort, timeoutClients, timeoutSeconds)
+                    .RunAsync().GetAwaiter().GetResult();
+                return;
+            }
+
+            // 느린 DB 확인 (서버: CHAT_DB_DELAY_MS=200): test_client dblatency [watchers] [loginers] [seconds]
+            if (args.Length > 0 && args[0] == "dblatency")
+            {
+                int watchers = args.Length > 1 ? int.Parse(args[1]) : 20;
+                int loginers = args.Length > 2 ? int.Parse(args[2]) : 20;
+                int dbSeconds = args.Length > 3 ? int.Parse(args[3]) : 10;
+
+                new DbLatencyCheck(serverIp, serverPort, watchers, loginers, dbSeconds)
+                    .RunAsync().GetAwaiter().GetResult();
+                return;
+            }
+
+            Console.WriteLine("Starting Test Clients...");
+
             int clientCount = 1;         // 접속시킬 클라이언트 수
 
             List<Task> clients = new List<Task>();
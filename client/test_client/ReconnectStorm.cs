@@ -0,0 +1,123 @@
+﻿using System;
+using System.Diagnostics;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace TestClient
+{
+    // ==================================================================================
+    // 재접속 폭주 측정
+    //  - 서버 재시작 직후처럼 clientCount 개가 한꺼번에 접속 -> 로그인
+    //  - 전원이 LOGIN_RES 를 받을 때까지 걸린 시간으로 connections/s 를 계산
+    //  - 라운드마다 전원 끊고 다시 반복
+    // ==================================================================================
+
+    public class ReconnectStorm
+    {
+        private const int HeaderSize = PacketCodec.HeaderSize;
+
+        private readonly string _ip;
+        private readonly int _port;
+        private readonly int _clientCount;
+        private readonly int _rounds;
+
+        public ReconnectStorm(string ip, int port, int clientCount, int rounds)
+        {
+            _ip = ip;
+            _port = port;
+            _clientCount = clientCount;
+            _rounds = rounds;
+        }
+
+        public async Task RunAsync()
+        {
+            Console.WriteLine($"[Storm] clients={_clientCount} rounds={_rounds}");
+
+            for (int round = 1; round <= _rounds; round++)
+            {
+                TcpClient[] clients = new TcpClient[_clientCount];
+                double[] latencies = new double[_clientCount];
+                int failed = 0;
+
+                Stopwatch sw = Stopwatch.StartNew();
+
+                Task[] tasks = new Task[_clientCount];
+                for (int i = 0; i < _clientCount; i++)
+                {
+                    int id = i;
+                    tasks[i] = Task.Run(async () =>
+                    {
+                        long start = sw.ElapsedTicks;
+                        clients[id] = new TcpClient { NoDelay = true };
+                        if (await ConnectAndLoginAsync(clients[id], id))
+                            latencies[id] = (sw.ElapsedTicks - start) * 1000.0 / Stopwatch.Frequency;
+                        else
+                        {
+                            latencies[id] = double.NaN;
+                            Interlocked.Increment(ref failed);
+                        }
+                    });
+                }
+
+                await Task.WhenAll(tasks);
+                double elapsed = sw.Elapsed.TotalSeconds;
+
+                double[] ok = Array.FindAll(latencies, l => !double.IsNaN(l));
+                Array.Sort(ok);
+
+                Console.WriteLine($"[Storm] round {round}: {ok.Length} logged in, {failed} failed, {elapsed:F2}s " +
+                                  $"=> {ok.Length / elapsed:F0} conn/s, " +
+                                  $"p50 {Percentile(ok, 0.50):F1}ms p99 {Percentile(ok, 0.99):F1}ms max {Percentile(ok, 1.0):F1}ms");
+
+                foreach (var client in clients)
+                    client?.Close();
+
+                // 서버가 세션을 정리할 시간 (같은 아이디로 다시 로그인하므로)
+                await Task.Delay(1000);
+            }
+        }
+
+        private async Task<bool> ConnectAndLoginAsync(TcpClient client, int id)
+        {
+            try
+            {
+                await client.ConnectAsync(_ip, _port);
+                NetworkStream stream = client.GetStream();
+
+                await ChurnStress.SendLoginAsync(stream, $"storm_{id}");
+
+                // LOGIN_RES 가 올 때까지 읽는다 (로그인 직후 다른 패킷은 오지 않는다)
+                byte[] buffer = new byte[256];
+                int filled = 0;
+                using var timeout = new CancellationTokenSource(10000);
+                while (true)
+                {
+                    int read = await stream.ReadAsync(buffer, filled, buffer.Length - filled, timeout.Token);
+                    if (read == 0) return false;
+                    filled += read;
+
+                    if (filled < HeaderSize) continue;
+                    ushort size = BitConverter.ToUInt16(buffer, 0);
+                    ushort packetId = BitConverter.ToUInt16(buffer, 2);
+                    if (filled < size) continue;
+
+                    return packetId == (ushort)PacketId.LOGIN_RES
+                        && PacketCodec.TryDeserialize(buffer, HeaderSize, size - HeaderSize, out PacketLoginRes res)
+                        && res.success;
+                }
+            }
+            catch (Exception)
+            {
+                return false;
+            }
+        }
+
+        internal static double Percentile(double[] sorted, double p)
+        {
+            if (sorted.Length == 0) return 0;
+            int index = (int)Math.Ceiling(p * sorted.Length) - 1;
+            return sorted[Math.Clamp(index, 0, sorted.Length - 1)];
+        }
+    }
+}
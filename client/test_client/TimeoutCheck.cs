@@ -0,0 +1,180 @@
+﻿using System;
+using System.Diagnostics;
+using System.Net.Sockets;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace TestClient
+{
+    // ==================================================================================
+    // 세션 시간 제한 확인 (서버 기본값: 로그인 10초, 무수신 30초)
+    //  - silent   : 접속만 하고 아무것도 보내지 않는다 -> 로그인 마감에 끊겨야 한다
+    //  - idle     : 로그인한 뒤 아무것도 보내지 않는다 -> 유휴 제한에 끊겨야 한다
+    //  - heartbeat: 로그인한 뒤 하트비트만 보낸다 -> 끝까지 살아 있어야 한다 (RTT 도 잰다)
+    // 서버가 끊은 시점은 접속 시각부터 잰다.
+    // ==================================================================================
+
+    public class TimeoutCheck
+    {
+        private const int HeaderSize = PacketCodec.HeaderSize;
+        private const int HeartbeatIntervalMs = 5000;
+
+        private readonly string _ip;
+        private readonly int _port;
+        private readonly int _clientsPerGroup;
+        private readonly int _seconds;
+
+        private readonly Group[] _groups = { new Group("silent"), new Group("idle"), new Group("heartbeat") };
+        private long _heartbeatReplies;
+        private long _rttTotalMs;
+        private volatile bool _running = true;
+
+        private class Group
+        {
+            public readonly string Name;
+            public int Connected;
+            public int Closed;
+            public long ClosedAfterMsTotal;
+            public long ClosedAfterMsMin = long.MaxValue;
+            public long ClosedAfterMsMax;
+
+            public Group(string name) { Name = name; }
+        }
+
+        public TimeoutCheck(string ip, int port, int clientsPerGroup, int seconds)
+        {
+            _ip = ip;
+            _port = port;
+            _clientsPerGroup = clientsPerGroup;
+            _seconds = seconds;
+        }
+
+        public async Task RunAsync()
+        {
+            Console.WriteLine($"[Timeout] clients/group={_clientsPerGroup} seconds={_seconds}");
+
+            Task[] tasks = new Task[_clientsPerGroup * _groups.Length];
+            for (int i = 0; i < tasks.Length; i++)
+            {
+                int id = i;
+                tasks[i] = Task.Run(() => RunClientAsync(id, _groups[id % _groups.Length]));
+            }
+
+            await Task.Delay(_seconds * 1000);
+            _running = false;
+
+            Console.WriteLine("[Timeout] ---------------- result ----------------");
+            foreach (Group group in _groups)
+            {
+                string closedAfter = group.Closed > 0
+                    ? $", closed after avg {group.ClosedAfterMsTotal / group.Closed} ms (min {group.ClosedAfterMsMin}, max {group.ClosedAfterMsMax})"
+                    : "";
+                Console.WriteLine($"[Timeout] {group.Name,-9}: connected {group.Connected}, closed by server {group.Closed}{closedAfter}");
+            }
+
+            long replies = Interlocked.Read(ref _heartbeatReplies);
+            Console.WriteLine($"[Timeout] heartbeat replies {replies}, avg rtt {(replies > 0 ? Interlocked.Read(ref _rttTotalMs) / (double)replies : 0):F2} ms");
+
+            await Task.WhenAny(Task.WhenAll(tasks), Task.Delay(2000));
+        }
+
+        private async Task RunClientAsync(int id, Group group)
+        {
+            TcpClient client = new TcpClient { NoDelay = true };
+            Stopwatch sw = Stopwatch.StartNew();
+            try
+            {
+                await client.ConnectAsync(_ip, _port);
+                NetworkStream stream = client.GetStream();
+                Interlocked.Increment(ref group.Connected);
+
+                if (group != _groups[0])
+                {
+                    await ChurnStress.SendLoginAsync(stream, $"timeout_{id}");
+                    if (!await ChurnStress.ReadLoginResAsync(stream)) return;
+                }
+
+                Task<bool> closed = WaitForCloseAsync(stream);
+
+                if (group == _groups[2])
+                {
+                    while (_running && !closed.IsCompleted)
+                    {
+                        byte[] heartbeat = PacketCodec.Serialize(new PacketHeartbeatReq { clientTime = (uint)Environment.TickCount });
+                        await stream.WriteAsync(heartbeat, 0, heartbeat.Length);
+                        await Task.WhenAny(closed, Task.Delay(HeartbeatIntervalMs));
+                    }
+                }
+
+                await Task.WhenAny(closed, WaitUntilStoppedAsync());
+                if (closed.IsCompleted && closed.Result)
+                    RecordClose(group, sw.ElapsedMilliseconds);
+            }
+            catch (Exception)
+            {
+                if (_running) RecordClose(group, sw.ElapsedMilliseconds);
+            }
+            finally
+            {
+                client.Close();
+            }
+        }
+
+        // 서버가 끊으면 true. 오는 하트비트 응답은 RTT 로 센다.
+        private async Task<bool> WaitForCloseAsync(NetworkStream stream)
+        {
+            byte[] buffer = new byte[4096];
+            int filled = 0;
+
+            try
+            {
+                while (true)
+                {
+                    int read = await stream.ReadAsync(buffer, filled, buffer.Length - filled);
+                    if (read == 0) return _running;
+                    filled += read;
+
+                    int offset = 0;
+                    while (filled - offset >= HeaderSize)
+                    {
+                        ushort size = BitConverter.ToUInt16(buffer, offset);
+                        ushort packetId = BitConverter.ToUInt16(buffer, offset + 2);
+                        if (size < HeaderSize || filled - offset < size) break;
+
+                        if (packetId == (ushort)PacketId.HEARTBEAT_RES
+                            && PacketCodec.TryDeserialize(buffer, offset + HeaderSize, size - HeaderSize, out PacketHeartbeatRes res))
+                        {
+                            Interlocked.Add(ref _rttTotalMs, (uint)Environment.TickCount - res.clientTime);
+                            Interlocked.Increment(ref _heartbeatReplies);
+                        }
+
+                        offset += size;
+                    }
+
+                    Buffer.BlockCopy(buffer, offset, buffer, 0, filled - offset);
+                    filled -= offset;
+                }
+            }
+            catch (Exception)
+            {
+                return _running;
+            }
+        }
+
+        private async Task WaitUntilStoppedAsync()
+        {
+            while (_running) await Task.Delay(100);
+        }
+
+        private static void RecordClose(Group group, long elapsedMs)
+        {
+            lock (group)
+            {
+                group.Closed++;
+                group.ClosedAfterMsTotal += elapsedMs;
+                group.ClosedAfterMsMin = Math.Min(group.ClosedAfterMsMin, elapsedMs);
+                group.ClosedAfterMsMax = Math.Max(group.ClosedAfterMsMax, elapsedMs);
+            }
+        }
+    }
+}
@@ -0,0 +1,796 @@
+#!/usr/bin/env python3
+# packets.schema 를 읽어 서버/클라이언트 패킷 코덱을 만든다.
+#
+#   python protocol/gen_protocol.py
+#
+# 만드는 파일
+#   server/NetProtocol.h                         (CP949, 서버 소스와 같은 인코딩)
+#   client/test_client/PacketDefine.cs           (UTF-8 BOM)
+#   client/iocp_chatting_server_practice*/Assets/Script/PacketDefine.cs (CP949, Unity)
+#
+# 표준 라이브러리만 쓴다.
+
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SCHEMA = os.path.join(ROOT, 'protocol', 'packets.schema')
+
+CPP_OUTPUT = ('server/NetProtocol.h', 'cp949')
+CS_OUTPUTS = [
+    ('client/test_client/PacketDefine.cs', 'utf-8-sig'),
+    ('client/iocp_chatting_server_practice/Assets/Script/PacketDefine.cs', 'cp949'),
+    ('client/iocp_chatting_server_practice_clone_0/Assets/Script/PacketDefine.cs', 'cp949'),
+]
+
+MAX_PACKET_SIZE = 0xFFFF
+HEADER_SIZE = 4
+
+# 스키마 타입 -> (바이트 수, C++ 타입, C# 타입)
+SCALARS = {
+    'bool': (1, 'bool', 'bool'),
+    'u8': (1, 'uint8_t', 'byte'),
+    'u16': (2, 'uint16_t', 'ushort'),
+    'u32': (4, 'uint32_t', 'uint'),
+    'i32': (4, 'int32_t', 'int'),
+    'f32': (4, 'float', 'float'),
+}
+
+
+class SchemaError(Exception):
+    pass
+
+
+class Field:
+    def __init__(self, kind, name, type_name=None, limit=0, comment=''):
+        self.kind = kind            # 'scalar' | 'string' | 'bytes' | 'array'
+        self.name = name
+        self.type_name = type_name  # scalar: 스키마 타입, array: 원소 struct 이름
+        self.limit = limit          # string/bytes: 최대 바이트, array: 최대 개수
+        self.comment = comment
+
+
+class Decl:
+    def __init__(self, kind, name, comments, line):
+        self.kind = kind            # 'packet' | 'message' | 'struct'
+        self.name = name
+        self.comments = comments    # 앞에 붙은 주석 줄
+        self.trailing = ''
+        self.gap = False            # 스키마에서 앞에 빈 줄이 있었다 (enum 묶음 구분)
+        self.line = line
+        self.packet_id = None
+        self.base = None            # packet NAME = id : Message
+        self.fields = None
+
+
+def split_comment(line):
+    pos = line.find('//')
+    if pos < 0:
+        return line.strip(), ''
+    return line[:pos].strip(), line[pos + 2:].strip()
+
+
+FIELD_RE = re.compile(r'^(\w+)(?:\((\d+)\)|\[(\d+)\])?\s+(\w+)\s*;$')
+PACKET_RE = re.compile(r'^packet\s+([A-Z][A-Z0-9_]*)\s*=\s*(\d+)(?:\s*:\s*(\w+))?$')
+TYPE_RE = re.compile(r'^(message|struct)\s+([A-Z]\w*)$')
+
+
+def parse(text):
+    decls = []
+    pending = []
+    current = None      # 필드 블록을 기다리거나 읽는 중인 선언
+    in_block = False
+    blank_before = False
+
+    for number, raw in enumerate(text.splitlines(), 1):
+        stripped = raw.strip()
+        if not stripped:
+            pending = []
+            blank_before = True
+            continue
+
+        code, comment = split_comment(stripped)
+        if not code:
+            pending.append(comment)
+            continue
+
+        gap = blank_before
+        blank_before = False
+
+        def fail(message):
+            raise SchemaError('%s:%d: %s' % (SCHEMA, number, message))
+
+        if in_block:
+            if code == '}':
+                in_block = False
+                current = None
+                continue
+            m = FIELD_RE.match(code)
+            if not m:
+                fail('bad field "%s"' % code)
+            type_name, str_limit, arr_limit, name = m.groups()
+            if type_name in ('string', 'bytes'):
+                if str_limit is None:
+                    fail('%s needs a max length: %s(N)' % (type_name, type_name))
+                field = Field(type_name, name, limit=int(str_limit), comment=comment)
+            elif arr_limit is not None:
+                field = Field('array', name, type_name, int(arr_limit), comment)
+            elif type_name in SCALARS and str_limit is None:
+                field = Field('scalar', name, type_name, comment=comment)
+            else:
+                fail('unknown type "%s"' % type_name)
+            if any(f.name == name for f in current.fields):
+                fail('duplicate field "%s"' % name)
+            current.fields.append(field)
+            pending = []
+            continue
+
+        if code == '{':
+            if current is None or current.fields is not None or current.base is not None:
+                fail('unexpected "{"')
+            current.fields = []
+            in_block = True
+            continue
+
+        m = PACKET_RE.match(code)
+        if m:
+            decl = Decl('packet', m.group(1), pending, number)
+            decl.packet_id = int(m.group(2))
+            decl.base = m.group(3)
+        else:
+            m = TYPE_RE.match(code)
+            if not m:
+                fail('cannot parse "%s"' % code)
+            decl = Decl(m.group(1), m.group(2), pending, number)
+
+        decl.trailing = comment
+        decl.gap = gap
+        decls.append(decl)
+        current = decl
+        pending = []
+
+    if in_block:
+        raise SchemaError('%s: unterminated "{"' % SCHEMA)
+    return decls
+
+
+def camel(name):
+    return ''.join(part.capitalize() for part in name.lower().split('_'))
+
+
+class Schema:
+    def __init__(self, decls):
+        self.packets = [d for d in decls if d.kind == 'packet']
+        self.messages = {d.name: d for d in decls if d.kind == 'message'}
+        self.structs = [d for d in decls if d.kind == 'struct']
+        self.struct_map = {d.name: d for d in self.structs}
+
+        ids = {}
+        for packet in self.packets:
+            if packet.packet_id in ids:
+                raise SchemaError('packet id %d used by %s and %s' % (packet.packet_id, ids[packet.packet_id], packet.name))
+            ids[packet.packet_id] = packet.name
+
+            if packet.base is not None:
+                message = self.messages.get(packet.base)
+                if message is None:
+                    raise SchemaError('%s: unknown message "%s"' % (packet.name, packet.base))
+                packet.fields = message.fields
+            elif packet.fields is None:
+                packet.fields = []
+            packet.type_name = 'Packet' + camel(packet.name)
+
+        for struct in self.structs:
+            struct.type_name = struct.name
+            if struct.fields is None:
+                struct.fields = []
+
+        for decl in self.structs + self.packets:
+            for field in decl.fields:
+                if field.kind == 'array' and field.type_name not in self.struct_map:
+                    raise SchemaError('%s.%s: unknown struct "%s"' % (decl.name, field.name, field.type_name))
+
+        for packet in self.packets:
+            size = self.max_size(packet)
+            if size + HEADER_SIZE > MAX_PACKET_SIZE:
+                raise SchemaError('%s: max size %d does not fit a u16 packet size' % (packet.name, size + HEADER_SIZE))
+
+    def field_max(self, field):
+        if field.kind == 'scalar':
+            return SCALARS[field.type_name][0]
+        if field.kind in ('string', 'bytes'):
+            return 2 + field.limit
+        return 2 + field.limit * self.max_size(self.struct_map[field.type_name])
+
+    def max_size(self, decl):
+        return sum(self.field_max(f) for f in decl.fields)
+
+    # 문자열/배열이 모두 비어 있을 때의 크기 (이보다 짧은 본문은 읽어 볼 필요도 없다)
+    def min_size(self, decl):
+        return sum(SCALARS[f.type_name][0] if f.kind == 'scalar' else 2 for f in decl.fields)
+
+    # 문자열/배열이 없으면 크기가 고정이다 (0: 가변)
+    def fixed_size(self, decl):
+        if any(f.kind != 'scalar' for f in decl.fields):
+            return 0
+        return sum(SCALARS[f.type_name][0] for f in decl.fields)
+
+
+def field_comment(field):
+    parts = []
+    if field.kind in ('string', 'bytes'):
+        parts.append('최대 %d 바이트' % field.limit)
+    elif field.kind == 'array':
+        parts.append('최대 %d 개' % field.limit)
+    if field.comment:
+        parts.append(field.comment)
+    return ', '.join(parts)
+
+
+def align_comments(lines):
+    # (코드, 주석) 목록의 주석 열을 맞춘다
+    width = max((len(code) for code, comment in lines if comment), default=0)
+    out = []
+    for code, comment in lines:
+        if comment:
+            out.append('%s   // %s' % (code.ljust(width), comment))
+        else:
+            out.append(code)
+    return out
+
+
+# ---------------------------------------------------------------------------
+# C++
+# ---------------------------------------------------------------------------
+
+def cpp_field_type(field):
+    if field.kind == 'scalar':
+        return SCALARS[field.type_name][1]
+    if field.kind in ('string', 'bytes'):
+        return 'std::string_view'
+    return 'PacketArray<%s>' % field.type_name
+
+
+def cpp_struct(schema, decl, out):
+    for comment in decl.comments:
+        out.append('// ' + comment)
+    if decl.trailing:
+        out.append('// ' + decl.trailing)
+    out.append('struct %s' % decl.type_name)
+    out.append('{')
+
+    if decl.kind == 'packet':
+        out.append('    static constexpr PacketId ID = PacketId::%s;' % decl.name)
+    out.append('    static constexpr size_t FIXED_SIZE = %d;' % schema.fixed_size(decl))
+    out.append('    static constexpr size_t MIN_SIZE = %d;' % schema.min_size(decl))
+    out.append('    static constexpr size_t MAX_SIZE = %d;' % schema.max_size(decl))
+
+    if decl.fields:
+        out.append('')
+        rows = []
+        for field in decl.fields:
+            init = ''
+            if field.kind == 'scalar':
+                init = ' = false' if field.type_name == 'bool' else ' = 0'
+            rows.append(('    %s %s%s;' % (cpp_field_type(field), field.name, init), field_comment(field)))
+        out.extend(align_comments(rows))
+
+    reads = []
+    writes = []
+    fixed = 0
+    sizes = []
+    for field in decl.fields:
+        if field.kind == 'scalar':
+            reads.append('reader.Read(%s)' % field.name)
+            writes.append('writer.Write(%s);' % field.name)
+            fixed += SCALARS[field.type_name][0]
+        elif field.kind == 'string':
+            reads.append('reader.ReadString(%s, %d)' % (field.name, field.limit))
+            writes.append('writer.WriteString(%s, %d);' % (field.name, field.limit))
+            sizes.append('PacketStringSize(%s, %d)' % (field.name, field.limit))
+        elif field.kind == 'bytes':
+            reads.append('reader.ReadBytes(%s, %d)' % (field.name, field.limit))
+            writes.append('writer.WriteBytes(%s, %d);' % (field.name, field.limit))
+            sizes.append('PacketBytesSize(%s, %d)' % (field.name, field.limit))
+        else:
+            reads.append('reader.ReadArray(%s, %d)' % (field.name, field.limit))
+            writes.append('writer.WriteArray(%s, %d);' % (field.name, field.limit))
+            sizes.append('%s.GetSize(%d)' % (field.name, field.limit))
+    if fixed or not sizes:
+        sizes.insert(0, str(fixed))
+
+    out.append('')
+    if reads:
+        out.append('    bool Read(PacketReader& reader)')
+        out.append('    {')
+        out.append('        return ' + '\n            && '.join(reads) + ';')
+        out.append('    }')
+    else:
+        out.append('    bool Read(PacketReader&) { return true; }')
+
+    out.append('')
+    out.append('    size_t GetSize() const { return %s; }' % ' + '.join(sizes))
+
+    out.append('')
+    if writes:
+        out.append('    void Write(PacketWriter& writer) const')
+        out.append('    {')
+        for write in writes:
+            out.append('        ' + write)
+        out.append('    }')
+    else:
+        out.append('    void Write(PacketWriter&) const {}')
+
+    out.append('};')
+    out.append('')
+
+
+def generate_cpp(schema):
+    out = [
+        '// protocol/packets.schema 에서 생성한 파일. 직접 고치지 말고 스키마를 고친 뒤',
+        '// python protocol/gen_protocol.py 로 다시 만든다.',
+        '#pragma once',
+        '#include <cstddef>',
+        '#include <cstdint>',
+        '#include <string_view>',
+        '#include "PacketStream.h"',
+        '',
+        'enum class PacketId : uint16_t',
+        '{',
+    ]
+
+    rows = []
+    for packet in sorted(schema.packets, key=lambda p: p.packet_id):
+        if packet.gap and rows:
+            rows.append(('', ''))
+        if packet.comments:
+            for comment in packet.comments:
+                rows.append(('    // ' + comment, ''))
+        rows.append(('    %s = %d,' % (packet.name, packet.packet_id), packet.trailing))
+    out.extend(align_comments(rows))
+    out.append('};')
+    out.append('')
+    out.append('#pragma pack(push, 1)')
+    out.append('')
+    out.append('struct GameHeader')
+    out.append('{')
+    out.append('    uint16_t packetSize;')
+    out.append('    uint16_t packetId;')
+    out.append('};')
+    out.append('')
+    out.append('#pragma pack(pop)')
+    out.append('')
+    out.append('// 받을 때는 Read 가 수신 버퍼를 가리키는 뷰만 채운다 (문자열/배열 복사 없음).')
+    out.append('// FIXED_SIZE 는 문자열/배열이 없는 고정 크기 본문 (0 이면 가변),')
+    out.append('// MIN_SIZE / MAX_SIZE 는 문자열/배열이 비었을 때 / 꽉 찼을 때의 본문 크기.')
+    out.append('// 보낼 때는 필드를 채우고 SendBuffer::Create(packet) 으로 실제 크기만큼 만든다.')
+    out.append('// 본문 뒤에 남는 바이트는 무시한다 (필드를 끝에 추가해도 예전 쪽이 읽을 수 있다).')
+    out.append('')
+
+    for struct in schema.structs:
+        cpp_struct(schema, struct, out)
+    for packet in schema.packets:
+        cpp_struct(schema, packet, out)
+
+    while out[-1] == '':
+        out.pop()
+    return '\n'.join(out) + '\n'
+
+
+# ---------------------------------------------------------------------------
+# C#
+# ---------------------------------------------------------------------------
+
+def cs_field_type(field):
+    if field.kind == 'scalar':
+        return SCALARS[field.type_name][2]
+    if field.kind == 'string':
+        return 'string'
+    if field.kind == 'bytes':
+        return 'ArraySegment<byte>'
+    return field.type_name + '[]'
+
+
+CS_RUNTIME = '''// 스키마로 만든 패킷이 공통으로 구현한다
+public interface IPacketElement
+{
+    int GetSize();
+    void Write(ref PacketWriter writer);
+    bool Read(ref PacketReader reader);
+}
+
+public interface IPacket : IPacketElement
+{
+    PacketId Id { get; }
+}
+
+// [헤더]
+[StructLayout(LayoutKind.Sequential, Pack = 1)]
+public struct GameHeader
+{
+    public ushort packetSize;
+    public ushort packetId;
+}
+
+public static class PacketCodec
+{
+    public const int HeaderSize = 4;
+
+    // 헤더를 포함한 패킷 하나를 실제 크기만큼 만든다
+    public static byte[] Serialize<T>(T packet) where T : struct, IPacket
+    {
+        byte[] buffer = new byte[HeaderSize + packet.GetSize()];
+        Serialize(packet, buffer, 0);
+        return buffer;
+    }
+
+    // 미리 잡아 둔 버퍼에 쓴다. 쓴 바이트 수 (헤더 포함)를 돌려준다.
+    public static int Serialize<T>(T packet, byte[] buffer, int offset) where T : struct, IPacket
+    {
+        int size = HeaderSize + packet.GetSize();
+        PacketWriter writer = new PacketWriter(buffer, offset);
+        writer.Write((ushort)size);
+        writer.Write((ushort)packet.Id);
+        packet.Write(ref writer);
+        return size;
+    }
+
+    // 헤더를 뺀 본문에서 읽는다. 잘렸거나 길이가 맞지 않으면 false.
+    public static bool TryDeserialize<T>(byte[] body, int offset, int count, out T packet) where T : struct, IPacket
+    {
+        packet = default(T);
+        PacketReader reader = new PacketReader(body, offset, count);
+        return packet.Read(ref reader);
+    }
+
+    public static bool TryDeserialize<T>(byte[] body, out T packet) where T : struct, IPacket
+    {
+        return TryDeserialize(body, 0, body.Length, out packet);
+    }
+}
+
+// 리틀 엔디언, 정렬 없음
+public struct PacketWriter
+{
+    private readonly byte[] _buffer;
+    private int _position;
+
+    public PacketWriter(byte[] buffer, int offset)
+    {
+        _buffer = buffer;
+        _position = offset;
+    }
+
+    public int Position { get { return _position; } }
+
+    public void Write(bool value) { _buffer[_position++] = (byte)(value ? 1 : 0); }
+    public void Write(byte value) { _buffer[_position++] = value; }
+
+    public void Write(ushort value)
+    {
+        _buffer[_position++] = (byte)value;
+        _buffer[_position++] = (byte)(value >> 8);
+    }
+
+    public void Write(uint value)
+    {
+        _buffer[_position++] = (byte)value;
+        _buffer[_position++] = (byte)(value >> 8);
+        _buffer[_position++] = (byte)(value >> 16);
+        _buffer[_position++] = (byte)(value >> 24);
+    }
+
+    public void Write(int value) { Write((uint)value); }
+    public void Write(float value) { Write((uint)BitConverter.SingleToInt32Bits(value)); }
+
+    public void WriteString(string value, int maxLength)
+    {
+        int length = StringSize(value, maxLength) - 2;
+        Write((ushort)length);
+        if (length > 0)
+        {
+            byte[] bytes = Encoding.UTF8.GetBytes(value);
+            Array.Copy(bytes, 0, _buffer, _position, length);
+            _position += length;
+        }
+    }
+
+    public void WriteBytes(ArraySegment<byte> value, int maxLength)
+    {
+        int length = Math.Min(value.Count, maxLength);
+        Write((ushort)length);
+        if (length > 0 && value.Array != null)
+        {
+            Array.Copy(value.Array, value.Offset, _buffer, _position, length);
+            _position += length;
+        }
+    }
+
+    public void WriteArray<T>(T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        if (items == null)
+        {
+            Write((ushort)0);
+            return;
+        }
+
+        int count = Math.Min(items.Length, maxCount);
+        Write((ushort)count);
+        for (int i = 0; i < count; i++)
+            items[i].Write(ref this);
+    }
+
+    // u16 길이 + UTF-8. 최대 길이를 넘으면 글자 중간이 아닌 곳에서 자른다.
+    public static int StringSize(string value, int maxLength)
+    {
+        if (string.IsNullOrEmpty(value)) return 2;
+
+        int length = Encoding.UTF8.GetByteCount(value);
+        if (length <= maxLength) return 2 + length;
+
+        byte[] bytes = Encoding.UTF8.GetBytes(value);
+        length = maxLength;
+        while (length > 0 && (bytes[length] & 0xC0) == 0x80) length--;
+        return 2 + length;
+    }
+
+    public static int BytesSize(ArraySegment<byte> value, int maxLength)
+    {
+        return 2 + Math.Min(value.Count, maxLength);
+    }
+
+    public static int ArraySize<T>(T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        if (items == null) return 2;
+
+        int size = 2;
+        int count = Math.Min(items.Length, maxCount);
+        for (int i = 0; i < count; i++)
+            size += items[i].GetSize();
+        return size;
+    }
+}
+
+public struct PacketReader
+{
+    private readonly byte[] _buffer;
+    private int _position;
+    private readonly int _end;
+
+    public PacketReader(byte[] buffer, int offset, int count)
+    {
+        _buffer = buffer;
+        _position = offset;
+        _end = offset + count;
+    }
+
+    public int Remaining { get { return _end - _position; } }
+
+    public bool Read(out bool value)
+    {
+        value = false;
+        if (Remaining < 1) return false;
+        value = _buffer[_position++] != 0;
+        return true;
+    }
+
+    public bool Read(out byte value)
+    {
+        value = 0;
+        if (Remaining < 1) return false;
+        value = _buffer[_position++];
+        return true;
+    }
+
+    public bool Read(out ushort value)
+    {
+        value = 0;
+        if (Remaining < 2) return false;
+        value = (ushort)(_buffer[_position] | (_buffer[_position + 1] << 8));
+        _position += 2;
+        return true;
+    }
+
+    public bool Read(out uint value)
+    {
+        value = 0;
+        if (Remaining < 4) return false;
+        value = (uint)(_buffer[_position] | (_buffer[_position + 1] << 8) | (_buffer[_position + 2] << 16) | (_buffer[_position + 3] << 24));
+        _position += 4;
+        return true;
+    }
+
+    public bool Read(out int value)
+    {
+        bool ok = Read(out uint bits);
+        value = (int)bits;
+        return ok;
+    }
+
+    public bool Read(out float value)
+    {
+        bool ok = Read(out uint bits);
+        value = BitConverter.Int32BitsToSingle((int)bits);
+        return ok;
+    }
+
+    public bool ReadString(out string value, int maxLength)
+    {
+        value = string.Empty;
+        if (!Read(out ushort length) || length > maxLength || Remaining < length) return false;
+        value = Encoding.UTF8.GetString(_buffer, _position, length);
+        _position += length;
+        return true;
+    }
+
+    // 문자열을 만들지 않고 버퍼 안의 위치만 돌려준다 (부하 클라이언트처럼 할당을 피할 때)
+    public bool ReadStringRange(out int offset, out int length, int maxLength)
+    {
+        offset = _position;
+        length = 0;
+        if (!Read(out ushort size) || size > maxLength || Remaining < size) return false;
+        offset = _position;
+        length = size;
+        _position += size;
+        return true;
+    }
+
+    // 복사하지 않고 받은 버퍼의 범위를 돌려준다 (버퍼를 다시 쓰기 전까지만 유효)
+    public bool ReadBytes(out ArraySegment<byte> value, int maxLength)
+    {
+        value = default(ArraySegment<byte>);
+        if (!Read(out ushort length) || length > maxLength || Remaining < length) return false;
+        value = new ArraySegment<byte>(_buffer, _position, length);
+        _position += length;
+        return true;
+    }
+
+    public bool ReadArray<T>(out T[] items, int maxCount) where T : struct, IPacketElement
+    {
+        items = Array.Empty<T>();
+        if (!Read(out ushort count) || count > maxCount) return false;
+
+        items = new T[count];
+        for (int i = 0; i < count; i++)
+        {
+            if (!items[i].Read(ref this)) return false;
+        }
+        return true;
+    }
+}
+'''
+
+
+def cs_struct(schema, decl, out):
+    for comment in decl.comments:
+        out.append('// ' + comment)
+    if decl.trailing:
+        out.append('// ' + decl.trailing)
+    interface = 'IPacket' if decl.kind == 'packet' else 'IPacketElement'
+    out.append('public struct %s : %s' % (decl.type_name, interface))
+    out.append('{')
+    out.append('    public const int MaxSize = %d;' % schema.max_size(decl))
+    if decl.kind == 'packet':
+        out.append('    public PacketId Id { get { return PacketId.%s; } }' % decl.name)
+
+    if decl.fields:
+        out.append('')
+        rows = [('    public %s %s;' % (cs_field_type(f), f.name), field_comment(f)) for f in decl.fields]
+        out.extend(align_comments(rows))
+
+    fixed = 0
+    sizes = []
+    writes = []
+    reads = []
+    for field in decl.fields:
+        if field.kind == 'scalar':
+            fixed += SCALARS[field.type_name][0]
+            writes.append('writer.Write(%s);' % field.name)
+            reads.append('reader.Read(out %s)' % field.name)
+        elif field.kind == 'string':
+            sizes.append('PacketWriter.StringSize(%s, %d)' % (field.name, field.limit))
+            writes.append('writer.WriteString(%s, %d);' % (field.name, field.limit))
+            reads.append('reader.ReadString(out %s, %d)' % (field.name, field.limit))
+        elif field.kind == 'bytes':
+            sizes.append('PacketWriter.BytesSize(%s, %d)' % (field.name, field.limit))
+            writes.append('writer.WriteBytes(%s, %d);' % (field.name, field.limit))
+            reads.append('reader.ReadBytes(out %s, %d)' % (field.name, field.limit))
+        else:
+            sizes.append('PacketWriter.ArraySize(%s, %d)' % (field.name, field.limit))
+            writes.append('writer.WriteArray(%s, %d);' % (field.name, field.limit))
+            reads.append('reader.ReadArray(out %s, %d)' % (field.name, field.limit))
+    if fixed or not sizes:
+        sizes.insert(0, str(fixed))
+
+    out.append('')
+    out.append('    public int GetSize() { return %s; }' % ' + '.join(sizes))
+    out.append('')
+    if writes:
+        out.append('    public void Write(ref PacketWriter writer)')
+        out.append('    {')
+        for write in writes:
+            out.append('        ' + write)
+        out.append('    }')
+    else:
+        out.append('    public void Write(ref PacketWriter writer) { }')
+    out.append('')
+    if reads:
+        out.append('    public bool Read(ref PacketReader reader)')
+        out.append('    {')
+        out.append('        return ' + '\n            && '.join(reads) + ';')
+        out.append('    }')
+    else:
+        out.append('    public bool Read(ref PacketReader reader) { return true; }')
+    out.append('}')
+    out.append('')
+
+
+def generate_cs(schema):
+    out = [
+        '// protocol/packets.schema 에서 생성한 파일. 직접 고치지 말고 스키마를 고친 뒤',
+        '// python protocol/gen_protocol.py 로 다시 만든다.',
+        'using System;',
+        'using System.Runtime.InteropServices;',
+        'using System.Text;',
+        '',
+        '// [패킷 ID] 서버의 PacketId enum 과 같은 스키마에서 만든다.',
+        'public enum PacketId : ushort',
+        '{',
+    ]
+
+    rows = []
+    for packet in sorted(schema.packets, key=lambda p: p.packet_id):
+        if packet.gap and rows:
+            rows.append(('', ''))
+        if packet.comments:
+            for comment in packet.comments:
+                rows.append(('    // ' + comment, ''))
+        rows.append(('    %s = %d,' % (packet.name, packet.packet_id), packet.trailing))
+    out.extend(align_comments(rows))
+    out.append('}')
+    out.append('')
+    out.extend(CS_RUNTIME.split('\n'))
+
+    for struct in schema.structs:
+        cs_struct(schema, struct, out)
+    for packet in schema.packets:
+        cs_struct(schema, packet, out)
+
+    while out[-1] == '':
+        out.pop()
+    return '\n'.join(out) + '\n'
+
+
+def write_output(path, encoding, text):
+    full = os.path.join(ROOT, path)
+    if not os.path.isdir(os.path.dirname(full)):
+        print('skip %s (directory not found)' % path)
+        return
+    data = text.encode(encoding)
+    if os.path.exists(full):
+        with open(full, 'rb') as f:
+            if f.read() == data:
+                return
+    with open(full, 'wb') as f:
+        f.write(data)
+    print('wrote %s' % path)
+
+
+def main():
+    try:
+        with open(SCHEMA, encoding='utf-8') as f:
+            schema = Schema(parse(f.read()))
+    except SchemaError as e:
+        print('[gen_protocol] %s' % e, file=sys.stderr)
+        return 1
+
+    write_output(CPP_OUTPUT[0], CPP_OUTPUT[1], generate_cpp(schema))
+    cs = generate_cs(schema)
+    for path, encoding in CS_OUTPUTS:
+        write_output(path, encoding, cs)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -1,108 +1,162 @@
 #include <iostream>
+#include <cstring>
+#include <thread>
 #include "ClientSession.h"
 #include "NetProtocol.h"
+#include "PacketDispatcher.h"
 #include "Server.h"
 #include "Command.h"
 
 extern Server* g_Server;
 
-ClientSession::ClientSession(SOCKET sock, uint32_t sessionId)
-    : socket_(sock), sessionId_(sessionId)
+std::atomic<uint32_t> ClientSession::s_maxSendBatchBytes = 64 * 1024;
+SendStats ClientSession::s_sendStats;
+std::atomic<bool> ClientSession::s_lendRecvBuffers = true;
+SendBackpressureConfig ClientSession::s_backpressure;
+
+namespace
 {
-    writePos_ = 0;
-    readPos_ = 0;
+    // 뒤에 오는 같은 종류 패킷이 앞의 것을 완전히 대신하는 패킷 (혼잡 시 최신 것만 보낸다)
+    bool IsLatestOnly(PacketId id)
+    {
+        return id == PacketId::SNAPSHOT;
+    }
+
+    bool OverLimit(uint32_t value, uint32_t limit)
+    {
+        return limit != 0 && value > limit;
+    }
+
+    // low 워터마크도 0 이면 보지 않는다 (그 기준으로는 언제나 내려간 것으로 본다)
+    bool UnderLimit(uint32_t value, uint32_t limit)
+    {
+        return limit == 0 || value <= limit;
+    }
+}
+
+ClientSession::ClientSession(SOCKET sock, uint32_t sessionId, IOEngine& ioEngine)
+    : socket_(sock), sessionId_(sessionId), ioEngine_(&ioEngine),
+    connectedMs_(GetMonotonicMs()), lastRecvMs_(connectedMs_)
+{
+    if (!s_lendRecvBuffers)
+        recvBuffer_ = RecvBufferPool::Acquire();
 }
 
 ClientSession::~ClientSession()
 {
     closesocket(socket_);
+    RecvBufferPool::Release(std::move(recvBuffer_));
 }
 
 void ClientSession::Disconnect()
 {
-    if (socket_ == INVALID_SOCKET) return;
+    // I/O 워커, 로직 스레드(백프레셔/로그아웃) 어디서든 불릴 수 있으므로 한 번만 처리한다
+    if (disconnected_.exchange(true)) return;
 
     std::string name = GetName();
     if (!name.empty()) {
-        auto cmd = std::make_unique<LogoutCommand>(sessionId_, name);
-        if (g_Server) Server::GetGLTInputQueue().Push(std::move(cmd));
+        if (g_Server) Server::GetLobbyQueue().Push(Command::Logout(sessionId_, name));
     }
     
-    closesocket(socket_);
+    // 엔진이 닫힘 표시를 한 뒤로는 PostRecv / PostSend 가 socket_ 을 읽지 않으므로 여기서 비워도 된다
+    ioEngine_->CloseSocket(this);
     socket_ = INVALID_SOCKET;
 
     std::cout << "[Session] Disconnected Client: " << sessionId_ << std::endl;
 }
 
-void ClientSession::Send(PacketId id, const std::string& serializedData)
+void ClientSession::PostRecv()
 {
-    const uint16_t dataSize = static_cast<uint16_t>(serializedData.size());
-    const uint16_t packetSize = sizeof(GameHeader) + dataSize;
-
-    std::vector<char> sendBuffer(packetSize);
-
-    GameHeader* header = reinterpret_cast<GameHeader*>(sendBuffer.data());
-    header->packetSize = packetSize;
-    header->packetId = static_cast<uint16_t>(id);
+    // 처리할 데이터가 남아 있지 않으면 버퍼를 돌려주고 버퍼 없이 데이터 도착만 기다린다
+    if (s_lendRecvBuffers && (recvBuffer_ == nullptr || recvBuffer_->GetDataSize() == 0))
+    {
+        RecvBufferPool::Release(std::move(recvBuffer_));
+        ioEngine_->PostRecv(this, nullptr, 0);
+        return;
+    }
 
-    std::memcpy(sendBuffer.data() + sizeof(GameHeader), serializedData.data(), dataSize);
+    PostRecvBuffer();
+}
 
-    PushSendPacket(sendBuffer);
+void ClientSession::OnRecvReady()
+{
+    PostRecvBuffer();
 }
 
-void ClientSession::Send(PacketId id, void* ptr, int size)
+void ClientSession::PostRecvBuffer()
 {
-    const uint16_t packetSize = sizeof(GameHeader) + static_cast<uint16_t>(size);
-    std::vector<char> sendBuffer(packetSize);
+    if (recvBuffer_ == nullptr)
+        recvBuffer_ = RecvBufferPool::Acquire();
 
-    GameHeader* header = reinterpret_cast<GameHeader*>(sendBuffer.data());
-    header->packetSize = packetSize;
-    header->packetId = static_cast<uint16_t>(id);
+    char* writePtr = recvBuffer_->GetWritePtr();
+    int freeSize = static_cast<int>(recvBuffer_->GetFreeSize());
 
-    // string ȯ  ٷ 
-    std::memcpy(sendBuffer.data() + sizeof(GameHeader), ptr, size);
+    if (freeSize <= 0)
+    {
+        // 더 이상 받을 공간이 없음 -> 에러 처리 혹은 연결 종료 로직
+        std::cout << "[Error] Recv Buffer Overflow!" << std::endl;
+        Disconnect();
+        return;
+    }
 
-    PushSendPacket(sendBuffer);
+    // 쓰기 위치부터 남은 공간만큼 받겠다 (mirror 링이면 끝에 걸쳐도 한 번에 받는다)
+    ioEngine_->PostRecv(this, writePtr, freeSize);
 }
 
-void ClientSession::PostRecv(HANDLE hIOCP)
+void ClientSession::Send(SendBufferRef buffer)
 {
-    DWORD flags = 0;
-    DWORD recvBytes = 0;
-
-    ZeroMemory(&recvIoData_.overlapped, sizeof(OVERLAPPED));
+    if (disconnected_.load(std::memory_order_relaxed)) return;
 
-    int freeSize = BUFFER_SIZE - writePos_;
+    const uint32_t size = buffer->GetSize();
+    const uint32_t queuedBytes = queuedBytes_.load(std::memory_order_relaxed);
+    const uint32_t queuedPackets = queuedPackets_.load(std::memory_order_relaxed);
 
-    if (freeSize <= 0)
+    if (OverLimit(queuedBytes + size, s_backpressure.hardBytes) || OverLimit(queuedPackets + 1, s_backpressure.hardPackets))
     {
-        //  ̻    ->  ó Ȥ   
-        std::cout << "[Error] Recv Buffer Overflow!" << std::endl;
+        s_sendStats.backpressureKicks.fetch_add(1, std::memory_order_relaxed);
+        std::cout << "[Session] Send Queue Over Hard Limit (" << queuedBytes << " bytes, " << queuedPackets
+            << " packets). Disconnecting: " << sessionId_ << std::endl;
         Disconnect();
         return;
     }
 
-    // WSABUF  (writePos_ ġ  ŭ ްڴ)
-    recvIoData_.wsaBuf.buf = &inputBuffer_[writePos_];
-    recvIoData_.wsaBuf.len = (ULONG)freeSize;
-    recvIoData_.operation = 0;
-
-    int ret = WSARecv(socket_, &recvIoData_.wsaBuf, 1, &recvBytes, &flags, &recvIoData_.overlapped, NULL);
+    if (!congested_.load(std::memory_order_relaxed)
+        && (OverLimit(queuedBytes, s_backpressure.highBytes) || OverLimit(queuedPackets, s_backpressure.highPackets)))
+    {
+        if (!congested_.exchange(true))
+            s_sendStats.congestionEvents.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    if (ret == SOCKET_ERROR)
+    if (congested_.load(std::memory_order_relaxed) && IsLatestOnly(buffer->GetPacketId()))
     {
-        int err = WSAGetLastError();
-        if (err != WSA_IO_PENDING)
+        // 아직 안 나간 이전 스냅샷은 새 스냅샷으로 대신한다
+        SendBufferRef superseded;
         {
-            std::cout << "WSARecv Failed: " << err << std::endl;
+            std::lock_guard<std::mutex> lock(snapshotLock_);
+            superseded = std::move(latestSnapshot_);
+            latestSnapshot_ = std::move(buffer);
+            hasLatestSnapshot_.store(true);
+
+            queuedBytes_.fetch_add(size, std::memory_order_relaxed);
+            if (superseded != nullptr)
+                queuedBytes_.fetch_sub(superseded->GetSize(), std::memory_order_relaxed);
+            else
+                queuedPackets_.fetch_add(1, std::memory_order_relaxed);
         }
-    }
-}
 
-void ClientSession::PushSendPacket(const std::vector<char>& packetData)
-{
-    auto packet = std::make_shared<std::vector<char>>(packetData);
-    outputQueue_.Push(packet);
+        if (superseded != nullptr)
+        {
+            coalescedSnapshots_.fetch_add(1, std::memory_order_relaxed);
+            s_sendStats.coalescedSnapshots.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else
+    {
+        // 꺼내는 쪽이 빼기 전에 항상 먼저 더해 두도록 Push 앞에서 센다
+        queuedBytes_.fetch_add(size, std::memory_order_relaxed);
+        queuedPackets_.fetch_add(1, std::memory_order_relaxed);
+        outputQueue_.Push(std::move(buffer));
+    }
 
     bool expected = false;
     if (isSending_.compare_exchange_strong(expected, true))
@@ -111,243 +165,317 @@ void ClientSession::PushSendPacket(const std::vector<char>& packetData)
     }
 }
 
-void ClientSession::FlushSend()
+// 큐가 low 워터마크 아래로 내려가면 혼잡 상태를 푼다
+void ClientSession::UpdateCongestion()
 {
-    std::shared_ptr<std::vector<char>> packet;
+    if (!congested_.load(std::memory_order_relaxed)) return;
+
+    uint32_t queuedBytes = queuedBytes_.load(std::memory_order_relaxed);
+    uint32_t queuedPackets = queuedPackets_.load(std::memory_order_relaxed);
+
+    if (UnderLimit(queuedBytes, s_backpressure.lowBytes) && UnderLimit(queuedPackets, s_backpressure.lowPackets))
+        congested_.store(false);
+}
 
-    if (!outputQueue_.Pop(packet))
+// isSending_ 을 잡은 스레드만 호출한다.
+// 큐에 쌓인 패킷을 한도 안에서 모두 모아 gather send 한 번으로 보낸다.
+// 혼잡 중 따로 남겨 둔 최신 스냅샷은 큐를 다 비운 배치 끝에 붙인다.
+void ClientSession::FlushSend()
+{
+    while (true)
     {
-        isSending_ = false;
-        return;
-    }
+        sendingPackets_.clear();
+        sendBufCount_ = 0;
+        sendBufHead_ = 0;
 
-    currentSendingPacket_ = packet;
+        uint32_t batchBytes = 0;
+        const uint32_t maxBatchBytes = s_maxSendBatchBytes.load(std::memory_order_relaxed);
+        bool queueDrained = false;
 
-    ZeroMemory(&sendIoData_.overlapped, sizeof(OVERLAPPED));
-    sendIoData_.operation = 1;
+        while (sendBufCount_ < MAX_SEND_BUFFERS)
+        {
+            SendBufferRef packet = std::move(deferredPacket_);
+            if (packet == nullptr)
+            {
+                if (!outputQueue_.Pop(packet))
+                {
+                    queueDrained = true;
+                    break;
+                }
+                queuedBytes_.fetch_sub(packet->GetSize(), std::memory_order_relaxed);
+                queuedPackets_.fetch_sub(1, std::memory_order_relaxed);
+            }
 
-    sendIoData_.wsaBuf.buf = currentSendingPacket_->data();
-    sendIoData_.wsaBuf.len = (ULONG)currentSendingPacket_->size();
+            uint32_t size = packet->GetSize();
+            if (sendBufCount_ > 0 && batchBytes + size > maxBatchBytes)
+            {
+                deferredPacket_ = std::move(packet);
+                break;
+            }
 
-    DWORD sendBytes = 0;
-    DWORD flags = 0;
+            sendBufs_[sendBufCount_++] = MakeIoBuffer(packet->GetData(), size);
+            sendingPackets_.push_back(std::move(packet));
+            batchBytes += size;
+        }
 
-    if (WSASend(socket_, &sendIoData_.wsaBuf, 1, &sendBytes, flags, &sendIoData_.overlapped, NULL) == SOCKET_ERROR)
-    {
-        if (WSAGetLastError() != WSA_IO_PENDING)
+        if (queueDrained && sendBufCount_ < MAX_SEND_BUFFERS && hasLatestSnapshot_.load())
         {
-            isSending_ = false;
+            SendBufferRef snapshot;
+            {
+                std::lock_guard<std::mutex> lock(snapshotLock_);
+                snapshot = std::move(latestSnapshot_);
+                hasLatestSnapshot_.store(false);
+
+                if (snapshot != nullptr)
+                {
+                    queuedBytes_.fetch_sub(snapshot->GetSize(), std::memory_order_relaxed);
+                    queuedPackets_.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+
+            if (snapshot != nullptr)
+            {
+                sendBufs_[sendBufCount_++] = MakeIoBuffer(snapshot->GetData(), snapshot->GetSize());
+                sendingPackets_.push_back(std::move(snapshot));
+            }
+        }
+
+        UpdateCongestion();
+
+        if (sendBufCount_ > 0)
+        {
+            s_sendStats.batches.fetch_add(1, std::memory_order_relaxed);
+            s_sendStats.packets.fetch_add(sendBufCount_, std::memory_order_relaxed);
+
+            if (!PostSendBatch())
+            {
+                sendingPackets_.clear();
+                isSending_ = false;
+            }
+            return;
         }
+
+        isSending_ = false;
+
+        // 플래그를 내리는 사이에 들어온 패킷은 Push 쪽 CAS 가 실패했으므로 여기서 마저 보낸다
+        if (outputQueue_.Empty() && !hasLatestSnapshot_.load()) return;
+
+        // 큐에 세었지만 아직 이어 붙이는 중인 패킷이면 Pop 은 실패한다. 그 생산자가 마칠 틈을 준다.
+        if (!hasLatestSnapshot_.load())
+            std::this_thread::yield();
+
+        bool expected = false;
+        if (!isSending_.compare_exchange_strong(expected, true)) return;
     }
 }
 
+bool ClientSession::PostSendBatch()
+{
+    s_sendStats.sendCalls.fetch_add(1, std::memory_order_relaxed);
+    return ioEngine_->PostSend(this, &sendBufs_[sendBufHead_], sendBufCount_ - sendBufHead_);
+}
+
 bool ClientSession::HasCompletePacket() const
 {
-    int dataSize = writePos_ - readPos_;
+    if (recvBuffer_ == nullptr) return false;
+
+    uint32_t dataSize = recvBuffer_->GetDataSize();
 
-    // 1)  ũ⸸ŭ   Ŷ ƴ
+    // 1) 헤더 크기만큼도 안 왔으면 패킷 아님
     if (dataSize < sizeof(GameHeader)) {
         return false;
     }
 
-    // 2)  о ü Ŷ ũ Ȯ
-    const GameHeader* header = reinterpret_cast<const GameHeader*>(&inputBuffer_[readPos_]);
+    // 2) 헤더를 읽어서 전체 패킷 크기 확인
+    const GameHeader* header = reinterpret_cast<const GameHeader*>(recvBuffer_->GetReadPtr());
 
-    // 3) ۿ ִ ȿ   Ŷ ü ũ⺸ ų 
+    // 3) 버퍼에 있는 유효 데이터 양이 패킷 전체 크기보다 많거나 같으면
     return dataSize >= header->packetSize;
 }
 
-std::unique_ptr<ICommand> ClientSession::DeserializeCommand()
+// 클라이언트가 보내는 패킷별 핸들러 (I/O 워커에서 불린다).
+// 받은 패킷을 처리하려면 스키마에 패킷을 추가하고, 여기에 OnPacket 하나와 아래 표에 한 줄을 더한다.
+// 패킷의 문자열은 수신 버퍼를 가리키므로 로직 스레드로 넘길 때 커맨드 슬롯에 복사한다 (힙 할당 없음).
+// 방 안의 일 (입장, 이동, 채팅) 은 그 방을 맡은 샤드로, 나머지는 로비로 보낸다.
+static void PushCommand(const Command& command)
 {
-    std::lock_guard<std::mutex> lock(lock_);
-
-    GameHeader* header = reinterpret_cast<GameHeader*>(&inputBuffer_[readPos_]);
-    const char* bodyPtr = reinterpret_cast<const char*>(&inputBuffer_[readPos_]) + sizeof(GameHeader);
-
-    int bodySize = header->packetSize - sizeof(GameHeader);
-    std::unique_ptr<ICommand> command = nullptr;
-    PacketId pktId = static_cast<PacketId>(header->packetId);
-
-    switch (pktId)
-    {
-        // α û ó
-    case PacketId::LOGIN_REQ:
-    {
-        // 1.  üũ
-        if (bodySize < sizeof(PacketLoginReq)) return nullptr;
+    Server::GetLobbyQueue().Push(command);
+}
 
-        // 2. ĳ
-        const PacketLoginReq* pkt = reinterpret_cast<const PacketLoginReq*>(bodyPtr);
+// 마지막으로 들어가려 한 방의 샤드로 보낸다. 방에 들어간 적이 없으면 버린다.
+static void PushRoomCommand(ClientSession& session, const Command& command)
+{
+    int32_t roomId;
+    if (session.GetRoomRoute(roomId))
+        Server::GetRoomQueue(roomId).Push(command);
+}
 
-        // 3.  
-        std::string username(pkt->username);
-        std::string password(pkt->password);
+static void OnPacket(ClientSession& session, const PacketRegisterReq& pkt)
+{
+    std::cout << "[RECV] REGISTER_REQ / ID: " << pkt.username << std::endl;
+    PushCommand(Command::Register(session.GetSessionId(), pkt.username, pkt.password));
+}
 
-        std::cout << "[RECV] LOGIN_REQ / ID: " << username << std::endl;
+static void OnPacket(ClientSession& session, const PacketLoginReq& pkt)
+{
+    std::cout << "[RECV] LOGIN_REQ / ID: " << pkt.username << std::endl;
+    PushCommand(Command::Login(session.GetSessionId(), pkt.username, pkt.password));
+}
 
-        // 4. Ŀǵ 
-        command = std::make_unique<LoginCommand>(sessionId_, username, password);
-        break;
-    }
+static void OnPacket(ClientSession& session, const PacketEnterRoom& pkt)
+{
+    std::cout << "[RECV] ENTER_ROOM / Room: " << pkt.roomId << std::endl;
+
+    // 다른 샤드의 방으로 옮길 때는 이전 방의 샤드가 내보낸 뒤 새 방의 샤드로 입장을 넘긴다.
+    // 두 샤드에 따로 넣으면 순서가 없어 한 틱 동안 두 방에 동시에 있을 수 있다.
+    // 같은 샤드 안에서는 JoinRoom 이 이전 방에서 빼고 넣는다.
+    int32_t previousRoomId;
+    bool changeShard = session.GetRoomRoute(previousRoomId)
+        && Server::GetShardOfRoom(previousRoomId) != Server::GetShardOfRoom(pkt.roomId);
+
+    session.SetRoomRoute(pkt.roomId);
+    if (changeShard)
+        Server::GetRoomQueue(previousRoomId).Push(Command::LeaveRoom(session.GetSessionId(), pkt.roomId));
+    else
+        PushRoomCommand(session, Command::EnterRoom(session.GetSessionId(), pkt.roomId));
+}
 
-    // ȸ û ó
-    case PacketId::REGISTER_REQ:
-    {
-        if (bodySize < sizeof(PacketRegisterReq)) return nullptr;
+static void OnPacket(ClientSession& session, const PacketChat& pkt)
+{
+    PushRoomCommand(session, Command::Chat(session.GetSessionId(), pkt.msg));
+}
 
-        const PacketRegisterReq* pkt = reinterpret_cast<const PacketRegisterReq*>(bodyPtr);
+static void OnPacket(ClientSession& session, const PacketMove& pkt)
+{
+    PushRoomCommand(session, Command::Move(session.GetSessionId(), pkt.vx, pkt.vy));
+}
 
-        std::string username(pkt->username);
-        std::string password(pkt->password);
+static void OnPacket(ClientSession& session, const PacketWhisperReq& pkt)
+{
+    PushCommand(Command::Whisper(session.GetSessionId(), pkt.target, pkt.msg));
+}
 
-        std::cout << "[RECV] REGISTER_REQ / ID: " << username << std::endl;
+static void OnPacket(ClientSession& session, const PacketCreateRoomReq& pkt)
+{
+    std::cout << "[RECV] CREATE_ROOM / Title: " << pkt.title << std::endl;
+    PushCommand(Command::CreateRoom(session.GetSessionId(), pkt.title));
+}
 
-        // RegisterCommand 
-        command = std::make_unique<RegisterCommand>(sessionId_, username, password);
-        break;
-    }
+static void OnPacket(ClientSession& session, const PacketRoomListReq&)
+{
+    std::cout << "[RECV] ROOM_LIST_REQ" << std::endl;
+    PushCommand(Command::RoomList(session.GetSessionId()));
+}
 
-    //   û
-    case PacketId::ENTER_ROOM:
-    {
-        if (bodySize < sizeof(PacketEnterRoom)) return nullptr;
+static void OnPacket(ClientSession& session, const PacketLogoutReq&)
+{
+    std::cout << "[RECV] LOGOUT_REQ" << std::endl;
+    PushCommand(Command::Logout(session.GetSessionId(), session.GetName()));
+}
 
-        const PacketEnterRoom* pkt = reinterpret_cast<const PacketEnterRoom*>(bodyPtr);
-        int32_t roomId = pkt->roomId;
+// 하트비트는 로직 스레드를 거치지 않고 바로 돌려준다 (수신 시각 갱신은 OnRecv 에서 이미 했다)
+static void OnPacket(ClientSession& session, const PacketHeartbeatReq& pkt)
+{
+    PacketHeartbeatRes res;
+    res.clientTime = pkt.clientTime;
+    session.SendPacket(res);
+}
 
-        std::cout << "[RECV] ENTER_ROOM / Room: " << roomId << std::endl;
+// 스냅샷 ACK 도 로직 스레드를 거치지 않는다. 다음 스냅샷을 만들 때 GameRoom 이 읽어 간다.
+static void OnPacket(ClientSession& session, const PacketSnapshotAck& pkt)
+{
+    session.SetSnapshotAck(pkt.tick);
+}
 
-        command = std::make_unique<EnterRoomCommand>(sessionId_, roomId);
-        break;
-    }
+using ClientPacketDispatcher = PacketDispatcher<ClientSession,
+    PacketRegisterReq,
+    PacketLoginReq,
+    PacketEnterRoom,
+    PacketChat,
+    PacketMove,
+    PacketWhisperReq,
+    PacketCreateRoomReq,
+    PacketRoomListReq,
+    PacketLogoutReq,
+    PacketHeartbeatReq,
+    PacketSnapshotAck>;
+
+void ClientSession::OnRecv(uint32_t bytesTransferred)
+{
+    recvBuffer_->OnWrite(bytesTransferred);
+    lastRecvMs_.store(GetMonotonicMs(), std::memory_order_relaxed);
 
-    case PacketId::CHAT:
+    while (true)
     {
-        if (bodySize < sizeof(PacketChat))
-        {
-            std::cout << "[Error] Invalid Chat Packet Size" << std::endl;
-            return nullptr;
-        }
-        const PacketChat* pkt = reinterpret_cast<const PacketChat*>(bodyPtr);
+        uint32_t dataSize = recvBuffer_->GetDataSize();
+        if (dataSize < sizeof(GameHeader)) break;
 
-        std::string msg(pkt->msg);
-        std::cout << "[Debug] Chat Msg: " << msg << std::endl;
-        command = std::make_unique<ChatCommand>(sessionId_, msg);
-    }
-    break;
+        const GameHeader* header = reinterpret_cast<const GameHeader*>(recvBuffer_->GetReadPtr());
+        uint16_t packetSize = header->packetSize;
 
-    case PacketId::MOVE:
-    {
-        if (bodySize < sizeof(PacketMove))
+        // 헤더보다 작거나 버퍼에 다 담을 수 없는 크기는 다시 맞출 방법이 없다
+        if (packetSize < sizeof(GameHeader) || packetSize > recvBuffer_->GetCapacity())
         {
-            std::cout << "[Error] Invalid Move Packet Size" << std::endl;
-            return nullptr;
+            std::cout << "[Session] Invalid Packet Size: " << packetSize << ". Disconnecting..." << std::endl;
+            Disconnect();
+            return;
         }
-        const PacketMove* pkt = reinterpret_cast<const PacketMove*>(bodyPtr);
-        command = std::make_unique<MoveCommand>(sessionId_, pkt->vx, pkt->vy);
-    }
-    break;
-
-    case PacketId::CREATE_ROOM_REQ:
-    {
-        if (bodySize < sizeof(PacketCreateRoomReq)) return nullptr;
-        const PacketCreateRoomReq* pkt = reinterpret_cast<const PacketCreateRoomReq*>(bodyPtr);
 
-        std::string title(pkt->title);
+        if (dataSize < packetSize) break;
 
-        std::cout << "[RECV] CREATE_ROOM / Title: " << title << std::endl;
-        command = std::make_unique<CreateRoomCommand>(sessionId_, title);
-        break;
-    }
+        // 필드는 링 위에서 바로 읽고, 로직 스레드로 넘길 커맨드에 들어갈 문자열만 한 번 복사한다
+        DispatchResult result = ClientPacketDispatcher::Dispatch(*this, header->packetId,
+            recvBuffer_->GetReadPtr() + sizeof(GameHeader), packetSize - sizeof(GameHeader));
 
-    case PacketId::ROOM_LIST_REQ:
-    {
-        std::cout << "[RECV] ROOM_LIST_REQ" << std::endl;
-        command = std::make_unique<RoomListCommand>(sessionId_);
-        break;
-    }
-
-    case PacketId::LOGOUT_REQ:
-    {
-        std::cout << "[RECV] LOGOUT_REQ" << std::endl;
-        std::string myName = name_;
-        command = std::make_unique<LogoutCommand>(sessionId_, myName);
-        break;
-    }
+        if (result != DispatchResult::OK)
+        {
+            std::cout << "[Session] " << ToString(result) << " (ID: " << header->packetId << ", Size: " << packetSize
+                << "). Disconnecting..." << std::endl;
+            Disconnect();
+            return;
+        }
 
-    default:
-        std::cout << "[RECV] Unknown Packet ID: " << header->packetId << std::endl;
-        return nullptr;
+        recvBuffer_->OnRead(packetSize);
     }
 
-    return command;
+    PostRecv();
 }
 
-void ClientSession::OnRecv(DWORD bytesTransferred)
+void ClientSession::OnSendCompleted(uint32_t bytesTransferred)
 {
-    MoveWritePos(bytesTransferred);
+    s_sendStats.bytes.fetch_add(bytesTransferred, std::memory_order_relaxed);
 
-    while (true)
+    // 다 나간 버퍼는 건너뛰고, 걸쳐서 끝난 버퍼는 나간 만큼 앞을 잘라낸다
+    while (bytesTransferred > 0 && sendBufHead_ < sendBufCount_)
     {
-        int dataSize = writePos_ - readPos_;
-        if (dataSize < sizeof(GameHeader)) break;
+        IoBuffer& buf = sendBufs_[sendBufHead_];
+        uint32_t size = IoBufferSize(buf);
 
-        GameHeader* header = reinterpret_cast<GameHeader*>(&inputBuffer_[readPos_]);
-        if (dataSize < header->packetSize) break;
-
-        std::unique_ptr<ICommand> command = DeserializeCommand();
-
-        if (command != nullptr) {
-            readPos_ += header->packetSize;
-            Server::GetGLTInputQueue().Push(std::move(command));
+        if (bytesTransferred >= size)
+        {
+            bytesTransferred -= size;
+            sendBufHead_++;
         }
-        else {
-            PacketId pktId = static_cast<PacketId>(header->packetId);
-            if (pktId == PacketId::LOGIN_REQ) {
-                readPos_ += header->packetSize;
-            }
-            else {
-                std::cout << "[Session] Error or Unknown Packet. Disconnecting..." << std::endl;
-                Disconnect();
-                return;
-            }
+        else
+        {
+            IoBufferAdvance(buf, bytesTransferred);
+            bytesTransferred = 0;
         }
     }
 
-    if (readPos_ == writePos_)
-    {
-        readPos_ = 0;
-        writePos_ = 0;
-    }
-
-    RegisterRecv();
-}
-
-void ClientSession::MoveWritePos(DWORD bytes)
-{
-    writePos_ += bytes;
-}
-
-void ClientSession::RegisterRecv()
-{
-    if (BUFFER_SIZE - writePos_ < 1024)
+    // 일부만 나갔으면 남은 부분을 다시 보낸다
+    if (sendBufHead_ < sendBufCount_)
     {
-        int dataSize = writePos_ - readPos_;
-
-        if (dataSize > 0)
+        s_sendStats.partialSends.fetch_add(1, std::memory_order_relaxed);
+        if (!PostSendBatch())
         {
-            std::memmove(&inputBuffer_[0], &inputBuffer_[readPos_], dataSize);
+            sendingPackets_.clear();
+            isSending_ = false;
         }
-
-        readPos_ = 0;
-        writePos_ = dataSize;
+        return;
     }
 
-    PostRecv(nullptr);
-}
-
-void ClientSession::OnSendCompleted(DWORD bytesTransferred)
-{
-    currentSendingPacket_ = nullptr;
+    // 다 나간 배치의 참조를 놓는다. 다른 세션이 같이 들고 있지 않으면 여기서 풀로 돌아간다.
+    sendingPackets_.clear();
     FlushSend();
 }
\ No newline at end of file
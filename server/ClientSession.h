@@ -1,6 +1,5 @@
 #pragma once
 
-#include <winsock2.h>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -10,38 +9,122 @@
 #include "Command.h"
 #include "LockFreeQueue.h"
 #include "NetProtocol.h"
+#include "IOEngine.h"
+#include "SendBuffer.h"
+#include "RecvBuffer.h"
 
+#ifdef _WIN32
 #pragma comment(lib, "Ws2_32.lib")
+#endif
 
-class GameRoom;
+// 송신 통계 (전체 세션 합계). packets / sendCalls 가 송신 한 번에 묶인 평균 패킷 수.
+struct SendStats
+{
+    std::atomic<uint64_t> sendCalls = 0;      // PostSend 호출 수 (부분 송신 재시도 포함)
+    std::atomic<uint64_t> batches = 0;        // 새로 묶은 배치 수
+    std::atomic<uint64_t> packets = 0;        // 배치에 담긴 패킷 수
+    std::atomic<uint64_t> bytes = 0;          // 완료된 송신 바이트
+    std::atomic<uint64_t> partialSends = 0;   // 요청보다 적게 나간 완료 수
+
+    std::atomic<uint64_t> coalescedSnapshots = 0;   // 혼잡 중 새 스냅샷에 밀려 버려진 스냅샷
+    std::atomic<uint64_t> congestionEvents = 0;     // high 워터마크를 넘어 혼잡 상태로 들어간 횟수
+    std::atomic<uint64_t> backpressureKicks = 0;    // hard 한도를 넘어 끊은 세션 수
+};
+
+// 세션별 송신 큐 워터마크 (0 이면 그 기준은 보지 않는다).
+// - high 를 넘으면 혼잡 상태: 스냅샷은 큐에 쌓지 않고 최신 것 하나만 남긴다 (채팅 등은 그대로 쌓는다)
+// - low 아래로 내려가면 혼잡 상태가 풀린다
+// - hard 를 넘기면 더 따라올 수 없는 클라이언트로 보고 끊는다
+struct SendBackpressureConfig
+{
+    uint32_t highBytes = 256 * 1024;
+    uint32_t lowBytes = 64 * 1024;
+    uint32_t hardBytes = 4 * 1024 * 1024;
+
+    uint32_t highPackets = 512;
+    uint32_t lowPackets = 128;
+    uint32_t hardPackets = 8192;
+};
 
 class ClientSession : public std::enable_shared_from_this<ClientSession>
 {
 public:
-    ClientSession(SOCKET sock, uint32_t sessionId);
+    ClientSession(SOCKET sock, uint32_t sessionId, IOEngine& ioEngine);
     ~ClientSession();
 
-    enum { BUFFER_SIZE = 65536 };
+    enum { MAX_SEND_BUFFERS = 64 };   // 송신 한 번에 묶는 최대 패킷 수
+
+    // 송신 한 번에 묶는 최대 바이트 (첫 패킷은 크기와 상관없이 항상 나간다)
+    static void SetMaxSendBatchBytes(uint32_t bytes) { s_maxSendBatchBytes = bytes; }
+    static SendStats& GetSendStats() { return s_sendStats; }
+
+    // 서버 시작 전에 설정한다
+    static void SetBackpressureConfig(const SendBackpressureConfig& config) { s_backpressure = config; }
+
+    // 켜면 쉬는 세션은 수신 버퍼 없이 데이터 도착만 기다리고, 도착하면 풀에서 빌려 쓴다
+    static void SetLendRecvBuffers(bool enable) { s_lendRecvBuffers = enable; }
+    static bool IsLendingRecvBuffers() { return s_lendRecvBuffers; }
 
     SOCKET GetSocket() const { return socket_; }
     uint32_t GetSessionId() const { return sessionId_; }
     void Disconnect();
 
+    // 아직 송신에 넘기지 않은 큐 깊이 (남겨 둔 최신 스냅샷 포함)
+    uint32_t GetQueuedBytes() const { return queuedBytes_.load(std::memory_order_relaxed); }
+    uint32_t GetQueuedPackets() const { return queuedPackets_.load(std::memory_order_relaxed); }
+    uint64_t GetCoalescedSnapshots() const { return coalescedSnapshots_.load(std::memory_order_relaxed); }
+    bool IsCongested() const { return congested_.load(std::memory_order_relaxed); }
+
     PER_IO_DATA recvIoData_;
 
-    char inputBuffer_[BUFFER_SIZE] = {};
+    void Send(SendBufferRef buffer);   // 복사 없이 참조만 큐에 넣는다 (브로드캐스트용)
 
-    void Send(PacketId id, const std::string& serializedData);
-    void Send(PacketId id, void* ptr, int size);
-    void PostRecv(HANDLE hIOCP);
-    void PushSendPacket(const std::vector<char>& packetData);
+    // 스키마로 만든 패킷 하나를 실제 크기만큼 직렬화해서 보낸다
+    template <typename T>
+    void SendPacket(const T& packet) { Send(SendBuffer::Create(packet)); }
+    void PostRecv();
 
     bool HasCompletePacket() const;
-    std::unique_ptr<ICommand> DeserializeCommand();
 
     void FlushSend();
-    void OnRecv(DWORD bytesTransferred);
-    void OnSendCompleted(DWORD bytesTransferred);
+    void OnRecv(uint32_t bytesTransferred);
+    void OnRecvReady();   // 버퍼 없이 걸어 둔 수신에 데이터가 도착했다
+    void OnSendCompleted(uint32_t bytesTransferred);
+
+    // 엔진에 걸어 둔 I/O 수. SessionReclaimer 는 이 값이 0 이 될 때까지 세션을 놓지 않는다.
+    // 완료 처리에서는 ReleaseIoRef 가 세션을 건드리는 마지막 호출이어야 한다.
+    void AddIoRef() { ioRefs_.fetch_add(1, std::memory_order_relaxed); }
+    void ReleaseIoRef() { ioRefs_.fetch_sub(1, std::memory_order_release); }
+    int32_t GetIoRefCount() const { return ioRefs_.load(std::memory_order_acquire); }
+
+    PER_IO_DATA& GetRecvIoData() { return recvIoData_; }
+    PER_IO_DATA& GetSendIoData() { return sendIoData_; }
+
+    // 시간 제한 확인용 (SessionTimers 가 만료 때만 읽는다)
+    int64_t GetConnectedMs() const { return connectedMs_; }
+    int64_t GetLastRecvMs() const { return lastRecvMs_.load(std::memory_order_relaxed); }
+    void SetLoggedIn() { loggedIn_.store(true, std::memory_order_relaxed); }
+    bool IsLoggedIn() const { return loggedIn_.load(std::memory_order_relaxed); }
+    bool IsDisconnected() const { return disconnected_.load(std::memory_order_relaxed); }
+
+    // 클라이언트가 마지막으로 적용했다고 알려 온 스냅샷 번호 (I/O 스레드가 쓰고 방 샤드가 델타 기준으로 읽는다)
+    void SetSnapshotAck(uint32_t seq) { snapshotAck_.store(seq, std::memory_order_relaxed); }
+    uint32_t GetSnapshotAck() const { return snapshotAck_.load(std::memory_order_relaxed); }
+
+    // 다음 스냅샷 번호 (1 부터). 방을 옮겨도, 방을 나가기 직전의 샤드와 들어간 샤드가 잠깐 같이 보내도 겹치지 않는다.
+    uint32_t NextSnapshotSeq() { return snapshotSeq_.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    // GameRoom 이 이 세션에 고른 스냅샷 간격 (틱) 과 ACK 로 잰 RTT (-1: 아직 모름). 통계 출력용으로 남겨 둔다.
+    void SetSnapshotRate(uint32_t intervalTicks, int32_t rttMs)
+    {
+        snapshotInterval_.store(intervalTicks, std::memory_order_relaxed);
+        snapshotRttMs_.store(rttMs, std::memory_order_relaxed);
+    }
+    uint32_t GetSnapshotInterval() const { return snapshotInterval_.load(std::memory_order_relaxed); }
+    int32_t GetSnapshotRttMs() const { return snapshotRttMs_.load(std::memory_order_relaxed); }
+
+    IOContext* GetIOContext() const { return ioContext_.get(); }
+    void SetIOContext(std::unique_ptr<IOContext> context) { ioContext_ = std::move(context); }
 
     void SetName(const std::string& name)
     {
@@ -55,34 +138,80 @@ public:
         return name_;
     }
 
-    void SetCurrentRoom(std::shared_ptr<GameRoom> room)
+    // 방 커맨드를 넘길 샤드를 고르는 데 쓰는 마지막 입장 요청 방 (패킷 핸들러에서만 바꾼다.
+    // 한 세션의 패킷은 한 번에 한 I/O 워커만 처리하므로 잠그지 않는다)
+    bool GetRoomRoute(int32_t& roomId) const
     {
-        std::lock_guard<std::mutex> lock(lock_);
-        currentRoom_ = room;
+        roomId = roomRoute_.load(std::memory_order_relaxed);
+        return hasRoomRoute_;
     }
-
-    std::shared_ptr<GameRoom> GetCurrentRoom()
+    void SetRoomRoute(int32_t roomId)
     {
-        std::lock_guard<std::mutex> lock(lock_);
-        return currentRoom_;
+        roomRoute_.store(roomId, std::memory_order_relaxed);
+        hasRoomRoute_ = true;
     }
+    // 방 샤드가 입장 커맨드를 처리할 때, 그 사이 다른 방으로 입장 요청이 또 왔는지 본다
+    bool IsRoomRoute(int32_t roomId) const { return roomRoute_.load(std::memory_order_relaxed) == roomId; }
 
 private:
     SOCKET socket_;
     uint32_t sessionId_;
+    IOEngine* ioEngine_;
+    std::unique_ptr<IOContext> ioContext_;
 
     std::mutex lock_;
     std::string name_ = "Guest";
-    std::shared_ptr<GameRoom> currentRoom_ = nullptr;
+
+    bool hasRoomRoute_ = false;
+    std::atomic<int32_t> roomRoute_ = 0;
 
     PER_IO_DATA sendIoData_;
-    int writePos_ = 0, readPos_ = 0;
-    std::shared_ptr<std::vector<char>> currentSendingPacket_;
 
-    LockFreeQueue<std::shared_ptr<std::vector<char>>> outputQueue_;
+    // 수신 링. 패킷은 항상 연속으로 보이므로 읽기 위치에서 바로 파싱한다.
+    // recv 완료 -> OnRecv -> 다음 PostRecv 가 한 줄로 이어지므로 따로 잠그지 않는다.
+    // 대여 모드에서는 남은 데이터가 없을 때 풀에 돌려주고 nullptr 로 둔다.
+    std::unique_ptr<RecvBuffer> recvBuffer_;
 
-    std::atomic<bool> isSending_ = false;
+    // 송신 중인 배치: 패킷 수명 유지 + gather 버퍼 (sendBufHead_ 부터 아직 안 나감)
+    std::vector<SendBufferRef> sendingPackets_;
+    IoBuffer sendBufs_[MAX_SEND_BUFFERS];
+    int sendBufCount_ = 0;
+    int sendBufHead_ = 0;
+    SendBufferRef deferredPacket_;   // 배치 한도를 넘겨 다음 배치로 미룬 패킷
+
+    static std::atomic<uint32_t> s_maxSendBatchBytes;
+    static SendStats s_sendStats;
+    static SendBackpressureConfig s_backpressure;
+    static std::atomic<bool> s_lendRecvBuffers;
 
-    void MoveWritePos(DWORD bytes);
-    void RegisterRecv();
+    LockFreeQueue<SendBufferRef> outputQueue_;
+
+    std::atomic<bool> isSending_ = false;
+    std::atomic<bool> disconnected_ = false;
+    std::atomic<int32_t> ioRefs_ = 0;
+
+    // 시간 제한: 접속 시각, 마지막으로 패킷이 들어온 시각, 로그인 여부
+    int64_t connectedMs_;
+    std::atomic<int64_t> lastRecvMs_;
+    std::atomic<bool> loggedIn_ = false;
+
+    std::atomic<uint32_t> snapshotAck_ = 0;
+    std::atomic<uint32_t> snapshotSeq_ = 0;
+    std::atomic<uint32_t> snapshotInterval_ = 0;
+    std::atomic<int32_t> snapshotRttMs_ = -1;
+
+    // 백프레셔: 큐 깊이와 혼잡 상태
+    std::atomic<uint32_t> queuedBytes_ = 0;
+    std::atomic<uint32_t> queuedPackets_ = 0;
+    std::atomic<bool> congested_ = false;
+    std::atomic<uint64_t> coalescedSnapshots_ = 0;
+
+    // 혼잡 중에 들어온 스냅샷은 큐 대신 여기 최신 것 하나만 둔다
+    std::mutex snapshotLock_;
+    SendBufferRef latestSnapshot_;
+    std::atomic<bool> hasLatestSnapshot_ = false;
+
+    bool PostSendBatch();
+    void PostRecvBuffer();
+    void UpdateCongestion();
 };
\ No newline at end of file
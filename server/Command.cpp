@@ -1,7 +1,10 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
 #include "Command.h"
+#include "CommandTask.h"
 #include "RoomManager.h"
 #include "GameRoom.h"
-#include "PlayerState.h"
 #include "Persistence.h"
 #include "PersistenceRequest.h"
 #include "Server.h"        
@@ -9,180 +12,307 @@
 
 extern Server* g_Server;
 
-// [1] ȸ Ŀǵ (DB ۾ û)
-void RegisterCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// [1] 회원가입 커맨드 (DB 작업 요청)
+static void ExecuteRegister(const Command& command, Persistence& persistence)
 {
     auto req = std::make_unique<PersistenceRequest>();
     req->type = RequestType::REGISTER;
-    req->sessionId = sessionId_;
-    req->username = username_;
-    req->password = password_;
+    req->sessionId = command.sessionId;
+    req->username = command.GetText(0);
+    req->password = command.GetText(1);
 
     persistence.PostRequest(std::move(req));
 }
 
-// [2] α Ŀǵ (DB ۾ û)
-void LoginCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// [2] 로그인 커맨드 (DB 조회를 co_await 하고, 결과는 로비 스레드에서 이어서 처리한다)
+static CommandTask ExecuteLogin(const Command& command, Persistence& persistence)
 {
-    auto session = g_Server->GetSession(sessionId_);
-    if (!session) return;
+    // command 는 큐 슬롯이라 co_await 전에 복사해 둔다
+    const uint32_t sessionId = command.sessionId;
+    std::string username(command.GetText(0));
+    std::string password(command.GetText(1));
+
+    if (g_Server->GetSession(sessionId) == nullptr) co_return;
 
-    int dbId = persistence.AuthenticateUser(username_, password_);
+    PersistenceResult auth = co_await persistence.AuthenticateUser(username, password, Server::GetLobbyQueue());
+    int dbId = auth.dbId;
+
+    // 기다리는 동안 끊겼을 수 있다 (끊긴 세션을 디렉터리에 올리면 그 이름으로 다시 로그인하지 못한다)
+    auto session = g_Server->GetSession(sessionId);
+    if (!session || session->IsDisconnected()) co_return;
 
     if (dbId != -1)
     {
-        if (g_Server->IsUserConnected(username_))
+        // 유저 디렉터리에 먼저 등록한 세션만 통과 (중복 로그인 확인 O(1))
+        UserDirectory& users = g_Server->GetUserDirectory();
+        if (!users.TryRegister(username, sessionId))
         {
-            std::cout << "[Login] Denied duplicate login: " << username_ << std::endl;
-
-            persistence.RemoveActiveUser(username_);
+            std::cout << "[Login] Denied duplicate login: " << username << std::endl;
 
             PacketLoginRes res;
             res.success = false;
             res.playerId = -1;
 
-            session->Send(PacketId::LOGIN_RES, &res, sizeof(res));
-            return;
+            session->SendPacket(res);
+            co_return;
         }
 
-        session->SetName(username_);
+        // 같은 세션이 다른 이름으로 다시 로그인하면 이전 이름은 놓는다
+        std::string previousName = session->GetName();
+        if (previousName != username && users.Unregister(previousName, sessionId))
+            persistence.SyncActiveUser(previousName, false);
+
+        session->SetName(username);
+        session->SetLoggedIn();
+        persistence.SyncActiveUser(username, true);   // Redis active_users 는 DB 스레드에서 따로 맞춘다
 
         PacketLoginRes res;
         res.success = true;
         res.playerId = dbId;
 
-        session->Send(PacketId::LOGIN_RES, &res, sizeof(res));
+        session->SendPacket(res);
 
-        std::cout << "[Login] Success: " << username_ << " (DB_ID: " << dbId << ")" << std::endl;
+        std::cout << "[Login] Success: " << username << " (DB_ID: " << dbId << ")" << std::endl;
     }
     else
     {
-        std::cout << "[Login] Failed (Invalid ID or PW): " << username_ << std::endl;
+        std::cout << "[Login] Failed (Invalid ID or PW): " << username << std::endl;
 
         PacketLoginRes res;
         res.success = false;
         res.playerId = -1;
 
-        session->Send(PacketId::LOGIN_RES, &res, sizeof(res));
+        session->SendPacket(res);
     }
 }
 
-// [3]   Ŀǵ ( )
-void EnterRoomCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// [3] 방 입장 커맨드 (게임 로직). 입장은 바로 하고, 최근 채팅은 Redis 조회를 co_await 한 뒤 이 샤드에서 보낸다.
+static CommandTask ExecuteEnterRoom(const Command& command, RoomManager& roomManager, Persistence& persistence)
 {
-    auto session = g_Server->GetSession(sessionId_);
-    if (session == nullptr) return;
+    const int32_t roomId = command.roomId;
+    const uint32_t sessionId = command.sessionId;
+    auto session = g_Server->GetSession(sessionId);
+    if (session == nullptr) co_return;
 
-    if (session->GetName().empty())
+    if (!session->IsLoggedIn())
     {
         std::cout << "[Warning] Unauthenticated user tried to join room." << std::endl;
-        return;
+        co_return;
     }
 
-    std::cout << "[Logic] Trying to Join Room... (Session: " << sessionId_
-        << ", TargetRoom: " << roomId_ << ")" << std::endl;
+    // 다른 샤드를 거쳐 넘어오는 동안 다른 방으로 입장 요청이 또 왔으면 그 요청이 이긴다
+    if (!session->IsRoomRoute(roomId)) co_return;
 
-    bool success = roomManager.JoinRoom(session, roomId_);
+    bool success = roomManager.JoinRoom(session->shared_from_this(), roomId);
 
     if (success)
     {
-        std::cout << "[Logic] User " << session->GetName() << " joined Room " << roomId_ << std::endl;
+        PersistenceResult history = co_await persistence.GetRecentChats(roomId, Server::GetRoomQueue(roomId));
 
-        std::vector<std::string> history = persistence.GetRecentChats(roomId_);
-        std::cout << history.size() << std::endl;
+        // 기다리는 동안 끊겼거나 다른 방으로 옮겼으면 보내지 않는다
+        session = g_Server->GetSession(sessionId);
+        if (session == nullptr) co_return;
 
-        for (const auto& chatLine : history) {
+        GameRoom* room = roomManager.FindRoomOfPlayer(sessionId);
+        if (room == nullptr || room->GetId() != roomId) co_return;
+
+        for (const auto& chatLine : history.chats) {
             PacketChat packet;
             packet.playerId = 0;
-            std::memset(packet.msg, 0, sizeof(packet.msg));
-
-            size_t copySize = (std::min)(chatLine.size(), sizeof(packet.msg) - 1);
-            std::memcpy(packet.msg, chatLine.c_str(), copySize);
+            packet.msg = chatLine;
 
-            session->Send(PacketId::CHAT, &packet, sizeof(packet));
+            session->SendPacket(packet);
         }
     }
     else
     {
-        std::cout << "[Logic] Failed to join room " << roomId_ << std::endl;
+        std::cout << "[Logic] Failed to join room " << roomId << std::endl;
     }
 }
 
-// [4]   Ŀǵ
-void LeaveRoomCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// [4] 방 퇴장 커맨드 (다른 샤드의 방으로 옮겨 갈 때 이전 방의 샤드로 온다). 내보낸 뒤 새 방의 샤드로 입장을 넘긴다.
+static void ExecuteLeaveRoom(const Command& command, RoomManager& roomManager)
 {
-    roomManager.RemovePlayerFromCurrentRoom(sessionId_);
-    std::cout << "[Logic] Session " << sessionId_ << " left the room." << std::endl;
+    roomManager.RemovePlayerFromCurrentRoom(command.sessionId);
+    std::cout << "[Logic] Session " << command.sessionId << " left the room." << std::endl;
+
+    Server::GetRoomQueue(command.roomId).Push(Command::EnterRoom(command.sessionId, command.roomId));
 }
 
-// [5] ̵ Ŀǵ ( )
-void MoveCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// [5] 이동 커맨드 (샤드 스레드만 방을 건드리므로 잠그지 않는다)
+static void ExecuteMove(const Command& command, RoomManager& roomManager)
 {
-    auto session = g_Server->GetSession(sessionId_);
-    if (session == nullptr) return;
-
-    auto room = session->GetCurrentRoom();
+    GameRoom* room = roomManager.FindRoomOfPlayer(command.sessionId);
     if (room == nullptr) return;
 
-    auto player = room->GetPlayer(sessionId_);
-    if (player)
-    {
-        player->velocity.x = vx_;
-        player->velocity.y = vy_;
-    }
+    room->SetPlayerVelocity(command.sessionId, command.move.vx, command.move.vy);
 }
 
-// [6] ä Ŀǵ (  + DB )
-void ChatCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// [6] 채팅 커맨드 (기존 유지 + DB 저장)
+static void ExecuteChat(const Command& command, RoomManager& roomManager, Persistence& persistence)
 {
-    auto session = g_Server->GetSession(sessionId_);
+    auto session = g_Server->GetSession(command.sessionId);
     if (session == nullptr) return;
 
-    auto room = session->GetCurrentRoom();
+    GameRoom* room = roomManager.FindRoomOfPlayer(command.sessionId);
     if (room == nullptr) return;
 
     std::string senderName = session->GetName();
+    std::string_view message = command.GetText(0);
+
+    room->BroadcastChat(senderName, message);
+
+    persistence.SaveAndCacheChat(room->GetId(), command.sessionId, senderName, message);
+}
+
+// [7] 귓속말 커맨드 (방과 상관없이 유저 디렉터리로 대상 세션을 바로 찾는다)
+static void ExecuteWhisper(const Command& command)
+{
+    const uint32_t sessionId = command.sessionId;
+    const std::string targetName(command.GetText(0));
+    auto session = g_Server->GetSession(sessionId);
+    if (session == nullptr) return;
+
+    UserDirectory& users = g_Server->GetUserDirectory();
+    std::string senderName = session->GetName();
+    if (users.Find(senderName) != sessionId)
+    {
+        std::cout << "[Warning] Unauthenticated user tried to whisper." << std::endl;
+        return;
+    }
+
+    ClientSession* target = nullptr;
+    uint32_t targetId = users.Find(targetName);
+    if (targetId != 0)
+        target = g_Server->GetSession(targetId);
 
-    room->BroadcastChat(senderName, message_);
+    if (target != nullptr)
+    {
+        PacketWhisper packet;
+        packet.sender = senderName;
+        packet.msg = command.GetText(1);
+
+        target->SendPacket(packet);
+    }
+
+    PacketWhisperRes res;
+    res.success = (target != nullptr);
+    res.target = targetName;
 
-    persistence.SaveAndCacheChat(room->GetId(), sessionId_, senderName, message_);
+    session->SendPacket(res);
+}
+
+// 방 번호만 로비에서 정하고, 방은 그 번호를 맡은 샤드가 만든다 (응답도 샤드가 보낸다)
+static void ExecuteCreateRoom(const Command& command)
+{
+    int32_t roomId = RoomManager::AllocateRoomId();
+    Server::GetRoomQueue(roomId).Push(Command::OpenRoom(command.sessionId, roomId, command.GetText(0)));
 }
 
-void CreateRoomCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+static void ExecuteOpenRoom(const Command& command, RoomManager& roomManager)
 {
-    auto session = g_Server->GetSession(sessionId_);
+    auto session = g_Server->GetSession(command.sessionId);
     if (!session) return;
 
-    auto newRoom = roomManager.CreateRoom(title_);
+    auto newRoom = roomManager.CreateRoom(command.roomId, std::string(command.GetText(0)));
     PacketCreateRoomRes res;
     res.success = (newRoom != nullptr);
     res.roomId = (newRoom != nullptr) ? newRoom->GetId() : -1;
 
-    session->Send(PacketId::CREATE_ROOM_RES, &res, sizeof(res));
+    session->SendPacket(res);
 }
 
-void RoomListCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// 샤드마다 잠깐 잠그고 방 목록을 모은다
+static void ExecuteRoomList(const Command& command)
 {
-    auto session = g_Server->GetSession(sessionId_);
-    if (session)
+    auto session = g_Server->GetSession(command.sessionId);
+    if (!session) return;
+
+    std::vector<RoomInfo> infos;
+    for (size_t i = 0; i < g_Server->GetShardCount(); ++i)
+        g_Server->GetShardRoomManager(i).CollectRoomList(infos);
+
+    std::sort(infos.begin(), infos.end(), [](const RoomInfo& a, const RoomInfo& b) { return a.roomId < b.roomId; });
+
+    // RoomInfo::title 은 문자열을 가리키기만 하므로 보낼 때까지 제목을 잡아 둔다
+    std::vector<std::string> titles;
+    titles.reserve(infos.size());
+    for (RoomInfo& info : infos)
     {
-        roomManager.SendRoomList(session);
+        titles.push_back("Game Room " + std::to_string(info.roomId));
+        info.title = titles.back();
     }
+
+    PacketRoomListRes res;
+    res.rooms = infos;
+
+    session->SendPacket(res);
 }
 
-void LogoutCommand::Execute(RoomManager& roomManager, Persistence& persistence)
+// 방에서는 샤드가 뺀다 (끊긴 세션은 다음 스냅샷 때 방에서 나간다)
+static void ExecuteLogout(const Command& command, Persistence& persistence)
 {
+    const std::string username(command.GetText(0));
 
-    std::cout << "[DEBUG] Try to remove user from Redis: [" << username_ << "]" << std::endl;
-    persistence.RemoveActiveUser(username_);
-
-    roomManager.RemovePlayerFromCurrentRoom(sessionId_);
+    // 디렉터리에서 실제로 이 세션이 갖고 있던 이름일 때만 Redis 에서도 뺀다
+    if (g_Server->GetUserDirectory().Unregister(username, command.sessionId))
+        persistence.SyncActiveUser(username, false);
 
-    std::cout << "[Logout] User: " << username_ << " logged out." << std::endl;
+    std::cout << "[Logout] User: " << username << " logged out." << std::endl;
 
-    auto session = g_Server->GetSession(sessionId_);
+    auto session = g_Server->GetSession(command.sessionId);
     if (session)
     {
         session->Disconnect();
     }
-}
\ No newline at end of file
+}
+
+void ExecuteLobbyCommand(const Command& command, Persistence& persistence)
+{
+    switch (command.type)
+    {
+    case CommandType::REGISTER: ExecuteRegister(command, persistence); break;
+    case CommandType::LOGIN: ExecuteLogin(command, persistence); break;
+    case CommandType::WHISPER: ExecuteWhisper(command); break;
+    case CommandType::CREATE_ROOM: ExecuteCreateRoom(command); break;
+    case CommandType::ROOM_LIST: ExecuteRoomList(command); break;
+    case CommandType::LOGOUT: ExecuteLogout(command, persistence); break;
+    case CommandType::RESUME: std::coroutine_handle<>::from_address(command.coroutine).resume(); break;
+
+    // 세션 시간 제한 타이머 (SessionTimers 는 로비 스레드에서만 건드린다)
+    case CommandType::SESSION_OPENED: g_Server->GetSessionTimers().OnSessionOpened(command.sessionId); break;
+    case CommandType::SESSION_CLOSED: g_Server->GetSessionTimers().OnSessionClosed(command.sessionId); break;
+
+    // 방 샤드 커맨드
+    case CommandType::ENTER_ROOM:
+    case CommandType::LEAVE_ROOM:
+    case CommandType::MOVE:
+    case CommandType::CHAT:
+    case CommandType::OPEN_ROOM:
+    case CommandType::NONE: break;
+    }
+}
+
+void ExecuteRoomCommand(const Command& command, RoomManager& roomManager, Persistence& persistence)
+{
+    switch (command.type)
+    {
+    case CommandType::ENTER_ROOM: ExecuteEnterRoom(command, roomManager, persistence); break;
+    case CommandType::LEAVE_ROOM: ExecuteLeaveRoom(command, roomManager); break;
+    case CommandType::MOVE: ExecuteMove(command, roomManager); break;
+    case CommandType::CHAT: ExecuteChat(command, roomManager, persistence); break;
+    case CommandType::OPEN_ROOM: ExecuteOpenRoom(command, roomManager); break;
+    case CommandType::RESUME: std::coroutine_handle<>::from_address(command.coroutine).resume(); break;
+
+    // 로비 커맨드
+    case CommandType::REGISTER:
+    case CommandType::LOGIN:
+    case CommandType::WHISPER:
+    case CommandType::CREATE_ROOM:
+    case CommandType::ROOM_LIST:
+    case CommandType::LOGOUT:
+    case CommandType::SESSION_OPENED:
+    case CommandType::SESSION_CLOSED:
+    case CommandType::NONE: break;
+    }
+}
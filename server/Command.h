@@ -1,139 +1,179 @@
 #pragma once
 
-#include <winsock2.h>
-#include <mutex>
-#include <string>
-#include <vector>
-#include <memory>
-#include <algorithm>
+#include <string_view>
+#include <cstring>
 #include "Utility.h"
+#include "PacketStream.h"
 
 class Persistence;
 class RoomManager;
 
-class ICommand
+enum class CommandType : uint8_t
 {
-public:
-    virtual ~ICommand() = default;
-    virtual void Execute(RoomManager& roomManager, Persistence& persistence) = 0;
+    NONE,
+    REGISTER,         // text: username, password
+    LOGIN,            // text: username, password
+    ENTER_ROOM,       // roomId
+    LEAVE_ROOM,       // roomId: 옮겨 갈 방 (이전 방의 샤드가 내보낸 뒤 그 방의 샤드로 ENTER_ROOM 을 넘긴다)
+    MOVE,             // vx, vy
+    CHAT,             // text: message
+    WHISPER,          // text: target, message
+    CREATE_ROOM,      // text: title
+    ROOM_LIST,
+    LOGOUT,           // text: username
+    SESSION_OPENED,   // 세션 시간 제한 타이머를 건다 / 뗀다 (SessionTimers 는 로비 스레드에서만 건드린다)
+    SESSION_CLOSED,
+    OPEN_ROOM,        // roomId, text: title (CREATE_ROOM 을 받은 로비가 번호를 정해서 방을 맡을 샤드로 넘긴다)
+    RESUME,           // coroutine: DB 작업을 co_await 하던 커맨드 처리 코루틴을 이어서 돌린다 (DB 워커가 넣는다, CommandTask.h)
 };
 
-class RegisterCommand : public ICommand {
-public:
-    RegisterCommand(uint32_t sessionId, std::string username, std::string password)
-        : sessionId_(sessionId), username_(std::move(username)), password_(std::move(password))
-    {
-    }
+// 다음 틱을 기다리지 않고 로직 스레드를 바로 깨우는 커맨드 (응답을 기다리는 요청, 채팅, 입장 / 퇴장).
+// 이동은 어차피 다음 시뮬레이션 틱에 반영되고, 세션 타이머는 급하지 않으므로 깨우지 않는다.
+inline bool IsUrgentCommand(CommandType type)
+{
+    return type != CommandType::MOVE && type != CommandType::SESSION_OPENED
+        && type != CommandType::SESSION_CLOSED && type != CommandType::NONE;
+}
+
+// 로직 스레드 (로비 / 방 샤드) 로 넘기는 커맨드. 힙을 쓰지 않도록 값 그대로 CommandQueue 슬롯에 복사한다.
+// 문자열은 슬롯 안의 text 에 이어 붙인다. 패킷 스키마의 최대 길이 (귓속말 49 + 255) 가 다 들어가는 크기이고,
+// 넘치는 문자열은 UTF-8 글자 경계에서 자른다. GetText 가 돌려주는 뷰는 슬롯이 살아 있는 동안 (Execute 안) 만 유효하다.
+struct Command
+{
+    enum { MAX_TEXTS = 2, TEXT_CAPACITY = 49 + 255 };
 
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
+    CommandType type = CommandType::NONE;
+    uint8_t textCount = 0;
+    uint16_t textLength[MAX_TEXTS] = {};
+    uint32_t sessionId = 0;
 
-private:
-    uint32_t sessionId_;
-    std::string username_;
-    std::string password_;
-};
-
-class LoginCommand : public ICommand {
-public:
-    LoginCommand(uint32_t sessionId, std::string username, std::string password)
-        : sessionId_(sessionId), username_(std::move(username)), password_(std::move(password))
+    union
     {
-    }
+        int32_t roomId;
+        struct { float vx; float vy; } move;
+        void* coroutine;   // std::coroutine_handle<>::address()
+    };
 
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
+    char text[TEXT_CAPACITY];
 
-private:
-    uint32_t sessionId_;
-    std::string username_;
-    std::string password_;
-};
+    Command() : move{ 0.0f, 0.0f } {}
+    Command(CommandType commandType, uint32_t id) : type(commandType), sessionId(id), move{ 0.0f, 0.0f } {}
 
-class EnterRoomCommand : public ICommand {
-public:
-    EnterRoomCommand(uint32_t sessionId, int32_t roomId)
-        : sessionId_(sessionId), roomId_(roomId)
+    std::string_view GetText(int index) const
     {
+        if (index >= textCount) return std::string_view();
+
+        size_t offset = 0;
+        for (int i = 0; i < index; ++i)
+            offset += textLength[i];
+        return std::string_view(text + offset, textLength[index]);
     }
 
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
+    void AddText(std::string_view value)
+    {
+        if (textCount >= MAX_TEXTS) return;
 
-private:
-    uint32_t sessionId_;
-    int32_t roomId_;
-};
+        size_t used = 0;
+        for (int i = 0; i < textCount; ++i)
+            used += textLength[i];
+
+        std::string_view clamped = ClampPacketString(value, TEXT_CAPACITY - used);
+        std::memcpy(text + used, clamped.data(), clamped.size());
+        textLength[textCount++] = static_cast<uint16_t>(clamped.size());
+    }
 
-class LeaveRoomCommand : public ICommand {
-public:
-    LeaveRoomCommand(uint32_t sessionId)
-        : sessionId_(sessionId)
+    static Command Register(uint32_t sessionId, std::string_view username, std::string_view password)
     {
+        Command command(CommandType::REGISTER, sessionId);
+        command.AddText(username);
+        command.AddText(password);
+        return command;
     }
 
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
+    static Command Login(uint32_t sessionId, std::string_view username, std::string_view password)
+    {
+        Command command(CommandType::LOGIN, sessionId);
+        command.AddText(username);
+        command.AddText(password);
+        return command;
+    }
 
-private:
-    uint32_t sessionId_;
-};
+    static Command EnterRoom(uint32_t sessionId, int32_t roomId)
+    {
+        Command command(CommandType::ENTER_ROOM, sessionId);
+        command.roomId = roomId;
+        return command;
+    }
 
-class MoveCommand : public ICommand {
-public:
-    MoveCommand(uint32_t sessionId, float vx, float vy)
-        : sessionId_(sessionId), vx_(vx), vy_(vy)
+    static Command LeaveRoom(uint32_t sessionId, int32_t nextRoomId)
     {
+        Command command(CommandType::LEAVE_ROOM, sessionId);
+        command.roomId = nextRoomId;
+        return command;
     }
 
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
+    static Command Move(uint32_t sessionId, float vx, float vy)
+    {
+        Command command(CommandType::MOVE, sessionId);
+        command.move.vx = vx;
+        command.move.vy = vy;
+        return command;
+    }
 
-private:
-    uint32_t sessionId_;
-    float vx_;
-    float vy_;
-};
+    static Command Chat(uint32_t sessionId, std::string_view message)
+    {
+        Command command(CommandType::CHAT, sessionId);
+        command.AddText(message);
+        return command;
+    }
 
-class ChatCommand : public ICommand {
-public:
-    ChatCommand(uint32_t sessionId, std::string message)
-        : sessionId_(sessionId), message_(std::move(message))
+    static Command Whisper(uint32_t sessionId, std::string_view target, std::string_view message)
     {
+        Command command(CommandType::WHISPER, sessionId);
+        command.AddText(target);
+        command.AddText(message);
+        return command;
     }
 
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
+    static Command CreateRoom(uint32_t sessionId, std::string_view title)
+    {
+        Command command(CommandType::CREATE_ROOM, sessionId);
+        command.AddText(title);
+        return command;
+    }
 
-private:
-    uint32_t sessionId_;
-    std::string message_;
-};
+    static Command RoomList(uint32_t sessionId) { return Command(CommandType::ROOM_LIST, sessionId); }
 
-class CreateRoomCommand : public ICommand {
-public:
-    CreateRoomCommand(uint32_t sessionId, std::string title)
-        : sessionId_(sessionId), title_(title) {
+    static Command Logout(uint32_t sessionId, std::string_view username)
+    {
+        Command command(CommandType::LOGOUT, sessionId);
+        command.AddText(username);
+        return command;
     }
 
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
-
-private:
-    uint32_t sessionId_;
-    std::string title_;
-};
+    static Command SessionOpened(uint32_t sessionId) { return Command(CommandType::SESSION_OPENED, sessionId); }
+    static Command SessionClosed(uint32_t sessionId) { return Command(CommandType::SESSION_CLOSED, sessionId); }
 
-class RoomListCommand : public ICommand {
-public:
-    RoomListCommand(uint32_t sessionId) : sessionId_(sessionId) {}
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
+    static Command Resume(void* coroutine)
+    {
+        Command command(CommandType::RESUME, 0);
+        command.coroutine = coroutine;
+        return command;
+    }
 
-private:
-    uint32_t sessionId_;
+    static Command OpenRoom(uint32_t sessionId, int32_t roomId, std::string_view title)
+    {
+        Command command(CommandType::OPEN_ROOM, sessionId);
+        command.roomId = roomId;
+        command.AddText(title);
+        return command;
+    }
 };
 
-class LogoutCommand : public ICommand
-{
-public:
-    LogoutCommand(uint32_t sessionId, const std::string& username)
-        : sessionId_(sessionId), username_(username) {}
-    void Execute(RoomManager& roomManager, Persistence& persistence) override;
-
-private:
-    uint32_t sessionId_;
-    std::string username_;
-};
\ No newline at end of file
+// 커맨드 종류별 처리.
+// - 로비 스레드: 가입 / 로그인 / 로그아웃, 귓속말, 방 목록, 방 번호 정하기, 세션 타이머
+// - 방 샤드 스레드: 방 입장 / 퇴장, 이동, 채팅, 방 만들기. roomManager 는 그 샤드가 맡은 방들이다.
+// 다른 쪽 커맨드가 들어오면 무시한다 (ClientSession 이 패킷을 받을 때 갈 곳을 정한다).
+// RESUME 은 양쪽 모두 처리한다 (코루틴이 멈출 때 이어서 돌 스레드의 큐를 정해 둔다).
+void ExecuteLobbyCommand(const Command& command, Persistence& persistence);
+void ExecuteRoomCommand(const Command& command, RoomManager& roomManager, Persistence& persistence);
@@ -0,0 +1,131 @@
+#include "CommandQueue.h"
+
+CommandQueue::CommandQueue() = default;
+
+CommandQueue::~CommandQueue()
+{
+    for (std::atomic<Ring*>& lane : rings_)
+        delete lane.load(std::memory_order_relaxed);
+}
+
+CommandQueue::Ring::Ring()
+{
+    for (uint64_t i = 0; i < RING_SIZE; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+bool CommandQueue::Ring::TryPush(const Command& command)
+{
+    uint64_t position = tail.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true)
+    {
+        slot = &slots[position & (RING_SIZE - 1)];
+        int64_t diff = static_cast<int64_t>(slot->sequence.load(std::memory_order_acquire) - position);
+        if (diff == 0)
+        {
+            // 빈 슬롯: 다른 생산자보다 먼저 잡으면 이 자리에 쓴다 (실패하면 position 이 새 tail 로 바뀐다)
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        }
+        else if (diff < 0)
+        {
+            return false;   // 한 바퀴 전 커맨드를 소비 스레드가 아직 처리하지 않았다 (가득 참)
+        }
+        else
+        {
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->command = command;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// 세션 ID 는 아래 비트가 거의 같게 나올 수 있으므로 섞어서 레인을 고른다 (같은 ID 는 항상 같은 레인)
+CommandQueue::Ring& CommandQueue::GetRing(uint32_t sessionId)
+{
+    uint32_t lane = (sessionId * 2654435761u) >> (32 - LANE_BITS);
+
+    Ring* ring = rings_[lane].load(std::memory_order_acquire);
+    if (ring != nullptr) return *ring;
+
+    std::lock_guard<std::mutex> lock(createLock_);
+    ring = rings_[lane].load(std::memory_order_relaxed);
+    if (ring == nullptr)
+    {
+        ring = new Ring();
+        rings_[lane].store(ring, std::memory_order_release);
+    }
+    return *ring;
+}
+
+void CommandQueue::Push(const Command& command)
+{
+    PushToRing(GetRing(command.sessionId), command);
+
+    if (IsUrgentCommand(command.type))
+        WakeConsumer();
+}
+
+void CommandQueue::WakeConsumer()
+{
+    // 카운터를 먼저 올린다. 소비 스레드가 아직 잠들기 전이면 잠들기 전에 카운터를 보고 자지 않는다.
+    urgentPushes_.fetch_add(1);
+    if (!sleeping_.load()) return;
+
+    std::lock_guard<std::mutex> lock(waitLock_);
+    wakeup_.notify_one();
+}
+
+bool CommandQueue::WaitUntil(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(waitLock_);
+    sleeping_.store(true);
+    bool woken = wakeup_.wait_until(lock, deadline, [this] { return urgentPushes_.load() != urgentDrained_; });
+    sleeping_.store(false);
+    return woken;
+}
+
+void CommandQueue::PushToRing(Ring& ring, const Command& command)
+{
+    // 넘침 큐가 남아 있으면 그 뒤에 붙여야 순서가 지켜진다 (소비 스레드가 비우면서 끈다)
+    if (ring.overflowing.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(ring.overflowLock);
+        if (ring.overflowing.load(std::memory_order_relaxed))
+        {
+            ring.overflow.push_back(command);
+            ring.overflowCount++;
+            return;
+        }
+    }
+
+    // 링이 찼으면 소비 스레드가 밀려 있는 것이다. 넘침 큐로 가기 전에 잠깐 양보한다 (소비 스레드 자신이 넣는 경우도 몇 번이면 끝난다).
+    for (int retry = 0; retry <= FULL_RETRIES; ++retry)
+    {
+        if (ring.TryPush(command)) return;
+        if (retry < FULL_RETRIES) std::this_thread::yield();
+    }
+
+    std::lock_guard<std::mutex> lock(ring.overflowLock);
+    ring.overflow.push_back(command);
+    ring.overflowCount++;
+    ring.overflowing.store(true, std::memory_order_release);
+}
+
+CommandQueue::Stats CommandQueue::GetStats() const
+{
+    Stats stats = {};
+    for (const std::atomic<Ring*>& lane : rings_)
+    {
+        Ring* ring = lane.load(std::memory_order_acquire);
+        if (ring == nullptr) continue;
+
+        stats.rings++;
+        stats.pushed += ring->tail.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(ring->overflowLock);
+        stats.overflowed += ring->overflowCount;
+    }
+    return stats;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "Command.h"
+
+// I/O 워커 등 여러 스레드 -> 로직 스레드 (로비 / 방 샤드) 커맨드 큐. 로직 스레드마다 하나씩 있다.
+// - 커맨드는 세션 ID 로 고른 레인 (링) 에 들어간다. 한 세션의 커맨드는 어느 스레드가 넣든 같은 링에 들어가므로
+//   넣은 순서대로 처리된다 (epoll / IOCP 는 한 세션의 다음 수신을 아무 워커나 처리하고, 로비가 넘기는 커맨드도 섞인다).
+//   다른 세션끼리의 순서는 보장하지 않는다.
+// - 링은 잠금 없는 다중 생산자 / 단일 소비자 링이다. 생산자는 tail 을 CAS 로 한 칸 잡아 슬롯에 쓰고
+//   슬롯의 sequence 로 다 썼다고 알린다. 소비 스레드는 잡힌 순서대로, 아직 쓰는 중인 슬롯 앞에서 멈춘다.
+//   한 세션의 다음 커맨드는 앞 커맨드를 다 넣은 뒤에야 만들어지므로 (워커는 처리를 마치고 다시 arm 한다) 잡는 순서가 곧 세션 순서다.
+//   커맨드는 슬롯에 값으로 복사되고 소비 스레드는 슬롯 위에서 바로 처리하므로 힙 할당/해제가 없다.
+//   링은 그 레인에 처음 Push 할 때 한 번만 만든다.
+// - 링이 가득 차면 소비 스레드가 따라올 틈을 잠깐 (FULL_RETRIES 번 yield) 준 뒤, 그래도 차 있으면
+//   그 링 뒤에 붙은 넘침 큐 (잠금 + deque) 에 넣는다. 넘침 큐가 비기 전까지는
+//   같은 링의 다음 커맨드도 넘침 큐로 가므로 세션별 순서는 그대로 지켜진다.
+// - 소비 스레드는 다음 틱까지 WaitUntil 로 잔다. 급한 커맨드 (IsUrgentCommand) 가 들어오면 바로 깨운다.
+//   생산자는 카운터 하나를 올리고, 소비 스레드가 자고 있을 때만 잠금을 잡고 깨운다 (이동 커맨드는 둘 다 하지 않는다).
+class CommandQueue
+{
+public:
+    enum { RING_SIZE = 2048, LANE_BITS = 3, LANE_COUNT = 1 << LANE_BITS, FULL_RETRIES = 16 };
+
+    struct Stats
+    {
+        uint64_t pushed;       // 링에 들어간 커맨드 (링의 tail 합)
+        uint64_t overflowed;   // 링이 가득 차서 넘침 큐로 간 커맨드
+        uint32_t rings;        // 만들어진 링 수 (LANE_COUNT 이하)
+    };
+
+    CommandQueue();
+    ~CommandQueue();
+
+    // 아무 스레드에서나 부른다 (소비 스레드가 처리 중에 자기 큐에 넣어도 된다)
+    void Push(const Command& command);
+
+    // 소비 스레드만 부른다. 링마다 들어온 순서대로 handler(const Command&) 를 부르고 처리한 수를 돌려준다.
+    template <typename Handler>
+    size_t Drain(Handler&& handler);
+
+    // 소비 스레드만 부른다. deadline 까지 자고, 마지막 Drain 뒤로 급한 커맨드가 들어왔으면 바로 (또는 도중에) 깬다.
+    // 급한 커맨드 때문에 깼으면 true.
+    bool WaitUntil(std::chrono::steady_clock::time_point deadline);
+
+    Stats GetStats() const;
+
+private:
+    // sequence: 비어서 pos 번째 커맨드를 기다리면 pos, 그 커맨드를 다 썼으면 pos + 1
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        Command command;
+    };
+
+    struct alignas(64) Ring
+    {
+        alignas(64) uint64_t head = 0;                // 소비 위치 (소비 스레드만 쓴다)
+        alignas(64) std::atomic<uint64_t> tail = 0;   // 생산자가 잡은 위치 (CAS 로 한 칸씩)
+
+        // 넘침 큐. overflowing 이 켜져 있는 동안에는 생산자가 링에 넣지 않는다.
+        std::atomic<bool> overflowing = false;
+        std::mutex overflowLock;
+        std::deque<Command> overflow;
+        uint64_t overflowCount = 0;   // overflowLock 안에서만
+
+        Slot slots[RING_SIZE];
+
+        Ring();
+        bool TryPush(const Command& command);
+
+        template <typename Handler>
+        size_t DrainRing(Handler& handler);
+    };
+
+    std::atomic<Ring*> rings_[LANE_COUNT] = {};
+    std::mutex createLock_;
+
+    // 급한 커맨드 깨우기
+    alignas(64) std::atomic<uint64_t> urgentPushes_ = 0;
+    std::atomic<bool> sleeping_ = false;
+    uint64_t urgentDrained_ = 0;   // 마지막 Drain 을 시작할 때 본 urgentPushes_ (소비 스레드만)
+    std::mutex waitLock_;
+    std::condition_variable wakeup_;
+
+    void WakeConsumer();
+
+    Ring& GetRing(uint32_t sessionId);
+    void PushToRing(Ring& ring, const Command& command);
+
+    template <typename Handler>
+    size_t DrainOne(Ring& ring, Handler& handler);
+};
+
+template <typename Handler>
+size_t CommandQueue::Ring::DrainRing(Handler& handler)
+{
+    size_t count = 0;
+    while (true)
+    {
+        Slot& slot = slots[head & (RING_SIZE - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) break;   // 비었거나 아직 쓰는 중
+
+        handler(static_cast<const Command&>(slot.command));
+
+        // 처리가 끝난 슬롯만 돌려준다 (handler 가 같은 링에 다시 넣을 수 있다)
+        slot.sequence.store(head + RING_SIZE, std::memory_order_release);
+        ++head;
+        ++count;
+    }
+    return count;
+}
+
+template <typename Handler>
+size_t CommandQueue::DrainOne(Ring& ring, Handler& handler)
+{
+    size_t count = ring.DrainRing(handler);
+    if (!ring.overflowing.load(std::memory_order_acquire)) return count;
+
+    // 넘침 큐가 켜진 뒤로는 새 Push 가 링에 들어오지 않는다. 링을 마저 비워야 넘침 큐보다 앞선 커맨드가 먼저 처리된다.
+    // 켜지기 전에 자리를 잡고 아직 쓰는 중인 슬롯이 있으면 그 커맨드가 넘침 큐의 같은 세션 커맨드보다 앞설 수 있으므로
+    // 넘침 큐는 다음 Drain 으로 미룬다.
+    count += ring.DrainRing(handler);
+    if (ring.head != ring.tail.load(std::memory_order_acquire)) return count;
+
+    std::deque<Command> pending;
+    {
+        std::lock_guard<std::mutex> lock(ring.overflowLock);
+        pending.swap(ring.overflow);
+        ring.overflowing.store(false, std::memory_order_release);
+    }
+
+    for (const Command& command : pending)
+        handler(command);
+    return count + pending.size();
+}
+
+template <typename Handler>
+size_t CommandQueue::Drain(Handler&& handler)
+{
+    // 이 뒤에 들어온 급한 커맨드만 다음 WaitUntil 을 깨운다 (이번에 같이 처리될 수도 있지만 한 번 더 비울 뿐이다)
+    urgentDrained_ = urgentPushes_.load();
+
+    size_t count = 0;
+    for (std::atomic<Ring*>& lane : rings_)
+    {
+        if (Ring* ring = lane.load(std::memory_order_acquire))
+            count += DrainOne(*ring, handler);
+    }
+    return count;
+}
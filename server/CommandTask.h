@@ -0,0 +1,21 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+
+// 로직 스레드 커맨드 처리 코루틴. 부르면 바로 돌기 시작하고, 끝나면 프레임을 스스로 지운다 (기다리는 쪽이 없다).
+// - co_await 로 멈추면 그 자리에서 호출 (Execute...Command) 이 돌아오고 로직 스레드는 다음 커맨드 / 틱으로 넘어간다.
+// - 기다리던 작업이 끝나면 RESUME 커맨드가 정해 둔 로직 스레드의 큐로 들어와서 그 스레드에서 이어서 돈다.
+// - 멈춘 동안 큐 슬롯 (const Command&) 은 다른 커맨드로 덮이고 세션은 끊기거나 해제될 수 있다.
+//   co_await 전에 필요한 값은 복사해 두고, co_await 뒤에는 세션을 sessionId 로 다시 찾는다.
+struct CommandTask
+{
+    struct promise_type
+    {
+        CommandTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
@@ -0,0 +1,443 @@
+#include "EpollWorker.h"
+#include "ClientSession.h"
+#include "SessionReclaimer.h"
+#include <iostream>
+#include <algorithm>
+#include <fcntl.h>
+#include <sys/eventfd.h>
+
+bool EpollEngine::Initialize(size_t workerCount)
+{
+    workerCount_ = workerCount;
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) return false;
+
+    // 종료 신호용 eventfd (level-triggered 로 등록해서 모든 워커가 깨어나게 한다)
+    wakeupFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeupFd_ < 0) return false;
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    return epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupFd_, &ev) == 0;
+}
+
+void EpollEngine::Close()
+{
+    StopListen();
+    for (auto& listener : listeners_)
+    {
+        if (listener->fd != INVALID_SOCKET)
+            closesocket(listener->fd);
+    }
+    listeners_.clear();
+
+    if (wakeupFd_ >= 0)
+    {
+        ::close(wakeupFd_);
+        wakeupFd_ = -1;
+    }
+
+    if (epollFd_ >= 0)
+    {
+        ::close(epollFd_);
+        epollFd_ = -1;
+    }
+}
+
+// wakeupFd_ 는 level-triggered 라서 한 번 쓰면 모든 워커가 깨어난다 (워커 수와 상관없다)
+void EpollEngine::WakeupWorkers(size_t)
+{
+    if (wakeupFd_ < 0) return;
+
+    stopping_ = true;
+    uint64_t one = 1;
+    ssize_t ret = ::write(wakeupFd_, &one, sizeof(one));
+    (void)ret;
+}
+
+EpollEngine::EpollContext* EpollEngine::GetContext(ClientSession* session)
+{
+    return static_cast<EpollContext*>(session->GetIOContext());
+}
+
+uint64_t EpollEngine::GetEventKey(ClientSession* session)
+{
+    return (uint64_t)session->GetSessionId() << 1;
+}
+
+// 워커 수만큼 SO_REUSEPORT 리스너를 열어 커널이 연결을 리스너별로 나눠 주게 한다.
+// 리스너마다 EPOLLONESHOT 이라 서로 다른 리스너는 여러 워커가 동시에 accept 한다.
+bool EpollEngine::Listen(uint16_t port, AcceptHandler onAccept)
+{
+    onAccept_ = std::move(onAccept);
+    listening_ = true;
+
+    size_t count = (std::max<size_t>)(1, workerCount_);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto listener = std::make_unique<Listener>();
+        listener->fd = CreateListenSocket(port);
+        if (listener->fd == INVALID_SOCKET) return false;
+
+        epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+        ev.data.u64 = reinterpret_cast<uintptr_t>(listener.get()) | LISTENER_TAG;
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, listener->fd, &ev) < 0)
+        {
+            closesocket(listener->fd);
+            return false;
+        }
+
+        listeners_.push_back(std::move(listener));
+    }
+    return true;
+}
+
+// 리스너 fd 는 처리 중인 워커가 있을 수 있으니 Close 에서 닫는다
+void EpollEngine::StopListen()
+{
+    if (!listening_.exchange(false)) return;
+
+    for (auto& listener : listeners_)
+    {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, listener->fd, nullptr);
+        shutdown(listener->fd, SHUT_RDWR);
+    }
+}
+
+void EpollEngine::HandleAccept(Listener& listener)
+{
+    while (listening_.load())
+    {
+        SOCKET sock = accept4(listener.fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (sock != INVALID_SOCKET)
+        {
+            onAccept_(sock);
+            continue;
+        }
+
+        int err = GetLastSocketError();
+        if (err == EINTR || err == ECONNABORTED) continue;
+        if (err != EAGAIN && err != EWOULDBLOCK)
+            std::cout << "[Error] Accept Failed: " << err << std::endl;
+        break;
+    }
+
+    if (!listening_.load()) return;
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+    ev.data.u64 = reinterpret_cast<uintptr_t>(&listener) | LISTENER_TAG;
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, listener.fd, &ev);
+}
+
+bool EpollEngine::Attach(ClientSession* session)
+{
+    SOCKET fd = session->GetSocket();
+
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+        return false;
+
+    auto ctx = std::make_unique<EpollContext>();
+    ctx->fd = fd;
+    session->SetIOContext(std::move(ctx));
+
+    // 관심 이벤트는 PostRecv / PostSend 에서 채운다
+    epoll_event ev = {};
+    ev.events = EPOLLET | EPOLLONESHOT;
+    ev.data.u64 = GetEventKey(session);
+    return epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+void EpollEngine::RearmLocked(ClientSession* session, EpollContext& ctx)
+{
+    PER_IO_DATA& recvIo = session->GetRecvIoData();
+    PER_IO_DATA& sendIo = session->GetSendIoData();
+
+    epoll_event ev = {};
+    ev.events = EPOLLET | EPOLLONESHOT;
+    if (recvIo.pending) ev.events |= EPOLLIN;
+    if (sendIo.pending) ev.events |= EPOLLOUT;
+    ev.data.u64 = GetEventKey(session);
+
+    ctx.armedEvents = ev.events & (EPOLLIN | EPOLLOUT);
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, ctx.fd, &ev);
+}
+
+bool EpollEngine::PostRecv(ClientSession* session, char* buf, int len)
+{
+    EpollContext* ctx = GetContext(session);
+    if (ctx == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return false;
+
+    PER_IO_DATA& ioData = session->GetRecvIoData();
+    ioData.buf = buf;
+    ioData.len = static_cast<uint32_t>(len);
+    ioData.transferred = 0;
+    ioData.pending = true;
+    ioData.operation = 0;
+
+    // 핸들러 안이라면 핸들러가 끝나면서 다시 arm 한다. 이미 EPOLLIN 으로 arm 되어 있으면 그 이벤트를 기다린다.
+    if (!ctx->inHandler && (ctx->armedEvents & EPOLLIN) == 0)
+        RearmLocked(session, *ctx);
+    return true;
+}
+
+bool EpollEngine::PostSend(ClientSession* session, IoBuffer* bufs, int count)
+{
+    EpollContext* ctx = GetContext(session);
+    if (ctx == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return false;
+
+    PER_IO_DATA& ioData = session->GetSendIoData();
+    ioData.bufs = bufs;
+    ioData.bufCount = count;
+    ioData.pending = true;
+    ioData.operation = 1;
+
+    if (!ctx->inHandler && (ctx->armedEvents & EPOLLOUT) == 0)
+        RearmLocked(session, *ctx);
+    return true;
+}
+
+// close 는 항상 핸들러 종료 시점에 한다. 다른 워커가 같은 fd 를 처리하는 중에 닫으면
+// fd 번호가 재사용되어 엉뚱한 소켓에 recv/send 할 수 있다.
+void EpollEngine::CloseSocket(ClientSession* session)
+{
+    EpollContext* ctx = GetContext(session);
+    if (ctx == nullptr)
+    {
+        closesocket(session->GetSocket());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return;
+    ctx->closed = true;
+
+    // 핸들러 밖(로직 스레드의 백프레셔 끊기, 로그아웃 등)에서 닫을 때는 shutdown 으로 깨워서
+    // 핸들러가 세션 정리(HandleSessionClosed)와 close 를 하게 한다
+    if (!ctx->inHandler)
+    {
+        shutdown(ctx->fd, SHUT_RDWR);
+
+        epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLET | EPOLLONESHOT;
+        ev.data.u64 = GetEventKey(session);
+        ctx->armedEvents = EPOLLIN;
+        epoll_ctl(epollFd_, EPOLL_CTL_MOD, ctx->fd, &ev);
+    }
+}
+
+bool EpollEngine::DoRecv(ClientSession* session, EpollContext& ctx)
+{
+    PER_IO_DATA& ioData = session->GetRecvIoData();
+
+    while (true)
+    {
+        SOCKET fd = INVALID_SOCKET;
+        char* buf = nullptr;
+        uint32_t len = 0;
+        {
+            std::lock_guard<std::mutex> lock(ctx.lock);
+            if (ctx.closed) return false;
+            if (!ioData.pending) return true;
+            fd = ctx.fd;
+            buf = ioData.buf;
+            len = ioData.len;
+
+            // 버퍼 없이 걸어 둔 recv: 읽을 게 생겼으니 세션이 버퍼를 빌려 다시 PostRecv 한다
+            if (buf == nullptr)
+                ioData.pending = false;
+        }
+
+        if (buf == nullptr)
+        {
+            session->OnRecvReady();
+            continue;
+        }
+
+        ssize_t n = ::recv(fd, buf, len, 0);
+
+        if (n > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(ctx.lock);
+                ioData.pending = false;
+            }
+            session->OnRecv(static_cast<uint32_t>(n));
+
+            // 덜 채웠으면 소켓 버퍼를 비운 것. 나머지는 재arm 시점에 다시 확인된다.
+            if (static_cast<uint32_t>(n) < len) return true;
+            continue;
+        }
+
+        if (n == 0) return false;
+
+        int err = GetLastSocketError();
+        if (err == EINTR) continue;
+        if (err == EAGAIN || err == EWOULDBLOCK) return true;
+
+        std::cout << "recv Failed: " << err << std::endl;
+        return false;
+    }
+}
+
+// sendmsg 한 번으로 요청된 버퍼를 모두 내보낸다. 일부만 나가도 나간 만큼 완료를 알리고,
+// 세션이 남은 부분으로 다시 PostSend 하면 같은 루프에서 이어서 보낸다.
+bool EpollEngine::DoSend(ClientSession* session, EpollContext& ctx)
+{
+    PER_IO_DATA& ioData = session->GetSendIoData();
+
+    while (true)
+    {
+        msghdr msg = {};
+        SOCKET fd = INVALID_SOCKET;
+        {
+            std::lock_guard<std::mutex> lock(ctx.lock);
+            if (ctx.closed) return false;
+            if (!ioData.pending) return true;
+            fd = ctx.fd;
+            msg.msg_iov = ioData.bufs;
+            msg.msg_iovlen = (size_t)ioData.bufCount;
+        }
+
+        ssize_t n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+
+        if (n > 0)
+        {
+            {
+                std::lock_guard<std::mutex> lock(ctx.lock);
+                ioData.pending = false;
+            }
+            session->OnSendCompleted(static_cast<uint32_t>(n));
+            continue;
+        }
+
+        int err = GetLastSocketError();
+        if (n < 0 && err == EINTR) continue;
+        if (n < 0 && (err == EAGAIN || err == EWOULDBLOCK)) return true;
+
+        std::cout << "send Failed: " << err << std::endl;
+        return false;
+    }
+}
+
+// 워커가 SessionReclaimer::Guard 안에서 부른다. 핸들러 안에서 세션이 끊겨 테이블에서 빠져도
+// 핸들러가 끝날 때까지는 해제되지 않는다.
+// 이벤트를 꺼낸 뒤 잡기 전에 다른 스레드가 다시 arm 하면 같은 세션의 이벤트가 다른 워커에게도 갈 수 있다.
+// 잡는 것은 ctx->lock 안에서 하고, 이미 다른 워커가 잡고 있으면 이벤트를 넘겨 두고 돌아간다.
+void EpollEngine::HandleEvents(ClientSession* session, uint32_t events)
+{
+    EpollContext* ctx = GetContext(session);
+    if (ctx == nullptr) return;
+
+    {
+        std::lock_guard<std::mutex> lock(ctx->lock);
+        ctx->armedEvents = 0;
+        if (ctx->fd == INVALID_SOCKET) return;   // 이미 닫았다
+        if (ctx->inHandler)
+        {
+            ctx->deferredEvents |= events;
+            return;
+        }
+        ctx->inHandler = true;
+    }
+
+    bool alive = true;
+    while (true)
+    {
+        if (alive && (events & EPOLLERR))
+            alive = false;
+
+        if (alive && (events & (EPOLLIN | EPOLLHUP)))
+            alive = DoRecv(session, *ctx);
+
+        if (alive && (events & EPOLLOUT))
+            alive = DoSend(session, *ctx);
+
+        // 핸들러 밖에서 닫았어도 (CloseSocket) 여기서 정리한다
+        if (alive)
+        {
+            std::lock_guard<std::mutex> lock(ctx->lock);
+            events = ctx->deferredEvents;
+            ctx->deferredEvents = 0;
+            alive = !ctx->closed;
+        }
+
+        // inHandler 상태에서 정리해야 close 가 핸들러 끝으로 미뤄진다
+        if (!alive)
+        {
+            HandleSessionClosed(session);
+            break;
+        }
+        if (events == 0) break;
+    }
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    ctx->inHandler = false;
+    ctx->deferredEvents = 0;
+
+    if (ctx->closed)
+    {
+        if (ctx->fd != INVALID_SOCKET)
+        {
+            closesocket(ctx->fd);
+            ctx->fd = INVALID_SOCKET;
+        }
+        return;
+    }
+
+    RearmLocked(session, *ctx);
+}
+
+void EpollEngine::RunWorker()
+{
+    epoll_event events[MAX_EVENTS];
+
+    while (true)
+    {
+        int count = epoll_wait(epollFd_, events, MAX_EVENTS, -1);
+
+        if (count < 0)
+        {
+            if (GetLastSocketError() == EINTR) continue;
+            std::cout << "[Worker] epoll_wait Failed: " << GetLastSocketError() << std::endl;
+            break;
+        }
+
+        SessionReclaimer::Guard guard;
+
+        for (int i = 0; i < count; ++i)
+        {
+            uint64_t data = events[i].data.u64;
+            if (data & LISTENER_TAG)
+            {
+                HandleAccept(*reinterpret_cast<Listener*>(data & ~(uint64_t)LISTENER_TAG));
+                continue;
+            }
+
+            if (data == 0)
+            {
+                if (stopping_.load())
+                {
+                    std::cout << "[Worker] Thread Exiting..." << std::endl;
+                    return;
+                }
+                continue;
+            }
+
+            // 이미 끊겨 테이블에서 빠진 세션의 이벤트면 nullptr (그 세션의 fd 는 끊은 핸들러가 닫는다)
+            ClientSession* pSession = FindSession((uint32_t)(data >> 1));
+            if (pSession == nullptr) continue;
+
+            HandleEvents(pSession, events[i].events);
+        }
+    }
+}
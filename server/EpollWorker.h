@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <sys/epoll.h>
+#include "IOEngine.h"
+
+// epoll 기반 I/O 엔진 (Linux).
+// EPOLLET | EPOLLONESHOT 으로 한 세션의 이벤트는 항상 하나의 워커만 처리하고,
+// 처리가 끝나면 남은 recv/send 요청에 맞춰 다시 arm 한다.
+// 핸들러 밖 (로직 스레드의 PostSend / CloseSocket) 에서 다시 arm 한 것과 이미 꺼낸 이벤트가 겹쳐
+// 두 워커가 같은 세션을 잡으면, 나중 워커는 이벤트만 남기고 돌아가고 먼저 잡은 워커가 이어서 처리한다.
+// 이벤트에는 세션 포인터 대신 세션 ID 를 실어, 이미 끊겨 해제된 세션의 늦은 이벤트는 조회에서 걸러진다.
+class EpollEngine : public IOEngine
+{
+public:
+    const char* GetName() const override { return "epoll"; }
+
+    bool Initialize(size_t workerCount) override;
+    void Close() override;
+
+    void RunWorker() override;
+    void WakeupWorkers(size_t workerCount) override;
+
+    bool Listen(uint16_t port, AcceptHandler onAccept) override;
+    void StopListen() override;
+
+    bool Attach(ClientSession* session) override;
+    bool PostRecv(ClientSession* session, char* buf, int len) override;
+    bool PostSend(ClientSession* session, IoBuffer* bufs, int count) override;
+    void CloseSocket(ClientSession* session) override;
+    size_t GetSessionContextSize() const override { return sizeof(EpollContext); }
+
+private:
+    struct EpollContext : public IOContext
+    {
+        std::mutex lock;
+        SOCKET fd = INVALID_SOCKET;
+        bool inHandler = false;         // 워커 하나가 이 세션을 잡고 있다
+        uint32_t armedEvents = 0;       // 마지막으로 arm 한 EPOLLIN / EPOLLOUT (이벤트를 꺼내면 0)
+        uint32_t deferredEvents = 0;    // 잡고 있는 워커가 이어서 처리할 이벤트
+        bool closed = false;
+    };
+
+    // SO_REUSEPORT 리스너 하나. epoll_event.data 에는 주소에 LISTENER_TAG 를 더해 세션(ID << 1)과 구분한다.
+    struct Listener
+    {
+        SOCKET fd = INVALID_SOCKET;
+    };
+
+    enum { MAX_EVENTS = 32 };
+    static constexpr uintptr_t LISTENER_TAG = 1;
+
+    int epollFd_ = -1;
+    int wakeupFd_ = -1;
+    size_t workerCount_ = 0;
+    std::atomic<bool> stopping_ = false;
+
+    std::vector<std::unique_ptr<Listener>> listeners_;
+    std::atomic<bool> listening_ = false;
+
+    static EpollContext* GetContext(ClientSession* session);
+    static uint64_t GetEventKey(ClientSession* session);
+
+    void HandleAccept(Listener& listener);
+
+    void HandleEvents(ClientSession* session, uint32_t events);
+    bool DoRecv(ClientSession* session, EpollContext& ctx);
+    bool DoSend(ClientSession* session, EpollContext& ctx);
+    void RearmLocked(ClientSession* session, EpollContext& ctx);
+};
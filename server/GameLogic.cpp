@@ -1,41 +1,92 @@
 #include "GameLogic.h"
+#include "SessionReclaimer.h"
 
-GameLogic::GameLogic(LockFreeQueue<std::unique_ptr<ICommand>>& inputQueue, RoomManager& roomManager, Persistence& persistence)
+SimulationConfig GameLogic::s_config;
+
+GameLogic::GameLogic(CommandQueue& inputQueue, RoomManager& roomManager, Persistence& persistence)
     : inputQueue_(inputQueue),
     roomManager_(roomManager),
     persistence_(persistence)
 {
-    running_ = true;
 }
 
 void GameLogic::Run() {
-    const std::chrono::milliseconds fixedTickDuration(16);
-    auto nextTick = std::chrono::steady_clock::now();
+    using Clock = std::chrono::steady_clock;
+    const std::chrono::nanoseconds fixedTickDuration(1000000000LL / GetTickHz());
+    const float fixedDeltaTime = 1.0f / GetTickHz();
+    const uint32_t maxCatchUpTicks = s_config.maxCatchUpTicks > 0 ? s_config.maxCatchUpTicks : 1;
+
+    // 아직 시뮬레이션하지 않은 벽시계 시간. 한 틱만큼 쌓일 때마다 고정 dt 로 한 틱 돈다.
+    auto last = Clock::now();
+    std::chrono::nanoseconds accumulator = fixedTickDuration;   // 첫 틱은 바로
 
     while (running_)
     {
-        ProcessAllInputs();
+        {
+            // 커맨드는 세션을 맨 포인터로 찾아 쓴다. 틱 동안은 끊긴 세션도 해제되지 않는다.
+            SessionReclaimer::Guard guard;
+
+            ProcessAllInputs();
+
+            auto now = Clock::now();
+            accumulator += now - last;
+            last = now;
+
+            if (accumulator >= fixedTickDuration)
+            {
+                tickStats_.lateness.Record(std::chrono::duration_cast<std::chrono::microseconds>(accumulator - fixedTickDuration).count());
+
+                uint32_t ran = 0;
+                while (accumulator >= fixedTickDuration && ran < maxCatchUpTicks)
+                {
+                    auto workStart = Clock::now();
+                    GameLogicUpdate(fixedDeltaTime);
+                    auto work = Clock::now() - workStart;
+
+                    tickStats_.work.Record(std::chrono::duration_cast<std::chrono::microseconds>(work).count());
+                    if (work > fixedTickDuration)
+                        tickStats_.overruns++;
+
+                    // 세션 해제 (SessionReclaimer::Collect) 는 로비가 돌린다. 샤드는 틱마다 Guard 를 놓기만 하면 된다.
+                    currentTick_++;
+                    accumulator -= fixedTickDuration;
+                    ran++;
+                }
 
-        GameLogicUpdate(std::chrono::duration<float>(fixedTickDuration).count());
+                tickStats_.ticks += ran;
+                tickStats_.catchUpTicks += ran - 1;
 
-        currentTick_++;
+                // 한도만큼 돌고도 밀려 있으면 나머지는 버린다 (계속 따라잡으려다 더 밀리지 않게)
+                if (accumulator >= fixedTickDuration)
+                {
+                    tickStats_.droppedTicks += static_cast<uint64_t>(accumulator / fixedTickDuration);
+                    accumulator %= fixedTickDuration;
+                }
 
-        nextTick += fixedTickDuration;
-        std::this_thread::sleep_until(nextTick);
+                // 틱에 걸린 시간도 다음 틱까지의 시간에 넣는다
+                now = Clock::now();
+                accumulator += now - last;
+                last = now;
+            }
+        }
+
+        // 다음 틱까지 잔다. 그 사이 급한 커맨드가 오면 깨어나 커맨드만 처리한다 (Guard 는 놓고 잔다).
+        if (accumulator < fixedTickDuration && inputQueue_.WaitUntil(last + (fixedTickDuration - accumulator)))
+            tickStats_.wakeups++;
     }
+
+    // 정지 전에 들어온 커맨드 (DB 워커가 넣은 RESUME 포함) 를 마저 처리한다. 남겨 두면 멈춘 코루틴 프레임이 풀리지 않는다.
+    SessionReclaimer::Guard guard;
+    ProcessAllInputs();
 }
 
 void GameLogic::GameLogicUpdate(float fixedDeltaTime) {
     roomManager_.UpdateAllRooms(fixedDeltaTime, currentTick_);
 }
 
+// 커맨드는 큐 슬롯 위에서 바로 처리한다 (복사/해제 없음)
 void GameLogic::ProcessAllInputs() {
-    std::unique_ptr<ICommand> command;
-
-    while (inputQueue_.Pop(command))
-    {
-        if (command) {
-            command->Execute(roomManager_, persistence_);
-        }
-    }
+    inputQueue_.Drain([this](const Command& command) {
+        ExecuteRoomCommand(command, roomManager_, persistence_);
+    });
 }
\ No newline at end of file
@@ -1,33 +1,63 @@
 #pragma once
 
+#include <atomic>
 #include <thread>
 #include <chrono>
 #include <memory>
 #include "Utility.h"
 #include "RoomManager.h"
 #include "Persistence.h"
-#include "Command.h"
-#include "LockFreeQueue.h"
+#include "CommandQueue.h"
+#include "LatencyHistogram.h"
 
+// 로직 스레드 틱 속도 (방 샤드와 로비가 같이 쓴다). 시뮬레이션은 고정 dt (1 / tickHz) 로 돌고, 스냅샷은 이 틱 위에서 따로 정한 간격으로 나간다 (SnapshotRateConfig).
+struct SimulationConfig
+{
+    uint32_t tickHz = 60;
+    uint32_t maxCatchUpTicks = 5;   // 늦었을 때 한 번에 따라잡는 최대 틱 수. 그보다 밀린 시간은 버린다 (시뮬레이션 시간이 벽시계보다 늦어진다)
+};
+
+// 샤드 틱 통계 (샤드 스레드가 쓰고 콘솔이 읽는다)
+struct TickStats
+{
+    LatencyHistogram work;       // 틱 하나 (시뮬레이션 + 스냅샷) 에 걸린 시간
+    LatencyHistogram lateness;   // 틱이 예정 시각보다 늦게 시작한 정도
+    std::atomic<uint64_t> ticks = 0;
+    std::atomic<uint64_t> overruns = 0;       // 한 틱이 틱 간격보다 오래 걸린 횟수
+    std::atomic<uint64_t> catchUpTicks = 0;   // 밀려서 한 번에 이어서 돌린 틱 수 (첫 틱 제외)
+    std::atomic<uint64_t> droppedTicks = 0;   // 따라잡기 한도를 넘어 버린 틱 수
+    std::atomic<uint64_t> wakeups = 0;        // 급한 커맨드 때문에 틱 사이에 깬 횟수
+};
+
+// 방 샤드 하나의 로직 스레드. 맡은 방들 (roomManager) 로 온 커맨드를 처리하고 고정 틱으로 시뮬레이션과 스냅샷을 돌린다.
+// 샤드끼리는 아무것도 나누지 않으므로 샤드 수만큼 코어를 더 쓸 수 있다 (방 하나는 여전히 스레드 하나).
+// 틱 사이에 급한 커맨드 (채팅, 입장 / 퇴장) 가 오면 깨어나 커맨드만 처리하고 다시 잔다. 시뮬레이션은 누적 시간으로 고정 dt 만큼씩만 돈다.
 class GameLogic
 {
 public:
-    GameLogic(LockFreeQueue<std::unique_ptr<ICommand>>& inputQueue, RoomManager& roomManager, Persistence& persistence);
+    GameLogic(CommandQueue& inputQueue, RoomManager& roomManager, Persistence& persistence);
+
+    // 서버 시작 전에 설정한다
+    static void SetConfig(const SimulationConfig& config) { s_config = config; }
+    static uint32_t GetTickHz() { return s_config.tickHz > 0 ? s_config.tickHz : 1; }
 
     void Run();
-    void Stop() { running_ = false; }
+    void Stop() { running_.store(false); }
+
+    const TickStats& GetTickStats() const { return tickStats_; }
 
 private:
-    bool running_ = true;
+    std::atomic<bool> running_ = true;
 
-    static constexpr float FIXED_DT = 1.0f / 60.0f;
+    static SimulationConfig s_config;
 
-    LockFreeQueue<std::unique_ptr<ICommand>>& inputQueue_;
+    CommandQueue& inputQueue_;
 
     RoomManager& roomManager_;
     Persistence& persistence_;
 
     uint32_t currentTick_ = 0;
+    TickStats tickStats_;
 
     void GameLogicUpdate(float fixedDeltaTime);
     void ProcessAllInputs();
@@ -1,56 +1,129 @@
 #include "GameRoom.h"
 #include "ClientSession.h"
+#include "GameLogic.h"
 #include "NetProtocol.h"
 #include <iostream>
 #include <cstring>
+#include <algorithm>
+
+InterestConfig GameRoom::s_interest;
+SnapshotRateConfig GameRoom::s_snapshotRate;
+SnapshotRateStats GameRoom::s_snapshotRateStats;
+
+namespace
+{
+    // hz 를 넘지 않는 가장 짧은 틱 간격
+    uint32_t IntervalForHz(uint32_t hz)
+    {
+        uint32_t tickHz = GameLogic::GetTickHz();
+        if (hz == 0) hz = 1;
+        return (std::max)(1u, (tickHz + hz - 1) / hz);
+    }
+}
 
 GameRoom::GameRoom(int id, const std::string& name)
-    : id_(id), name_(name)
+    : id_(id), name_(name), snapshotInterval_(IntervalForHz(s_snapshotRate.roomHz)),
+    grid_(s_interest.viewRadius + s_interest.leaveMargin)
 {
 }
 
-int GameRoom::GetPlayerCount() {
-    std::lock_guard<std::mutex> lock(roomMutex_);
+void GameRoom::SetSnapshotRate(uint32_t hz)
+{
+    snapshotInterval_ = IntervalForHz(hz);
+    for (auto& pair : sessions_)
+    {
+        Member& member = pair.second;
+        member.interval = snapshotInterval_;
+        member.healthySinceMs = 0;
+        member.session->SetSnapshotRate(member.interval, member.rttMs);
+    }
+
+    std::cout << "[Room] Room " << id_ << " snapshot interval " << snapshotInterval_ << " ticks" << std::endl;
+}
+
+GameRoom::SnapshotRateSummary GameRoom::GetSnapshotRateSummary()
+{
+    SnapshotRateSummary summary = { sessions_.size(), snapshotInterval_, 0, 0, 0, -1, -1 };
+    int64_t rttSum = 0;
+    size_t rttCount = 0;
+    for (auto& pair : sessions_)
+    {
+        const Member& member = pair.second;
+        if (summary.fastestInterval == 0 || member.interval < summary.fastestInterval) summary.fastestInterval = member.interval;
+        summary.slowestInterval = (std::max)(summary.slowestInterval, member.interval);
+        if (member.interval > snapshotInterval_) summary.slowedSessions++;
+        if (member.rttMs >= 0)
+        {
+            rttSum += member.rttMs;
+            rttCount++;
+            summary.maxRttMs = (std::max)(summary.maxRttMs, member.rttMs);
+        }
+    }
+    if (rttCount > 0) summary.averageRttMs = static_cast<int32_t>(rttSum / rttCount);
+    return summary;
+}
 
-    return static_cast<int>(players_.size());
+int GameRoom::GetPlayerCount() {
+    return static_cast<int>(players_.Size());
 }
 
 void GameRoom::Update(float fixedDeltaTime)
 {
-    std::lock_guard<std::mutex> lock(roomMutex_);
+    // 위치 / 속도 열 전체를 한 번에 적분하고, 칸이 바뀐 플레이어만 격자에서 옮긴다
+    players_.Integrate(fixedDeltaTime);
+
+    uint64_t* cells = players_.Cells();
+    for (uint32_t index = 0; index < players_.Size(); ++index)
+    {
+        Vector2 position = players_.GetPosition(index);
+        uint64_t cell = grid_.CellKey(position);
+        if (cell == cells[index]) continue;
 
-    for (auto& pair : players_) {
-        auto& player = pair.second;
-        player->ApplyMovement(fixedDeltaTime);
+        cells[index] = cell;
+        grid_.Move(index, position);
     }
 }
 
-void GameRoom::AddPlayer(std::shared_ptr<PlayerState> player, std::shared_ptr<ClientSession> session)
+void GameRoom::AddPlayer(std::shared_ptr<ClientSession> session)
 {
-    std::lock_guard<std::mutex> lock(roomMutex_);
-    players_[player->sessionId] = player;
-    sessions_[player->sessionId] = session;
+    const uint32_t sessionId = session->GetSessionId();
+    const Vector2 spawn = { 0.0f, 0.0f };
+    uint32_t index = players_.Add(sessionId, spawn, grid_.CellKey(spawn));
+    grid_.Insert(index, spawn);
 
-    std::cout << "Session " << player->sessionId << " joined Room " << id_ << std::endl;
+    Member& member = sessions_[sessionId];
+    member = Member();
+    member.session = session;
+    member.interval = snapshotInterval_;
+    session->SetSnapshotRate(member.interval, member.rttMs);
+
+    std::cout << "Session " << sessionId << " joined Room " << id_ << std::endl;
 }
 
 void GameRoom::RemovePlayer(uint32_t sessionId)
 {
-    std::lock_guard<std::mutex> lock(roomMutex_);
-
-    auto it = players_.find(sessionId);
-    if (it != players_.end())
+    uint32_t index = PlayerTable::NONE;
+    uint32_t movedFrom = PlayerTable::NONE;
+    bool removed = players_.Remove(sessionId, index, movedFrom);
+    if (removed)
     {
         PacketLeaveRoom leavePacket;
         leavePacket.playerId = sessionId;
 
-        BroadcastLocked(PacketId::LEAVE_ROOM, leavePacket, sessionId);
+        BroadcastPacket(leavePacket, sessionId);
+
+        // 격자는 자리 번호로 들고 있으므로 빈자리로 옮겨 온 플레이어도 다시 넣는다
+        grid_.Remove(index);
+        if (movedFrom != PlayerTable::NONE)
+        {
+            grid_.Remove(movedFrom);
+            grid_.Insert(index, players_.GetPosition(index));
+        }
     }
 
-    size_t removedCount = players_.erase(sessionId);
     sessions_.erase(sessionId);
 
-    if (removedCount == 0)
+    if (!removed)
     {
         std::cout << "[Error] Player " << sessionId << " Not Found" << std::endl;
     }
@@ -60,67 +133,209 @@ void GameRoom::RemovePlayer(uint32_t sessionId)
     }
 }
 
-void GameRoom::BroadcastStateSnapshot(uint32_t serverTick)
+void GameRoom::BroadcastStateSnapshot(uint32_t serverTick, std::vector<uint32_t>& disconnected)
 {
-    std::lock_guard<std::mutex> lock(roomMutex_);
-
     if (sessions_.empty()) return;
 
-    struct PlayerPosData {
-        uint32_t id;
-        float x;
-        float y;
-    };
+    int64_t nowMs = GetMonotonicMs();
+
+    // 세션마다 자기 간격이 된 틱에만 시야 안의 플레이어로 프레임을 만들고, 마지막 ACK 한 프레임을 기준으로 델타를 보낸다
+    for (auto& pair : sessions_)
+    {
+        uint32_t index = players_.Find(pair.first);
+        if (index == PlayerTable::NONE) continue;
 
-    size_t count = players_.size();
-    size_t dataSize = sizeof(uint32_t) + (count * sizeof(PlayerPosData)); // Count + Data
+        Member& member = pair.second;
+
+        // 끊긴 세션은 RoomManager 가 방에서 뺀다 (로그아웃이나 끊김은 샤드를 거치지 않는다)
+        if (member.session->IsDisconnected())
+        {
+            disconnected.push_back(pair.first);
+            continue;
+        }
+
+        MeasureRtt(member, nowMs);   // ACK 는 보내지 않는 틱에도 확인한다 (RTT 오차는 한 틱 이내)
+        if (serverTick < member.nextSnapshotTick) continue;
+
+        AdaptSnapshotRate(member, nowMs);
+        member.nextSnapshotTick = serverTick + member.interval;
+
+        // 스냅샷 번호는 샤드 틱이 아니라 세션 번호를 쓴다. 다른 샤드의 방으로 옮겨도 번호가 이어진다.
+        uint32_t seq = member.session->NextSnapshotSeq();
+        const SnapshotFrame* previous = member.history.Find(member.lastSnapshotSeq);
+        SnapshotFrame& frame = member.history.BeginFrame(seq);
+        if (previous == &frame) previous = nullptr;   // 한 바퀴 (HISTORY_SIZE 개) 만에 다시 만들면 같은 칸이다
+
+        CollectVisible(players_.GetPosition(index), previous, frame);
+        member.lastSnapshotSeq = seq;
+        frame.sentMs = nowMs;
+
+        // 프레임이 아직 남아 있어야 기준으로 쓴다 (아니면 전체)
+        uint32_t ack = member.session->GetSnapshotAck();
+        const SnapshotFrame* base = ack < seq ? member.history.Find(ack) : nullptr;
+
+        member.session->Send(BuildSnapshot(frame, base));
+        s_snapshotRateStats.sent.fetch_add(1, std::memory_order_relaxed);
+    }
+}
 
-    std::string sendBuffer;
-    sendBuffer.resize(dataSize);
-    char* ptr = &sendBuffer[0];
+void GameRoom::MeasureRtt(Member& member, int64_t nowMs)
+{
+    uint32_t ack = member.session->GetSnapshotAck();
+    if (ack == member.lastAck) return;
+    member.lastAck = ack;
+    member.lastAckMs = nowMs;
 
-    uint32_t count32 = static_cast<uint32_t>(count);
-    std::memcpy(ptr, &count32, sizeof(uint32_t));
-    ptr += sizeof(uint32_t);
+    // 이미 밀려난 프레임 (아주 늦은 ACK) 은 보낸 시각을 모르므로 재지 않는다
+    const SnapshotFrame* acked = member.history.Find(ack);
+    if (acked == nullptr || acked->sentMs == 0) return;
 
+    int32_t sample = static_cast<int32_t>(nowMs - acked->sentMs);
+    member.rttMs = member.rttMs < 0 ? sample : (member.rttMs * 7 + sample) / 8;
+}
 
-    for (auto& pair : players_) {
-        auto& p = pair.second;
+void GameRoom::AdaptSnapshotRate(Member& member, int64_t nowMs)
+{
+    const SnapshotRateConfig& config = s_snapshotRate;
+    const uint32_t slowestInterval = (std::max)(snapshotInterval_, IntervalForHz(config.minHz));
 
-        PlayerPosData data;
-        data.id = p->sessionId;
-        data.x = p->position.x;
-        data.y = p->position.y;
+    ClientSession& session = *member.session;
+    uint32_t queuedBytes = session.GetQueuedBytes();
+    bool congested = session.IsCongested();
 
-        std::memcpy(ptr, &data, sizeof(PlayerPosData));
-        ptr += sizeof(PlayerPosData);
+    // 지금 간격이면 ACK 가 한 간격 안에 바뀌어야 한다. 그보다 늦은 만큼은 RTT 가 적어도 그만큼이다.
+    int64_t latencyMs = member.rttMs;
+    if (member.lastAckMs != 0)
+    {
+        int64_t intervalMs = static_cast<int64_t>(member.interval) * 1000 / GameLogic::GetTickHz();
+        latencyMs = (std::max)(latencyMs, nowMs - member.lastAckMs - intervalMs);
     }
 
-    for (auto& pair : sessions_) {
-        pair.second->Send(PacketId::SNAPSHOT, sendBuffer);
+    bool slow = congested || queuedBytes >= config.slowQueueBytes || latencyMs >= config.slowRttMs;
+    bool healthy = !congested && queuedBytes < config.slowQueueBytes / 2 && latencyMs < config.slowRttMs * 3 / 4;
+
+    if (slow)
+    {
+        member.healthySinceMs = 0;
+        if (member.interval < slowestInterval && nowMs - member.lastSlowdownMs >= config.slowdownHoldMs)
+        {
+            member.interval = (std::min)(slowestInterval, member.interval * 2);
+            member.lastSlowdownMs = nowMs;
+            s_snapshotRateStats.slowdowns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    else if (healthy && member.interval > snapshotInterval_)
+    {
+        if (member.healthySinceMs == 0)
+        {
+            member.healthySinceMs = nowMs;
+        }
+        else if (nowMs - member.healthySinceMs >= config.recoverMs)
+        {
+            uint32_t step = (std::max)(1u, member.interval / 4);
+            member.interval = (std::max)(snapshotInterval_, member.interval - step);
+            member.healthySinceMs = nowMs;
+            s_snapshotRateStats.speedups.fetch_add(1, std::memory_order_relaxed);
+        }
     }
+    else if (!healthy)
+    {
+        member.healthySinceMs = 0;
+    }
+
+    session.SetSnapshotRate(member.interval, member.rttMs);
+}
+
+void GameRoom::CollectVisible(Vector2 center, const SnapshotFrame* previous, SnapshotFrame& frame)
+{
+    const float enterRadiusSq = s_interest.viewRadius * s_interest.viewRadius;
+    const float leaveRadius = s_interest.viewRadius + s_interest.leaveMargin;
+    const float leaveRadiusSq = leaveRadius * leaveRadius;
+
+    // 격자에서는 주변 칸의 자리 번호만 받고, 위치는 PlayerTable 의 열에서 바로 읽는다
+    const uint32_t* ids = players_.Ids();
+    const float* positionX = players_.PositionX();
+    const float* positionY = players_.PositionY();
+
+    grid_.QueryCells(center, leaveRadius, [&](uint32_t index) {
+        float dx = positionX[index] - center.x;
+        float dy = positionY[index] - center.y;
+        float distanceSq = dx * dx + dy * dy;
+        if (!(distanceSq <= leaveRadiusSq)) return;   // NaN 도 뺀다
+        if (distanceSq > enterRadiusSq)
+        {
+            // 시야 반경과 나가는 반경 사이: 지난 틱에 보이던 플레이어만 남긴다
+            if (previous == nullptr) return;
+            auto it = std::lower_bound(previous->entities.begin(), previous->entities.end(), ids[index],
+                [](const SnapshotEntity& entity, uint32_t id) { return entity.id < id; });
+            if (it == previous->entities.end() || it->id != ids[index]) return;
+        }
+
+        frame.entities.push_back(SnapshotEntity{ ids[index],
+            SnapshotCodec::Quantize(positionX[index]), SnapshotCodec::Quantize(positionY[index]) });
+    });
+
+    std::sort(frame.entities.begin(), frame.entities.end(),
+        [](const SnapshotEntity& a, const SnapshotEntity& b) { return a.id < b.id; });
 }
 
+SendBufferRef GameRoom::BuildSnapshot(SnapshotFrame& frame, const SnapshotFrame* base)
+{
+    static const std::vector<SnapshotEntity> emptyFrame;
+
+    snapshotEntries_.resize(PacketSnapshot::MAX_SIZE - PacketSnapshot::MIN_SIZE);
+    size_t size = 0;
+
+    // 델타가 최대 크기를 넘으면 전체로 보낸다.
+    // 전체도 넘치면 앞쪽 플레이어만 보내고 이 프레임은 기준으로 쓰지 않는다 (다음 틱도 전체).
+    if (base == nullptr || !SnapshotCodec::Encode(base->entities, frame.entities, snapshotEntries_.data(), snapshotEntries_.size(), size))
+    {
+        base = nullptr;
+        if (!SnapshotCodec::Encode(emptyFrame, frame.entities, snapshotEntries_.data(), snapshotEntries_.size(), size))
+            frame.truncated = true;
+    }
+
+    PacketSnapshot snapshot;
+    snapshot.tick = frame.tick;
+    snapshot.baseTick = base != nullptr ? base->tick : 0;
+    snapshot.entries = std::string_view(snapshotEntries_.data(), size);
+    return SendBuffer::Create(snapshot);
+}
 
-void GameRoom::BroadcastChat(const std::string& senderName, const std::string& message)
+void GameRoom::Broadcast(const SendBufferRef& buffer, uint32_t excludeId)
 {
-    std::lock_guard<std::mutex> lock(roomMutex_);
+    for (auto& pair : sessions_)
+    {
+        if (pair.first == excludeId) continue;
+        pair.second.session->Send(buffer);
+    }
+}
+
 
-    std::string finalMsg = senderName + ": " + message;
-    if (finalMsg.size() >= 256) finalMsg = finalMsg.substr(0, 255);
+void GameRoom::BroadcastChat(std::string_view senderName, std::string_view message)
+{
+    // "이름: 메시지" 를 스택 버퍼에 붙인다 (힙 할당 없음). 255 바이트를 넘으면 코덱이 글자 경계에서 자른다.
+    char line[512];
+    size_t length = 0;
+    for (std::string_view part : { senderName, std::string_view(": "), message })
+    {
+        size_t copy = std::min(part.size(), sizeof(line) - length);
+        std::memcpy(line + length, part.data(), copy);
+        length += copy;
+    }
 
     PacketChat packetData;
     packetData.playerId = 0;
-    std::memset(packetData.msg, 0, sizeof(packetData.msg));
-    std::memcpy(packetData.msg, finalMsg.c_str(), finalMsg.size());
+    packetData.msg = std::string_view(line, length);
 
-    BroadcastLocked(PacketId::CHAT, packetData);
+    BroadcastPacket(packetData);
 }
 
-std::shared_ptr<PlayerState> GameRoom::GetPlayer(uint32_t sessionId)
+bool GameRoom::SetPlayerVelocity(uint32_t sessionId, float vx, float vy)
 {
-    std::lock_guard<std::mutex> lock(roomMutex_);
-    auto it = players_.find(sessionId);
-    if (it != players_.end()) return it->second;
-    return nullptr;
+    uint32_t index = players_.Find(sessionId);
+    if (index == PlayerTable::NONE) return false;
+
+    players_.SetVelocity(index, vx, vy);
+    return true;
 }
\ No newline at end of file
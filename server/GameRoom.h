@@ -1,51 +1,145 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <vector>
 #include <map>
 #include <memory>
 #include <string>
-#include <mutex>
-#include "PlayerState.h"
+#include <string_view>
+#include "PlayerTable.h"
 // #include "LockFreeQueue.h"
 #include "NetProtocol.h"
+#include "SendBuffer.h"
+#include "SnapshotCodec.h"
+#include "SpatialGrid.h"
 
 class ClientSession;
 
+// 관심 영역: 스냅샷에는 자기 주변 viewRadius 안의 플레이어만 넣는다.
+// 경계에서 들락거리지 않도록, 이미 보이던 플레이어는 leaveMargin 만큼 더 멀어져야 뺀다.
+// 들어오고 나가는 것은 델타 스냅샷에 그대로 드러난다 (새로 보이면 기준에 없던 항목, 안 보이면 빠진 ID).
+struct InterestConfig
+{
+    float viewRadius = 30.0f;
+    float leaveMargin = 3.0f;
+};
+
+// 스냅샷 송신 속도. 시뮬레이션 틱 (SimulationConfig::tickHz) 과 따로 정한다.
+// - 방마다 기본 속도 (roomHz, SetSnapshotRate 로 방별로 바꾼다) 가 있고 세션은 그보다 빨리 받지 않는다.
+// - 세션의 송신 큐나 RTT 가 커지면 그 세션만 간격을 두 배로 늘린다 (minHz 까지).
+//   ACK 가 한 간격보다 더 늦어지고 있으면 (읽기를 멈춘 클라이언트) 그 대기 시간도 RTT 로 본다.
+//   늘린 효과가 보일 시간 (slowdownHoldMs) 이 지나야 다시 늘린다.
+// - 큐와 RTT 가 기준의 절반 / 3/4 아래로 recoverMs 동안 있으면 간격을 1/4 씩 (적어도 한 틱) 줄인다.
+// - 간격은 틱 단위라서 실제 속도는 tickHz / 간격 이다 (60Hz 틱에서 30, 20, 15, 12 ... Hz).
+struct SnapshotRateConfig
+{
+    uint32_t roomHz = 30;
+    uint32_t minHz = 5;
+
+    uint32_t slowQueueBytes = 32 * 1024;
+    uint32_t slowRttMs = 250;
+    uint32_t slowdownHoldMs = 500;
+    uint32_t recoverMs = 1000;
+};
+
+// 스냅샷 송신 통계 (전체 방 합계)
+struct SnapshotRateStats
+{
+    std::atomic<uint64_t> sent = 0;
+    std::atomic<uint64_t> slowdowns = 0;   // 세션 간격을 늘린 횟수
+    std::atomic<uint64_t> speedups = 0;    // 세션 간격을 줄인 횟수
+};
+
+// 방은 자기를 맡은 로직 샤드 스레드만 건드린다 (잠그지 않는다).
+// 다른 스레드가 읽는 GetPlayerCount / GetSnapshotRateSummary 와 SetSnapshotRate 는 RoomManager 의 잠금 안에서만 부른다.
 class GameRoom
 {
 public:
     GameRoom(int id, const std::string& name);
 
+    // 서버 시작 전에 설정한다
+    static void SetInterestConfig(const InterestConfig& config) { s_interest = config; }
+    static void SetSnapshotRateConfig(const SnapshotRateConfig& config) { s_snapshotRate = config; }
+    static SnapshotRateStats& GetSnapshotRateStats() { return s_snapshotRateStats; }
+
+    // 방 스냅샷 속도를 바꾼다. 세션마다 조절하던 간격은 새 속도에서 다시 시작한다.
+    void SetSnapshotRate(uint32_t hz);
+
+    // 통계 출력용 (간격은 틱 단위)
+    struct SnapshotRateSummary
+    {
+        size_t sessions;
+        uint32_t roomInterval;
+        uint32_t fastestInterval;
+        uint32_t slowestInterval;
+        size_t slowedSessions;   // 방 기본보다 느리게 받는 세션
+        int32_t averageRttMs;    // -1: 잰 세션이 없다
+        int32_t maxRttMs;
+    };
+    SnapshotRateSummary GetSnapshotRateSummary();
+    const std::string& GetName() const { return name_; }
+
     int GetId() const { return id_; }
     int GetPlayerCount();
 
     void Update(float fixedDeltaTime);
 
-    void AddPlayer(std::shared_ptr<PlayerState> player, std::shared_ptr<ClientSession> session);
+    void AddPlayer(std::shared_ptr<ClientSession> session);
     void RemovePlayer(uint32_t sessionId);
 
-    void BroadcastStateSnapshot(uint32_t serverTick);
-    void BroadcastChat(const std::string& senderName, const std::string& message);
+    // 방에 없으면 false
+    bool SetPlayerVelocity(uint32_t sessionId, float vx, float vy);
 
-    std::shared_ptr<PlayerState> GetPlayer(uint32_t sessionId);
+    // 끊긴 세션은 보내지 않고 disconnected 에 넣는다 (방에서 빼는 것은 RoomManager)
+    void BroadcastStateSnapshot(uint32_t serverTick, std::vector<uint32_t>& disconnected);
+    void BroadcastChat(std::string_view senderName, std::string_view message);
 
 private:
     int id_;
     std::string name_;
-    std::mutex roomMutex_;
 
-    std::map<uint32_t, std::shared_ptr<PlayerState>> players_;
-    std::map<uint32_t, std::shared_ptr<ClientSession>> sessions_;
+    // 세션마다 자기가 본 프레임 (시야 안의 플레이어) 을 따로 남긴다. ACK 는 이 안에서만 찾으므로
+    // 방에 들어온 뒤 처음 받는 스냅샷은 항상 전체이고, 이전 방의 ACK 는 쓰이지 않는다.
+    struct Member
+    {
+        std::shared_ptr<ClientSession> session;
+        SnapshotHistory history;
+        uint32_t lastSnapshotSeq = 0;    // 마지막으로 보낸 스냅샷 번호 (ClientSession::NextSnapshotSeq)
+
+        // 송신 속도 조절
+        uint32_t interval = 1;           // 스냅샷 간격 (틱)
+        uint32_t nextSnapshotTick = 0;   // 0: 바로 보낸다 (입장 직후)
+        uint32_t lastAck = 0;
+        int32_t rttMs = -1;              // ACK 로 잰 RTT 의 이동 평균 (-1: 아직 모름)
+        int64_t lastAckMs = 0;           // ACK 가 마지막으로 바뀐 시각 (0: ACK 를 보내지 않는 클라이언트)
+        int64_t lastSlowdownMs = 0;
+        int64_t healthySinceMs = 0;      // 0: 지금 멀쩡하지 않다
+    };
+
+    static InterestConfig s_interest;
+    static SnapshotRateConfig s_snapshotRate;
+    static SnapshotRateStats s_snapshotRateStats;
+
+    uint32_t snapshotInterval_;   // 방 기본 스냅샷 간격 (틱)
+
+    PlayerTable players_;                // 위치 / 속도 (SoA)
+    std::map<uint32_t, Member> sessions_;
+
+    SpatialGrid grid_;                   // players_ 의 자리 번호를 칸에 넣는다 (칸이 바뀔 때만 고친다)
+    std::vector<char> snapshotEntries_;  // 인코딩 버퍼 (용량 유지)
+
+    void MeasureRtt(Member& member, int64_t nowMs);
+    void AdaptSnapshotRate(Member& member, int64_t nowMs);
+    void CollectVisible(Vector2 center, const SnapshotFrame* previous, SnapshotFrame& frame);
+    SendBufferRef BuildSnapshot(SnapshotFrame& frame, const SnapshotFrame* base);
+
+    // 패킷은 한 번만 만들고 모든 세션 큐에 같은 버퍼를 넣는다
+    void Broadcast(const SendBufferRef& buffer, uint32_t excludeId = 0);
 
     template<typename T>
-    void BroadcastLocked(PacketId id, const T& packet, uint32_t excludeId = 0)
+    void BroadcastPacket(const T& packet, uint32_t excludeId = 0)
     {
-        std::string serializedData(reinterpret_cast<const char*>(&packet), sizeof(T));
-        for (auto& pair : sessions_)
-        {
-            if (pair.first == excludeId) continue;
-            pair.second->Send(id, serializedData);
-        }
+        Broadcast(SendBuffer::Create(packet), excludeId);
     }
 };
\ No newline at end of file
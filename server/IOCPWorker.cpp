@@ -1,12 +1,235 @@
 #include "IOCPWorker.h"
 #include "ClientSession.h"
 #include <iostream>
-#include "Server.h" 
-extern Server* g_Server;
+#include <algorithm>
 
-DWORD WINAPI IOCPWorkerThread(LPVOID arg)
+bool IOCPEngine::Initialize(size_t workerCount)
+{
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+        return false;
+
+    workerCount_ = workerCount;
+    hIOCP_ = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+    return hIOCP_ != NULL;
+}
+
+void IOCPEngine::Close()
+{
+    StopListen();
+    accepts_.clear();
+
+    if (hIOCP_ != NULL)
+    {
+        CloseHandle(hIOCP_);
+        hIOCP_ = NULL;
+    }
+
+    WSACleanup();
+}
+
+void IOCPEngine::WakeupWorkers(size_t workerCount)
+{
+    if (hIOCP_ == NULL) return;
+
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        PostQueuedCompletionStatus(hIOCP_, 0, 0, NULL);
+    }
+}
+
+bool IOCPEngine::Listen(uint16_t port, AcceptHandler onAccept)
+{
+    onAccept_ = std::move(onAccept);
+
+    listenSock_ = CreateListenSocket(port);
+    if (listenSock_ == INVALID_SOCKET) return false;
+
+    // 리스너도 IOCP 에 붙인다. AcceptEx 완료는 세션과 구분되는 키로 들어온다.
+    if (CreateIoCompletionPort((HANDLE)listenSock_, hIOCP_, GetAcceptKey(), 0) == NULL)
+        return false;
+
+    GUID guid = WSAID_ACCEPTEX;
+    DWORD bytes = 0;
+    if (WSAIoctl(listenSock_, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid),
+        &acceptEx_, sizeof(acceptEx_), &bytes, NULL, NULL) == SOCKET_ERROR)
+    {
+        std::cout << "[Error] AcceptEx Load Failed: " << WSAGetLastError() << std::endl;
+        return false;
+    }
+
+    listening_ = true;
+
+    // 워커마다 여러 건을 미리 걸어 두어 접속 폭주 때도 accept 가 비지 않게 한다
+    size_t count = (std::max<size_t>)(1, workerCount_) * ACCEPTS_PER_WORKER;
+    for (size_t i = 0; i < count; ++i)
+    {
+        accepts_.push_back(std::make_unique<AcceptIoData>());
+        if (!PostAccept(*accepts_.back()))
+            return false;
+    }
+    return true;
+}
+
+// 리스너를 닫으면 걸려 있던 AcceptEx 는 에러로 완료되고 다시 걸리지 않는다
+void IOCPEngine::StopListen()
+{
+    listening_ = false;
+
+    if (listenSock_ != INVALID_SOCKET)
+    {
+        closesocket(listenSock_);
+        listenSock_ = INVALID_SOCKET;
+    }
+}
+
+bool IOCPEngine::PostAccept(AcceptIoData& ioData)
+{
+    ZeroMemory(&ioData.overlapped, sizeof(OVERLAPPED));
+    ioData.sock = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0, WSA_FLAG_OVERLAPPED);
+    if (ioData.sock == INVALID_SOCKET) return false;
+
+    DWORD bytes = 0;
+    const DWORD addrLen = sizeof(SOCKADDR_IN) + 16;
+    if (!acceptEx_(listenSock_, ioData.sock, ioData.addrBuf, 0, addrLen, addrLen, &bytes, &ioData.overlapped))
+    {
+        int err = WSAGetLastError();
+        if (err != ERROR_IO_PENDING)
+        {
+            std::cout << "AcceptEx Failed: " << err << std::endl;
+            closesocket(ioData.sock);
+            ioData.sock = INVALID_SOCKET;
+            return false;
+        }
+    }
+    return true;
+}
+
+void IOCPEngine::OnAcceptCompleted(BOOL ok, AcceptIoData& ioData)
+{
+    SOCKET sock = ioData.sock;
+    ioData.sock = INVALID_SOCKET;
+
+    if (ok && listening_.load())
+    {
+        // AcceptEx 로 받은 소켓은 리스너 속성을 물려받도록 갱신해야 getpeername 등이 동작한다
+        SOCKET listenSock = listenSock_;
+        setsockopt(sock, SOL_SOCKET, SO_UPDATE_ACCEPT_CONTEXT, (char*)&listenSock, sizeof(listenSock));
+        onAccept_(sock);
+    }
+    else
+    {
+        closesocket(sock);
+    }
+
+    if (listening_.load())
+        PostAccept(ioData);
+}
+
+IOCPEngine::IOCPContext* IOCPEngine::GetContext(ClientSession* session)
+{
+    return static_cast<IOCPContext*>(session->GetIOContext());
+}
+
+bool IOCPEngine::Attach(ClientSession* session)
+{
+    session->SetIOContext(std::make_unique<IOCPContext>());
+
+    // IOCP에 클라이언트 소켓 등록
+    return CreateIoCompletionPort(
+        (HANDLE)session->GetSocket(),
+        hIOCP_,
+        (ULONG_PTR)session,
+        0
+    ) != NULL;
+}
+
+bool IOCPEngine::PostRecv(ClientSession* session, char* buf, int len)
+{
+    PER_IO_DATA& ioData = session->GetRecvIoData();
+    DWORD flags = 0;
+    DWORD recvBytes = 0;
+
+    // buf 가 없으면 0바이트 WSARecv: 데이터가 들어오면 버퍼를 잡지 않은 채 완료만 온다
+    ZeroMemory(&ioData.overlapped, sizeof(OVERLAPPED));
+    ioData.wsaBuf.buf = buf;
+    ioData.wsaBuf.len = (ULONG)len;
+    ioData.operation = (buf != nullptr) ? 0 : 2;
+
+    IOCPContext* ctx = GetContext(session);
+    if (ctx == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return false;
+
+    // 완료가 올 때까지 overlapped 가 세션 안에 있으므로 그동안은 세션을 놓지 못하게 한다
+    session->AddIoRef();
+
+    int ret = WSARecv(session->GetSocket(), &ioData.wsaBuf, 1, &recvBytes, &flags, &ioData.overlapped, NULL);
+
+    if (ret == SOCKET_ERROR)
+    {
+        int err = WSAGetLastError();
+        if (err != WSA_IO_PENDING)
+        {
+            std::cout << "WSARecv Failed: " << err << std::endl;
+            session->ReleaseIoRef();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IOCPEngine::PostSend(ClientSession* session, IoBuffer* bufs, int count)
+{
+    PER_IO_DATA& ioData = session->GetSendIoData();
+
+    ZeroMemory(&ioData.overlapped, sizeof(OVERLAPPED));
+    ioData.operation = 1;
+
+    DWORD sendBytes = 0;
+    DWORD flags = 0;
+
+    IOCPContext* ctx = GetContext(session);
+    if (ctx == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return false;
+
+    session->AddIoRef();
+
+    // WSABUF 배열은 호출 시점에 복사되고, 가리키는 버퍼만 완료까지 유지되면 된다
+    if (WSASend(session->GetSocket(), bufs, (DWORD)count, &sendBytes, flags, &ioData.overlapped, NULL) == SOCKET_ERROR)
+    {
+        if (WSAGetLastError() != WSA_IO_PENDING)
+        {
+            session->ReleaseIoRef();
+            return false;
+        }
+    }
+    return true;
+}
+
+// 걸려 있는 overlapped 작업은 에러로 완료되어 워커로 돌아온다.
+// PostRecv / PostSend 와 같은 잠금 아래에서 닫아, 닫힌 뒤로는 이 세션에 WSARecv / WSASend 를 걸지 않는다.
+void IOCPEngine::CloseSocket(ClientSession* session)
+{
+    IOCPContext* ctx = GetContext(session);
+    if (ctx == nullptr)
+    {
+        closesocket(session->GetSocket());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return;
+    ctx->closed = true;
+
+    closesocket(session->GetSocket());
+}
+
+void IOCPEngine::RunWorker()
 {
-    HANDLE hIOCP = (HANDLE)arg;
     DWORD bytesTransferred = 0;
     ULONG_PTR completionKey = 0;
     PER_IO_DATA* pIoData = nullptr;
@@ -14,7 +237,7 @@ DWORD WINAPI IOCPWorkerThread(LPVOID arg)
     while (true)
     {
         BOOL ok = GetQueuedCompletionStatus(
-            hIOCP,
+            hIOCP_,
             &bytesTransferred,
             &completionKey,
             (LPOVERLAPPED*)&pIoData,
@@ -27,28 +250,35 @@ DWORD WINAPI IOCPWorkerThread(LPVOID arg)
             break;
         }
 
-        ClientSession* pSession = reinterpret_cast<ClientSession*>(completionKey);
-
-        if (!ok || bytesTransferred == 0)
+        if (completionKey == GetAcceptKey() && pIoData != nullptr)
         {
-            if (pSession)
-            {
-                pSession->Disconnect();
-
-                if (g_Server)
-                    g_Server->RemoveSession(pSession->GetSessionId());
-            }
+            OnAcceptCompleted(ok, *reinterpret_cast<AcceptIoData*>(pIoData));
             continue;
         }
 
-        if (pIoData->operation == 0)
+        // 이 완료가 잡고 있는 I/O 참조 덕분에 세션이 끊겨 테이블에서 빠졌어도 아직 해제되지 않았다
+        ClientSession* pSession = reinterpret_cast<ClientSession*>(completionKey);
+        if (pSession == nullptr || pIoData == nullptr) continue;
+
+        // 0바이트 recv 는 0바이트로 완료되는 게 정상이다 (끊긴 경우는 이어서 건 실제 recv 가 0 으로 알려 준다)
+        if (!ok || (bytesTransferred == 0 && pIoData->operation != 2))
+        {
+            HandleSessionClosed(pSession);
+        }
+        else if (pIoData->operation == 0)
         {
             pSession->OnRecv(bytesTransferred);
         }
+        else if (pIoData->operation == 2)
+        {
+            pSession->OnRecvReady();
+        }
         else if (pIoData->operation == 1)
         {
             pSession->OnSendCompleted(bytesTransferred);
         }
+
+        // 다음 I/O 는 위에서 이미 자기 참조를 걸었다. 이후로는 세션을 건드리지 않는다.
+        pSession->ReleaseIoRef();
     }
-    return 0;
-}
\ No newline at end of file
+}
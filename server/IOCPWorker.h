@@ -1,6 +1,63 @@
 #pragma once
 
 #include <winsock2.h>
+#include <mswsock.h>
 #include <windows.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "IOEngine.h"
 
-DWORD WINAPI IOCPWorkerThread(LPVOID arg);
\ No newline at end of file
+class IOCPEngine : public IOEngine
+{
+public:
+    const char* GetName() const override { return "IOCP"; }
+
+    bool Initialize(size_t workerCount) override;
+    void Close() override;
+
+    void RunWorker() override;
+    void WakeupWorkers(size_t workerCount) override;
+
+    bool Listen(uint16_t port, AcceptHandler onAccept) override;
+    void StopListen() override;
+
+    bool Attach(ClientSession* session) override;
+    bool PostRecv(ClientSession* session, char* buf, int len) override;
+    bool PostSend(ClientSession* session, IoBuffer* bufs, int count) override;
+    void CloseSocket(ClientSession* session) override;
+    size_t GetSessionContextSize() const override { return sizeof(IOCPContext); }
+
+private:
+    // WSARecv / WSASend 는 I/O 워커와 로직 스레드(FlushSend) 어디서든 걸리므로, closesocket 과 같은 잠금 아래에서
+    // 닫혔는지 보고 건다. 닫은 뒤 같은 핸들 값이 새 소켓에 재사용되어도 엉뚱한 소켓에 걸지 않는다.
+    struct IOCPContext : public IOContext
+    {
+        std::mutex lock;
+        bool closed = false;
+    };
+
+    // AcceptEx 한 건. overlapped 가 맨 앞이어야 GQCS 결과에서 바로 꺼낼 수 있다.
+    struct AcceptIoData
+    {
+        OVERLAPPED overlapped;
+        SOCKET sock = INVALID_SOCKET;
+        char addrBuf[2 * (sizeof(SOCKADDR_IN) + 16)];
+    };
+
+    enum { ACCEPTS_PER_WORKER = 4 };
+
+    HANDLE hIOCP_ = NULL;
+    size_t workerCount_ = 0;
+
+    SOCKET listenSock_ = INVALID_SOCKET;
+    LPFN_ACCEPTEX acceptEx_ = nullptr;
+    std::atomic<bool> listening_ = false;
+    std::vector<std::unique_ptr<AcceptIoData>> accepts_;
+
+    static IOCPContext* GetContext(ClientSession* session);
+
+    ULONG_PTR GetAcceptKey() const { return (ULONG_PTR)this; }
+    bool PostAccept(AcceptIoData& ioData);
+    void OnAcceptCompleted(BOOL ok, AcceptIoData& ioData);
+};
@@ -0,0 +1,84 @@
+#include <cstdlib>
+#include <iostream>
+#include <cstring>
+#include "IOEngine.h"
+#include "ClientSession.h"
+#include "Server.h"
+
+#ifdef _WIN32
+#include "IOCPWorker.h"
+#else
+#include "EpollWorker.h"
+#endif
+#ifdef HAVE_IO_URING
+#include "UringWorker.h"
+#endif
+
+extern Server* g_Server;
+
+std::unique_ptr<IOEngine> IOEngine::Create()
+{
+#ifdef _WIN32
+    return std::make_unique<IOCPEngine>();
+#else
+    // CHAT_IO_ENGINE=uring 으로 io_uring 엔진 선택 (기본: epoll)
+    const char* name = std::getenv("CHAT_IO_ENGINE");
+#ifdef HAVE_IO_URING
+    if (name != nullptr && std::strcmp(name, "uring") == 0)
+        return std::make_unique<UringEngine>();
+#else
+    if (name != nullptr && std::strcmp(name, "uring") == 0)
+        std::cout << "[Server] io_uring engine not built, falling back to epoll" << std::endl;
+#endif
+    return std::make_unique<EpollEngine>();
+#endif
+}
+
+// 수신 0바이트 / 에러: 세션 정리
+void IOEngine::HandleSessionClosed(ClientSession* session)
+{
+    if (session == nullptr) return;
+
+    session->Disconnect();
+
+    if (g_Server)
+        g_Server->RemoveSession(session->GetSessionId());
+}
+
+ClientSession* IOEngine::FindSession(uint32_t sessionId)
+{
+    return g_Server ? g_Server->GetSession(sessionId) : nullptr;
+}
+
+// 리스너 소켓 생성 + bind + listen. 실패 시 INVALID_SOCKET
+SOCKET IOEngine::CreateListenSocket(uint16_t port)
+{
+#ifdef _WIN32
+    SOCKET sock = WSASocket(AF_INET, SOCK_STREAM, IPPROTO_TCP, NULL, 0, WSA_FLAG_OVERLAPPED);
+#else
+    SOCKET sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+#endif
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
+
+#ifndef _WIN32
+    // 같은 포트에 워커별 리스너를 여러 개 열면 커널이 연결을 나눠 준다
+    int on = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+#endif
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if (bind(sock, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+        listen(sock, SOMAXCONN) == SOCKET_ERROR)
+    {
+        std::cout << "[Error] Listen Failed (port " << port << "): " << GetLastSocketError() << std::endl;
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+
+    return sock;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include "Utility.h"
+
+class ClientSession;
+
+// 엔진별 세션 상태 (epoll 인터레스트 마스크 등). 세션이 소유한다.
+struct IOContext
+{
+    virtual ~IOContext() = default;
+};
+
+// 비동기 I/O 엔진 인터페이스.
+// 어떤 구현이든 완료 시점에 ClientSession::OnRecv / OnSendCompleted 를 호출한다.
+class IOEngine
+{
+public:
+    virtual ~IOEngine() = default;
+
+    virtual const char* GetName() const = 0;
+
+    virtual bool Initialize(size_t workerCount) = 0;
+    virtual void Close() = 0;
+
+    // 워커 스레드 본체. WakeupWorkers 가 호출될 때까지 반환하지 않는다.
+    virtual void RunWorker() = 0;
+    virtual void WakeupWorkers(size_t workerCount) = 0;
+
+    // 비동기 accept 시작. 수락된 소켓은 완료를 받은 워커 스레드에서 onAccept 로 넘어온다.
+    // (IOCP: AcceptEx 선등록 / epoll: 워커 수만큼 SO_REUSEPORT 리스너 / io_uring: 링마다 multishot accept)
+    using AcceptHandler = std::function<void(SOCKET)>;
+    virtual bool Listen(uint16_t port, AcceptHandler onAccept) = 0;
+    virtual void StopListen() = 0;
+
+    virtual bool Attach(ClientSession* session) = 0;
+    // buf 가 nullptr 이면 버퍼 없이 데이터 도착만 기다린다. 도착하면 OnRecvReady 를 호출하고,
+    // 세션은 그때 버퍼를 빌려 다시 PostRecv 한다. (IOCP: 0바이트 WSARecv / epoll: EPOLLIN / io_uring: 도착한 CQE)
+    virtual bool PostRecv(ClientSession* session, char* buf, int len) = 0;
+    // bufs 배열은 완료(OnSendCompleted)까지 세션이 유지한다. 완료는 실제로 나간 바이트 수로 오며
+    // 일부만 나갔다면 세션이 남은 부분으로 다시 PostSend 한다.
+    virtual bool PostSend(ClientSession* session, IoBuffer* bufs, int count) = 0;
+    virtual void CloseSocket(ClientSession* session) = 0;
+
+    // 세션 하나가 엔진 쪽에 따로 들고 있는 상태 크기 (메모리 리포트용)
+    virtual size_t GetSessionContextSize() const { return 0; }
+
+    static std::unique_ptr<IOEngine> Create();
+
+protected:
+    AcceptHandler onAccept_;
+
+    static void HandleSessionClosed(ClientSession* session);
+    // 세션 ID 로 조회 (SessionReclaimer::Guard 안에서만 쓴다)
+    static ClientSession* FindSession(uint32_t sessionId);
+    static SOCKET CreateListenSocket(uint16_t port);
+};
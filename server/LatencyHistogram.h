@@ -0,0 +1,57 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 시간 분포 (마이크로초). 구간은 2 의 거듭제곱: [0, 1) [1, 2) [2, 4) ... 마지막 구간은 그 위 전부.
+// 한 스레드가 Record 하고 다른 스레드 (콘솔) 가 읽는다. 읽는 동안 값이 바뀌어도 구간마다는 맞는 값이다.
+class LatencyHistogram
+{
+public:
+    enum { BUCKETS = 24 };   // 마지막 구간은 약 4 초 이상
+
+    void Record(int64_t us)
+    {
+        uint64_t value = us > 0 ? static_cast<uint64_t>(us) : 0;
+        int bucket = 0;
+        while (bucket < BUCKETS - 1 && value >= (1ULL << bucket))
+            bucket++;
+
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed))
+            max_.store(value, std::memory_order_relaxed);
+    }
+
+    uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t GetMax() const { return max_.load(std::memory_order_relaxed); }
+
+    // p (0 ~ 1) 가 들어 있는 구간의 위쪽 경계 (최댓값을 넘지 않게 자른다)
+    uint64_t Percentile(double p) const
+    {
+        uint64_t total = 0;
+        for (int i = 0; i < BUCKETS; ++i)
+            total += buckets_[i].load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+
+        uint64_t rank = static_cast<uint64_t>(p * total);
+        if (rank >= total) rank = total - 1;
+
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i)
+        {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen > rank)
+            {
+                uint64_t upper = 1ULL << i;
+                return upper < GetMax() ? upper : GetMax();
+            }
+        }
+        return GetMax();
+    }
+
+private:
+    std::atomic<uint64_t> buckets_[BUCKETS] = {};
+    std::atomic<uint64_t> count_ = 0;
+    std::atomic<uint64_t> max_ = 0;
+};
@@ -0,0 +1,57 @@
+#include <chrono>
+#include <thread>
+#include "LobbyLogic.h"
+#include "GameLogic.h"
+#include "SessionReclaimer.h"
+
+LobbyLogic::LobbyLogic(CommandQueue& inputQueue, Persistence& persistence, SessionTimers& sessionTimers)
+    : inputQueue_(inputQueue),
+    persistence_(persistence),
+    sessionTimers_(sessionTimers)
+{
+}
+
+void LobbyLogic::Run()
+{
+    const std::chrono::nanoseconds fixedTickDuration(1000000000LL / GameLogic::GetTickHz());
+    auto nextTick = std::chrono::steady_clock::now();
+
+    while (running_)
+    {
+        // 틱 시각이 지났을 때만 타이머와 세션 해제를 돌린다. 그 사이에는 급한 커맨드 (로그인, 방 목록 등) 로 깨어나 처리만 한다.
+        bool tickDue = std::chrono::steady_clock::now() >= nextTick;
+
+        {
+            // 커맨드는 세션을 맨 포인터로 찾아 쓴다. 틱 동안은 끊긴 세션도 해제되지 않는다.
+            SessionReclaimer::Guard guard;
+
+            ProcessAllInputs();
+
+            // 마감이 지난 세션만 휠에서 나온다 (틱마다 세션을 훑지 않는다)
+            if (tickDue)
+                sessionTimers_.Update(GetMonotonicMs());
+        }
+
+        if (tickDue)
+        {
+            // Guard 밖에서 epoch 를 넘기고 안전해진 세션을 놓는다 (방 샤드들이 Guard 를 놓은 뒤에야 넘어간다)
+            SessionReclaimer::Collect();
+            nextTick += fixedTickDuration;
+        }
+
+        if (inputQueue_.WaitUntil(nextTick))
+            wakeups_++;
+    }
+
+    // 정지 전에 들어온 커맨드 (DB 워커가 넣은 RESUME 포함) 를 마저 처리한다. 남겨 두면 멈춘 코루틴 프레임이 풀리지 않는다.
+    SessionReclaimer::Guard guard;
+    ProcessAllInputs();
+}
+
+// 커맨드는 큐 슬롯 위에서 바로 처리한다 (복사/해제 없음)
+void LobbyLogic::ProcessAllInputs()
+{
+    inputQueue_.Drain([this](const Command& command) {
+        ExecuteLobbyCommand(command, persistence_);
+    });
+}
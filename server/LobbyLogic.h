@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+#include "Persistence.h"
+#include "SessionTimers.h"
+#include "CommandQueue.h"
+
+// 로비 로직 스레드 (방 밖의 일). 가입 / 로그인, 귓속말, 방 목록과 방 번호, 세션 시간 제한 타이머를 맡고
+// 끊긴 세션의 지연 해제 (SessionReclaimer::Collect) 도 여기서 돌린다. 틱 속도는 방 샤드와 같다 (SimulationConfig).
+// 응답을 기다리는 요청은 틱을 기다리지 않고 큐가 깨워서 바로 처리한다.
+class LobbyLogic
+{
+public:
+    LobbyLogic(CommandQueue& inputQueue, Persistence& persistence, SessionTimers& sessionTimers);
+
+    void Run();
+    void Stop() { running_.store(false); }
+
+    // 급한 커맨드 때문에 틱 사이에 깬 횟수
+    uint64_t GetWakeupCount() const { return wakeups_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<bool> running_ = true;
+    std::atomic<uint64_t> wakeups_ = 0;
+
+    CommandQueue& inputQueue_;
+    Persistence& persistence_;
+    SessionTimers& sessionTimers_;
+
+    void ProcessAllInputs();
+};
@@ -1,37 +1,132 @@
 #pragma once
-#include <queue>
-#include <mutex>
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "SendBufferPool.h"
+
+// 잠금 없는 다중 생산자 / 단일 소비자 큐 (노드를 잇는 방식).
+// - Push 는 아무 스레드에서나 부른다. tail 을 exchange 로 바꾸고 이전 노드에 이어 붙이는 것이 전부다 (CAS 재시도 없음).
+// - Pop / DrainAll 은 한 번에 한 스레드만 부른다. 소비 스레드가 바뀌어도 되지만 넘겨줄 때 동기화가 있어야 한다
+//   (ClientSession 은 isSending_ 을 잡은 스레드가 소비한다).
+// - Empty / Size 는 아무 스레드에서나 부른다. 개수는 Push 가 노드를 잇기 전에 먼저 세므로,
+//   이어 붙이는 중인 항목이 있으면 Pop 은 실패해도 Empty 는 false 다 (그 사이에 소비를 그만두지 않게 한다).
+// - capacity 를 주면 그 개수를 넘는 Push 는 false 를 돌려준다 (0: 제한 없음).
+// 노드는 SendBufferPool 에서 가져오므로 정상 상태에서는 힙 할당이 없다 (스레드 캐시, 다른 스레드에서 반납해도 된다).
 template <typename T>
 class LockFreeQueue
 {
 public:
-    LockFreeQueue() {}
-    ~LockFreeQueue() {}
+    explicit LockFreeQueue(size_t capacity = 0)
+        : capacity_(capacity)
+    {
+        Node* stub = AllocateNode();
+        head_ = stub;
+        tail_.store(stub, std::memory_order_relaxed);
+    }
+
+    ~LockFreeQueue()
+    {
+        DrainAll([](T&&) {});
+        ReleaseNode(head_);
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
 
     bool Push(T item)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
-        queue_.push(std::move(item));
+        // 소비를 그만두려는 스레드의 Empty 와 엇갈리지 않도록 개수는 seq_cst 로 센다 (Empty 설명 참고)
+        size_t previousSize = size_.fetch_add(1);
+        if (capacity_ != 0 && previousSize >= capacity_)
+        {
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        Node* node = AllocateNode();
+        new (node->storage) T(std::move(item));
+
+        // 여기서부터 소비 쪽이 이 노드를 볼 때까지 (이전 노드의 next 를 쓸 때까지) 가 짧은 틈이다
+        Node* previous = tail_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
         return true;
     }
 
+    // 소비 스레드만 부른다
     bool Pop(T& item)
     {
-        std::lock_guard<std::mutex> lock(mutex_);
+        // head_ 는 이미 꺼낸 (값이 없는) 노드다. 다음 노드의 값을 꺼내고 그 노드가 새 head_ 가 된다.
+        Node* head = head_;
+        Node* next = head->next.load(std::memory_order_acquire);
+        if (next == nullptr) return false;
+
+        T* value = next->Value();
+        item = std::move(*value);
+        value->~T();
+
+        head_ = next;
+        ReleaseNode(head);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
 
-        if (queue_.empty())
+    // 소비 스레드만 부른다. 지금 이어져 있는 항목을 모두 꺼내 handler(T&&) 에 넘기고 꺼낸 수를 돌려준다.
+    // 개수는 끝에 한 번만 줄인다 (생산자와 같이 쓰는 카운터를 항목마다 건드리지 않는다).
+    template <typename Handler>
+    size_t DrainAll(Handler&& handler)
+    {
+        size_t count = 0;
+        Node* head = head_;
+        while (Node* next = head->next.load(std::memory_order_acquire))
         {
-            return false;
-        }
+            T* value = next->Value();
+            handler(std::move(*value));
+            value->~T();
 
-        item = std::move(queue_.front());
-        queue_.pop();
+            ReleaseNode(head);
+            head = next;
+            count++;
+        }
 
-        return true;
+        head_ = head;
+        if (count != 0)
+            size_.fetch_sub(count, std::memory_order_relaxed);
+        return count;
     }
 
+    // 소비를 그만둔 스레드가 플래그를 내린 뒤 확인하는 용도 (플래그를 내리는 것과 Push 가 모두 seq_cst 라서
+    // 여기서 비었다고 보면 그 뒤에 넣은 생산자는 내려간 플래그를 본다)
+    bool Empty() const { return size_.load() == 0; }
+    size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
 private:
-    std::mutex mutex_;
-    std::queue<T> queue_;
-};
\ No newline at end of file
+    struct Node
+    {
+        std::atomic<Node*> next;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* Value() { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    static Node* AllocateNode()
+    {
+        Node* node = new (SendBufferPool::Allocate(sizeof(Node))) Node;
+        node->next.store(nullptr, std::memory_order_relaxed);
+        return node;
+    }
+
+    static void ReleaseNode(Node* node)
+    {
+        node->~Node();
+        SendBufferPool::Release(node, sizeof(Node));
+    }
+
+    // 생산자들이 같이 쓰는 tail_ / size_ 와 소비 스레드만 쓰는 head_ 를 다른 캐시 라인에 둔다
+    alignas(64) std::atomic<Node*> tail_;
+    std::atomic<size_t> size_ = 0;
+    alignas(64) Node* head_;
+    const size_t capacity_;
+};
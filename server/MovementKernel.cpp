@@ -0,0 +1,128 @@
+#include "MovementKernel.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define MOVEMENT_KERNEL_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC / Clang 은 함수마다 AVX2 를 켠다. MSVC 는 /arch 없이도 AVX2 내장 함수를 쓸 수 있다.
+#if defined(MOVEMENT_KERNEL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MOVEMENT_KERNEL_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define MOVEMENT_KERNEL_AVX2_TARGET
+#endif
+
+namespace
+{
+    void IntegrateScalar(float* px, float* py, const float* vx, const float* vy, size_t begin, size_t count, float dt)
+    {
+        for (size_t i = begin; i < count; ++i)
+        {
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+        }
+    }
+
+#ifdef MOVEMENT_KERNEL_X86
+    // x86-64 는 SSE2 가 기본이다 (32 비트 빌드는 SSE2 가 켜져 있을 때만)
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MOVEMENT_KERNEL_SSE2 1
+    size_t IntegrateSse2(float* px, float* py, const float* vx, const float* vy, size_t count, float dt)
+    {
+        const __m128 step = _mm_set1_ps(dt);
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(_mm_loadu_ps(vx + i), step)));
+            _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(_mm_loadu_ps(vy + i), step)));
+        }
+        return i;
+    }
+#endif
+
+    MOVEMENT_KERNEL_AVX2_TARGET
+    size_t IntegrateAvx2(float* px, float* py, const float* vx, const float* vy, size_t count, float dt)
+    {
+        const __m256 step = _mm256_set1_ps(dt);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(px + i, _mm256_add_ps(_mm256_loadu_ps(px + i), _mm256_mul_ps(_mm256_loadu_ps(vx + i), step)));
+            _mm256_storeu_ps(py + i, _mm256_add_ps(_mm256_loadu_ps(py + i), _mm256_mul_ps(_mm256_loadu_ps(vy + i), step)));
+        }
+        return i;
+    }
+
+    bool CpuHasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        // 운영체제가 YMM 레지스터를 저장해 주는지 (OSXSAVE + XCR0)
+        __cpuid(info, 1);
+        if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+    MovementKernel::Level DetectLevel()
+    {
+#ifdef MOVEMENT_KERNEL_X86
+        if (CpuHasAvx2()) return MovementKernel::Level::AVX2;
+#endif
+#ifdef MOVEMENT_KERNEL_SSE2
+        return MovementKernel::Level::SSE2;
+#else
+        return MovementKernel::Level::SCALAR;
+#endif
+    }
+}
+
+MovementKernel::Level MovementKernel::GetSupportedLevel()
+{
+    static const Level level = DetectLevel();
+    return level;
+}
+
+const char* MovementKernel::GetLevelName(Level level)
+{
+    switch (level)
+    {
+    case Level::SCALAR: return "scalar";
+    case Level::SSE2: return "sse2";
+    case Level::AVX2: return "avx2";
+    }
+    return "";
+}
+
+void MovementKernel::Integrate(float* positionX, float* positionY, const float* velocityX, const float* velocityY, size_t count, float dt)
+{
+    Integrate(GetSupportedLevel(), positionX, positionY, velocityX, velocityY, count, dt);
+}
+
+void MovementKernel::Integrate(Level level, float* positionX, float* positionY, const float* velocityX, const float* velocityY, size_t count, float dt)
+{
+    if (level > GetSupportedLevel()) level = GetSupportedLevel();
+
+    // 넓은 커널이 묶음 단위로 처리하고 남은 꼬리는 스칼라로
+    size_t done = 0;
+#ifdef MOVEMENT_KERNEL_X86
+    if (level == Level::AVX2)
+        done = IntegrateAvx2(positionX, positionY, velocityX, velocityY, count, dt);
+#endif
+#ifdef MOVEMENT_KERNEL_SSE2
+    if (level == Level::SSE2)
+        done = IntegrateSse2(positionX, positionY, velocityX, velocityY, count, dt);
+#endif
+    IntegrateScalar(positionX, positionY, velocityX, velocityY, done, count, dt);
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+
+// 이동 적분 커널: position += velocity * dt 를 배열 전체에 한 번에 한다 (PlayerTable 의 SoA 배열).
+// - AVX2 (8 개씩) / SSE2 (4 개씩) / 스칼라 중 CPU 가 지원하는 가장 넓은 것을 처음 부를 때 고른다.
+//   AVX2 는 빌드 옵션 없이 함수 단위로 켜므로 AVX2 가 없는 CPU 에서도 같은 실행 파일이 돈다.
+// - 곱하고 더하는 순서는 셋 다 같다 (FMA 를 쓰지 않는다). 그래서 결과도 비트 단위로 같다.
+namespace MovementKernel
+{
+    enum class Level { SCALAR, SSE2, AVX2 };
+
+    void Integrate(float* positionX, float* positionY, const float* velocityX, const float* velocityY, size_t count, float dt);
+
+    // 벤치마크 / 비교용: 정해진 커널로 돌린다 (CPU 가 지원하지 않는 수준을 주면 지원하는 가장 넓은 것으로 내려간다)
+    void Integrate(Level level, float* positionX, float* positionY, const float* velocityX, const float* velocityY, size_t count, float dt);
+
+    Level GetSupportedLevel();
+    const char* GetLevelName(Level level);
+}
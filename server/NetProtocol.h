@@ -1,21 +1,28 @@
+// protocol/packets.schema 에서 생성한 파일. 직접 고치지 말고 스키마를 고친 뒤
+// python protocol/gen_protocol.py 로 다시 만든다.
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
+#include "PacketStream.h"
 
 enum class PacketId : uint16_t
 {
-    // [α/ ]
-    REGISTER_REQ = 1,    // ȸ û
-    REGISTER_RES = 2,    // ȸ 
-    LOGIN_REQ = 3,       // α û
-    LOGIN_RES = 4,       // α 
+    // [로그인/계정 관련]
+    REGISTER_REQ = 1,   // 회원가입 요청
+    REGISTER_RES = 2,   // 회원가입 결과
+    LOGIN_REQ = 3,      // 로그인 요청
+    LOGIN_RES = 4,      // 로그인 결과
 
-    // [ΰ/κ ]
-    ENTER_ROOM = 5,      //   û (α  )
-    LEAVE_ROOM = 6,      //  
+    // [인게임/로비 관련]
+    ENTER_ROOM = 5,     // 방 입장 요청 (로그인 성공 후)
+    LEAVE_ROOM = 6,     // 방 퇴장
 
-    // [ ÷]
+    // [게임 플레이]
     CHAT = 7,
     MOVE = 8,
+    // 방 상태. 클라이언트가 마지막으로 SNAPSHOT_ACK 한 틱(baseTick)에서 바뀐 플레이어만 담는다.
+    // entries 형식과 양자화는 server/SnapshotCodec.h 참고 (baseTick 0 이면 전체 스냅샷).
     SNAPSHOT = 9,
 
     ROOM_LIST_REQ = 10,
@@ -25,9 +32,23 @@ enum class PacketId : uint16_t
     CREATE_ROOM_RES = 13,
 
     LOGOUT_REQ = 14,
+
+    // [귓속말] 방과 상관없이 접속 중인 유저 한 명에게
+    WHISPER_REQ = 15,   // 보내기 (대상 이름 + 메시지)
+    WHISPER = 16,       // 받기 (보낸 사람 이름 + 메시지)
+    WHISPER_RES = 17,   // 보낸 사람에게 전달 결과
+
+    // [연결 유지] 클라이언트가 주기적으로 보내면 서버가 같은 내용을 그대로 돌려준다.
+    // 유휴 시간 제한(SessionTimeoutConfig::idleTimeoutMs)보다 짧은 주기로 보내야 끊기지 않는다.
+    HEARTBEAT_REQ = 18,
+    HEARTBEAT_RES = 19,
+
+    // [스냅샷 확인] 적용한 SNAPSHOT 의 tick (스냅샷 번호) 을 돌려준다. 서버는 다음 스냅샷을 이 번호 기준 델타로 만든다.
+    // 기준 틱을 갖고 있지 않아 델타를 풀 수 없으면 tick 0 을 보내 전체 스냅샷을 다시 받는다.
+    SNAPSHOT_ACK = 20,
 };
 
-#pragma pack(push, 1) 
+#pragma pack(push, 1)
 
 struct GameHeader
 {
@@ -35,73 +56,513 @@ struct GameHeader
     uint16_t packetId;
 };
 
+#pragma pack(pop)
+
+// 받을 때는 Read 가 수신 버퍼를 가리키는 뷰만 채운다 (문자열/배열 복사 없음).
+// FIXED_SIZE 는 문자열/배열이 없는 고정 크기 본문 (0 이면 가변),
+// MIN_SIZE / MAX_SIZE 는 문자열/배열이 비었을 때 / 꽉 찼을 때의 본문 크기.
+// 보낼 때는 필드를 채우고 SendBuffer::Create(packet) 으로 실제 크기만큼 만든다.
+// 본문 뒤에 남는 바이트는 무시한다 (필드를 끝에 추가해도 예전 쪽이 읽을 수 있다).
+
+struct RoomInfo
+{
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 10;
+    static constexpr size_t MAX_SIZE = 41;
+
+    int32_t roomId = 0;
+    int32_t userCount = 0;
+    std::string_view title;   // 최대 31 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(roomId)
+            && reader.Read(userCount)
+            && reader.ReadString(title, 31);
+    }
+
+    size_t GetSize() const { return 8 + PacketStringSize(title, 31); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(roomId);
+        writer.Write(userCount);
+        writer.WriteString(title, 31);
+    }
+};
+
+// [로그인/계정 관련]
+// 회원가입 요청
 struct PacketRegisterReq
 {
-    char username[50];
-    char password[50];
+    static constexpr PacketId ID = PacketId::REGISTER_REQ;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 102;
+
+    std::string_view username;   // 최대 49 바이트
+    std::string_view password;   // 최대 49 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.ReadString(username, 49)
+            && reader.ReadString(password, 49);
+    }
+
+    size_t GetSize() const { return PacketStringSize(username, 49) + PacketStringSize(password, 49); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.WriteString(username, 49);
+        writer.WriteString(password, 49);
+    }
 };
 
+// 회원가입 결과
 struct PacketRegisterRes
 {
-    bool success;
+    static constexpr PacketId ID = PacketId::REGISTER_RES;
+    static constexpr size_t FIXED_SIZE = 1;
+    static constexpr size_t MIN_SIZE = 1;
+    static constexpr size_t MAX_SIZE = 1;
+
+    bool success = false;
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(success);
+    }
+
+    size_t GetSize() const { return 1; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(success);
+    }
 };
 
+// 로그인 요청
 struct PacketLoginReq
 {
-    char username[50];
-    char password[50];
+    static constexpr PacketId ID = PacketId::LOGIN_REQ;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 102;
+
+    std::string_view username;   // 최대 49 바이트
+    std::string_view password;   // 최대 49 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.ReadString(username, 49)
+            && reader.ReadString(password, 49);
+    }
+
+    size_t GetSize() const { return PacketStringSize(username, 49) + PacketStringSize(password, 49); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.WriteString(username, 49);
+        writer.WriteString(password, 49);
+    }
 };
 
+// 로그인 결과
 struct PacketLoginRes
 {
-    bool success;
-    uint32_t playerId;
+    static constexpr PacketId ID = PacketId::LOGIN_RES;
+    static constexpr size_t FIXED_SIZE = 5;
+    static constexpr size_t MIN_SIZE = 5;
+    static constexpr size_t MAX_SIZE = 5;
+
+    bool success = false;
+    uint32_t playerId = 0;
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(success)
+            && reader.Read(playerId);
+    }
+
+    size_t GetSize() const { return 5; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(success);
+        writer.Write(playerId);
+    }
 };
 
+// [인게임/로비 관련]
+// 방 입장 요청 (로그인 성공 후)
 struct PacketEnterRoom
 {
-    int32_t roomId;
+    static constexpr PacketId ID = PacketId::ENTER_ROOM;
+    static constexpr size_t FIXED_SIZE = 4;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 4;
+
+    int32_t roomId = 0;
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(roomId);
+    }
+
+    size_t GetSize() const { return 4; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(roomId);
+    }
 };
 
+// 방 퇴장
 struct PacketLeaveRoom
 {
-    uint32_t playerId;
+    static constexpr PacketId ID = PacketId::LEAVE_ROOM;
+    static constexpr size_t FIXED_SIZE = 4;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 4;
+
+    uint32_t playerId = 0;
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(playerId);
+    }
+
+    size_t GetSize() const { return 4; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(playerId);
+    }
+};
+
+// [게임 플레이]
+struct PacketChat
+{
+    static constexpr PacketId ID = PacketId::CHAT;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 6;
+    static constexpr size_t MAX_SIZE = 261;
+
+    uint32_t playerId = 0;
+    std::string_view msg;   // 최대 255 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(playerId)
+            && reader.ReadString(msg, 255);
+    }
+
+    size_t GetSize() const { return 4 + PacketStringSize(msg, 255); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(playerId);
+        writer.WriteString(msg, 255);
+    }
 };
 
 struct PacketMove
 {
-    float vx;
-    float vy;
-    // float x, y;
+    static constexpr PacketId ID = PacketId::MOVE;
+    static constexpr size_t FIXED_SIZE = 8;
+    static constexpr size_t MIN_SIZE = 8;
+    static constexpr size_t MAX_SIZE = 8;
+
+    float vx = 0;
+    float vy = 0;
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(vx)
+            && reader.Read(vy);
+    }
+
+    size_t GetSize() const { return 8; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(vx);
+        writer.Write(vy);
+    }
 };
 
-struct PacketChat
+// 방 상태. 클라이언트가 마지막으로 SNAPSHOT_ACK 한 틱(baseTick)에서 바뀐 플레이어만 담는다.
+// entries 형식과 양자화는 server/SnapshotCodec.h 참고 (baseTick 0 이면 전체 스냅샷).
+struct PacketSnapshot
 {
-    uint32_t playerId;
-    char msg[256];
+    static constexpr PacketId ID = PacketId::SNAPSHOT;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 10;
+    static constexpr size_t MAX_SIZE = 65010;
+
+    uint32_t tick = 0;          // 스냅샷 번호 (세션마다 1 부터 하나씩 늘어난다. 방을 옮겨도 이어진다)
+    uint32_t baseTick = 0;      // 기준 틱. 0: 전체 (입장 직후, 기준을 잃었을 때)
+    std::string_view entries;   // 최대 65000 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(tick)
+            && reader.Read(baseTick)
+            && reader.ReadBytes(entries, 65000);
+    }
+
+    size_t GetSize() const { return 8 + PacketBytesSize(entries, 65000); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(tick);
+        writer.Write(baseTick);
+        writer.WriteBytes(entries, 65000);
+    }
 };
 
-struct RoomInfo
+struct PacketRoomListReq
 {
-    int32_t roomId;
-    int32_t userCount;
-    char title[32];
+    static constexpr PacketId ID = PacketId::ROOM_LIST_REQ;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 0;
+    static constexpr size_t MAX_SIZE = 0;
+
+    bool Read(PacketReader&) { return true; }
+
+    size_t GetSize() const { return 0; }
+
+    void Write(PacketWriter&) const {}
 };
 
 struct PacketRoomListRes
 {
-    int32_t count;
+    static constexpr PacketId ID = PacketId::ROOM_LIST_RES;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 2;
+    static constexpr size_t MAX_SIZE = 41986;
+
+    PacketArray<RoomInfo> rooms;   // 최대 1024 개
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.ReadArray(rooms, 1024);
+    }
+
+    size_t GetSize() const { return rooms.GetSize(1024); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.WriteArray(rooms, 1024);
+    }
 };
 
 struct PacketCreateRoomReq
 {
-    char title[32];
+    static constexpr PacketId ID = PacketId::CREATE_ROOM_REQ;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 2;
+    static constexpr size_t MAX_SIZE = 33;
+
+    std::string_view title;   // 최대 31 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.ReadString(title, 31);
+    }
+
+    size_t GetSize() const { return PacketStringSize(title, 31); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.WriteString(title, 31);
+    }
 };
 
 struct PacketCreateRoomRes
 {
-    bool success;
-    int32_t roomId;
+    static constexpr PacketId ID = PacketId::CREATE_ROOM_RES;
+    static constexpr size_t FIXED_SIZE = 5;
+    static constexpr size_t MIN_SIZE = 5;
+    static constexpr size_t MAX_SIZE = 5;
+
+    bool success = false;
+    int32_t roomId = 0;
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(success)
+            && reader.Read(roomId);
+    }
+
+    size_t GetSize() const { return 5; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(success);
+        writer.Write(roomId);
+    }
+};
+
+struct PacketLogoutReq
+{
+    static constexpr PacketId ID = PacketId::LOGOUT_REQ;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 0;
+    static constexpr size_t MAX_SIZE = 0;
+
+    bool Read(PacketReader&) { return true; }
+
+    size_t GetSize() const { return 0; }
+
+    void Write(PacketWriter&) const {}
+};
+
+// [귓속말] 방과 상관없이 접속 중인 유저 한 명에게
+// 보내기 (대상 이름 + 메시지)
+struct PacketWhisperReq
+{
+    static constexpr PacketId ID = PacketId::WHISPER_REQ;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 308;
+
+    std::string_view target;   // 최대 49 바이트
+    std::string_view msg;      // 최대 255 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.ReadString(target, 49)
+            && reader.ReadString(msg, 255);
+    }
+
+    size_t GetSize() const { return PacketStringSize(target, 49) + PacketStringSize(msg, 255); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.WriteString(target, 49);
+        writer.WriteString(msg, 255);
+    }
+};
+
+// 받기 (보낸 사람 이름 + 메시지)
+struct PacketWhisper
+{
+    static constexpr PacketId ID = PacketId::WHISPER;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 308;
+
+    std::string_view sender;   // 최대 49 바이트
+    std::string_view msg;      // 최대 255 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.ReadString(sender, 49)
+            && reader.ReadString(msg, 255);
+    }
+
+    size_t GetSize() const { return PacketStringSize(sender, 49) + PacketStringSize(msg, 255); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.WriteString(sender, 49);
+        writer.WriteString(msg, 255);
+    }
+};
+
+// 보낸 사람에게 전달 결과
+struct PacketWhisperRes
+{
+    static constexpr PacketId ID = PacketId::WHISPER_RES;
+    static constexpr size_t FIXED_SIZE = 0;
+    static constexpr size_t MIN_SIZE = 3;
+    static constexpr size_t MAX_SIZE = 52;
+
+    bool success = false;      // false: 대상이 접속 중이 아님
+    std::string_view target;   // 최대 49 바이트
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(success)
+            && reader.ReadString(target, 49);
+    }
+
+    size_t GetSize() const { return 1 + PacketStringSize(target, 49); }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(success);
+        writer.WriteString(target, 49);
+    }
 };
 
-#pragma pack(pop)
\ No newline at end of file
+// [연결 유지] 클라이언트가 주기적으로 보내면 서버가 같은 내용을 그대로 돌려준다.
+// 유휴 시간 제한(SessionTimeoutConfig::idleTimeoutMs)보다 짧은 주기로 보내야 끊기지 않는다.
+struct PacketHeartbeatReq
+{
+    static constexpr PacketId ID = PacketId::HEARTBEAT_REQ;
+    static constexpr size_t FIXED_SIZE = 4;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 4;
+
+    uint32_t clientTime = 0;   // 클라이언트 시각 (ms). 서버는 해석하지 않고 돌려주므로 RTT 측정에 쓴다.
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(clientTime);
+    }
+
+    size_t GetSize() const { return 4; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(clientTime);
+    }
+};
+
+struct PacketHeartbeatRes
+{
+    static constexpr PacketId ID = PacketId::HEARTBEAT_RES;
+    static constexpr size_t FIXED_SIZE = 4;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 4;
+
+    uint32_t clientTime = 0;   // 클라이언트 시각 (ms). 서버는 해석하지 않고 돌려주므로 RTT 측정에 쓴다.
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(clientTime);
+    }
+
+    size_t GetSize() const { return 4; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(clientTime);
+    }
+};
+
+// [스냅샷 확인] 적용한 SNAPSHOT 의 tick (스냅샷 번호) 을 돌려준다. 서버는 다음 스냅샷을 이 번호 기준 델타로 만든다.
+// 기준 틱을 갖고 있지 않아 델타를 풀 수 없으면 tick 0 을 보내 전체 스냅샷을 다시 받는다.
+struct PacketSnapshotAck
+{
+    static constexpr PacketId ID = PacketId::SNAPSHOT_ACK;
+    static constexpr size_t FIXED_SIZE = 4;
+    static constexpr size_t MIN_SIZE = 4;
+    static constexpr size_t MAX_SIZE = 4;
+
+    uint32_t tick = 0;
+
+    bool Read(PacketReader& reader)
+    {
+        return reader.Read(tick);
+    }
+
+    size_t GetSize() const { return 4; }
+
+    void Write(PacketWriter& writer) const
+    {
+        writer.Write(tick);
+    }
+};
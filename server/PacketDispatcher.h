@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "NetProtocol.h"
+
+// 받은 패킷을 ID 로 바로 찾아 디코딩하고 핸들러를 부르는 표.
+// - 받을 패킷 목록을 타입으로 넘기면 컴파일할 때 PacketId 크기의 표를 만든다 (ID 가 곧 인덱스).
+// - 핸들러는 패킷마다 OnPacket(Context&, const PacketXxx&) 하나만 만들면 된다.
+//   없거나 같은 ID 가 두 번 나오면 컴파일 에러가 난다.
+// - 본문 크기는 디코딩 전에 MIN_SIZE / MAX_SIZE 로 먼저 거른다.
+//   이후 필드 길이 검사는 생성된 Read 가 한다. 본문 뒤에 남는 바이트는 무시한다 (NetProtocol.h 참고).
+// 표에 없는 ID, 크기가 맞지 않거나 디코딩에 실패한 패킷은 모두 결과 코드로 돌려주고
+// 어떻게 처리할지 (로그 / 연결 종료) 는 부른 쪽이 정한다.
+enum class DispatchResult
+{
+    OK,
+    UNKNOWN_PACKET,   // 표에 없는 ID (보내기만 하는 패킷 포함)
+    BAD_SIZE,         // 본문이 MIN_SIZE 보다 짧거나 MAX_SIZE 보다 길다
+    MALFORMED,        // 필드 길이가 본문을 넘거나 스키마 최대 길이를 넘는다
+};
+
+inline const char* ToString(DispatchResult result)
+{
+    switch (result)
+    {
+    case DispatchResult::OK: return "OK";
+    case DispatchResult::UNKNOWN_PACKET: return "Unknown Packet";
+    case DispatchResult::BAD_SIZE: return "Bad Packet Size";
+    case DispatchResult::MALFORMED: return "Malformed Packet";
+    }
+    return "?";
+}
+
+// 표 크기 (가장 큰 ID + 1) 와 중복 검사. 클래스 안에서 부르면 아직 정의가 끝나지 않은 함수라 밖에 둔다.
+template <typename... Packets>
+constexpr size_t PacketTableSize()
+{
+    size_t maxId = 0;
+    for (size_t id : { static_cast<size_t>(Packets::ID)... })
+        maxId = id > maxId ? id : maxId;
+    return maxId + 1;
+}
+
+template <typename... Packets>
+constexpr bool HasUniquePacketIds()
+{
+    constexpr size_t ids[] = { static_cast<size_t>(Packets::ID)... };
+    for (size_t i = 0; i < sizeof...(Packets); ++i)
+        for (size_t j = i + 1; j < sizeof...(Packets); ++j)
+            if (ids[i] == ids[j]) return false;
+    return true;
+}
+
+template <typename Context, typename... Packets>
+class PacketDispatcher
+{
+public:
+    static_assert(sizeof...(Packets) > 0, "no packets");
+    static_assert(HasUniquePacketIds<Packets...>(), "packet registered twice");
+    static_assert(((Packets::MAX_SIZE + sizeof(GameHeader) <= UINT16_MAX) && ...), "packet too large");
+    static_assert(((Packets::MIN_SIZE <= Packets::MAX_SIZE) && ...), "bad packet size range");
+
+    // 헤더를 뺀 본문을 받는다. 본문은 핸들러가 끝날 때까지만 유효하다.
+    static DispatchResult Dispatch(Context& context, uint16_t packetId, const char* body, size_t bodySize)
+    {
+        if (packetId >= TABLE_SIZE) return DispatchResult::UNKNOWN_PACKET;
+
+        const Entry& entry = s_table[packetId];
+        if (entry.decode == nullptr) return DispatchResult::UNKNOWN_PACKET;
+        if (bodySize < entry.minSize || bodySize > entry.maxSize) return DispatchResult::BAD_SIZE;
+
+        return entry.decode(context, body, bodySize);
+    }
+
+private:
+    static constexpr size_t TABLE_SIZE = PacketTableSize<Packets...>();
+
+    using DecodeFunc = DispatchResult (*)(Context&, const char*, size_t);
+
+    struct Entry
+    {
+        DecodeFunc decode;
+        uint32_t minSize;
+        uint32_t maxSize;
+    };
+
+    template <typename Packet>
+    static DispatchResult Decode(Context& context, const char* body, size_t bodySize)
+    {
+        PacketReader reader(body, bodySize);
+        Packet packet;
+        if (!packet.Read(reader)) return DispatchResult::MALFORMED;
+
+        OnPacket(context, packet);
+        return DispatchResult::OK;
+    }
+
+    static constexpr std::array<Entry, TABLE_SIZE> MakeTable()
+    {
+        std::array<Entry, TABLE_SIZE> table{};
+        ((table[static_cast<size_t>(Packets::ID)] =
+            Entry{ &Decode<Packets>, static_cast<uint32_t>(Packets::MIN_SIZE), static_cast<uint32_t>(Packets::MAX_SIZE) }), ...);
+        return table;
+    }
+
+    // 상수 식으로 초기화되므로 정적 초기화 순서와 상관없이 처음부터 채워져 있다
+    static const std::array<Entry, TABLE_SIZE> s_table;
+};
+
+template <typename Context, typename... Packets>
+const std::array<typename PacketDispatcher<Context, Packets...>::Entry, PacketDispatcher<Context, Packets...>::TABLE_SIZE>
+    PacketDispatcher<Context, Packets...>::s_table = PacketDispatcher<Context, Packets...>::MakeTable();
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+// 스키마(protocol/packets.schema)로 만든 패킷 코덱(NetProtocol.h)이 쓰는 읽기/쓰기 도구.
+// - 정수/실수는 리틀 엔디언 그대로, 정렬 없이 붙여 쓴다 (서버는 x86/ARM 리틀 엔디언만 대상).
+// - 문자열: u16 바이트 수 + UTF-8 (널 문자 없음). 받을 때는 수신 버퍼를 가리키는 string_view 만 만든다.
+// - 바이트열: u16 바이트 수 + 바이트 그대로 (내용은 패킷이 정한다. 스냅샷 델타 등). 받을 때는 string_view.
+// - 배열: u16 개수 + 원소. 받을 때는 PacketArray 가 수신 버퍼 위에서 원소를 하나씩 풀어 준다.
+// 받은 패킷의 뷰는 수신 버퍼가 살아 있는 동안 (OnRead 전까지) 만 유효하다.
+
+class PacketReader;
+class PacketWriter;
+
+// 최대 길이를 넘는 문자열은 UTF-8 글자 중간이 아닌 곳에서 자른다
+inline std::string_view ClampPacketString(std::string_view value, size_t maxLength)
+{
+    if (value.size() <= maxLength) return value;
+
+    size_t length = maxLength;
+    while (length > 0 && (static_cast<uint8_t>(value[length]) & 0xC0) == 0x80)
+        --length;
+    return value.substr(0, length);
+}
+
+inline size_t PacketStringSize(std::string_view value, size_t maxLength)
+{
+    return sizeof(uint16_t) + ClampPacketString(value, maxLength).size();
+}
+
+inline size_t PacketBytesSize(std::string_view value, size_t maxLength)
+{
+    return sizeof(uint16_t) + (value.size() < maxLength ? value.size() : maxLength);
+}
+
+// 배열 필드.
+// - 받은 패킷: 인코딩된 원소 바이트를 가리키고, 순회할 때 원소를 하나씩 읽는다 (Read 에서 이미 검증함).
+// - 보낼 패킷: 호출한 쪽의 원소 배열을 가리킨다 (복사하지 않으므로 Create 가 끝날 때까지 살아 있어야 한다).
+template <typename T>
+class PacketArray
+{
+public:
+    PacketArray() = default;
+    PacketArray(const T* items, size_t count) : items_(items), count_(count) {}
+
+    template <typename Container>
+    PacketArray(const Container& items) : PacketArray(items.data(), items.size()) {}
+
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    class Iterator;
+    Iterator begin() const { return Iterator(*this, 0); }
+    Iterator end() const { return Iterator(*this, count_); }
+
+    // 보낼 때의 크기 (u16 개수 포함)
+    size_t GetSize(size_t maxCount) const
+    {
+        // 받은 배열을 그대로 다시 보낼 때 (Read 에서 이미 maxCount 를 확인했다)
+        if (items_ == nullptr) return sizeof(uint16_t) + bytes_;
+
+        size_t count = count_ < maxCount ? count_ : maxCount;
+        if constexpr (T::FIXED_SIZE != 0)
+            return sizeof(uint16_t) + count * T::FIXED_SIZE;
+
+        size_t size = sizeof(uint16_t);
+        for (size_t i = 0; i < count; ++i)
+            size += items_[i].GetSize();
+        return size;
+    }
+
+private:
+    friend class PacketReader;
+    friend class PacketWriter;
+
+    const char* data_ = nullptr;   // 받은 패킷의 원소 바이트
+    size_t bytes_ = 0;
+    const T* items_ = nullptr;     // 보낼 원소
+    size_t count_ = 0;
+};
+
+class PacketReader
+{
+public:
+    PacketReader(const char* data, size_t size) : ptr_(data), end_(data + size) {}
+
+    size_t GetRemaining() const { return static_cast<size_t>(end_ - ptr_); }
+
+    template <typename T>
+    bool Read(T& value)
+    {
+        static_assert(std::is_arithmetic_v<T>, "scalar fields only");
+        if (GetRemaining() < sizeof(T)) return false;
+        std::memcpy(&value, ptr_, sizeof(T));
+        ptr_ += sizeof(T);
+        return true;
+    }
+
+    bool Read(bool& value)
+    {
+        uint8_t byte = 0;
+        if (!Read(byte)) return false;
+        value = byte != 0;
+        return true;
+    }
+
+    bool ReadString(std::string_view& value, size_t maxLength)
+    {
+        uint16_t length = 0;
+        if (!Read(length) || length > maxLength || GetRemaining() < length) return false;
+        value = std::string_view(ptr_, length);
+        ptr_ += length;
+        return true;
+    }
+
+    bool ReadBytes(std::string_view& value, size_t maxLength)
+    {
+        return ReadString(value, maxLength);
+    }
+
+    // 원소를 한 번 끝까지 읽어 검증하고 바이트 범위만 기억한다
+    template <typename T>
+    bool ReadArray(PacketArray<T>& value, size_t maxCount)
+    {
+        uint16_t count = 0;
+        if (!Read(count) || count > maxCount) return false;
+
+        const char* begin = ptr_;
+        if constexpr (T::FIXED_SIZE != 0)
+        {
+            if (GetRemaining() < count * T::FIXED_SIZE) return false;
+            ptr_ += count * T::FIXED_SIZE;
+        }
+        else
+        {
+            for (uint16_t i = 0; i < count; ++i)
+            {
+                T item;
+                if (!item.Read(*this)) return false;
+            }
+        }
+
+        value = PacketArray<T>();
+        value.data_ = begin;
+        value.bytes_ = static_cast<size_t>(ptr_ - begin);
+        value.count_ = count;
+        return true;
+    }
+
+private:
+    const char* ptr_;
+    const char* end_;
+};
+
+// GetSize() 로 잡은 버퍼에 그대로 쓴다. 크기가 모자라면 넘치는 필드는 쓰지 않는다.
+class PacketWriter
+{
+public:
+    PacketWriter(char* data, size_t size) : ptr_(data), end_(data + size) {}
+
+    bool IsOverflow() const { return overflow_; }
+
+    template <typename T>
+    void Write(T value)
+    {
+        static_assert(std::is_arithmetic_v<T>, "scalar fields only");
+        WriteRaw(&value, sizeof(T));
+    }
+
+    void Write(bool value)
+    {
+        Write(static_cast<uint8_t>(value ? 1 : 0));
+    }
+
+    void WriteString(std::string_view value, size_t maxLength)
+    {
+        std::string_view clamped = ClampPacketString(value, maxLength);
+        Write(static_cast<uint16_t>(clamped.size()));
+        WriteRaw(clamped.data(), clamped.size());
+    }
+
+    // 바이트열은 글자 경계가 없으므로 최대 길이를 넘으면 자르고 넘침으로 표시한다 (보내는 쪽이 미리 맞춰야 한다)
+    void WriteBytes(std::string_view value, size_t maxLength)
+    {
+        if (value.size() > maxLength)
+        {
+            overflow_ = true;
+            value = value.substr(0, maxLength);
+        }
+        Write(static_cast<uint16_t>(value.size()));
+        WriteRaw(value.data(), value.size());
+    }
+
+    template <typename T>
+    void WriteArray(const PacketArray<T>& value, size_t maxCount)
+    {
+        if (value.items_ == nullptr)
+        {
+            Write(static_cast<uint16_t>(value.count_));
+            WriteRaw(value.data_, value.bytes_);
+            return;
+        }
+
+        size_t count = value.size() < maxCount ? value.size() : maxCount;
+        Write(static_cast<uint16_t>(count));
+        for (size_t i = 0; i < count; ++i)
+            value.items_[i].Write(*this);
+    }
+
+private:
+    void WriteRaw(const void* data, size_t size)
+    {
+        if (static_cast<size_t>(end_ - ptr_) < size)
+        {
+            overflow_ = true;
+            return;
+        }
+        if (size > 0) std::memcpy(ptr_, data, size);
+        ptr_ += size;
+    }
+
+    char* ptr_;
+    char* end_;
+    bool overflow_ = false;
+};
+
+template <typename T>
+class PacketArray<T>::Iterator
+{
+public:
+    Iterator(const PacketArray& array, size_t index)
+        : array_(&array), index_(index), reader_(array.data_, array.bytes_)
+    {
+        Load();
+    }
+
+    const T& operator*() const { return current_; }
+    const T* operator->() const { return &current_; }
+
+    Iterator& operator++()
+    {
+        ++index_;
+        Load();
+        return *this;
+    }
+
+    bool operator==(const Iterator& other) const { return index_ == other.index_; }
+    bool operator!=(const Iterator& other) const { return index_ != other.index_; }
+
+private:
+    void Load()
+    {
+        if (index_ >= array_->count_) return;
+
+        if (array_->items_ != nullptr)
+            current_ = array_->items_[index_];
+        else
+            current_.Read(reader_);
+    }
+
+    const PacketArray* array_;
+    size_t index_;
+    PacketReader reader_;
+    T current_{};
+};
@@ -1,9 +1,14 @@
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include "Persistence.h"
 #include "PersistenceRequest.h"
 #include "NetProtocol.h"
 #include "Server.h"
 #include "ClientSession.h"
+#include "SessionReclaimer.h"
+#include "ThreadTopology.h"
+#include "CommandQueue.h"
 
 extern Server* g_Server;
 
@@ -27,6 +32,9 @@ bool Persistence::Initialize(const std::string& dbUrl, const std::string& dbUser
     redisHost_ = redisHost;
     redisPort_ = redisPort;
 
+    const char* delay = std::getenv("CHAT_DB_DELAY_MS");
+    injectedDelayMs_ = delay != nullptr ? std::atoi(delay) : 0;
+
     try {
         for (int i = 0; i < threadCount_; ++i) {
             sql::Connection* con = driver_->connect(dbUrl_, dbUser_, dbPass_);
@@ -48,21 +56,34 @@ bool Persistence::Initialize(const std::string& dbUrl, const std::string& dbUser
     for (int i = 0; i < threadCount_; ++i) {
         workers_.emplace_back(&Persistence::WorkerLoop, this);
     }
+    redisWriteThread_ = std::thread(&Persistence::RedisWriteLoop, this);
 
     std::cout << "[Persistence] Initialized with " << threadCount_ << " DB threads and Redis connection.\n";
+    if (injectedDelayMs_ > 0)
+        std::cout << "[Persistence] Injected latency: " << injectedDelayMs_ << " ms per request (CHAT_DB_DELAY_MS)" << std::endl;
     return true;
 }
 
 void Persistence::Stop()
 {
-    if (!running_) return;
-    running_ = false;
+    {
+        // PostRequest 와 같은 잠금 아래에서 내려야 워커가 빈 큐를 보고 나간 뒤에 요청이 들어오지 않는다
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!running_) return;
+        running_ = false;
+    }
     cv_.notify_all();
 
     for (auto& t : workers_) {
         if (t.joinable()) t.join();
     }
 
+    {
+        std::lock_guard<std::mutex> lock(redisWriteMutex_);
+    }
+    redisWriteCv_.notify_all();
+    if (redisWriteThread_.joinable()) redisWriteThread_.join();
+
     if (redisCtx_) {
         redisReply* reply = (redisReply*)redisCommand(redisCtx_, "DEL active_users");
         if (reply) freeReplyObject(reply);
@@ -78,23 +99,25 @@ void Persistence::Stop()
     connections_.clear();
 }
 
-void Persistence::PostRequest(std::unique_ptr<PersistenceRequest> request)
+bool Persistence::PostRequest(std::unique_ptr<PersistenceRequest> request)
 {
     {
         std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!running_) return false;
         requestQueue_.push(std::move(request));
     }
     cv_.notify_one();
+    return true;
 }
 
-// [Connection Helper] Ŀؼ  / ݳϱ
+// [Connection Helper] 커넥션 가져오기 / 반납하기
 sql::Connection* Persistence::GetConnection()
 {
     std::lock_guard<std::mutex> lock(connectionMutex_);
 
     if (connections_.empty())
     {
-        // Ǯ 
+        // 풀이 비어있으면
         try {
             sql::Connection* con = driver_->connect(dbUrl_, dbUser_, dbPass_);
             con->setSchema("chatdb");
@@ -117,70 +140,50 @@ void Persistence::ReturnConnection(sql::Connection* con)
     connections_.push_back(con);
 }
 
-// [AuthenticateUser]  α  ( )
-int Persistence::AuthenticateUser(const std::string& username, const std::string& password)
+bool PersistenceAwaiter::await_suspend(std::coroutine_handle<> continuation)
 {
-    sql::Connection* conn = nullptr;
-    int dbId = -1;
-
-    try
-    {
-        conn = GetConnection();
-        if (conn == nullptr) return -1;
-
-        std::unique_ptr<sql::PreparedStatement> pstmt(
-            conn->prepareStatement("SELECT id FROM User WHERE username = ? AND password = ?")
-        );
-        pstmt->setString(1, username);
-        pstmt->setString(2, password);
-
-        std::unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
-        if (res->next())
-        {
-            dbId = res->getInt("id");
-        }
-
-        ReturnConnection(conn);
-    }
-    catch (sql::SQLException& e)
-    {
-        std::cout << "[DB Error] AuthenticateUser: " << e.what() << std::endl;
-        if (conn) delete conn;
-        return -1;
-    }
+    request_->result = &result_;
+    request_->continuation = continuation;
+    return persistence_.PostRequest(std::move(request_));
+}
 
-    if (dbId != -1)
-    {
-        if (CheckAndRegisterSession(username) == false)
-        {
-            std::cout << "[Login Fail] User already logged in: " << username << std::endl;
-            return -1;
-        }
-    }
+// [AuthenticateUser] 로그인 인증 (로비 스레드가 co_await 한다)
+PersistenceAwaiter Persistence::AuthenticateUser(const std::string& username, const std::string& password, CommandQueue& resumeQueue)
+{
+    auto req = std::make_unique<PersistenceRequest>();
+    req->type = RequestType::LOGIN;
+    req->username = username;
+    req->password = password;
+    req->resumeQueue = &resumeQueue;
+    return PersistenceAwaiter(*this, std::move(req));
+}
 
-    return dbId;
+// [GetRecentChats] 방 입장 때 보낼 최근 채팅 (방 샤드 스레드가 co_await 한다)
+PersistenceAwaiter Persistence::GetRecentChats(int roomId, CommandQueue& resumeQueue)
+{
+    auto req = std::make_unique<PersistenceRequest>();
+    req->type = RequestType::LOAD_RECENT_CHATS;
+    req->roomId = roomId;
+    req->resumeQueue = &resumeQueue;
+    return PersistenceAwaiter(*this, std::move(req));
 }
 
-void Persistence::SaveAndCacheChat(int roomId, uint32_t sessionId, const std::string& user, const std::string& msg) {
+void Persistence::SaveAndCacheChat(int roomId, uint32_t sessionId, std::string_view user, std::string_view msg) {
     auto req = std::make_unique<PersistenceRequest>();
     req->type = RequestType::SAVE_CHAT;
     req->sessionId = sessionId;
     req->username = user;
     req->message = msg;
+    req->roomId = roomId;
     PostRequest(std::move(req));
 
-    InternalCacheChat(roomId, user, msg);
-}
-
-void Persistence::InternalCacheChat(int roomId, const std::string& user, const std::string& msg) {
-    std::lock_guard<std::mutex> lock(redisMutex_);
-    if (!redisCtx_) return;
-
-    std::string key = "room:chat:" + std::to_string(roomId);
-    std::string data = user + ":" + msg;
-
-    freeReplyObject(redisCommand(redisCtx_, "LPUSH %s %s", key.c_str(), data.c_str()));
-    freeReplyObject(redisCommand(redisCtx_, "LTRIM %s 0 49", key.c_str()));
+    // 캐시는 DB 워커 (여럿) 를 거치지 않는다. 거치면 거의 같은 때 온 채팅의 LPUSH 순서가 바뀐다.
+    RedisWrite write;
+    write.kind = RedisWrite::Kind::CACHE_CHAT;
+    write.roomId = roomId;
+    write.username = user;
+    write.message = msg;
+    PostRedisWrite(std::move(write));
 }
 
 void Persistence::ProcessSaveChat(sql::Connection* con, const PersistenceRequest& req)
@@ -200,39 +203,66 @@ void Persistence::ProcessSaveChat(sql::Connection* con, const PersistenceRequest
     }
 }
 
-void Persistence::ProcessRegister(sql::Connection* con, const PersistenceRequest& req)
+void Persistence::ProcessLogin(sql::Connection* con, const PersistenceRequest& req)
 {
-    bool success = false;
+    if (!con) return;   // 결과는 dbId -1 (인증 실패) 그대로 돌려보낸다
     try {
         std::unique_ptr<sql::PreparedStatement> pstmt(
-            con->prepareStatement("INSERT INTO User(username, password) VALUES(?, ?)")
+            con->prepareStatement("SELECT id FROM User WHERE username = ? AND password = ?")
         );
         pstmt->setString(1, req.username);
         pstmt->setString(2, req.password);
-        pstmt->executeUpdate();
-        success = true;
-        std::cout << "[DB] Registered User: " << req.username << std::endl;
+
+        std::unique_ptr<sql::ResultSet> res(pstmt->executeQuery());
+        if (res->next()) {
+            req.result->dbId = res->getInt("id");
+        }
     }
     catch (sql::SQLException& e) {
-        if (e.getErrorCode() == 1062) {
-            std::cout << "[DB] Register Failed (Duplicate): " << req.username << std::endl;
+        std::cout << "[DB Error] AuthenticateUser: " << e.what() << std::endl;
+    }
+
+    // 중복 로그인은 로비 스레드가 UserDirectory 로 확인한다 (Redis 왕복 없음)
+}
+
+void Persistence::ProcessRegister(sql::Connection* con, const PersistenceRequest& req)
+{
+    bool success = false;
+    if (con) {
+        try {
+            std::unique_ptr<sql::PreparedStatement> pstmt(
+                con->prepareStatement("INSERT INTO User(username, password) VALUES(?, ?)")
+            );
+            pstmt->setString(1, req.username);
+            pstmt->setString(2, req.password);
+            pstmt->executeUpdate();
+            success = true;
+            std::cout << "[DB] Registered User: " << req.username << std::endl;
         }
-        else {
-            std::cerr << "[DB Error/Register] " << e.what() << std::endl;
+        catch (sql::SQLException& e) {
+            if (e.getErrorCode() == 1062) {
+                std::cout << "[DB] Register Failed (Duplicate): " << req.username << std::endl;
+            }
+            else {
+                std::cerr << "[DB Error/Register] " << e.what() << std::endl;
+            }
+            success = false;
         }
-        success = false;
     }
 
+    SessionReclaimer::Guard guard;
     auto session = g_Server->GetSession(req.sessionId);
     if (session) {
         PacketRegisterRes res;
         res.success = success;
-        session->Send(PacketId::REGISTER_RES, &res, sizeof(res));
+        session->SendPacket(res);
     }
 }
 
 void Persistence::WorkerLoop()
 {
+    ThreadTopology::EnterSharedThread();
+
     sql::Connection* myCon = nullptr;
     {
         std::lock_guard<std::mutex> lock(connectionMutex_);
@@ -249,12 +279,14 @@ void Persistence::WorkerLoop()
         }
     }
 
+    // 커넥션이 없어도 요청은 계속 꺼낸다. co_await 하는 로직 스레드의 코루틴이 멈춰 있지 않도록
+    // 로그인 / 가입은 실패로 답하고, Redis 만 쓰는 최근 채팅 조회는 그대로 한다.
     if (myCon == nullptr) {
-        std::cerr << "[Persistence] Worker failed to get DB connection!" << std::endl;
-        return;
+        std::cerr << "[Persistence] Worker failed to get DB connection! (login / register will fail)" << std::endl;
     }
 
-    while (running_)
+    // 멈춘 뒤에도 큐가 빌 때까지 돈다 (남긴 요청을 기다리는 코루틴은 다시 이어지지 못한다)
+    while (true)
     {
         std::unique_ptr<PersistenceRequest> req = nullptr;
         {
@@ -268,6 +300,9 @@ void Persistence::WorkerLoop()
         }
 
         if (req) {
+            if (injectedDelayMs_ > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(injectedDelayMs_));
+
             switch (req->type)
             {
             case RequestType::SAVE_CHAT:
@@ -277,55 +312,107 @@ void Persistence::WorkerLoop()
                 ProcessRegister(myCon, *req);
                 break;
             case RequestType::LOGIN:
+                ProcessLogin(myCon, *req);
+                break;
+            case RequestType::LOAD_RECENT_CHATS:
+                ProcessLoadRecentChats(*req);
+                break;
+            default:
                 break;
             }
+
+            // 결과를 채웠으니 기다리던 코루틴을 로직 스레드로 돌려보낸다 (그 스레드를 바로 깨운다)
+            if (req->resumeQueue != nullptr)
+                req->resumeQueue->Push(Command::Resume(req->continuation.address()));
         }
     }
 
     delete myCon;
 }
 
-std::vector<std::string> Persistence::GetRecentChats(int roomId) {
+void Persistence::ProcessLoadRecentChats(const PersistenceRequest& req)
+{
     std::lock_guard<std::mutex> lock(redisMutex_);
-    std::vector<std::string> chats;
-    if (!redisCtx_) return chats;
+    if (!redisCtx_) return;
 
-    std::string key = "room:chat:" + std::to_string(roomId);
+    std::string key = "room:chat:" + std::to_string(req.roomId);
     redisReply* reply = (redisReply*)redisCommand(redisCtx_, "LRANGE %s 0 -1", key.c_str());
 
     if (reply && reply->type == REDIS_REPLY_ARRAY) {
         for (int i = (int)reply->elements - 1; i >= 0; --i) {
-            chats.push_back(reply->element[i]->str);
+            req.result->chats.push_back(reply->element[i]->str);
         }
     }
     freeReplyObject(reply);
-    return chats;
 }
 
-bool Persistence::CheckAndRegisterSession(const std::string& username)
+void Persistence::SyncActiveUser(const std::string& username, bool online)
 {
-    std::lock_guard<std::mutex> lock(redisMutex_);
-    if (!redisCtx_) return true;
+    RedisWrite write;
+    write.kind = RedisWrite::Kind::PRESENCE;
+    write.username = username;
+    write.online = online;
+    PostRedisWrite(std::move(write));
+}
 
-    redisReply* reply = (redisReply*)redisCommand(redisCtx_, "SADD active_users %s", username.c_str());
+void Persistence::PostRedisWrite(RedisWrite write)
+{
+    {
+        std::lock_guard<std::mutex> lock(redisWriteMutex_);
+        redisWriteQueue_.push_back(std::move(write));
+    }
+    redisWriteCv_.notify_one();
+}
+
+// 쌓인 변경을 한 번에 꺼내 파이프라이닝으로 보낸다. 같은 유저의 SADD/SREM, 같은 방의 LPUSH 순서는 큐 순서 그대로다.
+void Persistence::RedisWriteLoop()
+{
+    ThreadTopology::EnterSharedThread();
 
-    bool isNewLogin = false;
-    if (reply)
+    std::vector<RedisWrite> batch;
+
+    while (true)
     {
-        if (reply->type == REDIS_REPLY_INTEGER && reply->integer == 1)
         {
-            isNewLogin = true;
+            std::unique_lock<std::mutex> lock(redisWriteMutex_);
+            redisWriteCv_.wait(lock, [this] { return !redisWriteQueue_.empty() || !running_; });
+            if (redisWriteQueue_.empty() && !running_) break;
+            batch.swap(redisWriteQueue_);
         }
-        freeReplyObject(reply);
-    }
 
-    return isNewLogin;
-}
+        std::lock_guard<std::mutex> lock(redisMutex_);
+        if (!redisCtx_) {
+            batch.clear();
+            continue;
+        }
 
-void Persistence::RemoveActiveUser(const std::string& username) {
-    std::lock_guard<std::mutex> lock(redisMutex_);
-    if (!redisCtx_) return;
+        size_t replies = 0;
+        std::string key;
+        std::string data;
+        for (const RedisWrite& write : batch) {
+            if (write.kind == RedisWrite::Kind::PRESENCE) {
+                redisAppendCommand(redisCtx_, write.online ? "SADD active_users %s" : "SREM active_users %s",
+                    write.username.c_str());
+                replies += 1;
+                continue;
+            }
+
+            key = "room:chat:" + std::to_string(write.roomId);
+            data.assign(write.username).append(":").append(write.message);
+            redisAppendCommand(redisCtx_, "LPUSH %s %s", key.c_str(), data.c_str());
+            redisAppendCommand(redisCtx_, "LTRIM %s 0 49", key.c_str());
+            replies += 2;
+        }
+
+        for (size_t i = 0; i < replies; ++i) {
+            redisReply* reply = nullptr;
+            if (redisGetReply(redisCtx_, (void**)&reply) != REDIS_OK) {
+                std::cerr << "[Redis] Write Sync Failed: " << (redisCtx_->errstr) << std::endl;
+                break;
+            }
+            freeReplyObject(reply);
+        }
 
-    freeReplyObject(redisCommand(redisCtx_, "SREM active_users %s", username.c_str()));
-    std::cout << "[Redis] Removed active session: " << username << std::endl;
-}
\ No newline at end of file
+        batch.clear();
+    }
+}
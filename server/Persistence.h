@@ -5,13 +5,37 @@
 #include <cppconn/driver.h>
 #include <cppconn/exception.h>
 #include <hiredis/hiredis.h>
+#include <string_view>
 #include <vector>
 #include <queue>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <memory>
 #include "PersistenceRequest.h"
 
+class Persistence;
+
+// co_await 하는 DB 작업 (CommandTask 코루틴 안에서만 쓴다).
+// 멈출 때 요청을 DB 워커로 넘기고, 워커가 결과를 채우면 요청에 적어 둔 로직 스레드에서 이어진다.
+// 결과는 이 객체 (코루틴 프레임 안) 에 있으므로 워커가 쓰는 동안 로직 스레드는 건드리지 않는다.
+// Persistence 가 이미 멈췄으면 멈추지 않고 빈 결과로 바로 이어진다 (이어 줄 워커가 없어 프레임이 남지 않도록).
+class PersistenceAwaiter
+{
+public:
+    PersistenceAwaiter(Persistence& persistence, std::unique_ptr<PersistenceRequest> request)
+        : persistence_(persistence), request_(std::move(request)) {}
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<> continuation);
+    PersistenceResult await_resume() { return std::move(result_); }
+
+private:
+    Persistence& persistence_;
+    std::unique_ptr<PersistenceRequest> request_;
+    PersistenceResult result_;
+};
+
 class Persistence
 {
 public:
@@ -20,22 +44,32 @@ public:
 
     bool Initialize(const std::string& dbUrl, const std::string& dbUser, const std::string& dbPass,
         const std::string& redisHost, int redisPort);
+    // 워커는 큐에 남은 요청을 모두 처리하고 끝난다 (기다리던 코루틴의 RESUME 까지 넣은 뒤 반환)
     void Stop();
-    void PostRequest(std::unique_ptr<PersistenceRequest> request);
+    // 멈춘 뒤에는 받지 않고 false
+    bool PostRequest(std::unique_ptr<PersistenceRequest> request);
 
-    int AuthenticateUser(const std::string& username, const std::string& password);
+    // co_await 로 기다린다. 조회는 DB 워커에서 돌고, 코루틴은 resumeQueue 를 비우는 로직 스레드에서 이어진다.
+    // 결과: dbId (없으면 -1)
+    PersistenceAwaiter AuthenticateUser(const std::string& username, const std::string& password, CommandQueue& resumeQueue);
+    // 결과: chats (Redis 에 남은 최근 채팅, 오래된 것부터)
+    PersistenceAwaiter GetRecentChats(int roomId, CommandQueue& resumeQueue);
 
-    std::vector<std::string> GetRecentChats(int roomId);
-    void SaveAndCacheChat(int roomId, uint32_t sessionId, const std::string& user, const std::string& msg);
+    // DB 저장은 워커에서, Redis 최근 채팅 캐시는 Redis 쓰기 스레드에서 한다 (바로 반환).
+    // 캐시는 한 스레드가 넣은 순서대로 쓰므로 방을 맡은 샤드 스레드가 부른 순서가 그대로 남는다.
+    void SaveAndCacheChat(int roomId, uint32_t sessionId, std::string_view user, std::string_view msg);
 
-    void RemoveActiveUser(const std::string& username);
+    // Redis active_users 집합을 접속 상태에 맞춘다. 전용 스레드가 모아서 보내므로 바로 반환한다.
+    void SyncActiveUser(const std::string& username, bool online);
 
 private:
     void WorkerLoop();
     void ProcessSaveChat(sql::Connection* con, const PersistenceRequest& req);
     void ProcessRegister(sql::Connection* con, const PersistenceRequest& req);
+    void ProcessLogin(sql::Connection* con, const PersistenceRequest& req);
+    void ProcessLoadRecentChats(const PersistenceRequest& req);
 
-    bool CheckAndRegisterSession(const std::string& username);
+    void RedisWriteLoop();
 
     sql::Connection* GetConnection();
     void ReturnConnection(sql::Connection* con);
@@ -61,6 +95,22 @@ private:
 
     int threadCount_;
     bool running_;
+    int injectedDelayMs_ = 0;   // CHAT_DB_DELAY_MS: 요청마다 워커에서 이만큼 더 기다린다 (느린 DB 흉내, 시험용)
+
+    // active_users 동기화와 최근 채팅 캐시 (순서를 지키기 위해 스레드 하나가 처리)
+    struct RedisWrite
+    {
+        enum class Kind { PRESENCE, CACHE_CHAT };
+        Kind kind;
+        std::string username;
+        bool online = false;   // PRESENCE
+        int roomId = 0;        // CACHE_CHAT
+        std::string message;   // CACHE_CHAT
+    };
+    std::vector<RedisWrite> redisWriteQueue_;
+    std::mutex redisWriteMutex_;
+    std::condition_variable redisWriteCv_;
+    std::thread redisWriteThread_;
 
-    void InternalCacheChat(int roomId, const std::string& user, const std::string& msg);
+    void PostRedisWrite(RedisWrite write);
 };
\ No newline at end of file
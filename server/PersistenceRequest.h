@@ -1,5 +1,9 @@
 #pragma once
+#include <coroutine>
 #include <string>
+#include <vector>
+
+class CommandQueue;
 
 enum class RequestType {
     NONE,
@@ -7,12 +11,25 @@ enum class RequestType {
     LOAD_USER_DATA,
     REGISTER,
     LOGIN,
+    LOAD_RECENT_CHATS,
+};
+
+// co_await 한 요청의 결과 (DB 워커가 채운다)
+struct PersistenceResult {
+    int dbId = -1;                    // LOGIN: 없으면 -1
+    std::vector<std::string> chats;   // LOAD_RECENT_CHATS: 오래된 것부터
 };
 
 struct PersistenceRequest {
     RequestType type;
     uint32_t sessionId;
+    int roomId = 0;
     std::string username;
     std::string password;
     std::string message;
-};
\ No newline at end of file
+
+    // co_await 로 기다리는 요청: 워커가 result 를 채운 뒤 continuation 을 resumeQueue 의 로직 스레드로 돌려보낸다
+    PersistenceResult* result = nullptr;
+    std::coroutine_handle<> continuation;
+    CommandQueue* resumeQueue = nullptr;
+};
@@ -1,7 +0,0 @@
-#include "PlayerState.h"
-
-void PlayerState::ApplyMovement(float fixedDeltaTime)
-{
-    position.x += velocity.x * fixedDeltaTime;
-    position.y += velocity.y * fixedDeltaTime;
-}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#include "PlayerTable.h"
+#include "MovementKernel.h"
+
+uint32_t PlayerTable::Add(uint32_t id, Vector2 position, uint64_t cell)
+{
+    auto result = index_.emplace(id, static_cast<uint32_t>(ids_.size()));
+    if (!result.second) return result.first->second;
+
+    ids_.push_back(id);
+    positionX_.push_back(position.x);
+    positionY_.push_back(position.y);
+    velocityX_.push_back(0.0f);
+    velocityY_.push_back(0.0f);
+    cells_.push_back(cell);
+    return result.first->second;
+}
+
+bool PlayerTable::Remove(uint32_t id, uint32_t& index, uint32_t& movedFrom)
+{
+    auto it = index_.find(id);
+    if (it == index_.end()) return false;
+
+    index = it->second;
+    index_.erase(it);
+
+    // 마지막 플레이어를 빈자리로 옮긴다
+    uint32_t last = static_cast<uint32_t>(ids_.size() - 1);
+    movedFrom = NONE;
+    if (index != last)
+    {
+        ids_[index] = ids_[last];
+        positionX_[index] = positionX_[last];
+        positionY_[index] = positionY_[last];
+        velocityX_[index] = velocityX_[last];
+        velocityY_[index] = velocityY_[last];
+        cells_[index] = cells_[last];
+        index_[ids_[index]] = index;
+        movedFrom = last;
+    }
+
+    ids_.pop_back();
+    positionX_.pop_back();
+    positionY_.pop_back();
+    velocityX_.pop_back();
+    velocityY_.pop_back();
+    cells_.pop_back();
+    return true;
+}
+
+void PlayerTable::Integrate(float fixedDeltaTime)
+{
+    MovementKernel::Integrate(positionX_.data(), positionY_.data(), velocityX_.data(), velocityY_.data(), ids_.size(), fixedDeltaTime);
+}
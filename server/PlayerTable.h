@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Utility.h"
+
+// 방 안 플레이어의 위치 / 속도 (SoA, 방을 맡은 샤드 스레드에서만 쓴다).
+// - 자리 번호 0 ~ Size()-1 로 빈틈없이 채운 열 (column) 들이고, 세션 ID -> 자리 번호는 옆 표로 찾는다.
+// - 빠지면 마지막 플레이어를 빈자리로 옮긴다 (그 플레이어의 자리 번호가 바뀐다. Remove 가 알려 준다).
+// - 이동은 위치 / 속도 열 전체를 MovementKernel 로 한 번에 적분한다.
+// - cells 는 GameRoom 이 쓰는 격자 칸 열이다 (칸이 바뀐 플레이어만 SpatialGrid 를 고친다).
+class PlayerTable
+{
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // 새 자리 번호 (이미 있으면 그 자리)
+    uint32_t Add(uint32_t id, Vector2 position, uint64_t cell);
+
+    // 없으면 false. index: 비운 자리, movedFrom: 그 자리로 옮겨 온 플레이어의 이전 자리 (마지막 자리를 비웠으면 NONE)
+    bool Remove(uint32_t id, uint32_t& index, uint32_t& movedFrom);
+
+    uint32_t Find(uint32_t id) const
+    {
+        auto it = index_.find(id);
+        return it != index_.end() ? it->second : NONE;
+    }
+
+    size_t Size() const { return ids_.size(); }
+    bool Empty() const { return ids_.empty(); }
+
+    void Integrate(float fixedDeltaTime);
+
+    uint32_t GetId(uint32_t index) const { return ids_[index]; }
+    Vector2 GetPosition(uint32_t index) const { return Vector2{ positionX_[index], positionY_[index] }; }
+    void SetVelocity(uint32_t index, float vx, float vy)
+    {
+        velocityX_[index] = vx;
+        velocityY_[index] = vy;
+    }
+
+    // 열을 그대로 읽는다 (스냅샷 수집)
+    const uint32_t* Ids() const { return ids_.data(); }
+    const float* PositionX() const { return positionX_.data(); }
+    const float* PositionY() const { return positionY_.data(); }
+    uint64_t* Cells() { return cells_.data(); }
+
+private:
+    std::vector<uint32_t> ids_;
+    std::vector<float> positionX_;
+    std::vector<float> positionY_;
+    std::vector<float> velocityX_;
+    std::vector<float> velocityY_;
+    std::vector<uint64_t> cells_;
+
+    std::unordered_map<uint32_t, uint32_t> index_;   // 세션 ID -> 자리 번호
+};
@@ -0,0 +1,261 @@
+#include "RecvBuffer.h"
+#include "ThreadTopology.h"
+#include <iostream>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#pragma comment(lib, "onecore.lib")   // VirtualAlloc2 / MapViewOfFile3
+#else
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // 선형 모드에서 남은 공간이 이보다 적으면 앞으로 당긴다 (예전 RegisterRecv 기준과 같음)
+    const uint32_t kLinearCompactThreshold = 1024;
+
+    struct NodePool
+    {
+        std::mutex lock;
+        std::vector<std::unique_ptr<RecvBuffer>> buffers;
+    };
+
+    NodePool g_pools[ThreadTopology::MAX_NODES];
+    std::atomic<size_t> g_maxPooled = 1024;
+
+    NodePool& GetPool(int node)
+    {
+        return g_pools[node < 0 ? 0 : node % ThreadTopology::MAX_NODES];
+    }
+
+    std::atomic<uint64_t> g_lent = 0;
+    std::atomic<uint64_t> g_created = 0;
+    std::atomic<uint64_t> g_acquires = 0;
+}
+
+RecvBuffer::RecvBuffer(uint32_t capacity, int node)
+    : capacity_(capacity), node_(node)
+{
+    if (MapMirrored())
+    {
+        mirrored_ = true;
+        return;
+    }
+
+    static bool s_warned = false;
+    if (!s_warned)
+    {
+        s_warned = true;
+        std::cout << "[RecvBuffer] Mirror Mapping Failed, Using Linear Buffer" << std::endl;
+    }
+
+    base_ = new char[capacity_];
+}
+
+RecvBuffer::~RecvBuffer()
+{
+    if (mirrored_)
+        UnmapMirrored();
+    else
+        delete[] base_;
+}
+
+#ifdef _WIN32
+bool RecvBuffer::MapMirrored()
+{
+    HANDLE section = CreateFileMappingNumaW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, capacity_, nullptr,
+        node_ >= 0 ? (DWORD)node_ : NUMA_NO_PREFERRED_NODE);
+    if (section == nullptr) return false;
+
+    // 두 배 크기 placeholder 를 잡고 반으로 나눈 뒤 같은 section 을 양쪽에 매핑한다
+    char* placeholder = static_cast<char*>(VirtualAlloc2(nullptr, nullptr, (SIZE_T)capacity_ * 2,
+        MEM_RESERVE | MEM_RESERVE_PLACEHOLDER, PAGE_NOACCESS, nullptr, 0));
+    if (placeholder == nullptr)
+    {
+        CloseHandle(section);
+        return false;
+    }
+
+    VirtualFree(placeholder, capacity_, MEM_RELEASE | MEM_PRESERVE_PLACEHOLDER);
+
+    void* first = MapViewOfFile3(section, nullptr, placeholder, 0, capacity_,
+        MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+    void* second = MapViewOfFile3(section, nullptr, placeholder + capacity_, 0, capacity_,
+        MEM_REPLACE_PLACEHOLDER, PAGE_READWRITE, nullptr, 0);
+
+    CloseHandle(section);   // 뷰가 section 을 붙잡고 있으므로 핸들은 바로 닫는다
+
+    if (first == nullptr || second == nullptr)
+    {
+        if (first) UnmapViewOfFile(first);
+        else VirtualFree(placeholder, 0, MEM_RELEASE);
+        if (second) UnmapViewOfFile(second);
+        else VirtualFree(placeholder + capacity_, 0, MEM_RELEASE);
+        return false;
+    }
+
+    base_ = placeholder;
+    return true;
+}
+
+void RecvBuffer::UnmapMirrored()
+{
+    UnmapViewOfFile(base_);
+    UnmapViewOfFile(base_ + capacity_);
+}
+#else
+bool RecvBuffer::MapMirrored()
+{
+    int fd = static_cast<int>(syscall(SYS_memfd_create, "recv_ring", 1u /* MFD_CLOEXEC */));
+    if (fd < 0) return false;
+
+    if (ftruncate(fd, capacity_) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    // 두 배 크기 주소 공간을 예약한 뒤 앞/뒤 절반에 같은 파일을 덮어 매핑한다
+    void* reserved = mmap(nullptr, (size_t)capacity_ * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+
+    char* base = static_cast<char*>(reserved);
+    void* first = mmap(base, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    void* second = mmap(base + capacity_, capacity_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+
+    close(fd);   // 매핑이 파일을 붙잡고 있으므로 세션마다 fd 를 들고 있을 필요는 없다
+
+    if (first == MAP_FAILED || second == MAP_FAILED)
+    {
+        munmap(base, (size_t)capacity_ * 2);
+        return false;
+    }
+
+    // 페이지는 처음 쓸 때 잡히므로 그 전에 노드를 정해 둔다 (실패해도 동작에는 지장 없다)
+    if (node_ >= 0 && node_ < 64)
+    {
+        const int MPOL_PREFERRED = 1;
+        unsigned long nodeMask = 1ul << node_;
+        syscall(SYS_mbind, base, (size_t)capacity_, MPOL_PREFERRED, &nodeMask, sizeof(nodeMask) * 8, 0);
+    }
+
+    base_ = base;
+    return true;
+}
+
+void RecvBuffer::UnmapMirrored()
+{
+    munmap(base_, (size_t)capacity_ * 2);
+}
+#endif
+
+char* RecvBuffer::GetWritePtr()
+{
+    if (!mirrored_ && capacity_ - writePos_ < kLinearCompactThreshold)
+    {
+        uint32_t dataSize = GetDataSize();
+        if (dataSize > 0)
+            std::memmove(base_, base_ + readPos_, dataSize);
+
+        readPos_ = 0;
+        writePos_ = dataSize;
+    }
+
+    return base_ + Offset(writePos_);
+}
+
+uint32_t RecvBuffer::GetFreeSize() const
+{
+    // mirror 모드: 링 끝을 넘어가도 뒤쪽 매핑으로 이어지므로 남은 용량 전체가 연속 공간이다
+    return mirrored_ ? capacity_ - GetDataSize() : capacity_ - writePos_;
+}
+
+void RecvBuffer::OnRead(uint32_t bytes)
+{
+    readPos_ += bytes;
+
+    if (!mirrored_ && readPos_ == writePos_)
+    {
+        readPos_ = 0;
+        writePos_ = 0;
+    }
+}
+
+std::unique_ptr<RecvBuffer> RecvBufferPool::Acquire()
+{
+    g_acquires.fetch_add(1, std::memory_order_relaxed);
+    g_lent.fetch_add(1, std::memory_order_relaxed);
+
+    int node = ThreadTopology::IsNumaLocalBuffers() ? ThreadTopology::GetCurrentNode() : -1;
+    NodePool& pool = GetPool(node);
+    {
+        std::lock_guard<std::mutex> lock(pool.lock);
+        if (!pool.buffers.empty())
+        {
+            std::unique_ptr<RecvBuffer> buffer = std::move(pool.buffers.back());
+            pool.buffers.pop_back();
+            return buffer;
+        }
+    }
+
+    g_created.fetch_add(1, std::memory_order_relaxed);
+    return std::make_unique<RecvBuffer>(BUFFER_SIZE, node);
+}
+
+// 남은 데이터는 버린다 (세션은 다 파싱했거나 끊어질 때만 반납한다)
+void RecvBufferPool::Release(std::unique_ptr<RecvBuffer> buffer)
+{
+    if (buffer == nullptr) return;
+    g_lent.fetch_sub(1, std::memory_order_relaxed);
+
+    buffer->Reset();
+
+    // 다른 노드의 워커가 돌려줘도 버퍼 메모리가 있는 노드의 풀로 돌아간다
+    NodePool& pool = GetPool(buffer->GetNode());
+    {
+        std::lock_guard<std::mutex> lock(pool.lock);
+        if (pool.buffers.size() < g_maxPooled.load(std::memory_order_relaxed))
+        {
+            pool.buffers.push_back(std::move(buffer));
+            return;
+        }
+    }
+    // 풀이 가득 찼으면 잠금 밖에서 해제된다
+}
+
+void RecvBufferPool::SetMaxPooled(size_t count)
+{
+    g_maxPooled = count;
+
+    for (NodePool& pool : g_pools)
+    {
+        std::lock_guard<std::mutex> lock(pool.lock);
+        if (pool.buffers.size() > count)
+            pool.buffers.resize(count);
+    }
+}
+
+RecvBufferPool::Stats RecvBufferPool::GetStats()
+{
+    Stats stats = {};
+    stats.lent = g_lent.load();
+    stats.created = g_created.load();
+    stats.acquires = g_acquires.load();
+
+    for (NodePool& pool : g_pools)
+    {
+        std::lock_guard<std::mutex> lock(pool.lock);
+        stats.pooled += pool.buffers.size();
+    }
+    return stats;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// 세션 수신용 링 버퍼.
+// 같은 물리 페이지를 가상 주소에 두 번 이어 붙여(mirror) 매핑하므로, 링 끝에 걸친 패킷도
+// 항상 한 덩어리로 보인다. 덕분에 memmove 로 당겨 올 필요 없이 읽기 위치에서 바로 파싱한다.
+// 매핑이 안 되는 환경에서는 예전처럼 선형 버퍼 + 공간이 부족할 때 앞으로 당기는 방식으로 동작한다.
+class RecvBuffer
+{
+public:
+    // capacity 는 페이지 크기(Windows 는 할당 단위 64KB)의 배수인 2의 거듭제곱이어야 한다.
+    // node 를 주면 그 NUMA 노드의 메모리를 우선해서 쓴다 (-1: 처음 쓰는 스레드의 노드).
+    explicit RecvBuffer(uint32_t capacity, int node = -1);
+    ~RecvBuffer();
+
+    RecvBuffer(const RecvBuffer&) = delete;
+    RecvBuffer& operator=(const RecvBuffer&) = delete;
+
+    bool IsMirrored() const { return mirrored_; }
+    uint32_t GetCapacity() const { return capacity_; }
+    int GetNode() const { return node_; }
+
+    // 쓰기: recv 에 넘길 연속 공간. 선형 모드에서는 필요하면 여기서 당긴다.
+    char* GetWritePtr();
+    uint32_t GetFreeSize() const;
+    void OnWrite(uint32_t bytes) { writePos_ += bytes; }
+
+    // 읽기: 아직 처리하지 않은 데이터가 GetReadPtr() 부터 GetDataSize() 만큼 연속으로 있다
+    const char* GetReadPtr() const { return base_ + Offset(readPos_); }
+    uint32_t GetDataSize() const { return writePos_ - readPos_; }
+    void OnRead(uint32_t bytes);
+
+    // 풀에 돌려주기 전에 위치를 처음으로 되돌린다
+    void Reset() { readPos_ = 0; writePos_ = 0; }
+
+private:
+    bool MapMirrored();
+    void UnmapMirrored();
+    uint32_t Offset(uint32_t pos) const { return mirrored_ ? (pos & (capacity_ - 1)) : pos; }
+
+    char* base_ = nullptr;
+    uint32_t capacity_ = 0;
+    int node_ = -1;
+    bool mirrored_ = false;
+
+    // mirror 모드에서는 계속 증가하는 누적 위치 (차이만 쓰므로 wrap 되어도 된다)
+    uint32_t readPos_ = 0;
+    uint32_t writePos_ = 0;
+};
+
+// 수신 버퍼 대여 풀.
+// 쉬고 있는 세션은 버퍼 없이 "데이터 도착" 만 기다리다가, 데이터가 오면 여기서 빌리고
+// 받은 것을 다 파싱하면 돌려준다. 접속 수가 아니라 동시에 데이터를 받는 세션 수만큼만 버퍼가 있다.
+// NUMA 노드가 여럿이면(ThreadTopology::IsNumaLocalBuffers) 노드마다 따로 풀을 두고,
+// 빌리는 I/O 워커가 고정된 노드의 버퍼를 준다.
+class RecvBufferPool
+{
+public:
+    enum { BUFFER_SIZE = 65536 };
+
+    struct Stats
+    {
+        uint64_t lent;      // 지금 세션이 빌려 간 버퍼 수
+        uint64_t pooled;    // 풀에서 쉬고 있는 버퍼 수
+        uint64_t created;   // 지금까지 새로 만든 버퍼 수
+        uint64_t acquires;  // 대여 횟수
+    };
+
+    static std::unique_ptr<RecvBuffer> Acquire();
+    static void Release(std::unique_ptr<RecvBuffer> buffer);
+
+    // 풀에 남겨 둘 최대 개수 (노드마다). 넘치는 반납분은 바로 해제한다.
+    static void SetMaxPooled(size_t count);
+    static Stats GetStats();
+};
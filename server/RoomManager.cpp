@@ -1,21 +1,28 @@
+#include <algorithm>
+#include <cstring>
 #include "RoomManager.h"
 #include "ClientSession.h"
-#include "PlayerState.h" // PlayerState   ʿ
+#include "GameLogic.h"
 
-RoomManager::RoomManager() {
+std::atomic<int32_t> RoomManager::s_nextRoomId = 1;
+
+RoomManager::RoomManager(size_t shardIndex)
+    : shardIndex_(shardIndex)
+{
 }
 
-std::shared_ptr<GameRoom> RoomManager::CreateRoom(const std::string& title)
+std::shared_ptr<GameRoom> RoomManager::CreateRoom(int32_t roomId, const std::string& title)
 {
     std::lock_guard<std::mutex> lock(roomMutex_);
 
-    int roomId = nextRoomId_++;
+    auto it = rooms_.find(roomId);
+    if (it != rooms_.end()) return it->second;
 
     auto newRoom = std::make_shared<GameRoom>(roomId, title);
 
     rooms_[roomId] = newRoom;
 
-    std::cout << "[Room] Created Room " << roomId << ": " << title << std::endl;
+    std::cout << "[Room] Created Room " << roomId << ": " << title << " (shard " << shardIndex_ << ")" << std::endl;
     return newRoom;
 }
 
@@ -24,8 +31,13 @@ void RoomManager::UpdateAllRooms(float fixedDeltaTime, uint32_t serverTick) {
     for (auto& pair : rooms_) {
         auto& room = pair.second;
         room->Update(fixedDeltaTime);
-        room->BroadcastStateSnapshot(serverTick);
+        room->BroadcastStateSnapshot(serverTick, disconnected_);
     }
+
+    // 끊긴 세션은 방을 다 돈 뒤에 뺀다 (빈 방을 지우면 rooms_ 가 바뀐다)
+    for (uint32_t sessionId : disconnected_)
+        RemovePlayerLocked(sessionId);
+    disconnected_.clear();
 }
 
 bool RoomManager::JoinRoom(std::shared_ptr<ClientSession> session, int targetRoomId)
@@ -76,32 +88,24 @@ bool RoomManager::JoinRoom(std::shared_ptr<ClientSession> session, int targetRoo
         playerToRoomMap_.erase(sessionId);
     }
 
-    std::string playerName = "Unknown";
-    try {
-        playerName = session->GetName();
-        std::cout << "[Debug] Player Name: " << playerName << std::endl;
-    }
-    catch (...) {
-        std::cout << "[Error] Failed to get Player Name!" << std::endl;
-    }
-
-    auto newPlayerState = std::make_shared<PlayerState>(sessionId, playerName, targetRoomId);
+    std::cout << "[Debug] Player Name: " << session->GetName() << std::endl;
 
+    // 위치 / 속도는 방의 PlayerTable 에 (원점에서 시작)
     std::cout << "[Debug] Calling targetRoom->AddPlayer..." << std::endl;
-    targetRoom->AddPlayer(newPlayerState, session);
+    targetRoom->AddPlayer(session);
 
     playerToRoomMap_[sessionId] = targetRoomId;
 
-    std::cout << "[Debug] Calling session->SetCurrentRoom..." << std::endl;
-    session->SetCurrentRoom(targetRoom);
-
     std::cout << "[RoomManager] Join Success!" << std::endl;
     return true;
 }
 
 void RoomManager::RemovePlayerFromCurrentRoom(uint32_t sessionId) {
     std::lock_guard<std::mutex> lock(roomMutex_);
+    RemovePlayerLocked(sessionId);
+}
 
+void RoomManager::RemovePlayerLocked(uint32_t sessionId) {
     if (playerToRoomMap_.count(sessionId)) {
         int roomId = playerToRoomMap_[sessionId];
 
@@ -120,58 +124,58 @@ void RoomManager::RemovePlayerFromCurrentRoom(uint32_t sessionId) {
     }
 }
 
-std::shared_ptr<GameRoom> RoomManager::GetRoom(int roomId) {
-    std::lock_guard<std::mutex> lock(roomMutex_);
-    auto it = rooms_.find(roomId);
-    if (it != rooms_.end()) return it->second;
-    return nullptr;
+GameRoom* RoomManager::FindRoomOfPlayer(uint32_t sessionId) {
+    auto playerIt = playerToRoomMap_.find(sessionId);
+    if (playerIt == playerToRoomMap_.end()) return nullptr;
+
+    auto roomIt = rooms_.find(playerIt->second);
+    return roomIt != rooms_.end() ? roomIt->second.get() : nullptr;
 }
 
-std::shared_ptr<GameRoom> RoomManager::GetRoomOfPlayer(uint32_t sessionId) {
+void RoomManager::CollectRoomList(std::vector<RoomInfo>& out)
+{
     std::lock_guard<std::mutex> lock(roomMutex_);
-    if (playerToRoomMap_.count(sessionId)) {
-        int roomId = playerToRoomMap_[sessionId];
-        if (rooms_.count(roomId)) {
-            return rooms_[roomId];
-        }
+
+    for (auto& pair : rooms_)
+    {
+        RoomInfo info;
+        info.roomId = pair.first;
+        info.userCount = pair.second->GetPlayerCount();
+        out.push_back(info);
     }
-    return nullptr;
 }
 
-void RoomManager::SendRoomList(std::shared_ptr<ClientSession> session)
+bool RoomManager::SetSnapshotRate(int32_t roomId, uint32_t hz)
 {
     std::lock_guard<std::mutex> lock(roomMutex_);
 
-    uint16_t roomCount = static_cast<uint16_t>(rooms_.size());
-    uint16_t bodySize = sizeof(PacketRoomListRes) + (sizeof(RoomInfo) * roomCount);
-    uint16_t packetSize = sizeof(GameHeader) + bodySize;
+    auto it = rooms_.find(roomId);
+    if (it == rooms_.end()) return false;
 
-    std::vector<char> sendBuffer(packetSize);
-    char* ptr = sendBuffer.data();
+    it->second->SetSnapshotRate(hz);
+    return true;
+}
 
-    GameHeader* header = reinterpret_cast<GameHeader*>(ptr);
-    header->packetSize = packetSize;
-    header->packetId = (uint16_t)PacketId::ROOM_LIST_RES;
-    ptr += sizeof(GameHeader);
+void RoomManager::PrintSnapshotRateReport()
+{
+    std::lock_guard<std::mutex> lock(roomMutex_);
 
-    PacketRoomListRes* res = reinterpret_cast<PacketRoomListRes*>(ptr);
-    res->count = roomCount;
-    ptr += sizeof(PacketRoomListRes);
+    const double tickHz = GameLogic::GetTickHz();
+    std::cout << "[Rooms] shard " << shardIndex_ << ": rooms " << rooms_.size() << ", simulation " << tickHz << " Hz" << std::endl;
 
     for (auto& pair : rooms_)
     {
-        std::shared_ptr<GameRoom> room = pair.second;
-
-        RoomInfo info;
-        info.roomId = pair.first;
-        info.userCount = room->GetPlayerCount();
-
-        std::string title = "Game Room " + std::to_string(info.roomId);
-        strncpy_s(info.title, title.c_str(), 32);
-
-        memcpy(ptr, &info, sizeof(RoomInfo));
-        ptr += sizeof(RoomInfo);
+        GameRoom::SnapshotRateSummary summary = pair.second->GetSnapshotRateSummary();
+        std::cout << "[Rooms] #" << pair.first << " " << pair.second->GetName()
+            << ": sessions " << summary.sessions
+            << ", snapshot " << tickHz / summary.roomInterval << " Hz";
+        if (summary.sessions > 0)
+        {
+            std::cout << ", sessions " << tickHz / summary.slowestInterval << " ~ " << tickHz / summary.fastestInterval << " Hz"
+                << " (slowed " << summary.slowedSessions << ")";
+        }
+        if (summary.averageRttMs >= 0)
+            std::cout << ", rtt avg " << summary.averageRttMs << " ms, max " << summary.maxRttMs << " ms";
+        std::cout << std::endl;
     }
-
-    session->PushSendPacket(sendBuffer);
-}
\ No newline at end of file
+}
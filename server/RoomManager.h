@@ -4,19 +4,28 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 #include <iostream>
 #include "GameRoom.h"
 #include "NetProtocol.h"
 
 class ClientSession;
 
+// 로직 샤드 하나가 맡은 방들. 방 번호로 샤드가 정해진다 (Server::GetShardOfRoom).
+// - 방은 샤드 스레드만 건드린다 (GameRoom 은 잠그지 않는다).
+// - 방 목록과 방 안의 세션을 바꾸는 일 (입장 / 퇴장, 방 만들기 / 지우기, 틱 갱신) 은 샤드 스레드가 roomMutex_ 를 잡고 한다.
+//   그래서 다른 스레드 (로비의 방 목록, 콘솔) 는 roomMutex_ 를 잡으면 방을 읽을 수 있다.
+// - 이동 / 채팅은 잠그지 않고 FindRoomOfPlayer 로 찾는다 (샤드 스레드에서만).
 class RoomManager
 {
 public:
-    RoomManager();
-    static RoomManager* Instance() { static RoomManager instance; return &instance; }
+    explicit RoomManager(size_t shardIndex = 0);
 
-    std::shared_ptr<GameRoom> CreateRoom(const std::string& name);
+    // 새 방 번호 (로비가 CREATE_ROOM 을 받을 때 정한다. 모든 샤드가 같이 쓴다)
+    static int32_t AllocateRoomId() { return s_nextRoomId.fetch_add(1); }
+
+    // 이미 있는 번호면 그 방을 돌려준다
+    std::shared_ptr<GameRoom> CreateRoom(int32_t roomId, const std::string& name);
 
     void UpdateAllRooms(float fixedDeltaTime, uint32_t serverTick);
 
@@ -24,14 +33,24 @@ public:
 
     void RemovePlayerFromCurrentRoom(uint32_t sessionId);
 
-    std::shared_ptr<GameRoom> GetRoom(int roomId);
-    std::shared_ptr<GameRoom> GetRoomOfPlayer(uint32_t sessionId);
+    // 샤드 스레드에서만 (잠그지 않는다)
+    GameRoom* FindRoomOfPlayer(uint32_t sessionId);
+
+    // 다른 스레드에서 불러도 된다
+    void CollectRoomList(std::vector<RoomInfo>& out);
+    bool SetSnapshotRate(int32_t roomId, uint32_t hz);
 
-    void SendRoomList(std::shared_ptr<ClientSession> session);
+    // 방마다 스냅샷 속도와 세션별로 고른 속도 범위, RTT 를 출력한다
+    void PrintSnapshotRateReport();
 
 private:
+    static std::atomic<int32_t> s_nextRoomId;
+
+    size_t shardIndex_;
     std::map<int, std::shared_ptr<GameRoom>> rooms_;
     std::mutex roomMutex_;
     std::map<uint32_t, int> playerToRoomMap_;
-    std::atomic<int> nextRoomId_ = 1;
-};
\ No newline at end of file
+    std::vector<uint32_t> disconnected_;   // 틱 갱신에서 나온 끊긴 세션 (용량 유지)
+
+    void RemovePlayerLocked(uint32_t sessionId);
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "NetProtocol.h"
+#include "SendBufferPool.h"
+
+// 헤더(GameHeader)까지 채워진 완성 패킷.
+// 한 번 만들어 채운 뒤에는 바꾸지 않고, 여러 세션의 송신 큐가 shared_ptr 로 같이 참조한다.
+// (방 브로드캐스트는 인원 수와 상관없이 버퍼 하나로 끝난다)
+// 데이터와 shared_ptr 제어 블록 모두 SendBufferPool 에서 가져오고, 마지막 참조가
+// 풀리는 시점(보통 OnSendCompleted 뒤 송신 배치를 비울 때)에 풀로 돌아간다.
+class SendBuffer
+{
+public:
+    SendBuffer(PacketId id, uint16_t bodySize)
+        : size_(sizeof(GameHeader) + bodySize)
+    {
+        data_ = static_cast<char*>(SendBufferPool::Allocate(size_));
+
+        GameHeader* header = reinterpret_cast<GameHeader*>(data_);
+        header->packetSize = static_cast<uint16_t>(size_);
+        header->packetId = static_cast<uint16_t>(id);
+    }
+
+    ~SendBuffer()
+    {
+        SendBufferPool::Release(data_, size_);
+    }
+
+    SendBuffer(const SendBuffer&) = delete;
+    SendBuffer& operator=(const SendBuffer&) = delete;
+
+    // 본문을 채울 빈 패킷. 채운 뒤 SendBufferRef 로 넘긴다.
+    static std::shared_ptr<SendBuffer> Create(PacketId id, uint16_t bodySize)
+    {
+        return std::allocate_shared<SendBuffer>(PoolAllocator<SendBuffer>(), id, bodySize);
+    }
+
+    static std::shared_ptr<SendBuffer> Create(PacketId id, const void* body, uint16_t bodySize)
+    {
+        auto buffer = Create(id, bodySize);
+        if (bodySize > 0)
+            std::memcpy(buffer->GetBody(), body, bodySize);
+        return buffer;
+    }
+
+    // 스키마로 만든 패킷 (NetProtocol.h). 본문은 실제 크기만큼만 잡는다.
+    template <typename T>
+    static std::shared_ptr<SendBuffer> Create(const T& packet)
+    {
+        static_assert(T::MAX_SIZE + sizeof(GameHeader) <= UINT16_MAX, "packet too large");
+
+        const size_t bodySize = packet.GetSize();
+        auto buffer = Create(T::ID, static_cast<uint16_t>(bodySize));
+        PacketWriter writer(buffer->GetBody(), bodySize);
+        packet.Write(writer);
+        return buffer;
+    }
+
+    char* GetBody() { return data_ + sizeof(GameHeader); }
+
+    const char* GetData() const { return data_; }
+    uint32_t GetSize() const { return size_; }
+    PacketId GetPacketId() const { return static_cast<PacketId>(reinterpret_cast<const GameHeader*>(data_)->packetId); }
+
+private:
+    char* data_ = nullptr;
+    uint32_t size_ = 0;
+};
+
+using SendBufferRef = std::shared_ptr<const SendBuffer>;
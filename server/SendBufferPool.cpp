@@ -0,0 +1,183 @@
+#include "SendBufferPool.h"
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    struct CentralList
+    {
+        std::mutex lock;
+        std::vector<void*> blocks;
+    };
+
+    CentralList g_central[SendBufferPool::SIZE_CLASS_COUNT];
+
+    std::atomic<uint64_t> g_allocations = 0;
+    std::atomic<uint64_t> g_threadCacheHits = 0;
+    std::atomic<uint64_t> g_centralHits = 0;
+    std::atomic<uint64_t> g_systemAllocs = 0;
+    std::atomic<uint64_t> g_oversizeAllocs = 0;
+    std::atomic<uint64_t> g_releases = 0;
+
+    int GetSizeClass(size_t size)
+    {
+        size_t blockSize = SendBufferPool::MIN_BLOCK_SIZE;
+        int sizeClass = 0;
+        while (blockSize < size)
+        {
+            blockSize <<= 1;
+            sizeClass++;
+        }
+        return sizeClass;
+    }
+
+    size_t GetBlockSize(int sizeClass)
+    {
+        return (size_t)SendBufferPool::MIN_BLOCK_SIZE << sizeClass;
+    }
+
+    // 카운터는 스레드 안에서 모았다가 공용 목록과 주고받을 때 한 번에 더한다
+    struct ThreadCache
+    {
+        std::vector<void*> blocks[SendBufferPool::SIZE_CLASS_COUNT];
+
+        uint64_t allocations = 0;
+        uint64_t threadCacheHits = 0;
+        uint64_t centralHits = 0;
+        uint64_t systemAllocs = 0;
+        uint64_t releases = 0;
+
+        ThreadCache()
+        {
+            for (auto& list : blocks)
+                list.reserve(SendBufferPool::THREAD_CACHE_LIMIT);
+        }
+
+        ~ThreadCache()
+        {
+            for (int i = 0; i < SendBufferPool::SIZE_CLASS_COUNT; ++i)
+                ReturnToCentral(i, blocks[i].size());
+            FlushCounters();
+        }
+
+        void FlushCounters()
+        {
+            g_allocations.fetch_add(allocations, std::memory_order_relaxed);
+            g_threadCacheHits.fetch_add(threadCacheHits, std::memory_order_relaxed);
+            g_centralHits.fetch_add(centralHits, std::memory_order_relaxed);
+            g_systemAllocs.fetch_add(systemAllocs, std::memory_order_relaxed);
+            g_releases.fetch_add(releases, std::memory_order_relaxed);
+            allocations = threadCacheHits = centralHits = systemAllocs = releases = 0;
+        }
+
+        void Refill(int sizeClass)
+        {
+            std::vector<void*>& list = blocks[sizeClass];
+            {
+                CentralList& central = g_central[sizeClass];
+                std::lock_guard<std::mutex> lock(central.lock);
+
+                size_t count = (std::min)(central.blocks.size(), (size_t)SendBufferPool::TRANSFER_BATCH);
+                list.insert(list.end(), central.blocks.end() - count, central.blocks.end());
+                central.blocks.resize(central.blocks.size() - count);
+            }
+            FlushCounters();
+        }
+
+        void ReturnToCentral(int sizeClass, size_t count)
+        {
+            std::vector<void*>& list = blocks[sizeClass];
+            if (count == 0) return;
+
+            CentralList& central = g_central[sizeClass];
+            std::lock_guard<std::mutex> lock(central.lock);
+            central.blocks.insert(central.blocks.end(), list.end() - count, list.end());
+            list.resize(list.size() - count);
+        }
+    };
+
+    thread_local ThreadCache t_cache;
+}
+
+void* SendBufferPool::Allocate(size_t size)
+{
+    if (size > MAX_BLOCK_SIZE)
+    {
+        g_oversizeAllocs.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(size);
+    }
+
+    int sizeClass = GetSizeClass(size);
+    std::vector<void*>& list = t_cache.blocks[sizeClass];
+    t_cache.allocations++;
+
+    if (!list.empty())
+    {
+        t_cache.threadCacheHits++;
+        void* block = list.back();
+        list.pop_back();
+        return block;
+    }
+
+    t_cache.Refill(sizeClass);
+    if (!list.empty())
+    {
+        t_cache.centralHits++;
+        void* block = list.back();
+        list.pop_back();
+        return block;
+    }
+
+    t_cache.systemAllocs++;
+    return ::operator new(GetBlockSize(sizeClass));
+}
+
+void SendBufferPool::Release(void* block, size_t size)
+{
+    if (block == nullptr) return;
+
+    if (size > MAX_BLOCK_SIZE)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    int sizeClass = GetSizeClass(size);
+    std::vector<void*>& list = t_cache.blocks[sizeClass];
+    t_cache.releases++;
+
+    // 다른 스레드에서 만든 블록이 한쪽에 계속 쌓이지 않도록 넘친 만큼 공용 목록으로 돌려준다
+    if (list.size() >= THREAD_CACHE_LIMIT)
+    {
+        t_cache.ReturnToCentral(sizeClass, TRANSFER_BATCH);
+        t_cache.FlushCounters();
+    }
+
+    list.push_back(block);
+}
+
+SendBufferPool::Stats SendBufferPool::GetStats()
+{
+    Stats stats = {};
+    stats.allocations = g_allocations.load();
+    stats.threadCacheHits = g_threadCacheHits.load();
+    stats.centralHits = g_centralHits.load();
+    stats.systemAllocs = g_systemAllocs.load();
+    stats.oversizeAllocs = g_oversizeAllocs.load();
+    stats.releases = g_releases.load();
+    return stats;
+}
+
+void SendBufferPool::PrintStats()
+{
+    Stats stats = GetStats();
+    std::cout << "[Stats] send buffer pool: allocs " << stats.allocations
+        << ", thread cache hits " << stats.threadCacheHits
+        << ", central hits " << stats.centralHits
+        << ", system allocs " << stats.systemAllocs
+        << ", oversize " << stats.oversizeAllocs
+        << ", releases " << stats.releases
+        << ", hit rate " << stats.HitRate() * 100.0 << "%" << std::endl;
+}
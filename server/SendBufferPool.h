@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+// 송신 패킷용 크기별(size class) 풀.
+// - 스레드마다 클래스별 캐시를 두고, 비었을 때/넘칠 때만 공용 목록과 묶음으로 주고받는다.
+// - 할당한 스레드와 반납하는 스레드가 달라도 된다 (로직 스레드에서 만들고 I/O 워커에서 반납).
+// - MAX_BLOCK_SIZE 보다 큰 요청은 풀을 거치지 않고 operator new 로 처리한다.
+class SendBufferPool
+{
+public:
+    enum
+    {
+        MIN_BLOCK_SIZE = 64,
+        MAX_BLOCK_SIZE = 128 * 1024,
+        SIZE_CLASS_COUNT = 12,      // 64, 128, ... 128KB
+        THREAD_CACHE_LIMIT = 128,   // 클래스별 스레드 캐시 최대 개수
+        TRANSFER_BATCH = 32,        // 공용 목록과 한 번에 주고받는 개수
+    };
+
+    struct Stats
+    {
+        uint64_t allocations;
+        uint64_t threadCacheHits;   // 스레드 캐시에서 바로 나간 수
+        uint64_t centralHits;       // 공용 목록에서 묶음으로 가져온 수
+        uint64_t systemAllocs;      // 풀이 비어 새로 할당한 블록 수
+        uint64_t oversizeAllocs;    // 풀 대상이 아닌 큰 요청
+        uint64_t releases;
+
+        double HitRate() const
+        {
+            return allocations ? (double)(threadCacheHits + centralHits) / allocations : 0.0;
+        }
+    };
+
+    static void* Allocate(size_t size);
+    static void Release(void* block, size_t size);
+
+    // 스레드 캐시의 카운터는 묶음 이동/스레드 종료 때 합산되므로 약간 늦게 반영된다
+    static Stats GetStats();
+    static void PrintStats();
+};
+
+// allocate_shared 용 STL allocator. 제어 블록과 객체를 같은 풀 블록에 담는다.
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(SendBufferPool::Allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { SendBufferPool::Release(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
@@ -1,20 +1,40 @@
 #include <iostream>
+#include <algorithm>
 #include "Server.h"
-#include "IOCPWorker.h"
+#include "IOEngine.h"
 #include "GameLogic.h"
+#include "LobbyLogic.h"
 #include "Persistence.h"
+#include "ThreadTopology.h"
 
-extern DWORD WINAPI IOCPWorkerThread(LPVOID arg);
-LockFreeQueue<std::unique_ptr<ICommand>> Server::s_gltInputQueue;
+struct Server::LogicShard
+{
+    explicit LogicShard(size_t index) : roomManager(index) {}
+
+    RoomManager roomManager;
+    std::unique_ptr<GameLogic> logic;
+    std::thread thread;
+};
+
+CommandQueue Server::s_lobbyQueue;
+std::vector<std::unique_ptr<CommandQueue>> Server::s_roomQueues;
 
-Server::Server(int iocpThreadCount, int dbThreadCount)
-    : hIOCP_(NULL),
-    listenSock_(INVALID_SOCKET),
-    nextSessionId_(1)
+Server::Server(int iocpThreadCount, int dbThreadCount, int logicThreadCount)
 {
+    ioEngine_ = IOEngine::Create();
     persistence_ = std::make_unique<Persistence>(dbThreadCount);
-    gameLogic_ = std::make_unique<GameLogic>(Server::GetGLTInputQueue(), roomManager_, *persistence_);
-    iocpThreadCount_ = iocpThreadCount;
+
+    size_t shardCount = logicThreadCount > 0 ? logicThreadCount : 1;
+    s_roomQueues.clear();
+    for (size_t i = 0; i < shardCount; ++i)
+    {
+        s_roomQueues.push_back(std::make_unique<CommandQueue>());
+        shards_.push_back(std::make_unique<LogicShard>(i));
+        shards_[i]->logic = std::make_unique<GameLogic>(*s_roomQueues[i], shards_[i]->roomManager, *persistence_);
+    }
+    lobbyLogic_ = std::make_unique<LobbyLogic>(GetLobbyQueue(), *persistence_, sessionTimers_);
+
+    iocpThreadCount_ = iocpThreadCount > 0 ? iocpThreadCount : 1;
 }
 
 Server::~Server()
@@ -22,84 +42,92 @@ Server::~Server()
     Stop();
 }
 
-// Start:     
-bool Server::Start(USHORT port)
+// Start: 서버 실행 및 스레드 생성
+bool Server::Start(uint16_t port)
 {
-    // 1. Ʈŷ  IOCP  (WSAStartup, CreateIoCompletionPort )
-    WSADATA wsaData;
-    WSAStartup(MAKEWORD(2, 2), &wsaData);
-
-    listenSock_ = WSASocket(AF_INET, SOCK_STREAM, 0, NULL, 0, WSA_FLAG_OVERLAPPED);
-
-    sockaddr_in addr;
-    ZeroMemory(&addr, sizeof(addr));
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(9190);
-    addr.sin_addr.s_addr = htonl(INADDR_ANY);
-
-    bind(listenSock_, (SOCKADDR*)&addr, sizeof(addr));
-    listen(listenSock_, SOMAXCONN);
-
-    hIOCP_ = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+    // 1. 네트워킹 및 I/O 엔진 설정 (IOCP: WSAStartup, CreateIoCompletionPort / epoll: epoll_create1)
+    if (!ioEngine_->Initialize(iocpThreadCount_))
+    {
+        std::cout << "[Error] " << ioEngine_->GetName() << " Engine Init Failed" << std::endl;
+        return false;
+    }
+    std::cout << "[Server] I/O Engine: " << ioEngine_->GetName() << std::endl;
 
-    //޸ ̸ 
+    //메모리 미리 예약
     iocpWorkerThreads_.reserve(iocpThreadCount_);
 
-    // 2. IOCP Worker Thread   
+    // 2. I/O Worker Thread 생성 및 실행 (ThreadTopology 가 정한 코어로 옮긴 뒤 시작)
     for (size_t i = 0; i < iocpThreadCount_; ++i)
     {
-        // IOCPWorkerThread Լ ͸ Ͽ  
-        iocpWorkerThreads_.emplace_back(IOCPWorkerThread, hIOCP_);
+        iocpWorkerThreads_.emplace_back([this, i] {
+            ThreadTopology::EnterIoThread(i);
+            ioEngine_->RunWorker();
+        });
     }
 
-    // 3. Game Logic Thread (GLT) 
-    gameLogicThread_ = std::thread(&GameLogic::Run, gameLogic_.get());
-
-    // 4. Ŭ̾Ʈ   
-    acceptThread_ = std::thread(&Server::AcceptLoop, this);
+    // 3. 방 샤드 스레드 (샤드마다 전용 코어) 와 로비 스레드 실행
+    for (size_t i = 0; i < shards_.size(); ++i)
+    {
+        shards_[i]->thread = std::thread([this, i] {
+            ThreadTopology::EnterLogicThread(i);
+            shards_[i]->logic->Run();
+        });
+    }
+    lobbyThread_ = std::thread([this] {
+        ThreadTopology::EnterSharedThread();
+        lobbyLogic_->Run();
+    });
+    std::cout << "[Server] Logic shards: " << shards_.size() << " (+ lobby)" << std::endl;
+
+    // 4. 비동기 accept 시작 (수락된 소켓은 완료를 받은 I/O 워커에서 HandleNewClient 로 들어온다)
+    if (!ioEngine_->Listen(port, [this](SOCKET clientSock) { HandleNewClient(clientSock); }))
+    {
+        std::cout << "[Error] Listen Failed on port " << port << std::endl;
+        return false;
+    }
+    std::cout << "[Server] Listening on port " << port << std::endl;
 
-    return true; //  
+    return true; // 성공 시
 }
 
-// Stop:     ڿ 
+// Stop: 모든 스레드 종료 및 자원 정리
 void Server::Stop()
 {
     if (isStopped_) return;
     isStopped_ = true;
 
     std::cout << "Stopping server..." << std::endl;
-    // 1. Accept  
-    accepting_ = false;
+    // 1. accept 정지 (걸려 있는 비동기 accept 취소)
+    ioEngine_->StopListen();
 
-    if (listenSock_ != INVALID_SOCKET) {
-        closesocket(listenSock_);
-        listenSock_ = INVALID_SOCKET;
+    // 2. DBTP 정지 (Persistence::Stop()). 로직 스레드보다 먼저 멈춰, 기다리던 코루틴의 RESUME 이
+    //    아직 도는 로직 스레드로 들어가게 한다. 이후의 co_await 는 멈추지 않고 빈 결과로 이어진다.
+    if (persistence_)
+    {
+        persistence_->Stop();
     }
 
-    if (acceptThread_.joinable()) 
-    {
-        acceptThread_.join();
-    }   
+    // 3. 로직 스레드 (방 샤드, 로비) 에 정지 신호 전달 및 조인 (남은 커맨드는 나가기 전에 처리한다)
+    for (auto& shard : shards_)
+        shard->logic->Stop();
+    if (lobbyLogic_)
+        lobbyLogic_->Stop();
 
-    // 2. GLT  ȣ   
-    if (gameLogic_)
+    for (auto& shard : shards_)
     {
-        gameLogic_->Stop();
-        if (gameLogicThread_.joinable())
+        if (shard->thread.joinable())
         {
-            gameLogicThread_.join();
+            shard->thread.join();
         }
     }
-
-    // 3. IOCP Worker Thread  ȣ  (PostQueuedCompletionStatus  ̿)  
-    if (hIOCP_ != NULL)
+    if (lobbyThread_.joinable())
     {
-        for (size_t i = 0; i < iocpWorkerThreads_.size(); ++i)
-        {
-            PostQueuedCompletionStatus(hIOCP_, 0, 0, NULL);
-        }
+        lobbyThread_.join();
     }
 
+    // 4. I/O Worker Thread 정지 신호 전달 (IOCP: PostQueuedCompletionStatus / epoll: eventfd) 및 조인
+    ioEngine_->WakeupWorkers(iocpWorkerThreads_.size());
+
     for (auto& t : iocpWorkerThreads_)
     {
         if (t.joinable())
@@ -108,98 +136,195 @@ void Server::Stop()
         }
     }
 
-    // 4. DBTP  (Persistence::Stop())
-    if (persistence_)
-    {
-        persistence_->Stop();
-    }
+    ioEngine_->Close();
 
-    if (hIOCP_ != NULL)
-    {
-        CloseHandle(hIOCP_);
-        hIOCP_ = NULL;
-    }
+    // 5. 세션을 쓰는 스레드가 모두 끝났으니 해제를 미뤄 둔 세션을 놓는다
+    SessionReclaimer::Drain();
+}
 
-    WSACleanup();
+RoomManager& Server::GetShardRoomManager(size_t index)
+{
+    return shards_[index]->roomManager;
 }
 
-LockFreeQueue<std::unique_ptr<ICommand>>& Server::GetGLTInputQueue()
+CommandQueue& Server::GetLobbyQueue()
 {
-    return s_gltInputQueue;
+    return s_lobbyQueue;
 }
 
-// Ŭ̾Ʈ    
-void Server::AcceptLoop()
+// 새 클라이언트 처리 로직 구현 (I/O 워커 스레드에서 호출)
+void Server::HandleNewClient(SOCKET clientSock)
 {
-    while (accepting_.load()) {
-        SOCKET clientSock = accept(listenSock_, NULL, NULL);
+    std::cout << "New Client connected! Socket: " << clientSock << "\n";
 
-        if (clientSock == INVALID_SOCKET)
-        {
-            //    ߻   
-            if (!accepting_.load()) break;
+    // 세션 테이블에서 슬롯을 잡아 ID 를 받는다
+    uint32_t newId = sessions_.Reserve();
+    if (newId == SessionTable<ClientSession>::INVALID_ID)
+    {
+        std::cout << "[Error] Session Table Full" << std::endl;
+        closesocket(clientSock);
+        return;
+    }
 
-            // ¥  α    
-            int err = WSAGetLastError();
-            std::cout << "[Error] Accept Failed: " << err << std::endl;
-            continue;
-        }
+    // ClientSession에 클라이언트 소켓 등록
+    auto newSession = std::make_shared<ClientSession>(clientSock, newId, *ioEngine_);
 
-        std::cout << "New Client connected! Socket: " << clientSock << "\n";
-        HandleNewClient(clientSock);
+    // I/O 엔진에 클라이언트 소켓 등록
+    if (!ioEngine_->Attach(newSession.get()))
+    {
+        std::cout << "[Error] Attach Failed: " << GetLastSocketError() << std::endl;
+        sessions_.Remove(newId);
+        return; // 소켓은 세션 소멸자에서 닫힌다
     }
+
+    sessions_.Publish(newId, newSession);
+
+    // 로그인 마감 / 유휴 타이머는 로비 스레드에서 건다
+    GetLobbyQueue().Push(Command::SessionOpened(newId));
+
+    newSession->PostRecv();
 }
 
-//  Ŭ̾Ʈ ó  
-void Server::HandleNewClient(SOCKET clientSock)
+// 다른 스레드가 아직 맨 포인터로 쓰고 있거나 I/O 가 걸려 있을 수 있으므로 바로 놓지 않는다
+void Server::RemoveSession(uint32_t sessionId)
 {
-    // ClientSession Ŭ̾Ʈ  
-    uint32_t newId = nextSessionId_.fetch_add(1);
-    auto newSession = std::make_shared<ClientSession>(clientSock, newId);
-
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    sessions_.emplace(newId, newSession);
-
-    // IOCP Ŭ̾Ʈ  
-    CreateIoCompletionPort(
-        (HANDLE)clientSock,
-        hIOCP_,
-        (ULONG_PTR)newSession.get(),
-        0
-    );
-
-    newSession->PostRecv(hIOCP_);
+    std::shared_ptr<ClientSession> session = sessions_.Remove(sessionId);
+    if (session == nullptr) return;
+
+    GetLobbyQueue().Push(Command::SessionClosed(sessionId));
+    SessionReclaimer::Retire(std::move(session));
 }
 
-void Server::RemoveSession(uint32_t sessionId)
+ClientSession* Server::GetSession(uint32_t id)
+{
+    return sessions_.Get(id);
+}
+
+// 해당 유저가 접속중인지 확인하는 함수
+bool Server::IsUserConnected(const std::string& username)
 {
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    sessions_.erase(sessionId);
+    return users_.Find(username) != 0;
 }
 
-std::shared_ptr<ClientSession> Server::GetSession(uint32_t id)
+size_t Server::GetSessionCount()
 {
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    auto it = sessions_.find(id);
+    return sessions_.Size();
+}
 
-    if (it == sessions_.end())
-        return nullptr;
+void Server::PrintMemoryReport()
+{
+    size_t sessionCount = GetSessionCount();
+    RecvBufferPool::Stats recvStats = RecvBufferPool::GetStats();
+
+    // 세션 객체(make_shared 제어 블록, 송신 큐의 빈 노드 포함) + 엔진 컨텍스트 + 세션 테이블 슬롯
+    const size_t sessionBytes = sizeof(ClientSession) + 16 + SendBufferPool::MIN_BLOCK_SIZE;
+    const size_t contextBytes = ioEngine_->GetSessionContextSize();
+    const size_t slotBytes = sizeof(std::atomic<uint64_t>) + sizeof(std::shared_ptr<ClientSession>) + sizeof(ClientSession*) + sizeof(uint32_t) + 4;
+    const size_t fixedBytes = sessionBytes + contextBytes + slotBytes;
+
+    const size_t recvBufferBytes = RecvBufferPool::BUFFER_SIZE;
+    size_t totalBytes = sessionCount * fixedBytes + (size_t)(recvStats.lent + recvStats.pooled) * recvBufferBytes;
+
+    std::cout << "[Memory] sessions: " << sessionCount
+        << ", recv buffer lending: " << (ClientSession::IsLendingRecvBuffers() ? "on" : "off") << std::endl;
+    std::cout << "[Memory] per session fixed: " << fixedBytes << " B (session " << sessionBytes
+        << ", " << ioEngine_->GetName() << " context " << contextBytes
+        << ", table slot " << slotBytes << ")" << std::endl;
+    std::cout << "[Memory] recv buffers (" << recvBufferBytes / 1024 << " KB): lent " << recvStats.lent
+        << ", pooled " << recvStats.pooled
+        << ", created " << recvStats.created
+        << ", acquires " << recvStats.acquires << std::endl;
+    SessionReclaimer::Stats reclaimStats = SessionReclaimer::GetStats();
+    std::cout << "[Memory] session reclamation: epoch " << reclaimStats.epoch
+        << ", retired " << reclaimStats.retired
+        << ", reclaimed " << reclaimStats.reclaimed
+        << ", pending " << reclaimStats.pending
+        << " (waiting on I/O " << reclaimStats.waitingIo << ")" << std::endl;
+    CommandQueue::Stats commandStats = GetLobbyQueue().GetStats();
+    std::cout << "[Memory] lobby command queue: " << commandStats.rings << " lane rings x "
+        << sizeof(Command) * CommandQueue::RING_SIZE / 1024 << " KB"
+        << ", pushed " << commandStats.pushed
+        << ", overflowed " << commandStats.overflowed << std::endl;
+    for (size_t i = 0; i < s_roomQueues.size(); ++i)
+    {
+        commandStats = s_roomQueues[i]->GetStats();
+        std::cout << "[Memory] shard " << i << " command queue: " << commandStats.rings << " lane rings"
+            << ", pushed " << commandStats.pushed
+            << ", overflowed " << commandStats.overflowed << std::endl;
+    }
+    std::cout << "[Memory] estimated total: " << totalBytes / 1024 << " KB"
+        << ", per session: " << (sessionCount ? totalBytes / sessionCount : 0) << " B"
+        << " (send queues / snapshots not included)" << std::endl;
+}
 
-    return it->second;
+void Server::PrintTickReport()
+{
+    std::cout << "[Ticks] " << GameLogic::GetTickHz() << " Hz (" << 1000000 / GameLogic::GetTickHz() << " us)"
+        << ", lobby wakeups " << lobbyLogic_->GetWakeupCount() << std::endl;
+    for (size_t i = 0; i < shards_.size(); ++i)
+    {
+        const TickStats& stats = shards_[i]->logic->GetTickStats();
+        std::cout << "[Ticks] shard " << i << ": ticks " << stats.ticks.load()
+            << ", overruns " << stats.overruns.load()
+            << ", catch-up " << stats.catchUpTicks.load()
+            << ", dropped " << stats.droppedTicks.load()
+            << ", wakeups " << stats.wakeups.load() << std::endl;
+        std::cout << "[Ticks] shard " << i << " work us: p50 " << stats.work.Percentile(0.5)
+            << ", p99 " << stats.work.Percentile(0.99)
+            << ", p99.9 " << stats.work.Percentile(0.999)
+            << ", max " << stats.work.GetMax()
+            << " / lateness us: p50 " << stats.lateness.Percentile(0.5)
+            << ", p99 " << stats.lateness.Percentile(0.99)
+            << ", max " << stats.lateness.GetMax() << std::endl;
+    }
 }
 
-// ش   Ȯϴ Լ
-bool Server::IsUserConnected(const std::string& username)
+void Server::PrintSendQueueReport(size_t topCount)
 {
-    std::lock_guard<std::mutex> lock(sessionMutex_);
+    // 정렬 도중 값이 바뀌지 않도록 한 번 읽어 둔 값으로 비교한다
+    struct Entry
+    {
+        std::shared_ptr<ClientSession> session;
+        uint32_t bytes;
+        uint32_t packets;
+        bool congested;
+    };
+
+    std::vector<Entry> entries;
+    entries.reserve(sessions_.Size());
+    sessions_.ForEach([&](uint32_t, const std::shared_ptr<ClientSession>& session) {
+        entries.push_back({ session, session->GetQueuedBytes(), session->GetQueuedPackets(), session->IsCongested() });
+    });
+
+    uint64_t totalBytes = 0;
+    uint64_t totalPackets = 0;
+    size_t congestedCount = 0;
+    for (const Entry& entry : entries)
+    {
+        totalBytes += entry.bytes;
+        totalPackets += entry.packets;
+        if (entry.congested) congestedCount++;
+    }
+
+    std::cout << "[Queues] sessions: " << entries.size()
+        << ", congested: " << congestedCount
+        << ", queued bytes: " << totalBytes
+        << ", queued packets: " << totalPackets << std::endl;
 
-    for (auto& pair : sessions_)
+    size_t count = (std::min)(topCount, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+        [](const Entry& a, const Entry& b) { return a.bytes > b.bytes; });
+
+    for (size_t i = 0; i < count; ++i)
     {
-        auto session = pair.second;
-        if (session && session->GetName() == username)
-        {
-            return true;
-        }
+        const Entry& entry = entries[i];
+        if (entry.packets == 0) break;
+
+        std::cout << "[Queues] #" << entry.session->GetSessionId() << " " << entry.session->GetName()
+            << ": " << entry.bytes << " bytes, " << entry.packets << " packets"
+            << ", coalesced snapshots " << entry.session->GetCoalescedSnapshots()
+            << ", snapshot " << static_cast<double>(GameLogic::GetTickHz()) / (std::max)(1u, entry.session->GetSnapshotInterval()) << " Hz"
+            << ", rtt " << entry.session->GetSnapshotRttMs() << " ms"
+            << (entry.congested ? ", congested" : "") << std::endl;
     }
-    return false;
-}
\ No newline at end of file
+}
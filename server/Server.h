@@ -1,62 +1,92 @@
 #pragma once
 
-#include <winsock2.h>
-#include <windows.h>
 #include <vector>
 #include <memory>
 #include <thread>
 #include <mutex>
-#include <map>
 #include "ClientSession.h"
+#include "CommandQueue.h"
 #include "Utility.h"
-#include "IOCPWorker.h"
+#include "IOEngine.h"
+#include "SessionTable.h"
+#include "SessionReclaimer.h"
+#include "UserDirectory.h"
+#include "SessionTimers.h"
 #include "RoomManager.h"
 #include "Persistence.h"
 
+#ifdef _WIN32
 #pragma comment(lib, "Ws2_32.lib")
+#endif
 
 class GameLogic;
+class LobbyLogic;
 class Persistence;
 
 class Server
 {
 public:
-    Server(int iocpThreadCount, int dbThreadCount);
+    Server(int iocpThreadCount, int dbThreadCount, int logicThreadCount);
     ~Server();
 
-    bool Start(USHORT port);
+    bool Start(uint16_t port);
     void Stop();
-    static LockFreeQueue<std::unique_ptr<ICommand>>& GetGLTInputQueue();
+
+    // 로비 커맨드 큐와 방 번호를 맡은 샤드의 커맨드 큐 (아무 스레드에서나 넣는다)
+    static CommandQueue& GetLobbyQueue();
+    static CommandQueue& GetRoomQueue(int32_t roomId) { return *s_roomQueues[GetShardOfRoom(roomId)]; }
+    static size_t GetShardOfRoom(int32_t roomId) { return static_cast<uint32_t>(roomId) % s_roomQueues.size(); }
+
     Persistence& GetPersistence() { return *persistence_; }
     void RemoveSession(uint32_t sessionId);
-    std::shared_ptr<ClientSession> GetSession(uint32_t id);
-    RoomManager& GetRoomManager() { return roomManager_; }
+    // 잠금/참조 카운트 없는 조회. SessionReclaimer::Guard 안에서만 쓴다.
+    ClientSession* GetSession(uint32_t id);
+    size_t GetShardCount() const { return shards_.size(); }
+    RoomManager& GetShardRoomManager(size_t index);
+    RoomManager& GetRoomManagerOfRoom(int32_t roomId) { return GetShardRoomManager(GetShardOfRoom(roomId)); }
     bool IsUserConnected(const std::string& username);
+    UserDirectory& GetUserDirectory() { return users_; }
+    SessionTimers& GetSessionTimers() { return sessionTimers_; }
+    size_t GetSessionCount();
+
+    // 세션당 메모리 사용량 추정 (로비 규모에 맞춰 장비를 잡을 때 참고)
+    void PrintMemoryReport();
+
+    // 송신 큐가 가장 깊은 세션들 (느린 클라이언트 확인용)
+    void PrintSendQueueReport(size_t topCount = 10);
+
+    // 샤드별 틱 시간 / 늦음 분포와 따라잡기, 틱 사이에 깬 횟수
+    void PrintTickReport();
 
 private:
-    RoomManager roomManager_;
+    // 방 샤드: 방 번호 % 샤드 수로 정한 방들을 스레드 하나가 맡는다 (커맨드 큐는 s_roomQueues 의 같은 자리)
+    struct LogicShard;
+
     std::unique_ptr<Persistence> persistence_;
-    static LockFreeQueue<std::unique_ptr<ICommand>> s_gltInputQueue;
+    static CommandQueue s_lobbyQueue;
+    static std::vector<std::unique_ptr<CommandQueue>> s_roomQueues;
 
-    // IOCP ڵ
-    HANDLE hIOCP_;
-    SOCKET listenSock_;
-    std::atomic<bool> accepting_ = true;
-    int iocpThreadCount_;
+    // I/O 엔진 (Windows: IOCP, Linux: epoll / io_uring). accept 도 엔진이 워커에서 처리한다.
+    std::unique_ptr<IOEngine> ioEngine_;
+    size_t iocpThreadCount_;
     bool isStopped_ = false;
 
-    // 1. I/O Ŀ  Ǯ
+    // 1. I/O 워커 스레드 풀
     std::vector<std::thread> iocpWorkerThreads_;
 
-    // 2.    (GLT)
-    std::unique_ptr<GameLogic> gameLogic_;
-    std::thread gameLogicThread_, acceptThread_;
+    // 2. 로직 스레드: 방 샤드들과 로비
+    std::vector<std::unique_ptr<LogicShard>> shards_;
+    std::unique_ptr<LobbyLogic> lobbyLogic_;
+    std::thread lobbyThread_;
+
+    // 클라이언트 세션 관리 (ID = 슬롯 + 세대, 조회는 잠금 없음)
+    SessionTable<ClientSession> sessions_;
+
+    // 로그인한 유저 이름 -> 세션 ID (중복 로그인 확인, 귓속말)
+    UserDirectory users_;
 
-    // Ŭ̾Ʈ   (ID )
-    std::mutex sessionMutex_;
-    std::map<uint32_t, std::shared_ptr<ClientSession>> sessions_;
-    std::atomic<uint32_t> nextSessionId_ = 1;
+    // 로그인 마감 / 유휴 타이머 (로비가 틱마다 돌린다)
+    SessionTimers sessionTimers_;
 
-    void AcceptLoop();
     void HandleNewClient(SOCKET clientSock);
 };
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <vector>
+#include "SessionReclaimer.h"
+#include "ClientSession.h"
+
+namespace
+{
+    // 스레드별 epoch 표시. 0 = Guard 밖, 그 외 = (들어올 때 본 epoch << 1) | 1
+    struct alignas(64) ThreadRecord
+    {
+        std::atomic<uint64_t> state = 0;
+        std::atomic<bool> used = false;
+    };
+
+    struct RetiredSession
+    {
+        uint64_t epoch;
+        std::shared_ptr<ClientSession> session;
+    };
+
+    ThreadRecord g_records[SessionReclaimer::MAX_THREADS];
+    std::atomic<uint32_t> g_recordCount = 0;          // 한 번이라도 쓰인 레코드 범위
+    std::atomic<uint32_t> g_unregisteredActive = 0;   // 레코드를 못 받고 Guard 안에 있는 스레드 수
+    std::atomic<uint64_t> g_epoch = 1;
+
+    std::mutex g_retiredLock;
+    std::vector<RetiredSession> g_retired;
+
+    std::atomic<uint64_t> g_retiredCount = 0;
+    std::atomic<uint64_t> g_reclaimedCount = 0;
+    std::atomic<uint64_t> g_waitingIo = 0;
+
+    // 스레드가 끝나면 레코드를 돌려준다
+    struct ThreadSlot
+    {
+        int index = -1;
+        int depth = 0;
+        bool overflow = false;
+
+        ~ThreadSlot()
+        {
+            if (index < 0) return;
+            g_records[index].state.store(0, std::memory_order_release);
+            g_records[index].used.store(false, std::memory_order_release);
+        }
+    };
+
+    thread_local ThreadSlot t_slot;
+
+    int AcquireRecord()
+    {
+        for (uint32_t i = 0; i < SessionReclaimer::MAX_THREADS; ++i)
+        {
+            bool expected = false;
+            if (g_records[i].used.load(std::memory_order_relaxed)) continue;
+            if (!g_records[i].used.compare_exchange_strong(expected, true)) continue;
+
+            uint32_t count = g_recordCount.load();
+            while (count < i + 1 && !g_recordCount.compare_exchange_weak(count, i + 1)) {}
+            return (int)i;
+        }
+        return -1;
+    }
+
+    // Guard 안의 스레드가 모두 지금 epoch 에 들어와 있으면 epoch 를 하나 넘긴다
+    void TryAdvance()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (g_unregisteredActive.load() != 0) return;
+
+        uint64_t epoch = g_epoch.load();
+        uint32_t count = g_recordCount.load();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            uint64_t state = g_records[i].state.load(std::memory_order_acquire);
+            if ((state & 1) != 0 && (state >> 1) != epoch) return;
+        }
+
+        g_epoch.compare_exchange_strong(epoch, epoch + 1);
+    }
+}
+
+SessionReclaimer::Guard::Guard()
+{
+    ThreadSlot& slot = t_slot;
+    if (slot.depth++ > 0) return;
+
+    if (slot.index < 0 && !slot.overflow)
+    {
+        slot.index = AcquireRecord();
+        if (slot.index < 0)
+        {
+            slot.overflow = true;
+            std::cout << "[Reclaimer] Thread Record Full. Reclamation pauses while this thread is in a guard." << std::endl;
+        }
+    }
+
+    if (slot.index < 0)
+    {
+        g_unregisteredActive.fetch_add(1);
+        return;
+    }
+
+    // 표시를 먼저 보이게 한 뒤에 테이블을 읽는다 (TryAdvance 의 fence 와 짝)
+    g_records[slot.index].state.store((g_epoch.load() << 1) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+SessionReclaimer::Guard::~Guard()
+{
+    ThreadSlot& slot = t_slot;
+    if (--slot.depth > 0) return;
+
+    if (slot.index < 0)
+    {
+        g_unregisteredActive.fetch_sub(1);
+        return;
+    }
+
+    g_records[slot.index].state.store(0, std::memory_order_release);
+}
+
+void SessionReclaimer::Retire(std::shared_ptr<ClientSession> session)
+{
+    if (session == nullptr) return;
+
+    // 테이블에서 뺀 것이 보인 뒤의 epoch 를 붙인다
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t epoch = g_epoch.load();
+
+    {
+        std::lock_guard<std::mutex> lock(g_retiredLock);
+        g_retired.push_back({ epoch, std::move(session) });
+    }
+    g_retiredCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t SessionReclaimer::Collect()
+{
+    TryAdvance();
+    uint64_t epoch = g_epoch.load();
+
+    std::vector<std::shared_ptr<ClientSession>> released;
+    uint64_t waitingIo = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_retiredLock);
+        if (g_retired.empty()) return 0;
+
+        size_t kept = 0;
+        for (RetiredSession& entry : g_retired)
+        {
+            // 두 epoch 가 지나면 Guard 안에서 이 세션을 본 스레드는 없다. 남은 것은 엔진에 걸린 I/O 뿐이다.
+            bool graceOver = entry.epoch + 2 <= epoch;
+            if (graceOver && entry.session->GetIoRefCount() == 0)
+            {
+                released.push_back(std::move(entry.session));
+                continue;
+            }
+
+            if (graceOver) waitingIo++;
+            g_retired[kept++] = std::move(entry);
+        }
+        g_retired.resize(kept);
+    }
+
+    g_waitingIo.store(waitingIo, std::memory_order_relaxed);
+    g_reclaimedCount.fetch_add(released.size(), std::memory_order_relaxed);
+
+    // 마지막 참조였다면 잠금 밖(여기)에서 소멸한다
+    return released.size();
+}
+
+void SessionReclaimer::Drain()
+{
+    std::vector<RetiredSession> released;
+    {
+        std::lock_guard<std::mutex> lock(g_retiredLock);
+        released.swap(g_retired);
+    }
+
+    g_waitingIo.store(0, std::memory_order_relaxed);
+    g_reclaimedCount.fetch_add(released.size(), std::memory_order_relaxed);
+}
+
+SessionReclaimer::Stats SessionReclaimer::GetStats()
+{
+    Stats stats = {};
+    stats.epoch = g_epoch.load();
+    stats.retired = g_retiredCount.load();
+    stats.reclaimed = g_reclaimedCount.load();
+    stats.waitingIo = g_waitingIo.load();
+
+    std::lock_guard<std::mutex> lock(g_retiredLock);
+    stats.pending = g_retired.size();
+    return stats;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+class ClientSession;
+
+// 끊긴 세션의 지연 해제 (epoch 기반).
+// - 세션 테이블에서 뺀 세션은 바로 놓지 않고 Retire 로 넘긴다.
+// - 테이블에서 꺼낸 맨 포인터는 Guard 안에서만 쓴다. Guard 를 잡은 스레드가 모두 한 번 이상
+//   빠져나가야(전역 epoch 가 두 번 넘어가야) 해제 후보가 되므로 Guard 안에서는 참조 카운트 없이 써도 된다.
+// - 엔진에 걸려 있는 I/O(ClientSession::GetIoRefCount)가 남아 있으면 완료될 때까지 더 기다린다.
+class SessionReclaimer
+{
+public:
+    enum { MAX_THREADS = 256 };
+
+    struct Stats
+    {
+        uint64_t epoch;       // 현재 전역 epoch
+        uint64_t retired;     // 지금까지 Retire 된 세션 수
+        uint64_t reclaimed;   // 실제로 놓은 세션 수
+        uint64_t pending;     // 아직 기다리는 세션 수
+        uint64_t waitingIo;   // 그 중 epoch 는 지났지만 I/O 완료를 기다리는 수
+    };
+
+    // 테이블에서 꺼낸 세션 포인터를 쓰는 구간. 같은 스레드에서 겹쳐 잡아도 된다.
+    class Guard
+    {
+    public:
+        Guard();
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    static void Retire(std::shared_ptr<ClientSession> session);
+
+    // epoch 를 넘길 수 있으면 넘기고, 안전해진 세션을 놓는다 (로비 스레드가 틱마다 부른다). 놓은 수를 반환.
+    static size_t Collect();
+
+    // 모든 스레드를 멈춘 뒤(서버 종료) 남은 세션을 전부 놓는다
+    static void Drain();
+
+    static Stats GetStats();
+};
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 세션 ID -> 세션 조회 테이블.
+// - ID = (세대 << SLOT_BITS) | 슬롯 번호. 슬롯 배열을 바로 인덱싱하므로 조회는 O(1)이고,
+//   슬롯이 재사용되면 세대가 바뀌어 끊긴 세션의 옛 ID 로는 새 세션을 찾을 수 없다.
+// - 조회(Find)는 잠금 없이 슬롯 상태를 CAS 로 잠깐 "읽는 중" 표시만 하고 shared_ptr 를 복사한다.
+//   Get 은 표시도 복사도 없이 맨 포인터만 준다. 빠진 값을 바로 놓지 않는 쪽(Server 의 SessionReclaimer)에서 쓴다.
+// - 등록/해제는 슬롯 번호로 나눈 샤드별 mutex 로 처리해 서로 다른 샤드끼리는 경쟁하지 않는다.
+template <typename T>
+class SessionTable
+{
+public:
+    enum
+    {
+        SLOT_BITS = 20,
+        MAX_SLOTS = 1 << SLOT_BITS,           // 동시 세션 최대 1M
+        GENERATION_MASK = (1 << (32 - SLOT_BITS)) - 1,
+        CHUNK_BITS = 12,
+        CHUNK_SIZE = 1 << CHUNK_BITS,          // 슬롯은 4096개 묶음으로 필요할 때 만든다
+        CHUNK_COUNT = MAX_SLOTS / CHUNK_SIZE,
+        SHARD_COUNT = 16,
+    };
+
+    static constexpr uint32_t INVALID_ID = 0;
+
+    SessionTable()
+    {
+        for (auto& chunk : chunks_)
+            chunk.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~SessionTable()
+    {
+        for (auto& chunk : chunks_)
+            delete[] chunk.load(std::memory_order_relaxed);
+    }
+
+    SessionTable(const SessionTable&) = delete;
+    SessionTable& operator=(const SessionTable&) = delete;
+
+    static uint32_t GetSlot(uint32_t id) { return id & (MAX_SLOTS - 1); }
+    static uint32_t GetGeneration(uint32_t id) { return id >> SLOT_BITS; }
+
+    // 빈 슬롯을 잡고 ID 를 만든다. Publish 전까지는 Find 에 보이지 않는다. 가득 차면 INVALID_ID.
+    uint32_t Reserve()
+    {
+        uint32_t shardIndex = nextShard_.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+
+        for (uint32_t tried = 0; tried < SHARD_COUNT; ++tried)
+        {
+            Shard& shard = shards_[(shardIndex + tried) % SHARD_COUNT];
+            std::lock_guard<std::mutex> lock(shard.lock);
+
+            uint32_t slotIndex = 0;
+            if (!shard.freeSlots.empty())
+            {
+                slotIndex = shard.freeSlots.back();
+                shard.freeSlots.pop_back();
+            }
+            else
+            {
+                // 샤드 i 는 i, i + SHARD_COUNT, i + 2 * SHARD_COUNT ... 슬롯을 맡는다
+                slotIndex = shard.nextLocal * SHARD_COUNT + (uint32_t)(&shard - shards_);
+                if (slotIndex >= MAX_SLOTS) continue;
+                shard.nextLocal++;
+            }
+
+            Slot& slot = GetOrCreateSlot(slotIndex);
+            slot.generation = (slot.generation + 1) & GENERATION_MASK;
+            if (slot.generation == 0) slot.generation = 1;   // ID 0 은 쓰지 않는다
+
+            return (slot.generation << SLOT_BITS) | slotIndex;
+        }
+
+        return INVALID_ID;
+    }
+
+    // Reserve 한 ID 에 세션을 붙여 조회 가능하게 만든다
+    void Publish(uint32_t id, std::shared_ptr<T> value)
+    {
+        Slot* slot = FindSlot(GetSlot(id));
+        if (slot == nullptr) return;   // Reserve 로 받은 ID 가 아니다
+
+        slot->raw.store(value.get(), std::memory_order_relaxed);
+        slot->value = std::move(value);
+        slot->state.store((uint64_t)id << 32, std::memory_order_release);
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 잠금 없는 조회. 없거나 세대가 다르면 nullptr.
+    std::shared_ptr<T> Find(uint32_t id) const
+    {
+        if (id == INVALID_ID) return nullptr;
+        Slot* slot = FindSlot(GetSlot(id));
+        if (slot == nullptr) return nullptr;
+
+        // 상위 32비트 = 현재 ID, 하위 32비트 = 값을 복사 중인 reader 수
+        uint64_t state = slot->state.load(std::memory_order_acquire);
+        while (true)
+        {
+            if ((uint32_t)(state >> 32) != id) return nullptr;
+            if (slot->state.compare_exchange_weak(state, state + 1, std::memory_order_acquire))
+                break;
+        }
+
+        std::shared_ptr<T> value = slot->value;
+        slot->state.fetch_sub(1, std::memory_order_release);
+        return value;
+    }
+
+    // 참조 카운트를 건드리지 않는 조회. 없거나 세대가 다르면 nullptr.
+    // 반환된 포인터는 Remove 로 빠진 값이 아직 살아 있는 동안만 유효하다 (값의 수명은 호출한 쪽이 보장한다).
+    T* Get(uint32_t id) const
+    {
+        if (id == INVALID_ID) return nullptr;
+        Slot* slot = FindSlot(GetSlot(id));
+        if (slot == nullptr) return nullptr;
+
+        if ((uint32_t)(slot->state.load(std::memory_order_acquire) >> 32) != id) return nullptr;
+        T* value = slot->raw.load(std::memory_order_acquire);
+
+        // 읽는 사이에 빠지고 다른 세션이 들어왔을 수 있으니 ID 를 한 번 더 본다
+        if ((uint32_t)(slot->state.load(std::memory_order_acquire) >> 32) != id) return nullptr;
+        return value;
+    }
+
+    // 조회에서 빼고 슬롯을 돌려준다. Reserve 만 하고 Publish 하지 않은 ID 도 받는다.
+    // 빠진 값은 반환하므로 마지막 참조라면 호출한 쪽의 잠금 밖에서 소멸한다.
+    std::shared_ptr<T> Remove(uint32_t id)
+    {
+        if (id == INVALID_ID) return nullptr;
+        uint32_t slotIndex = GetSlot(id);
+        Slot* slot = FindSlot(slotIndex);
+        if (slot == nullptr) return nullptr;
+
+        Shard& shard = shards_[slotIndex % SHARD_COUNT];
+        std::lock_guard<std::mutex> lock(shard.lock);
+
+        if (slot->generation != GetGeneration(id)) return nullptr;
+
+        // 세대가 맞으면 Publish 된 상태이거나 Reserve 만 된 상태다.
+        // ID 를 지워 새 reader 를 막고, 이미 복사 중인 reader 가 끝날 때까지 기다린다
+        uint64_t state = slot->state.load(std::memory_order_acquire);
+        bool published = false;
+        while ((uint32_t)(state >> 32) == id)
+        {
+            if (slot->state.compare_exchange_weak(state, state & 0xFFFFFFFFull, std::memory_order_acq_rel))
+            {
+                published = true;
+                break;
+            }
+        }
+
+        while ((slot->state.load(std::memory_order_acquire) & 0xFFFFFFFFull) != 0)
+            std::this_thread::yield();
+
+        std::shared_ptr<T> value = std::move(slot->value);
+        slot->value = nullptr;
+        slot->raw.store(nullptr, std::memory_order_relaxed);
+        slot->generation = (slot->generation + 1) & GENERATION_MASK;   // 옛 ID 로 Remove 가 또 와도 무시된다
+        shard.freeSlots.push_back(slotIndex);
+
+        if (published)
+            count_.fetch_sub(1, std::memory_order_relaxed);
+        return value;
+    }
+
+    // 등록된 값 전체를 돈다. 도는 도중의 등록/해제는 반영될 수도, 안 될 수도 있다.
+    template <typename Fn>
+    void ForEach(Fn&& fn) const
+    {
+        for (uint32_t c = 0; c < CHUNK_COUNT; ++c)
+        {
+            Slot* chunk = chunks_[c].load(std::memory_order_acquire);
+            if (chunk == nullptr) continue;
+
+            for (uint32_t i = 0; i < CHUNK_SIZE; ++i)
+            {
+                uint32_t id = (uint32_t)(chunk[i].state.load(std::memory_order_acquire) >> 32);
+                if (id == INVALID_ID) continue;
+
+                std::shared_ptr<T> value = Find(id);
+                if (value != nullptr) fn(id, value);
+            }
+        }
+    }
+
+    size_t Size() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> state{ 0 };
+        std::shared_ptr<T> value;
+        std::atomic<T*> raw{ nullptr };   // Get 용 (value.get() 과 같다)
+        uint32_t generation = 0;   // 샤드 잠금 안에서만 바뀐다
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex lock;
+        std::vector<uint32_t> freeSlots;
+        uint32_t nextLocal = 0;
+    };
+
+    Slot* FindSlot(uint32_t slotIndex) const
+    {
+        Slot* chunk = chunks_[slotIndex >> CHUNK_BITS].load(std::memory_order_acquire);
+        return chunk ? &chunk[slotIndex & (CHUNK_SIZE - 1)] : nullptr;
+    }
+
+    // 여러 샤드가 같은 묶음을 동시에 만들 수 있으므로 먼저 올린 쪽 것을 쓴다
+    Slot& GetOrCreateSlot(uint32_t slotIndex)
+    {
+        std::atomic<Slot*>& entry = chunks_[slotIndex >> CHUNK_BITS];
+        Slot* chunk = entry.load(std::memory_order_acquire);
+        if (chunk == nullptr)
+        {
+            Slot* created = new Slot[CHUNK_SIZE];
+            if (entry.compare_exchange_strong(chunk, created, std::memory_order_acq_rel))
+                chunk = created;
+            else
+                delete[] created;
+        }
+        return chunk[slotIndex & (CHUNK_SIZE - 1)];
+    }
+
+    std::atomic<Slot*> chunks_[CHUNK_COUNT];
+    Shard shards_[SHARD_COUNT];
+    std::atomic<uint32_t> nextShard_{ 0 };
+    std::atomic<size_t> count_{ 0 };
+};
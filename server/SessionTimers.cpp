@@ -0,0 +1,140 @@
+#include <iostream>
+#include <algorithm>
+#include "SessionTimers.h"
+#include "Server.h"
+
+extern Server* g_Server;
+
+SessionTimeoutConfig SessionTimers::s_config;
+
+SessionTimers::SessionTimers()
+    : wheel_(0), startMs_(GetMonotonicMs())
+{
+}
+
+// 마감이 틱 중간이면 다음 칸으로 올린다 (일찍 깨어나도 OnExpired 가 다시 건다)
+uint64_t SessionTimers::ToTick(int64_t ms) const
+{
+    if (ms <= startMs_) return 0;
+    return (uint64_t)((ms - startMs_ + TICK_MS - 1) / TICK_MS);
+}
+
+SessionTimers::Entry& SessionTimers::GetEntry(uint32_t sessionId)
+{
+    uint32_t slot = SessionTable<ClientSession>::GetSlot(sessionId);
+    if (slot >= entries_.size())
+        entries_.resize((std::max<size_t>)(slot + 1, entries_.size() * 2));
+    return entries_[slot];
+}
+
+void SessionTimers::Arm(uint32_t sessionId, int64_t deadlineMs)
+{
+    Entry& entry = GetEntry(sessionId);
+    wheel_.Cancel(entry.timer);
+
+    entry.sessionId = sessionId;
+    entry.timer = wheel_.Schedule(ToTick(deadlineMs), sessionId);
+    armed_.store(wheel_.Size(), std::memory_order_relaxed);
+}
+
+void SessionTimers::OnSessionOpened(uint32_t sessionId)
+{
+    ClientSession* session = g_Server->GetSession(sessionId);
+    if (session == nullptr) return;
+
+    int64_t deadline = INT64_MAX;
+    if (s_config.loginTimeoutMs != 0)
+        deadline = (std::min)(deadline, session->GetConnectedMs() + s_config.loginTimeoutMs);
+    if (s_config.idleTimeoutMs != 0)
+        deadline = (std::min)(deadline, session->GetConnectedMs() + s_config.idleTimeoutMs);
+
+    if (deadline != INT64_MAX)
+        Arm(sessionId, deadline);
+}
+
+void SessionTimers::OnSessionClosed(uint32_t sessionId)
+{
+    uint32_t slot = SessionTable<ClientSession>::GetSlot(sessionId);
+    if (slot >= entries_.size()) return;
+
+    // 슬롯을 이미 새 세션이 쓰고 있으면 건드리지 않는다
+    Entry& entry = entries_[slot];
+    if (entry.sessionId != sessionId) return;
+
+    wheel_.Cancel(entry.timer);
+    entry = Entry();
+    armed_.store(wheel_.Size(), std::memory_order_relaxed);
+}
+
+void SessionTimers::Update(int64_t nowMs)
+{
+    int64_t elapsed = nowMs - startMs_;
+    if (elapsed < 0) return;
+
+    expired_.clear();
+    wheel_.Advance((uint64_t)(elapsed / TICK_MS), expired_);
+
+    for (uint64_t key : expired_)
+        OnExpired(static_cast<uint32_t>(key), nowMs);
+
+    armed_.store(wheel_.Size(), std::memory_order_relaxed);
+}
+
+void SessionTimers::OnExpired(uint32_t sessionId, int64_t nowMs)
+{
+    Entry& entry = GetEntry(sessionId);
+    if (entry.sessionId != sessionId) return;
+    entry = Entry();
+
+    fired_.fetch_add(1, std::memory_order_relaxed);
+
+    ClientSession* session = g_Server->GetSession(sessionId);
+    if (session == nullptr || session->IsDisconnected()) return;
+
+    int64_t deadline = INT64_MAX;
+
+    if (s_config.loginTimeoutMs != 0 && !session->IsLoggedIn())
+    {
+        int64_t loginDeadline = session->GetConnectedMs() + s_config.loginTimeoutMs;
+        if (nowMs >= loginDeadline)
+        {
+            loginTimeouts_.fetch_add(1, std::memory_order_relaxed);
+            std::cout << "[Session] Login Timeout. Disconnecting: " << sessionId << std::endl;
+            session->Disconnect();
+            return;
+        }
+        deadline = loginDeadline;
+    }
+
+    if (s_config.idleTimeoutMs != 0)
+    {
+        int64_t idleDeadline = session->GetLastRecvMs() + s_config.idleTimeoutMs;
+        if (nowMs >= idleDeadline)
+        {
+            idleKicks_.fetch_add(1, std::memory_order_relaxed);
+            std::cout << "[Session] Idle Timeout (" << nowMs - session->GetLastRecvMs()
+                << " ms). Disconnecting: " << sessionId << std::endl;
+            session->Disconnect();
+            return;
+        }
+        deadline = (std::min)(deadline, idleDeadline);
+    }
+
+    // 그 사이 패킷이 와서 마감이 밀렸다
+    if (deadline != INT64_MAX)
+    {
+        rearmed_.fetch_add(1, std::memory_order_relaxed);
+        Arm(sessionId, deadline);
+    }
+}
+
+SessionTimers::Stats SessionTimers::GetStats() const
+{
+    Stats stats;
+    stats.armed = armed_.load(std::memory_order_relaxed);
+    stats.fired = fired_.load(std::memory_order_relaxed);
+    stats.rearmed = rearmed_.load(std::memory_order_relaxed);
+    stats.loginTimeouts = loginTimeouts_.load(std::memory_order_relaxed);
+    stats.idleKicks = idleKicks_.load(std::memory_order_relaxed);
+    return stats;
+}
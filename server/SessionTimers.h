@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "TimerWheel.h"
+
+// 세션 시간 제한 (ms, 0 이면 그 기준은 보지 않는다).
+// - login: 접속 후 이 시간 안에 로그인하지 못하면 끊는다
+// - idle: 이 시간 동안 아무 패킷(하트비트 포함)도 오지 않으면 끊는다 (반쯤 끊긴 TCP 정리)
+struct SessionTimeoutConfig
+{
+    uint32_t loginTimeoutMs = 10 * 1000;
+    uint32_t idleTimeoutMs = 30 * 1000;
+};
+
+// 세션별 로그인 마감 / 유휴 타이머. 로비 스레드에서만 쓴다 (통계만 다른 스레드에서 읽는다).
+// - 세션마다 타이머를 하나만 걸고, 패킷이 올 때는 세션의 마지막 수신 시각만 갱신한다.
+//   타이머가 만료되면 그때 마감을 다시 계산해서 아직이면 남은 시간만큼 다시 건다.
+//   그래서 수신 경로는 휠을 건드리지 않고, 틱마다 세션을 훑지도 않는다.
+// - 만료 처리는 SessionReclaimer::Guard 안에서 한다 (세션을 맨 포인터로 찾는다).
+class SessionTimers
+{
+public:
+    enum { TICK_MS = 16 };   // 휠 한 칸 (로직 스레드 틱과 같다)
+
+    struct Stats
+    {
+        uint64_t armed;          // 지금 걸려 있는 타이머 수
+        uint64_t fired;          // 만료되어 확인한 횟수
+        uint64_t rearmed;        // 확인해 보니 아직이라 다시 건 횟수
+        uint64_t loginTimeouts;  // 로그인 마감으로 끊은 세션
+        uint64_t idleKicks;      // 유휴로 끊은 세션
+    };
+
+    // 서버 시작 전에 설정한다
+    static void SetConfig(const SessionTimeoutConfig& config) { s_config = config; }
+    static const SessionTimeoutConfig& GetConfig() { return s_config; }
+
+    SessionTimers();
+
+    void OnSessionOpened(uint32_t sessionId);
+    void OnSessionClosed(uint32_t sessionId);
+
+    // 지금 시각까지 휠을 돌리고 만료된 세션을 확인한다
+    void Update(int64_t nowMs);
+
+    Stats GetStats() const;
+
+private:
+    struct Entry
+    {
+        uint32_t sessionId = 0;
+        TimerWheel::TimerId timer = TimerWheel::INVALID_TIMER;
+    };
+
+    static SessionTimeoutConfig s_config;
+
+    TimerWheel wheel_;
+    int64_t startMs_;
+
+    // 세션 테이블 슬롯 번호로 바로 찾는다 (해시 없음)
+    std::vector<Entry> entries_;
+    std::vector<uint64_t> expired_;
+
+    std::atomic<uint64_t> armed_ = 0;
+    std::atomic<uint64_t> fired_ = 0;
+    std::atomic<uint64_t> rearmed_ = 0;
+    std::atomic<uint64_t> loginTimeouts_ = 0;
+    std::atomic<uint64_t> idleKicks_ = 0;
+
+    uint64_t ToTick(int64_t ms) const;
+    Entry& GetEntry(uint32_t sessionId);
+    void Arm(uint32_t sessionId, int64_t deadlineMs);
+    void OnExpired(uint32_t sessionId, int64_t nowMs);
+};
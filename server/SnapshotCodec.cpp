@@ -0,0 +1,261 @@
+#include "SnapshotCodec.h"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // 차이가 int32 를 넘지 않도록 위치 범위를 자른다 (+-500 만 단위)
+    constexpr int32_t MAX_QUANTIZED = 1 << 29;
+    constexpr size_t MAX_ENTRY_SIZE = 15;   // varint 5 바이트 x 3
+
+    uint32_t ZigZag(int32_t value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int32_t UnZigZag(uint32_t value)
+    {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+
+    // 깨진 패킷에서도 부호 있는 오버플로가 나지 않게 부호 없는 정수로 더한다
+    int32_t Add(int32_t base, int32_t delta)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(base) + static_cast<uint32_t>(delta));
+    }
+
+    size_t PutVarint(char* out, uint32_t value)
+    {
+        size_t size = 0;
+        while (value >= 0x80)
+        {
+            out[size++] = static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out[size++] = static_cast<char>(value);
+        return size;
+    }
+
+    void PutCount(char* out, uint16_t count)
+    {
+        std::memcpy(out, &count, sizeof(count));
+    }
+
+    class EntryReader
+    {
+    public:
+        EntryReader(const char* data, size_t size) : ptr_(data), end_(data + size) {}
+
+        const char* GetPtr() const { return ptr_; }
+        bool IsEnd() const { return ptr_ == end_; }
+
+        bool ReadCount(uint16_t& count)
+        {
+            if (static_cast<size_t>(end_ - ptr_) < sizeof(count)) return false;
+            std::memcpy(&count, ptr_, sizeof(count));
+            ptr_ += sizeof(count);
+            return true;
+        }
+
+        bool ReadVarint(uint32_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 35; shift += 7)
+            {
+                if (ptr_ == end_) return false;
+                uint8_t byte = static_cast<uint8_t>(*ptr_++);
+                value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) return true;
+            }
+            return false;
+        }
+
+        // 오름차순 ID. 첫 ID 만 차이 0 (ID 0) 을 허용한다.
+        bool ReadId(uint32_t& id, bool first)
+        {
+            uint32_t gap = 0;
+            if (!ReadVarint(gap)) return false;
+            if (!first && gap == 0) return false;
+            if (!first && gap > UINT32_MAX - id) return false;
+            id = first ? gap : id + gap;
+            return true;
+        }
+
+        void Skip(const char* ptr) { ptr_ = ptr; }
+
+    private:
+        const char* ptr_;
+        const char* end_;
+    };
+}
+
+int32_t SnapshotCodec::Quantize(float value)
+{
+    float scaled = value * POSITION_SCALE;
+    if (!(scaled > -MAX_QUANTIZED)) return -MAX_QUANTIZED;   // NaN 도 여기로
+    if (scaled > MAX_QUANTIZED) return MAX_QUANTIZED;
+    return static_cast<int32_t>(std::lround(scaled));
+}
+
+float SnapshotCodec::Dequantize(int32_t value)
+{
+    return static_cast<float>(value) / POSITION_SCALE;
+}
+
+bool SnapshotCodec::Encode(const std::vector<SnapshotEntity>& base, const std::vector<SnapshotEntity>& current,
+    char* out, size_t capacity, size_t& size)
+{
+    size = 0;
+    if (capacity < sizeof(uint16_t) * 2) return false;
+
+    // 1) 빠진 플레이어. 뒤에 updatedCount 자리는 항상 남겨 둔다.
+    size_t removedLimit = capacity - sizeof(uint16_t);
+    size_t pos = sizeof(uint16_t);
+    uint16_t removedCount = 0;
+    uint32_t lastId = 0;
+    bool complete = true;
+
+    size_t j = 0;
+    for (const SnapshotEntity& old : base)
+    {
+        while (j < current.size() && current[j].id < old.id) ++j;
+        if (j < current.size() && current[j].id == old.id) continue;
+
+        char entry[MAX_ENTRY_SIZE];
+        size_t entrySize = PutVarint(entry, old.id - lastId);
+        if (pos + entrySize > removedLimit || removedCount == UINT16_MAX)
+        {
+            complete = false;
+            break;
+        }
+        std::memcpy(out + pos, entry, entrySize);
+        pos += entrySize;
+        lastId = old.id;
+        removedCount++;
+    }
+    PutCount(out, removedCount);
+
+    // 2) 새로 들어왔거나 위치가 바뀐 플레이어
+    size_t countPos = pos;
+    pos += sizeof(uint16_t);
+    uint16_t updatedCount = 0;
+    lastId = 0;
+
+    size_t i = 0;
+    for (const SnapshotEntity& now : current)
+    {
+        if (!complete) break;
+
+        while (i < base.size() && base[i].id < now.id) ++i;
+        int32_t baseX = 0;
+        int32_t baseY = 0;
+        if (i < base.size() && base[i].id == now.id)
+        {
+            if (base[i].x == now.x && base[i].y == now.y) continue;
+            baseX = base[i].x;
+            baseY = base[i].y;
+        }
+
+        char entry[MAX_ENTRY_SIZE];
+        size_t entrySize = PutVarint(entry, now.id - lastId);
+        entrySize += PutVarint(entry + entrySize, ZigZag(now.x - baseX));
+        entrySize += PutVarint(entry + entrySize, ZigZag(now.y - baseY));
+        if (pos + entrySize > capacity || updatedCount == UINT16_MAX)
+        {
+            complete = false;
+            break;
+        }
+        std::memcpy(out + pos, entry, entrySize);
+        pos += entrySize;
+        lastId = now.id;
+        updatedCount++;
+    }
+    PutCount(out + countPos, updatedCount);
+
+    size = pos;
+    return complete;
+}
+
+bool SnapshotCodec::Decode(std::string_view entries, const std::vector<SnapshotEntity>& base, std::vector<SnapshotEntity>& out)
+{
+    out.clear();
+
+    // 빠진 목록과 바뀐 목록을 base 와 함께 한 번에 합친다. 먼저 빠진 목록 끝 (= 바뀐 목록 시작) 을 찾는다.
+    EntryReader removed(entries.data(), entries.size());
+    uint16_t removedCount = 0;
+    if (!removed.ReadCount(removedCount)) return false;
+
+    EntryReader updated(entries.data(), entries.size());
+    updated.Skip(removed.GetPtr());
+    uint32_t scanId = 0;
+    for (uint16_t k = 0; k < removedCount; ++k)
+    {
+        if (!updated.ReadId(scanId, k == 0)) return false;
+    }
+
+    uint16_t updatedCount = 0;
+    if (!updated.ReadCount(updatedCount)) return false;
+
+    uint32_t removedId = 0;
+    uint16_t removedLeft = removedCount;
+    if (removedLeft > 0 && !removed.ReadId(removedId, true)) return false;
+
+    SnapshotEntity next{};
+    uint32_t dx = 0;
+    uint32_t dy = 0;
+    uint16_t updatedLeft = updatedCount;
+    auto readUpdate = [&]() {
+        return updated.ReadId(next.id, updatedLeft == updatedCount) && updated.ReadVarint(dx) && updated.ReadVarint(dy);
+    };
+    if (updatedLeft > 0 && !readUpdate()) return false;
+
+    size_t i = 0;
+    while (i < base.size() || updatedLeft > 0)
+    {
+        if (updatedLeft > 0 && (i == base.size() || next.id < base[i].id))
+        {
+            // 기준에 없던 플레이어
+            out.push_back(SnapshotEntity{ next.id, UnZigZag(dx), UnZigZag(dy) });
+        }
+        else if (removedLeft > 0 && removedId == base[i].id)
+        {
+            ++i;
+            if (--removedLeft > 0 && !removed.ReadId(removedId, false)) return false;
+            continue;
+        }
+        else if (updatedLeft > 0 && next.id == base[i].id)
+        {
+            const SnapshotEntity& old = base[i++];
+            out.push_back(SnapshotEntity{ old.id, Add(old.x, UnZigZag(dx)), Add(old.y, UnZigZag(dy)) });
+        }
+        else
+        {
+            out.push_back(base[i++]);
+            continue;
+        }
+
+        if (--updatedLeft > 0 && !readUpdate()) return false;
+    }
+
+    // 기준에 없는 ID 를 빼라고 했거나 뒤에 쓰레기가 붙어 있다
+    return removedLeft == 0 && updated.IsEnd();
+}
+
+SnapshotFrame& SnapshotHistory::BeginFrame(uint32_t tick)
+{
+    SnapshotFrame& frame = frames_[tick % HISTORY_SIZE];
+    frame.tick = tick;
+    frame.truncated = false;
+    frame.sentMs = 0;
+    frame.entities.clear();
+    return frame;
+}
+
+const SnapshotFrame* SnapshotHistory::Find(uint32_t tick) const
+{
+    if (tick == 0) return nullptr;
+
+    const SnapshotFrame& frame = frames_[tick % HISTORY_SIZE];
+    if (frame.tick != tick || frame.truncated) return nullptr;
+    return &frame;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// SNAPSHOT 패킷의 entries 인코딩 (클라이언트는 SnapshotState.cs 가 같은 형식을 푼다).
+// - 위치는 POSITION_SCALE 배 한 정수(1/100 단위)로 보낸다. 그보다 작은 움직임은 바뀐 것으로 보지 않는다.
+// - 기준 프레임(클라이언트가 SNAPSHOT_ACK 한 틱)과 비교해서 빠진 플레이어와 위치가 바뀐 플레이어만 쓴다.
+//   기준이 없으면 빈 프레임과 비교한 것과 같다 (= 전체 스냅샷, baseTick 0).
+// - 형식. ID 는 오름차순이고 바로 앞 ID 와의 차이를 쓴다 (첫 ID 는 0 과의 차이).
+//   varint 는 7 비트씩 낮은 쪽부터, zigzag 는 부호 있는 차이를 작은 양수로 바꾼 것.
+//     u16 removedCount, removedCount x { varint idGap }
+//     u16 updatedCount, updatedCount x { varint idGap, varint zigzag(x - baseX), varint zigzag(y - baseY) }
+//   기준 프레임에 없던 플레이어는 baseX / baseY 를 0 으로 본다.
+struct SnapshotEntity
+{
+    uint32_t id;
+    int32_t x;   // 양자화한 위치
+    int32_t y;
+};
+
+// 한 틱의 방 상태 (id 오름차순)
+struct SnapshotFrame
+{
+    uint32_t tick = 0;
+    bool truncated = false;   // 전체 스냅샷이 최대 크기를 넘어 앞쪽만 보냈다 (기준 프레임으로 쓰지 않는다)
+    int64_t sentMs = 0;       // 보낸 시각. 이 틱의 ACK 가 오면 RTT 를 잰다
+    std::vector<SnapshotEntity> entities;
+};
+
+namespace SnapshotCodec
+{
+    constexpr float POSITION_SCALE = 100.0f;
+
+    int32_t Quantize(float value);
+    float Dequantize(int32_t value);
+
+    // base -> current 에서 바뀐 것만 out 에 쓴다.
+    // capacity 를 넘으면 false. 그때도 size 까지는 올바른 형식이라 (앞쪽 플레이어만 담긴다) 전체 스냅샷이면 그대로 보낼 수 있다.
+    bool Encode(const std::vector<SnapshotEntity>& base, const std::vector<SnapshotEntity>& current,
+        char* out, size_t capacity, size_t& size);
+
+    // base 에 entries 를 적용해서 out 을 만든다. 형식이 깨졌거나 base 에 없는 플레이어를 빼라고 하면 false.
+    bool Decode(std::string_view entries, const std::vector<SnapshotEntity>& base, std::vector<SnapshotEntity>& out);
+}
+
+// 최근 HISTORY_SIZE 틱의 프레임을 남겨 둔다 (세션마다 하나, 방을 맡은 샤드 스레드에서만 쓴다).
+// 클라이언트의 ACK 는 이 안에 있어야 기준으로 쓸 수 있다 (16ms 틱에서 약 1 초).
+// 프레임의 벡터는 틱마다 비우고 다시 쓰므로 용량이 유지된다.
+class SnapshotHistory
+{
+public:
+    enum { HISTORY_SIZE = 64 };
+
+    // tick 의 프레임을 비워서 돌려준다 (가장 오래된 프레임을 덮어쓴다)
+    SnapshotFrame& BeginFrame(uint32_t tick);
+
+    // 남아 있고 잘리지 않은 프레임만 돌려준다
+    const SnapshotFrame* Find(uint32_t tick) const;
+
+private:
+    SnapshotFrame frames_[HISTORY_SIZE];
+};
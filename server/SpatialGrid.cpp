@@ -0,0 +1,82 @@
+#include "SpatialGrid.h"
+
+namespace
+{
+    // 칸 번호 범위. 클라이언트가 보낸 속도로 좌표가 터무니없이 커지거나 NaN 이 되어도 여기로 모은다.
+    constexpr float MAX_CELL = 1 << 20;
+}
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : cellSize_(cellSize > 0.0f ? cellSize : 1.0f)
+{
+}
+
+int32_t SpatialGrid::ToCell(float value) const
+{
+    float cell = std::floor(value / cellSize_);
+    if (!(cell > -MAX_CELL)) return static_cast<int32_t>(-MAX_CELL);   // NaN 도 여기로
+    if (cell > MAX_CELL) return static_cast<int32_t>(MAX_CELL);
+    return static_cast<int32_t>(cell);
+}
+
+void SpatialGrid::Insert(uint32_t id, Vector2 position)
+{
+    if (slots_.count(id) != 0)
+    {
+        Move(id, position);
+        return;
+    }
+    AddToCell(id, position, CellKey(position));
+}
+
+void SpatialGrid::Remove(uint32_t id)
+{
+    auto it = slots_.find(id);
+    if (it == slots_.end()) return;
+
+    RemoveFromCell(it->second);
+    slots_.erase(it);
+}
+
+void SpatialGrid::Move(uint32_t id, Vector2 position)
+{
+    auto it = slots_.find(id);
+    if (it == slots_.end()) return;
+
+    uint64_t cell = CellKey(position);
+    Slot& slot = it->second;
+    if (slot.cell == cell)
+    {
+        cells_[cell][slot.index].position = position;
+        return;
+    }
+
+    RemoveFromCell(slot);
+    slots_.erase(it);
+    AddToCell(id, position, cell);
+    cellChanges_++;
+}
+
+void SpatialGrid::AddToCell(uint32_t id, Vector2 position, uint64_t cell)
+{
+    std::vector<Item>& items = cells_[cell];
+    slots_[id] = Slot{ cell, static_cast<uint32_t>(items.size()) };
+    items.push_back(Item{ id, position });
+}
+
+void SpatialGrid::RemoveFromCell(const Slot& slot)
+{
+    auto cellIt = cells_.find(slot.cell);
+    std::vector<Item>& items = cellIt->second;
+
+    // 마지막 항목을 빈자리로 옮긴다
+    if (slot.index + 1 != items.size())
+    {
+        items[slot.index] = items.back();
+        slots_[items[slot.index].id].index = slot.index;
+    }
+    items.pop_back();
+
+    if (items.empty())
+        cells_.erase(cellIt);
+}
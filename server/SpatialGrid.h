@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Utility.h"
+
+// 방 안 플레이어 위치의 균일 격자 (관심 영역 조회용, 방을 맡은 샤드 스레드에서만 쓴다).
+// - 칸 크기는 보통 시야 반경과 같게 잡는다. 그러면 반경 조회는 주변 3x3 칸만 본다.
+// - 칸은 좌표로 해시해서 플레이어가 있는 칸만 만든다 (맵 크기 제한 없음). 빈 칸은 지운다.
+// - Move 는 칸이 바뀔 때만 칸 사이를 옮기고, 아니면 칸 안의 위치만 고친다.
+// - 위치를 따로 들고 있는 쪽 (GameRoom 의 PlayerTable) 은 CellKey 로 비교해서 칸이 바뀔 때만 Move 하고 QueryCells 로 후보만 받는다.
+class SpatialGrid
+{
+public:
+    struct Item
+    {
+        uint32_t id;
+        Vector2 position;
+    };
+
+    struct Stats
+    {
+        size_t items;
+        size_t cells;
+        uint64_t cellChanges;   // 칸을 옮긴 횟수
+    };
+
+    explicit SpatialGrid(float cellSize);
+
+    void Insert(uint32_t id, Vector2 position);
+    void Remove(uint32_t id);
+    void Move(uint32_t id, Vector2 position);
+
+    // center 에서 radius 안에 있는 항목마다 visit(const Item&) 를 부른다 (순서는 정해지지 않는다)
+    template <typename Visitor>
+    void Query(Vector2 center, float radius, Visitor&& visit) const;
+
+    // center 에서 radius 를 덮는 칸들의 항목마다 visit(uint32_t id) 를 부른다 (거리는 재지 않는다).
+    // 칸이 바뀔 때만 Move 하면 Item::position 은 마지막으로 칸을 옮긴 때의 위치라서 거리는 부르는 쪽이 잰다.
+    template <typename Visitor>
+    void QueryCells(Vector2 center, float radius, Visitor&& visit) const;
+
+    // position 이 들어가는 칸
+    uint64_t CellKey(Vector2 position) const { return MakeKey(ToCell(position.x), ToCell(position.y)); }
+
+    Stats GetStats() const { return Stats{ slots_.size(), cells_.size(), cellChanges_ }; }
+
+private:
+    struct Slot
+    {
+        uint64_t cell;
+        uint32_t index;   // 칸 벡터 안의 위치
+    };
+
+    float cellSize_;
+    std::unordered_map<uint64_t, std::vector<Item>> cells_;
+    std::unordered_map<uint32_t, Slot> slots_;
+    uint64_t cellChanges_ = 0;
+
+    int32_t ToCell(float value) const;
+    static uint64_t MakeKey(int32_t cx, int32_t cy)
+    {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+
+    void AddToCell(uint32_t id, Vector2 position, uint64_t cell);
+    void RemoveFromCell(const Slot& slot);
+};
+
+template <typename Visitor>
+void SpatialGrid::QueryCells(Vector2 center, float radius, Visitor&& visit) const
+{
+    int32_t minX = ToCell(center.x - radius);
+    int32_t maxX = ToCell(center.x + radius);
+    int32_t minY = ToCell(center.y - radius);
+    int32_t maxY = ToCell(center.y + radius);
+
+    for (int32_t cx = minX; cx <= maxX; ++cx)
+    {
+        for (int32_t cy = minY; cy <= maxY; ++cy)
+        {
+            auto it = cells_.find(MakeKey(cx, cy));
+            if (it == cells_.end()) continue;
+
+            for (const Item& item : it->second)
+                visit(item.id);
+        }
+    }
+}
+
+template <typename Visitor>
+void SpatialGrid::Query(Vector2 center, float radius, Visitor&& visit) const
+{
+    int32_t minX = ToCell(center.x - radius);
+    int32_t maxX = ToCell(center.x + radius);
+    int32_t minY = ToCell(center.y - radius);
+    int32_t maxY = ToCell(center.y + radius);
+    float radiusSq = radius * radius;
+
+    for (int32_t cx = minX; cx <= maxX; ++cx)
+    {
+        for (int32_t cy = minY; cy <= maxY; ++cy)
+        {
+            auto it = cells_.find(MakeKey(cx, cy));
+            if (it == cells_.end()) continue;
+
+            for (const Item& item : it->second)
+            {
+                float dx = item.position.x - center.x;
+                float dy = item.position.y - center.y;
+                if (dx * dx + dy * dy <= radiusSq)
+                    visit(item);
+            }
+        }
+    }
+}
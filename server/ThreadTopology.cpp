@@ -0,0 +1,399 @@
+#include "ThreadTopology.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <fstream>
+#endif
+
+namespace
+{
+    struct Cpu
+    {
+        int id;
+        int core;   // 같은 물리 코어면 같은 값 (SMT 형제 중 가장 작은 CPU 번호)
+        int node;
+    };
+
+    struct Plan
+    {
+        std::vector<Cpu> cpus;   // 이 프로세스가 쓸 수 있는 CPU
+        int nodeCount = 1;
+        int coreCount = 1;
+        bool pinned = false;
+        bool numaLocal = false;
+
+        int ioThreads = 1;
+        int dbThreads = 2;
+        int logicThreads = 1;
+        std::vector<int> logicCpus;   // 샤드 순서대로. 이보다 많은 샤드는 공용 CPU
+        std::vector<int> ioCpus;
+        std::vector<int> sharedCpus;
+    };
+
+    Plan g_plan;
+    thread_local int t_node = 0;
+
+    const Cpu* FindCpu(int id)
+    {
+        for (const Cpu& cpu : g_plan.cpus)
+        {
+            if (cpu.id == id) return &cpu;
+        }
+        return nullptr;
+    }
+
+    std::string JoinCpus(const std::vector<int>& ids)
+    {
+        std::string text;
+        for (int id : ids)
+        {
+            if (!text.empty()) text += ",";
+            text += std::to_string(id);
+        }
+        return text;
+    }
+
+#ifdef _WIN32
+    // 프로세서 그룹 0 (64개) 까지만 다룬다
+    std::vector<Cpu> DetectCpus()
+    {
+        DWORD_PTR processMask = 0;
+        DWORD_PTR systemMask = 0;
+        GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask);
+
+        std::vector<Cpu> cpus;
+        for (int i = 0; i < 64; ++i)
+        {
+            if (processMask & ((DWORD_PTR)1 << i))
+                cpus.push_back({ i, i, 0 });
+        }
+        if (cpus.empty()) cpus.push_back({ 0, 0, 0 });
+
+        DWORD length = 0;
+        GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+        if (length == 0) return cpus;
+
+        std::vector<char> buffer(length);
+        if (!GetLogicalProcessorInformationEx(RelationAll,
+            reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data()), &length))
+            return cpus;
+
+        for (DWORD offset = 0; offset < length; )
+        {
+            auto* entry = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+
+            if (entry->Relationship == RelationProcessorCore && entry->Processor.GroupMask[0].Group == 0)
+            {
+                KAFFINITY mask = entry->Processor.GroupMask[0].Mask;
+                int first = -1;
+                for (Cpu& cpu : cpus)
+                {
+                    if (!(mask & ((KAFFINITY)1 << cpu.id))) continue;
+                    if (first < 0) first = cpu.id;
+                    cpu.core = first;
+                }
+            }
+            else if (entry->Relationship == RelationNumaNode && entry->NumaNode.GroupMask.Group == 0)
+            {
+                for (Cpu& cpu : cpus)
+                {
+                    if (entry->NumaNode.GroupMask.Mask & ((KAFFINITY)1 << cpu.id))
+                        cpu.node = (int)entry->NumaNode.NodeNumber;
+                }
+            }
+
+            offset += entry->Size;
+        }
+        return cpus;
+    }
+
+    bool PinTo(const std::vector<int>& ids)
+    {
+        DWORD_PTR mask = 0;
+        for (int id : ids)
+        {
+            if (id < 64) mask |= (DWORD_PTR)1 << id;
+        }
+        return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+    }
+#else
+    // sysfs 의 "0-3,8,10-11" 형식
+    std::vector<int> ReadCpuList(const std::string& path)
+    {
+        std::vector<int> ids;
+        std::ifstream file(path);
+        std::string text;
+        if (!std::getline(file, text)) return ids;
+
+        size_t pos = 0;
+        while (pos < text.size())
+        {
+            size_t comma = text.find(',', pos);
+            std::string range = text.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+            pos = (comma == std::string::npos) ? text.size() : comma + 1;
+            if (range.empty()) continue;
+
+            size_t dash = range.find('-');
+            int first = std::atoi(range.c_str());
+            int last = (dash == std::string::npos) ? first : std::atoi(range.c_str() + dash + 1);
+            for (int id = first; id <= last; ++id)
+                ids.push_back(id);
+        }
+        return ids;
+    }
+
+    std::vector<Cpu> DetectCpus()
+    {
+        std::vector<Cpu> cpus;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int i = 0; i < CPU_SETSIZE; ++i)
+            {
+                if (CPU_ISSET(i, &set)) cpus.push_back({ i, i, 0 });
+            }
+        }
+        if (cpus.empty()) cpus.push_back({ 0, 0, 0 });
+
+        for (Cpu& cpu : cpus)
+        {
+            std::vector<int> siblings = ReadCpuList("/sys/devices/system/cpu/cpu" + std::to_string(cpu.id) + "/topology/thread_siblings_list");
+            if (!siblings.empty())
+                cpu.core = *std::min_element(siblings.begin(), siblings.end());
+        }
+
+        // 노드 번호는 비어 있을 수 있으므로 있는 것만 읽는다
+        for (int node = 0; node < 64; ++node)
+        {
+            for (int id : ReadCpuList("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist"))
+            {
+                for (Cpu& cpu : cpus)
+                {
+                    if (cpu.id == id) cpu.node = node;
+                }
+            }
+        }
+        return cpus;
+    }
+
+    bool PinTo(const std::vector<int>& ids)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int id : ids)
+        {
+            if (id < CPU_SETSIZE) CPU_SET(id, &set);
+        }
+        return CPU_COUNT(&set) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+#endif
+
+    void BuildPlan(const ThreadTopology::Config& config)
+    {
+        Plan& plan = g_plan;
+        plan = Plan();
+        plan.cpus = DetectCpus();
+        plan.dbThreads = (std::max)(1, config.dbThreads);
+
+        std::set<int> nodes;
+        std::set<int> cores;
+        for (const Cpu& cpu : plan.cpus)
+        {
+            nodes.insert(cpu.node);
+            cores.insert(cpu.core);
+        }
+        plan.nodeCount = (int)nodes.size();
+        plan.coreCount = (int)cores.size();
+
+        plan.logicThreads = config.logicThreads > 0 ? config.logicThreads : (std::max)(1, plan.coreCount / 4);
+
+        // 물리 코어가 하나뿐이면 나눠 줄 코어가 없다
+        plan.pinned = config.pinThreads && plan.coreCount >= 2;
+        if (!plan.pinned)
+        {
+            plan.ioThreads = config.ioThreads > 0 ? config.ioThreads : (std::max)(1, plan.coreCount - 1);
+            return;
+        }
+
+        // 샤드마다 물리 코어 하나. 지정한 CPU 를 먼저 쓰고, 모자라면 CPU 0 과 같은 노드에서 CPU 0 과 다른 코어부터 고른다.
+        // I/O 워커 몫으로 적어도 한 코어는 남긴다.
+        const int reservable = (std::min)(plan.logicThreads, plan.coreCount - 1);
+        std::set<int> logicCores;
+        for (int id : config.logicCpus)
+        {
+            const Cpu* cpu = FindCpu(id);
+            if ((int)plan.logicCpus.size() >= reservable) break;
+            if (cpu == nullptr || !logicCores.insert(cpu->core).second) continue;
+            plan.logicCpus.push_back(id);
+        }
+
+        const Cpu& first = plan.cpus.front();
+        while ((int)plan.logicCpus.size() < reservable)
+        {
+            const Cpu* logic = nullptr;
+            for (const Cpu& cpu : plan.cpus)
+            {
+                if (cpu.core == first.core || logicCores.count(cpu.core) != 0) continue;
+                if (logic == nullptr || (cpu.node == first.node && logic->node != first.node))
+                    logic = &cpu;
+            }
+            if (logic == nullptr) break;   // CPU 0 의 코어만 남았다
+
+            logicCores.insert(logic->core);
+            plan.logicCpus.push_back(logic->id);
+        }
+        const Cpu* logic = plan.logicCpus.empty() ? &first : FindCpu(plan.logicCpus.front());
+
+        // 샤드 코어의 SMT 형제도 다른 스레드에 주지 않는다
+        for (const Cpu& cpu : plan.cpus)
+        {
+            if (logicCores.count(cpu.core) == 0) plan.sharedCpus.push_back(cpu.id);
+        }
+
+        for (int id : config.ioCpus)
+        {
+            const Cpu* cpu = FindCpu(id);
+            if (cpu != nullptr && logicCores.count(cpu->core) == 0) plan.ioCpus.push_back(id);
+        }
+
+        int ioCoreCount = (int)plan.ioCpus.size();
+        if (plan.ioCpus.empty())
+        {
+            // 물리 코어마다 하나씩, 첫 샤드와 같은 노드부터. 남는 SMT 형제는 워커가 더 많을 때 쓴다.
+            std::vector<const Cpu*> candidates;
+            for (const Cpu& cpu : plan.cpus)
+            {
+                if (logicCores.count(cpu.core) == 0) candidates.push_back(&cpu);
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [logic](const Cpu* a, const Cpu* b) {
+                return (a->node == logic->node) > (b->node == logic->node);
+            });
+
+            std::set<int> usedCores;
+            std::vector<int> siblings;
+            for (const Cpu* cpu : candidates)
+            {
+                if (usedCores.insert(cpu->core).second) plan.ioCpus.push_back(cpu->id);
+                else siblings.push_back(cpu->id);
+            }
+            ioCoreCount = (int)plan.ioCpus.size();
+            plan.ioCpus.insert(plan.ioCpus.end(), siblings.begin(), siblings.end());
+        }
+
+        plan.ioThreads = config.ioThreads > 0 ? config.ioThreads : (std::max)(1, ioCoreCount);
+        plan.numaLocal = config.numaLocalRecvBuffers && plan.nodeCount > 1;
+    }
+}
+
+void ThreadTopology::Configure(Config config)
+{
+    // CHAT_PIN_THREADS=0 으로 고정 없이 돌려 비교한다
+    const char* pin = std::getenv("CHAT_PIN_THREADS");
+    if (pin != nullptr)
+        config.pinThreads = std::strcmp(pin, "0") != 0;
+
+    // CHAT_LOGIC_THREADS=N 으로 샤드 수를 바꾼다
+    const char* logicThreads = std::getenv("CHAT_LOGIC_THREADS");
+    if (logicThreads != nullptr && std::atoi(logicThreads) > 0)
+        config.logicThreads = std::atoi(logicThreads);
+
+    BuildPlan(config);
+    EnterSharedThread();
+}
+
+int ThreadTopology::GetIoThreadCount()
+{
+    return g_plan.ioThreads;
+}
+
+int ThreadTopology::GetDbThreadCount()
+{
+    return g_plan.dbThreads;
+}
+
+int ThreadTopology::GetLogicThreadCount()
+{
+    return g_plan.logicThreads;
+}
+
+void ThreadTopology::EnterLogicThread(size_t index)
+{
+    if (!g_plan.pinned) return;
+
+    // 코어를 받지 못한 샤드는 공용 CPU 에서 돈다
+    if (index >= g_plan.logicCpus.size())
+    {
+        EnterSharedThread();
+        return;
+    }
+
+    int cpu = g_plan.logicCpus[index];
+    if (!PinTo({ cpu }))
+        std::cout << "[Topology] Failed to pin logic shard " << index << " to cpu " << cpu << std::endl;
+
+    t_node = FindCpu(cpu)->node;
+}
+
+void ThreadTopology::EnterIoThread(size_t index)
+{
+    if (!g_plan.pinned || g_plan.ioCpus.empty()) return;
+
+    int cpu = g_plan.ioCpus[index % g_plan.ioCpus.size()];
+    if (!PinTo({ cpu }))
+        std::cout << "[Topology] Failed to pin I/O worker " << index << " to cpu " << cpu << std::endl;
+
+    t_node = FindCpu(cpu)->node;
+}
+
+void ThreadTopology::EnterSharedThread()
+{
+    if (!g_plan.pinned) return;
+    PinTo(g_plan.sharedCpus);
+}
+
+int ThreadTopology::GetCurrentNode()
+{
+    return t_node;
+}
+
+int ThreadTopology::GetNodeCount()
+{
+    return g_plan.nodeCount;
+}
+
+bool ThreadTopology::IsNumaLocalBuffers()
+{
+    return g_plan.numaLocal;
+}
+
+void ThreadTopology::PrintPlan()
+{
+    const Plan& plan = g_plan;
+    std::cout << "[Topology] cpus " << plan.cpus.size() << " (physical cores " << plan.coreCount
+        << ", NUMA nodes " << plan.nodeCount << "), pinning " << (plan.pinned ? "on" : "off") << std::endl;
+
+    if (plan.pinned)
+    {
+        std::cout << "[Topology] logic x" << plan.logicThreads << " -> cpus " << JoinCpus(plan.logicCpus) << " (cores reserved"
+            << (plan.logicThreads > (int)plan.logicCpus.size() ? ", rest shared" : "") << ")"
+            << ", io x" << plan.ioThreads << " -> cpus " << JoinCpus(plan.ioCpus)
+            << ", db x" << plan.dbThreads << " / others -> cpus " << JoinCpus(plan.sharedCpus) << std::endl;
+    }
+    else
+    {
+        std::cout << "[Topology] logic x" << plan.logicThreads << ", io x" << plan.ioThreads << ", db x" << plan.dbThreads << " (scheduler decides)" << std::endl;
+    }
+
+    std::cout << "[Topology] NUMA-local recv buffers: " << (plan.numaLocal ? "on" : "off") << std::endl;
+}
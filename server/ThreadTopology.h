@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// 스레드 배치 (코어 고정 / NUMA).
+// - 시작할 때 쓸 수 있는 CPU, 같은 물리 코어의 SMT 형제, NUMA 노드를 읽어 배치를 정한다.
+// - 로직 샤드 스레드는 각자 물리 코어 하나를 혼자 쓴다 (SMT 형제도 비워 둔다). 인터럽트가 몰리는 CPU 0 은 피한다.
+//   I/O 워커가 쓸 코어가 하나는 남도록, 코어가 모자라면 남는 샤드는 공용 CPU 에서 돈다.
+// - I/O 워커는 첫 샤드와 같은 노드의 나머지 물리 코어부터 하나씩 맡는다.
+// - 로비 / DB / 콘솔 등 나머지 스레드는 샤드 코어만 빼고 어디서든 돈다.
+// - 노드가 둘 이상이면 수신 버퍼를 빌린 스레드의 노드 메모리에서 잡는다 (RecvBufferPool).
+// CHAT_PIN_THREADS=0 으로 고정을 끄고, CHAT_LOGIC_THREADS=N 으로 샤드 수를 바꿔 비교할 수 있다.
+class ThreadTopology
+{
+public:
+    enum { MAX_NODES = 8 };
+
+    struct Config
+    {
+        int ioThreads = 0;            // 0: 샤드 코어를 뺀 물리 코어 수
+        int dbThreads = 2;
+        int logicThreads = 0;         // 로직 샤드 수. 0: 물리 코어의 1/4 (적어도 1)
+        bool pinThreads = true;
+        std::vector<int> logicCpus;   // 비우면 자동
+        std::vector<int> ioCpus;      // 비우면 자동
+        bool numaLocalRecvBuffers = true;
+    };
+
+    // 서버를 만들기 전에 main 에서 한 번 부른다. 호출한 스레드는 공용 CPU 로 옮겨진다.
+    static void Configure(Config config);
+
+    static int GetIoThreadCount();
+    static int GetDbThreadCount();
+    static int GetLogicThreadCount();
+
+    // 각 스레드가 시작할 때 자기 자리로 옮긴다
+    static void EnterLogicThread(size_t index);
+    static void EnterIoThread(size_t index);
+    static void EnterSharedThread();
+
+    // 지금 스레드가 고정된 NUMA 노드 (고정하지 않았으면 0)
+    static int GetCurrentNode();
+    static int GetNodeCount();
+    static bool IsNumaLocalBuffers();
+
+    static void PrintPlan();
+};
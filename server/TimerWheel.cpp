@@ -0,0 +1,174 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel(uint64_t startTick)
+    : currentTick_(startTick)
+{
+    for (uint32_t& head : buckets_)
+        head = NIL;
+}
+
+// 남은 틱 수로 단계를 고르고, 그 단계에서는 만료 틱의 해당 자리로 칸을 고른다.
+// expireTick 은 항상 currentTick_ 이상이다 (같으면 Advance 가 지금 처리하는 칸).
+uint32_t TimerWheel::GetBucket(uint64_t expireTick) const
+{
+    uint64_t delta = expireTick - currentTick_;
+    for (int level = 0; level < LEVEL_COUNT - 1; ++level)
+    {
+        if (delta < (1ull << (LEVEL_BITS * (level + 1))))
+            return level * SLOT_COUNT + (uint32_t)((expireTick >> (LEVEL_BITS * level)) & SLOT_MASK);
+    }
+
+    // 맨 위 단계보다 멀면 끝 칸에 두고, 풀릴 때 다시 나눈다
+    const uint64_t maxDelta = (1ull << (LEVEL_BITS * LEVEL_COUNT)) - 1;
+    uint64_t tick = delta > maxDelta ? currentTick_ + maxDelta : expireTick;
+    return (LEVEL_COUNT - 1) * SLOT_COUNT + (uint32_t)((tick >> (LEVEL_BITS * (LEVEL_COUNT - 1))) & SLOT_MASK);
+}
+
+void TimerWheel::Link(uint32_t index)
+{
+    Node& node = nodes_[index];
+    uint32_t bucket = GetBucket(node.expireTick);
+
+    node.bucket = bucket;
+    node.prev = NIL;
+    node.next = buckets_[bucket];
+    if (node.next != NIL)
+        nodes_[node.next].prev = index;
+    buckets_[bucket] = index;
+}
+
+void TimerWheel::Unlink(uint32_t index)
+{
+    Node& node = nodes_[index];
+
+    if (node.prev != NIL)
+        nodes_[node.prev].next = node.next;
+    else
+        buckets_[node.bucket] = node.next;
+
+    if (node.next != NIL)
+        nodes_[node.next].prev = node.prev;
+
+    node.prev = NIL;
+    node.next = NIL;
+}
+
+void TimerWheel::Release(uint32_t index)
+{
+    Node& node = nodes_[index];
+    node.bucket = NIL;
+    node.generation++;
+    freeNodes_.push_back(index);
+    count_--;
+}
+
+TimerWheel::TimerId TimerWheel::Schedule(uint64_t expireTick, uint64_t key)
+{
+    uint32_t index;
+    if (!freeNodes_.empty())
+    {
+        index = freeNodes_.back();
+        freeNodes_.pop_back();
+    }
+    else
+    {
+        index = (uint32_t)nodes_.size();
+        nodes_.emplace_back();
+    }
+
+    // 이미 지난 타이머는 바로 다음 틱에 만료시킨다
+    Node& node = nodes_[index];
+    node.expireTick = expireTick > currentTick_ ? expireTick : currentTick_ + 1;
+    node.key = key;
+    Link(index);
+    count_++;
+
+    // 0 은 INVALID_TIMER 이므로 인덱스는 1 부터 센다
+    return ((uint64_t)node.generation << 32) | (index + 1);
+}
+
+bool TimerWheel::Cancel(TimerId id)
+{
+    if (id == INVALID_TIMER) return false;
+
+    uint32_t index = (uint32_t)(id & 0xFFFFFFFF) - 1;
+    if (index >= nodes_.size()) return false;
+
+    Node& node = nodes_[index];
+    if (node.bucket == NIL || node.generation != (uint32_t)(id >> 32)) return false;
+
+    Unlink(index);
+    Release(index);
+    return true;
+}
+
+// 위 단계 칸 하나를 떼어 현재 틱 기준으로 다시 넣는다 (대부분 한 단계 아래로 내려간다)
+void TimerWheel::Cascade(int level, uint32_t slot)
+{
+    uint32_t bucket = level * SLOT_COUNT + slot;
+    uint32_t index = buckets_[bucket];
+    buckets_[bucket] = NIL;
+
+    while (index != NIL)
+    {
+        uint32_t next = nodes_[index].next;
+        Link(index);
+        index = next;
+    }
+}
+
+void TimerWheel::Advance(uint64_t nowTick, std::vector<uint64_t>& expired)
+{
+    // 걸린 타이머가 없으면 빈 칸을 하나씩 돌 필요가 없다
+    if (count_ == 0)
+    {
+        if (nowTick > currentTick_) currentTick_ = nowTick;
+        return;
+    }
+
+    while (currentTick_ < nowTick)
+    {
+        uint64_t tick = ++currentTick_;
+
+        // 아래 단계가 한 바퀴 돌았으면 위 단계의 이번 칸을 풀어 내린다 (위 단계부터)
+        if ((tick & SLOT_MASK) == 0)
+        {
+            int top = 1;
+            while (top < LEVEL_COUNT - 1 && ((tick >> (LEVEL_BITS * top)) & SLOT_MASK) == 0)
+                top++;
+
+            for (int level = top; level >= 1; --level)
+                Cascade(level, (uint32_t)((tick >> (LEVEL_BITS * level)) & SLOT_MASK));
+        }
+
+        uint32_t bucket = (uint32_t)(tick & SLOT_MASK);
+        uint32_t index = buckets_[bucket];
+        buckets_[bucket] = NIL;
+
+        while (index != NIL)
+        {
+            Node& node = nodes_[index];
+            uint32_t next = node.next;
+
+            if (node.expireTick > tick)
+            {
+                // 맨 위 단계 끝 칸에 잘려 들어갔던 먼 타이머
+                Link(index);
+            }
+            else
+            {
+                expired.push_back(node.key);
+                node.prev = NIL;
+                node.next = NIL;
+                Release(index);
+            }
+            index = next;
+        }
+
+        if (count_ == 0)
+        {
+            currentTick_ = nowTick;
+            break;
+        }
+    }
+}
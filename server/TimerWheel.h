@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 계층형 해시 타이밍 휠 (Varghese & Lauck).
+// - 한 단계에 256칸씩 4단계. 0단계 한 칸이 한 틱이고, 위 단계 칸은 아래 단계 한 바퀴를 담는다.
+// - 등록/취소는 칸의 이중 연결 리스트에 넣고 빼기만 하므로 O(1), 틱마다 도는 것은 만료되는 칸 하나뿐이다.
+//   위 단계 칸은 아래 단계가 한 바퀴 돌 때 한 번 풀어서 다시 나눠 담는다.
+// - 노드는 배열에 두고 인덱스로 잇는다 (타이머마다 힙 할당 없음).
+// 한 스레드(로비)에서만 쓴다.
+class TimerWheel
+{
+public:
+    using TimerId = uint64_t;
+    static constexpr TimerId INVALID_TIMER = 0;
+
+    enum
+    {
+        LEVEL_BITS = 8,
+        SLOT_COUNT = 1 << LEVEL_BITS,
+        SLOT_MASK = SLOT_COUNT - 1,
+        LEVEL_COUNT = 4,
+    };
+
+    explicit TimerWheel(uint64_t startTick = 0);
+
+    // expireTick 에 만료될 타이머를 건다. 이미 지난 틱이면 다음 Advance 에서 만료된다.
+    TimerId Schedule(uint64_t expireTick, uint64_t key);
+
+    // 아직 만료되지 않은 타이머면 빼고 true
+    bool Cancel(TimerId id);
+
+    // nowTick 까지 시간을 진행하고 만료된 타이머의 key 를 expired 뒤에 붙인다
+    void Advance(uint64_t nowTick, std::vector<uint64_t>& expired);
+
+    uint64_t GetCurrentTick() const { return currentTick_; }
+    size_t Size() const { return count_; }
+
+private:
+    static constexpr uint32_t NIL = 0xFFFFFFFF;
+
+    struct Node
+    {
+        uint64_t expireTick = 0;
+        uint64_t key = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        uint32_t bucket = NIL;      // 들어 있는 칸 (NIL 이면 비어 있는 노드)
+        uint32_t generation = 0;    // 노드를 다시 쓰면 올라가서 옛 TimerId 를 무효로 만든다
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> freeNodes_;
+    uint32_t buckets_[LEVEL_COUNT * SLOT_COUNT];
+
+    uint64_t currentTick_;
+    size_t count_ = 0;
+
+    uint32_t GetBucket(uint64_t expireTick) const;
+    void Link(uint32_t index);
+    void Unlink(uint32_t index);
+    void Cascade(int level, uint32_t slot);
+    void Release(uint32_t index);
+};
@@ -0,0 +1,850 @@
+#include "UringWorker.h"
+#include "ClientSession.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
+// liburing 없이 커널 ABI(<linux/io_uring.h>)를 직접 사용한다
+namespace
+{
+    int io_uring_setup(unsigned entries, io_uring_params* params)
+    {
+        return (int)syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    int io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+        return (int)syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    int io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nrArgs)
+    {
+        return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs);
+    }
+}
+
+struct UringEngine::Ring
+{
+    int fd = -1;
+
+    // SQ
+    void* sqPtr = nullptr;
+    size_t sqSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqesSize = 0;
+    unsigned localTail = 0;
+    std::mutex sqLock;
+
+    // CQ
+    void* cqPtr = nullptr;
+    size_t cqSize = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    // provided buffer ring (워커 스레드만 접근)
+    io_uring_buf_ring* bufRing = nullptr;
+    size_t bufRingSize = 0;
+    char* bufPool = nullptr;
+    unsigned short bufTail = 0;
+    bool legacyBuffers = false;     // buffer ring 을 못 쓰면 IORING_OP_PROVIDE_BUFFERS 로 대체
+
+    // 이 링 전용 SO_REUSEPORT 리스너
+    SOCKET listenFd = INVALID_SOCKET;
+
+    // fixed file 슬롯
+    std::mutex fileLock;
+    std::vector<int> freeSlots;
+
+    // 다른 스레드에서 SQE 를 넣었을 때 워커를 깨우는 eventfd
+    int wakeupFd = -1;
+    uint64_t wakeupValue = 0;
+    std::atomic<bool> wakeupPending = false;
+};
+
+namespace
+{
+    thread_local void* t_currentRing = nullptr;
+}
+
+UringEngine::UringEngine()
+{
+}
+
+UringEngine::~UringEngine()
+{
+    Close();
+}
+
+UringEngine::UringContext* UringEngine::GetContext(ClientSession* session)
+{
+    return static_cast<UringContext*>(session->GetIOContext());
+}
+
+bool UringEngine::Initialize(size_t workerCount)
+{
+    // fixed file 테이블 크기는 RLIMIT_NOFILE 을 넘을 수 없다
+    rlimit limit = {};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0)
+    {
+        fixedFilesPerRing_ = (unsigned)(std::min<rlim_t>)(MAX_FIXED_FILES, limit.rlim_cur);
+    }
+
+    for (size_t i = 0; i < workerCount; ++i)
+    {
+        auto ring = std::make_unique<Ring>();
+        if (!SetupRing(*ring))
+        {
+            std::cout << "[io_uring] Ring Setup Failed: " << GetLastSocketError() << std::endl;
+            DestroyRing(*ring);
+            return false;
+        }
+        rings_.push_back(std::move(ring));
+    }
+    return !rings_.empty();
+}
+
+bool UringEngine::SetupRing(Ring& ring)
+{
+    io_uring_params params = {};
+    params.flags = IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN;
+
+    ring.fd = io_uring_setup(RING_ENTRIES, &params);
+    if (ring.fd < 0 && errno == EINVAL)
+    {
+        params = {};
+        ring.fd = io_uring_setup(RING_ENTRIES, &params);
+    }
+    if (ring.fd < 0) return false;
+
+    ring.sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring.cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMmap)
+    {
+        ring.sqSize = ring.cqSize = (std::max)(ring.sqSize, ring.cqSize);
+    }
+
+    ring.sqPtr = mmap(nullptr, ring.sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQ_RING);
+    if (ring.sqPtr == MAP_FAILED) { ring.sqPtr = nullptr; return false; }
+
+    if (singleMmap)
+    {
+        ring.cqPtr = ring.sqPtr;
+    }
+    else
+    {
+        ring.cqPtr = mmap(nullptr, ring.cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_CQ_RING);
+        if (ring.cqPtr == MAP_FAILED) { ring.cqPtr = nullptr; return false; }
+    }
+
+    ring.sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, ring.sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    ring.sqes = static_cast<io_uring_sqe*>(sqes);
+
+    char* sq = static_cast<char*>(ring.sqPtr);
+    ring.sqHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    ring.sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    ring.sqMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    ring.sqEntries = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_entries);
+    ring.localTail = *ring.sqTail;
+
+    // SQ index 배열은 항상 항등 매핑으로 둔다
+    unsigned* sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    for (unsigned i = 0; i < ring.sqEntries; ++i)
+        sqArray[i] = i;
+
+    char* cq = static_cast<char*>(ring.cqPtr);
+    ring.cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    ring.cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    ring.cqMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    ring.cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+    // registered files (sparse)
+    io_uring_rsrc_register files = {};
+    files.nr = fixedFilesPerRing_;
+    files.flags = IORING_RSRC_REGISTER_SPARSE;
+    if (io_uring_register(ring.fd, IORING_REGISTER_FILES2, &files, sizeof(files)) < 0)
+        return false;
+
+    ring.freeSlots.reserve(fixedFilesPerRing_);
+    for (int i = (int)fixedFilesPerRing_ - 1; i >= 0; --i)
+        ring.freeSlots.push_back(i);
+
+    ring.bufPool = static_cast<char*>(std::aligned_alloc(4096, (size_t)RECV_BUFFER_COUNT * RECV_BUFFER_SIZE));
+    if (ring.bufPool == nullptr) return false;
+
+    // provided buffer ring
+    ring.bufRingSize = RECV_BUFFER_COUNT * sizeof(io_uring_buf);
+    void* bufRing = mmap(nullptr, ring.bufRingSize, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE | MAP_POPULATE, -1, 0);
+    if (bufRing == MAP_FAILED) return false;
+    ring.bufRing = static_cast<io_uring_buf_ring*>(bufRing);
+    std::memset(ring.bufRing, 0, ring.bufRingSize);
+
+    io_uring_buf_reg reg = {};
+    reg.ring_addr = reinterpret_cast<uint64_t>(ring.bufRing);
+    reg.ring_entries = RECV_BUFFER_COUNT;
+    reg.bgid = RECV_BUFFER_GROUP;
+    bool registered = io_uring_register(ring.fd, IORING_REGISTER_PBUF_RING, &reg, 1) == 0;
+
+    if (registered)
+    {
+        for (unsigned i = 0; i < RECV_BUFFER_COUNT; ++i)
+            RecycleBuffer(ring, (uint16_t)i);
+    }
+
+    // 등록은 되는데 커널이 버퍼를 못 가져가는 환경이 있어서 실제로 한 번 받아 본다
+    if (!registered || !ProbeBufferRing(ring))
+    {
+        if (registered)
+        {
+            io_uring_buf_reg unreg = {};
+            unreg.bgid = RECV_BUFFER_GROUP;
+            io_uring_register(ring.fd, IORING_UNREGISTER_PBUF_RING, &unreg, 1);
+        }
+        munmap(ring.bufRing, ring.bufRingSize);
+        ring.bufRing = nullptr;
+        ring.legacyBuffers = true;
+        std::cout << "[io_uring] Buffer Ring Unavailable, Using PROVIDE_BUFFERS" << std::endl;
+
+        std::lock_guard<std::mutex> lock(ring.sqLock);
+        io_uring_sqe* sqe = GetSqeLocked(ring);
+        if (sqe == nullptr) return false;
+
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = RECV_BUFFER_COUNT;
+        sqe->addr = reinterpret_cast<uint64_t>(ring.bufPool);
+        sqe->len = RECV_BUFFER_SIZE;
+        sqe->buf_group = RECV_BUFFER_GROUP;
+        sqe->off = 0;
+        sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+        sqe->user_data = OP_PROVIDE;
+        SubmitLocked(ring);
+    }
+
+    ring.wakeupFd = eventfd(0, EFD_CLOEXEC);
+    return ring.wakeupFd >= 0;
+}
+
+// 워커가 돌기 전에 socketpair 로 buffer select recv 를 한 번 해 본다
+bool UringEngine::ProbeBufferRing(Ring& ring)
+{
+    int pair[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, pair) < 0) return false;
+
+    char probe = 0;
+    bool ok = ::write(pair[1], &probe, 1) == 1;
+    if (ok)
+    {
+        std::lock_guard<std::mutex> lock(ring.sqLock);
+        io_uring_sqe* sqe = GetSqeLocked(ring);
+        ok = sqe != nullptr;
+        if (ok)
+        {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = pair[0];
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = RECV_BUFFER_GROUP;
+            sqe->user_data = OP_PROVIDE;
+            __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+            ok = io_uring_enter(ring.fd, 1, 1, IORING_ENTER_GETEVENTS) == 1;
+        }
+    }
+
+    if (ok)
+    {
+        unsigned head = *ring.cqHead;
+        ok = head != __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+        if (ok)
+        {
+            io_uring_cqe* cqe = &ring.cqes[head & ring.cqMask];
+            ok = cqe->res == 1 && (cqe->flags & IORING_CQE_F_BUFFER);
+            if (ok)
+                RecycleBuffer(ring, (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT));
+            __atomic_store_n(ring.cqHead, head + 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    return ok;
+}
+
+void UringEngine::DestroyRing(Ring& ring)
+{
+    if (ring.listenFd != INVALID_SOCKET) closesocket(ring.listenFd);
+    if (ring.wakeupFd >= 0) ::close(ring.wakeupFd);
+    if (ring.bufPool) std::free(ring.bufPool);
+    if (ring.bufRing) munmap(ring.bufRing, ring.bufRingSize);
+    if (ring.sqes) munmap(ring.sqes, ring.sqesSize);
+    if (ring.cqPtr && ring.cqPtr != ring.sqPtr) munmap(ring.cqPtr, ring.cqSize);
+    if (ring.sqPtr) munmap(ring.sqPtr, ring.sqSize);
+    if (ring.fd >= 0) ::close(ring.fd);
+
+    ring.listenFd = INVALID_SOCKET;
+    ring.wakeupFd = -1;
+    ring.bufPool = nullptr;
+    ring.bufRing = nullptr;
+    ring.sqes = nullptr;
+    ring.cqPtr = nullptr;
+    ring.sqPtr = nullptr;
+    ring.fd = -1;
+}
+
+void UringEngine::Close()
+{
+    listening_ = false;
+    for (auto& ring : rings_)
+        DestroyRing(*ring);
+    rings_.clear();
+}
+
+// 워커마다 자기 링의 eventfd 를 기다리므로 링 수만큼 깨운다 (워커 수와 같다)
+void UringEngine::WakeupWorkers(size_t)
+{
+    stopping_ = true;
+    for (auto& ring : rings_)
+    {
+        uint64_t one = 1;
+        ssize_t ret = ::write(ring->wakeupFd, &one, sizeof(one));
+        (void)ret;
+    }
+}
+
+io_uring_sqe* UringEngine::GetSqeLocked(Ring& ring)
+{
+    unsigned head = __atomic_load_n(ring.sqHead, __ATOMIC_ACQUIRE);
+
+    // SQ 가 가득 차면 직접 제출해서 자리를 만든다
+    if (ring.localTail - head >= ring.sqEntries)
+    {
+        SubmitLocked(ring);
+        head = __atomic_load_n(ring.sqHead, __ATOMIC_ACQUIRE);
+        if (ring.localTail - head >= ring.sqEntries)
+            return nullptr;
+    }
+
+    io_uring_sqe* sqe = &ring.sqes[ring.localTail & ring.sqMask];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ring.localTail++;
+    return sqe;
+}
+
+void UringEngine::SubmitLocked(Ring& ring)
+{
+    __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+    unsigned pending = ring.localTail - __atomic_load_n(ring.sqHead, __ATOMIC_ACQUIRE);
+    if (pending > 0)
+        io_uring_enter(ring.fd, pending, 0, 0);
+}
+
+// 워커 스레드 밖에서 SQE 를 넣었다면 워커가 제출하도록 깨운다.
+// 깨우기는 묶음당 한 번: 다음 io_uring_enter 까지 쌓인 SQE 는 함께 제출된다.
+void UringEngine::Wakeup(Ring& ring)
+{
+    if (t_currentRing == &ring) return;
+
+    if (!ring.wakeupPending.exchange(true))
+    {
+        uint64_t one = 1;
+        ssize_t ret = ::write(ring.wakeupFd, &one, sizeof(one));
+        (void)ret;
+    }
+}
+
+void UringEngine::SubmitWakeupRead(Ring& ring)
+{
+    std::lock_guard<std::mutex> lock(ring.sqLock);
+    io_uring_sqe* sqe = GetSqeLocked(ring);
+    if (sqe == nullptr) return;
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = ring.wakeupFd;
+    sqe->addr = reinterpret_cast<uint64_t>(&ring.wakeupValue);
+    sqe->len = sizeof(ring.wakeupValue);
+    sqe->user_data = OP_WAKEUP;
+    __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+}
+
+bool UringEngine::Listen(uint16_t port, AcceptHandler onAccept)
+{
+    onAccept_ = std::move(onAccept);
+    listening_ = true;
+
+    for (auto& ring : rings_)
+    {
+        ring->listenFd = CreateListenSocket(port);
+        if (ring->listenFd == INVALID_SOCKET) return false;
+        if (!ArmAccept(*ring)) return false;
+    }
+    return true;
+}
+
+// 걸려 있는 multishot accept 를 취소한다. 리스너 fd 는 DestroyRing 에서 닫는다.
+void UringEngine::StopListen()
+{
+    if (!listening_.exchange(false)) return;
+
+    for (auto& ring : rings_)
+    {
+        {
+            std::lock_guard<std::mutex> lock(ring->sqLock);
+            io_uring_sqe* sqe = GetSqeLocked(*ring);
+            if (sqe == nullptr) continue;
+
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->addr = OP_ACCEPT;
+            sqe->user_data = OP_CANCEL;
+            __atomic_store_n(ring->sqTail, ring->localTail, __ATOMIC_RELEASE);
+        }
+        Wakeup(*ring);
+    }
+}
+
+bool UringEngine::ArmAccept(Ring& ring)
+{
+    {
+        std::lock_guard<std::mutex> lock(ring.sqLock);
+        io_uring_sqe* sqe = GetSqeLocked(ring);
+        if (sqe == nullptr) return false;
+
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = ring.listenFd;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->user_data = OP_ACCEPT;
+        __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+    }
+
+    Wakeup(ring);
+    return true;
+}
+
+// 워커 스레드에서 불린다. onAccept 안의 Attach 는 t_currentRing 을 보고 이 링에 붙는다.
+void UringEngine::HandleAccept(Ring& ring, int res, uint32_t flags)
+{
+    if (res >= 0)
+    {
+        if (listening_.load())
+            onAccept_(res);
+        else
+            closesocket(res);
+    }
+    else if (res != -ECANCELED)
+    {
+        std::cout << "[Error] Accept Failed: " << -res << std::endl;
+    }
+
+    if ((flags & IORING_CQE_F_MORE) == 0 && listening_.load())
+        ArmAccept(ring);
+}
+
+bool UringEngine::Attach(ClientSession* session)
+{
+    if (rings_.empty()) return false;
+
+    // accept 완료를 처리 중인 워커라면 자기 링에 붙여 다른 스레드를 거치지 않게 한다
+    Ring& ring = (t_currentRing != nullptr)
+        ? *static_cast<Ring*>(t_currentRing)
+        : *rings_[nextRing_.fetch_add(1) % rings_.size()];
+
+    int slot = -1;
+    {
+        std::lock_guard<std::mutex> lock(ring.fileLock);
+        if (ring.freeSlots.empty())
+        {
+            std::cout << "[io_uring] No Free Fixed File Slot" << std::endl;
+            return false;
+        }
+        slot = ring.freeSlots.back();
+        ring.freeSlots.pop_back();
+    }
+
+    int fd = session->GetSocket();
+    io_uring_files_update update = {};
+    update.offset = (unsigned)slot;
+    update.fds = reinterpret_cast<uint64_t>(&fd);
+    if (io_uring_register(ring.fd, IORING_REGISTER_FILES_UPDATE, &update, 1) < 0)
+    {
+        std::lock_guard<std::mutex> lock(ring.fileLock);
+        ring.freeSlots.push_back(slot);
+        return false;
+    }
+
+    auto ctx = std::make_unique<UringContext>();
+    ctx->ring = &ring;
+    ctx->fd = fd;
+    ctx->fixedIndex = slot;
+    session->SetIOContext(std::move(ctx));
+
+    // 걸려 있는 작업이 모두 완료되고 fixed file 을 정리할 때까지 세션을 놓지 못하게 한다
+    session->AddIoRef();
+    return true;
+}
+
+bool UringEngine::ArmRecvLocked(ClientSession* session, UringContext& ctx)
+{
+    Ring& ring = *ctx.ring;
+    {
+        std::lock_guard<std::mutex> lock(ring.sqLock);
+        io_uring_sqe* sqe = GetSqeLocked(ring);
+        if (sqe == nullptr) return false;
+
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = ctx.fixedIndex;
+        sqe->flags = IOSQE_FIXED_FILE | IOSQE_BUFFER_SELECT;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->buf_group = RECV_BUFFER_GROUP;
+        sqe->user_data = reinterpret_cast<uint64_t>(session) | OP_RECV;
+        __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+    }
+
+    ctx.recvArmed = true;
+    ctx.inflight++;
+    Wakeup(ring);
+    return true;
+}
+
+bool UringEngine::PostRecv(ClientSession* session, char* buf, int len)
+{
+    UringContext* ctx = GetContext(session);
+    if (ctx == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return false;
+
+    PER_IO_DATA& ioData = session->GetRecvIoData();
+    ioData.buf = buf;
+    ioData.len = static_cast<uint32_t>(len);
+    ioData.transferred = 0;
+    ioData.pending = true;
+    ioData.operation = 0;
+
+    // multishot recv 가 이미 걸려 있으면 버퍼 위치만 갱신하면 된다
+    if (ctx->recvArmed) return true;
+    return ArmRecvLocked(session, *ctx);
+}
+
+bool UringEngine::SubmitSendLocked(ClientSession* session, UringContext& ctx)
+{
+    PER_IO_DATA& ioData = session->GetSendIoData();
+    Ring& ring = *ctx.ring;
+
+    // msghdr 는 SQE 가 제출될 때까지 살아 있어야 하므로 컨텍스트에 둔다
+    ctx.sendMsg = {};
+    ctx.sendMsg.msg_iov = ioData.bufs;
+    ctx.sendMsg.msg_iovlen = (size_t)ioData.bufCount;
+
+    std::lock_guard<std::mutex> lock(ring.sqLock);
+    io_uring_sqe* sqe = GetSqeLocked(ring);
+    if (sqe == nullptr) return false;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = ctx.fixedIndex;
+    sqe->flags = IOSQE_FIXED_FILE;
+    sqe->addr = reinterpret_cast<uint64_t>(&ctx.sendMsg);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = reinterpret_cast<uint64_t>(session) | OP_SEND;
+    __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool UringEngine::PostSend(ClientSession* session, IoBuffer* bufs, int count)
+{
+    UringContext* ctx = GetContext(session);
+    if (ctx == nullptr) return false;
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return false;
+
+    PER_IO_DATA& ioData = session->GetSendIoData();
+    ioData.bufs = bufs;
+    ioData.bufCount = count;
+    ioData.pending = true;
+    ioData.operation = 1;
+
+    if (!SubmitSendLocked(session, *ctx))
+        return false;
+
+    ctx->inflight++;
+    Wakeup(*ctx->ring);
+    return true;
+}
+
+// shutdown 으로 걸려 있는 recv/send 를 끝내고, 정리는 마지막 완료를 받은 워커가 한다.
+// 아무 작업도 없을 수 있으니 NOP 을 하나 걸어 정리 시점을 워커로 넘긴다.
+void UringEngine::CloseSocket(ClientSession* session)
+{
+    UringContext* ctx = GetContext(session);
+    if (ctx == nullptr)
+    {
+        closesocket(session->GetSocket());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(ctx->lock);
+    if (ctx->closed) return;
+    ctx->closed = true;
+
+    shutdown(ctx->fd, SHUT_RDWR);
+
+    Ring& ring = *ctx->ring;
+    {
+        std::lock_guard<std::mutex> sqLock(ring.sqLock);
+        io_uring_sqe* sqe = GetSqeLocked(ring);
+        if (sqe == nullptr) return;
+
+        sqe->opcode = IORING_OP_NOP;
+        sqe->user_data = reinterpret_cast<uint64_t>(session) | OP_CLOSE;
+        __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+    }
+
+    ctx->inflight++;
+    Wakeup(ring);
+}
+
+void UringEngine::RecycleBuffer(Ring& ring, uint16_t bufferId)
+{
+    if (ring.legacyBuffers)
+    {
+        std::lock_guard<std::mutex> lock(ring.sqLock);
+        io_uring_sqe* sqe = GetSqeLocked(ring);
+        if (sqe == nullptr) return;
+
+        sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+        sqe->fd = 1;
+        sqe->addr = reinterpret_cast<uint64_t>(ring.bufPool + (size_t)bufferId * RECV_BUFFER_SIZE);
+        sqe->len = RECV_BUFFER_SIZE;
+        sqe->buf_group = RECV_BUFFER_GROUP;
+        sqe->off = bufferId;
+        sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+        sqe->user_data = OP_PROVIDE;
+        __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+        return;
+    }
+
+    io_uring_buf* buf = &ring.bufRing->bufs[ring.bufTail & (RECV_BUFFER_COUNT - 1)];
+    buf->addr = reinterpret_cast<uint64_t>(ring.bufPool + (size_t)bufferId * RECV_BUFFER_SIZE);
+    buf->len = RECV_BUFFER_SIZE;
+    buf->bid = bufferId;
+    ring.bufTail++;
+    __atomic_store_n(&ring.bufRing->tail, ring.bufTail, __ATOMIC_RELEASE);
+}
+
+// 커널이 고른 버퍼에서 세션 수신 버퍼로 옮긴다. 세션이 버퍼 없이 기다리고 있었으면 이때 빌린다.
+// 세션 버퍼 여유보다 크면 OnRecv 로 나눠서 넘긴다 (OnRecv 가 매번 PostRecv 로 새 위치를 알려준다).
+void UringEngine::DeliverRecv(ClientSession* session, UringContext& ctx, const char* data, uint32_t size)
+{
+    PER_IO_DATA& ioData = session->GetRecvIoData();
+    uint32_t offset = 0;
+
+    while (offset < size)
+    {
+        char* dst = nullptr;
+        uint32_t capacity = 0;
+        {
+            std::lock_guard<std::mutex> lock(ctx.lock);
+            if (!ioData.pending || ctx.closed) return;
+            dst = ioData.buf;
+            capacity = ioData.len;
+            ioData.pending = false;
+        }
+
+        // 버퍼 없이 기다리던 세션: 빌려 온 버퍼로 다시 PostRecv 하면 같은 루프에서 이어서 옮긴다
+        if (dst == nullptr)
+        {
+            session->OnRecvReady();
+            continue;
+        }
+
+        uint32_t chunk = (std::min)(capacity, size - offset);
+        std::memcpy(dst, data + offset, chunk);
+        offset += chunk;
+
+        session->OnRecv(chunk);
+    }
+}
+
+void UringEngine::HandleRecv(Ring& ring, ClientSession* session, int res, uint32_t flags)
+{
+    UringContext* ctx = GetContext(session);
+
+    if (res > 0 && (flags & IORING_CQE_F_BUFFER))
+    {
+        uint16_t bufferId = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+        DeliverRecv(session, *ctx, ring.bufPool + (size_t)bufferId * RECV_BUFFER_SIZE, (uint32_t)res);
+        RecycleBuffer(ring, bufferId);
+    }
+
+    bool closed = (res == 0) || (res < 0 && res != -ENOBUFS);
+
+    if ((flags & IORING_CQE_F_MORE) == 0)
+    {
+        std::lock_guard<std::mutex> lock(ctx->lock);
+        ctx->recvArmed = false;
+        ctx->inflight--;
+
+        // 버퍼 고갈(ENOBUFS) 등으로 multishot 이 풀렸으면 다시 건다
+        if (!closed && !ctx->closed && session->GetRecvIoData().pending)
+            ArmRecvLocked(session, *ctx);
+    }
+
+    if (closed)
+        HandleSessionClosed(session);
+}
+
+// 일부만 나갔어도 나간 만큼 완료를 알린다. 남은 부분은 세션이 다시 PostSend 한다.
+void UringEngine::HandleSend(ClientSession* session, int res)
+{
+    UringContext* ctx = GetContext(session);
+    PER_IO_DATA& ioData = session->GetSendIoData();
+
+    {
+        std::lock_guard<std::mutex> lock(ctx->lock);
+        ioData.pending = false;
+        ctx->inflight--;
+    }
+
+    if (res <= 0)
+    {
+        HandleSessionClosed(session);
+        return;
+    }
+
+    session->OnSendCompleted((uint32_t)res);
+}
+
+void UringEngine::ReleaseIfDrained(ClientSession* session)
+{
+    UringContext* ctx = GetContext(session);
+    {
+        std::lock_guard<std::mutex> lock(ctx->lock);
+        if (!ctx->closed || ctx->inflight > 0 || ctx->fd == INVALID_SOCKET) return;
+
+        Ring& ring = *ctx->ring;
+        int fd = -1;
+        io_uring_files_update update = {};
+        update.offset = (unsigned)ctx->fixedIndex;
+        update.fds = reinterpret_cast<uint64_t>(&fd);
+        io_uring_register(ring.fd, IORING_REGISTER_FILES_UPDATE, &update, 1);
+        {
+            std::lock_guard<std::mutex> fileLock(ring.fileLock);
+            ring.freeSlots.push_back(ctx->fixedIndex);
+        }
+        ctx->fixedIndex = -1;
+
+        closesocket(ctx->fd);
+        ctx->fd = INVALID_SOCKET;
+    }
+
+    // 잠금을 푼 뒤에 놓는다. 이후로는 로비 스레드의 SessionReclaimer 가 언제든 세션을 해제할 수 있다.
+    session->ReleaseIoRef();
+}
+
+void UringEngine::HandleCompletion(Ring& ring, uint64_t userData, int res, uint32_t flags)
+{
+    ClientSession* session = reinterpret_cast<ClientSession*>(userData & ~(uint64_t)OP_MASK);
+
+    switch (userData & OP_MASK)
+    {
+    case OP_RECV:
+        HandleRecv(ring, session, res, flags);
+        break;
+    case OP_SEND:
+        HandleSend(session, res);
+        break;
+    case OP_CLOSE:
+    {
+        std::lock_guard<std::mutex> lock(GetContext(session)->lock);
+        GetContext(session)->inflight--;
+        break;
+    }
+    default:
+        return;
+    }
+
+    ReleaseIfDrained(session);
+}
+
+void UringEngine::RunWorker()
+{
+    size_t index = nextWorker_.fetch_add(1);
+    if (index >= rings_.size()) return;
+
+    Ring& ring = *rings_[index];
+    t_currentRing = &ring;
+
+    SubmitWakeupRead(ring);
+
+    while (true)
+    {
+        // 이 시점 이후에 들어온 SQE 는 다시 깨우기를 요청한다
+        ring.wakeupPending.store(false);
+
+        unsigned toSubmit = 0;
+        {
+            std::lock_guard<std::mutex> lock(ring.sqLock);
+            __atomic_store_n(ring.sqTail, ring.localTail, __ATOMIC_RELEASE);
+            toSubmit = ring.localTail - __atomic_load_n(ring.sqHead, __ATOMIC_ACQUIRE);
+        }
+
+        int ret = io_uring_enter(ring.fd, toSubmit, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+        {
+            std::cout << "[Worker] io_uring_enter Failed: " << errno << std::endl;
+            break;
+        }
+
+        unsigned head = *ring.cqHead;
+        unsigned tail = __atomic_load_n(ring.cqTail, __ATOMIC_ACQUIRE);
+
+        while (head != tail)
+        {
+            io_uring_cqe* cqe = &ring.cqes[head & ring.cqMask];
+            uint64_t userData = cqe->user_data;
+            int res = cqe->res;
+            uint32_t flags = cqe->flags;
+
+            head++;
+            __atomic_store_n(ring.cqHead, head, __ATOMIC_RELEASE);
+
+            if (userData == OP_PROVIDE || userData == OP_CANCEL)
+                continue;
+
+            if (userData == OP_ACCEPT)
+            {
+                HandleAccept(ring, res, flags);
+                continue;
+            }
+
+            if (userData == OP_WAKEUP)
+            {
+                if (stopping_.load())
+                {
+                    std::cout << "[Worker] Thread Exiting..." << std::endl;
+                    t_currentRing = nullptr;
+                    return;
+                }
+                SubmitWakeupRead(ring);
+                continue;
+            }
+
+            HandleCompletion(ring, userData, res, flags);
+        }
+    }
+
+    t_currentRing = nullptr;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <linux/io_uring.h>
+#include "IOEngine.h"
+
+// io_uring 기반 I/O 엔진 (Linux 5.19+).
+// - 워커 스레드마다 링 하나. 세션은 Attach 시점에 링에 라운드로빈으로 배정된다.
+// - 세션 소켓은 registered fixed file 로 등록한다.
+// - 수신은 multishot recv + provided buffer ring: 한 번 걸어 두면 재요청 syscall 이 없다.
+//   (buffer ring 을 쓸 수 없는 커널에서는 IORING_OP_PROVIDE_BUFFERS 로 대체한다)
+// - accept 는 링마다 SO_REUSEPORT 리스너 + multishot accept. 받은 소켓은 그 링에 그대로 붙인다.
+// - 송신 SQE 는 링에 쌓아 두고 워커가 io_uring_enter 한 번으로 묶어서 제출한다.
+class UringEngine : public IOEngine
+{
+public:
+    UringEngine();
+    ~UringEngine() override;
+
+    const char* GetName() const override { return "io_uring"; }
+
+    bool Initialize(size_t workerCount) override;
+    void Close() override;
+
+    void RunWorker() override;
+    void WakeupWorkers(size_t workerCount) override;
+
+    bool Listen(uint16_t port, AcceptHandler onAccept) override;
+    void StopListen() override;
+
+    bool Attach(ClientSession* session) override;
+    bool PostRecv(ClientSession* session, char* buf, int len) override;
+    bool PostSend(ClientSession* session, IoBuffer* bufs, int count) override;
+    void CloseSocket(ClientSession* session) override;
+    size_t GetSessionContextSize() const override { return sizeof(UringContext); }
+
+private:
+    enum
+    {
+        RING_ENTRIES = 4096,
+        MAX_FIXED_FILES = 16384,
+        RECV_BUFFER_COUNT = 1024,   // 2의 거듭제곱
+        RECV_BUFFER_SIZE = 4096,
+        RECV_BUFFER_GROUP = 0,
+    };
+
+    enum OpType : uint64_t
+    {
+        OP_RECV = 0,
+        OP_SEND = 1,
+        OP_CLOSE = 2,
+        OP_WAKEUP = 3,
+        OP_PROVIDE = 4,
+        OP_ACCEPT = 5,
+        OP_CANCEL = 6,
+        OP_MASK = 7,
+    };
+
+    struct Ring;
+
+    struct UringContext : public IOContext
+    {
+        std::mutex lock;
+        Ring* ring = nullptr;
+        SOCKET fd = INVALID_SOCKET;
+        int fixedIndex = -1;
+        int inflight = 0;
+        bool recvArmed = false;
+        bool closed = false;
+        msghdr sendMsg = {};
+    };
+
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::atomic<size_t> nextWorker_ = 0;
+    std::atomic<size_t> nextRing_ = 0;
+    std::atomic<bool> stopping_ = false;
+    std::atomic<bool> listening_ = false;
+    unsigned fixedFilesPerRing_ = MAX_FIXED_FILES;
+
+    static UringContext* GetContext(ClientSession* session);
+
+    bool SetupRing(Ring& ring);
+    bool ProbeBufferRing(Ring& ring);
+    void DestroyRing(Ring& ring);
+
+    io_uring_sqe* GetSqeLocked(Ring& ring);
+    void SubmitLocked(Ring& ring);
+    void Wakeup(Ring& ring);
+
+    bool ArmAccept(Ring& ring);
+    void HandleAccept(Ring& ring, int res, uint32_t flags);
+    bool ArmRecvLocked(ClientSession* session, UringContext& ctx);
+    bool SubmitSendLocked(ClientSession* session, UringContext& ctx);
+    void SubmitWakeupRead(Ring& ring);
+
+    void HandleCompletion(Ring& ring, uint64_t userData, int res, uint32_t flags);
+    void HandleRecv(Ring& ring, ClientSession* session, int res, uint32_t flags);
+    void HandleSend(ClientSession* session, int res);
+    void DeliverRecv(ClientSession* session, UringContext& ctx, const char* data, uint32_t size);
+    void RecycleBuffer(Ring& ring, uint16_t bufferId);
+    void ReleaseIfDrained(ClientSession* session);
+};
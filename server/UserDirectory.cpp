@@ -0,0 +1,49 @@
+#include "UserDirectory.h"
+#include <functional>
+
+UserDirectory::Shard& UserDirectory::GetShard(const std::string& username) const
+{
+    return shards_[std::hash<std::string>()(username) % SHARD_COUNT];
+}
+
+bool UserDirectory::TryRegister(const std::string& username, uint32_t sessionId)
+{
+    Shard& shard = GetShard(username);
+    std::lock_guard<std::mutex> lock(shard.lock);
+
+    auto result = shard.users.emplace(username, sessionId);
+    return result.second || result.first->second == sessionId;
+}
+
+bool UserDirectory::Unregister(const std::string& username, uint32_t sessionId)
+{
+    Shard& shard = GetShard(username);
+    std::lock_guard<std::mutex> lock(shard.lock);
+
+    auto it = shard.users.find(username);
+    if (it == shard.users.end() || it->second != sessionId)
+        return false;
+
+    shard.users.erase(it);
+    return true;
+}
+
+uint32_t UserDirectory::Find(const std::string& username) const
+{
+    Shard& shard = GetShard(username);
+    std::lock_guard<std::mutex> lock(shard.lock);
+
+    auto it = shard.users.find(username);
+    return it == shard.users.end() ? 0 : it->second;
+}
+
+size_t UserDirectory::Size() const
+{
+    size_t count = 0;
+    for (const Shard& shard : shards_)
+    {
+        std::lock_guard<std::mutex> lock(shard.lock);
+        count += shard.users.size();
+    }
+    return count;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// 접속 중인 유저 이름 -> 세션 ID.
+// 로그인 성공 시 등록, 로그아웃/끊김 시 해제한다. 중복 로그인 확인과 귓속말 대상 찾기가 O(1)이다.
+// 이름 해시로 나눈 샤드마다 잠금이 따로 있어 서로 다른 이름끼리는 경쟁하지 않는다.
+class UserDirectory
+{
+public:
+    enum { SHARD_COUNT = 16 };
+
+    // 비어 있거나 이미 같은 세션이 갖고 있으면 true. 다른 세션이 쓰고 있으면 false.
+    bool TryRegister(const std::string& username, uint32_t sessionId);
+
+    // 그 이름을 sessionId 가 갖고 있을 때만 지운다 (중복 로그인으로 거절된 세션이 원래 주인을 지우지 않도록)
+    bool Unregister(const std::string& username, uint32_t sessionId);
+
+    // 없으면 0
+    uint32_t Find(const std::string& username) const;
+
+    size_t Size() const;
+
+private:
+    struct Shard
+    {
+        mutable std::mutex lock;
+        std::unordered_map<std::string, uint32_t> users;
+    };
+
+    Shard& GetShard(const std::string& username) const;
+
+    mutable Shard shards_[SHARD_COUNT];
+};
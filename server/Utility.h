@@ -1,20 +1,72 @@
 #pragma once
 
+#ifdef _WIN32
 #include <winsock2.h>
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
 #include <mutex>
 #include <queue>
 #include <atomic>
 #include <cstdint>
+#include <chrono>
+
+#ifdef _WIN32
+inline int GetLastSocketError() { return WSAGetLastError(); }
+
+// 모아 보내기(gather send)용 버퍼 조각. WSASend 에 그대로 넘긴다.
+using IoBuffer = WSABUF;
+inline IoBuffer MakeIoBuffer(const char* buf, uint32_t len) { IoBuffer b; b.buf = const_cast<char*>(buf); b.len = len; return b; }
+inline char* IoBufferData(const IoBuffer& b) { return b.buf; }
+inline uint32_t IoBufferSize(const IoBuffer& b) { return b.len; }
+inline void IoBufferAdvance(IoBuffer& b, uint32_t n) { b.buf += n; b.len -= n; }
+#else
+using SOCKET = int;
+constexpr SOCKET INVALID_SOCKET = -1;
+constexpr int SOCKET_ERROR = -1;
+
+inline int closesocket(SOCKET sock) { return ::close(sock); }
+inline int GetLastSocketError() { return errno; }
+
+// 모아 보내기(gather send)용 버퍼 조각. sendmsg / IORING_OP_SENDMSG 에 그대로 넘긴다.
+using IoBuffer = iovec;
+inline IoBuffer MakeIoBuffer(const char* buf, uint32_t len) { IoBuffer b; b.iov_base = const_cast<char*>(buf); b.iov_len = len; return b; }
+inline char* IoBufferData(const IoBuffer& b) { return static_cast<char*>(b.iov_base); }
+inline uint32_t IoBufferSize(const IoBuffer& b) { return static_cast<uint32_t>(b.iov_len); }
+inline void IoBufferAdvance(IoBuffer& b, uint32_t n) { b.iov_base = static_cast<char*>(b.iov_base) + n; b.iov_len -= n; }
+#endif
+
+// 세션 시간 제한 등에 쓰는 단조 시계 (ms)
+inline int64_t GetMonotonicMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 struct PER_IO_DATA {
+#ifdef _WIN32
     OVERLAPPED overlapped;
     WSABUF wsaBuf;
-    char buffer[1024];
-    int operation; // 0: recv, 1: send
+#else
+    // epoll: 준비 이벤트가 오면 엔진이 이 영역으로 직접 recv/send
+    char* buf = nullptr;        // recv
+    uint32_t len = 0;
+    uint32_t transferred = 0;
+    IoBuffer* bufs = nullptr;   // send (세션이 가진 IoBuffer 배열)
+    int bufCount = 0;
+    bool pending = false;
+#endif
+    int operation; // 0: recv, 1: send, 2: 버퍼 없이 건 recv (데이터 도착 알림)
 };
 
 struct Vector2
 {
     float x;
     float y;
-};
\ No newline at end of file
+};
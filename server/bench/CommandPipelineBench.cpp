@@ -0,0 +1,323 @@
+// I/O 스레드 -> GLT 커맨드 전달 벤치마크 + 힙 할당 확인
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target command_pipeline_bench
+//   ./build/command_pipeline_bench [producers] [packetsPerProducer]
+// 생산자 스레드가 채팅/이동 패킷을 PacketDispatcher 로 풀어 커맨드를 만들고, 소비 스레드가 GLT 처럼 틱마다 비운다.
+// - alloc: 전역 operator new 를 세어서, 링을 만든 뒤 (정상 상태) 에는 할당이 0 인지 확인한다.
+//          비교용으로 이전 방식 (unique_ptr<ICommand> + std::string, 잠금 큐) 의 패킷당 할당 수도 센다.
+// - flood: 쉬지 않고 밀어 넣을 때 커맨드당 시간과 넘침 큐로 간 수 (넘침 큐는 할당한다).
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../CommandQueue.h"
+#include "../PacketDispatcher.h"
+
+namespace
+{
+    std::atomic<uint64_t> g_allocations = 0;
+}
+
+void* operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // ---- 이전 방식 (가상 함수 + 문자열 멤버, 잠금 큐) ----
+    struct OldCommand
+    {
+        virtual ~OldCommand() = default;
+        virtual uint64_t Execute() const = 0;
+    };
+
+    struct OldChatCommand : OldCommand
+    {
+        OldChatCommand(uint32_t sessionId, std::string message) : sessionId_(sessionId), message_(std::move(message)) {}
+        uint64_t Execute() const override { return sessionId_ + message_.size(); }
+        uint32_t sessionId_;
+        std::string message_;
+    };
+
+    struct OldMoveCommand : OldCommand
+    {
+        OldMoveCommand(uint32_t sessionId, float vx, float vy) : sessionId_(sessionId), vx_(vx), vy_(vy) {}
+        uint64_t Execute() const override { return sessionId_ + static_cast<uint64_t>(vx_ + vy_ + 2); }
+        uint32_t sessionId_;
+        float vx_;
+        float vy_;
+    };
+
+    // 이전 GLT 입력 큐 (당시 LockFreeQueue: std::mutex + std::queue)
+    template <typename T>
+    class OldQueue
+    {
+    public:
+        void Push(T item)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push(std::move(item));
+        }
+
+        bool Pop(T& item)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty()) return false;
+            item = std::move(queue_.front());
+            queue_.pop();
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::queue<T> queue_;
+    };
+
+    // ---- 생산자: 수신 패킷 -> 커맨드 ----
+    struct NewProducer
+    {
+        CommandQueue* queue;
+        uint32_t sessionId;
+    };
+
+    struct OldProducer
+    {
+        OldQueue<std::unique_ptr<OldCommand>>* queue;
+        uint32_t sessionId;
+    };
+
+    void OnPacket(NewProducer& producer, const PacketChat& pkt) { producer.queue->Push(Command::Chat(producer.sessionId, pkt.msg)); }
+    void OnPacket(NewProducer& producer, const PacketMove& pkt) { producer.queue->Push(Command::Move(producer.sessionId, pkt.vx, pkt.vy)); }
+
+    void OnPacket(OldProducer& producer, const PacketChat& pkt)
+    {
+        producer.queue->Push(std::make_unique<OldChatCommand>(producer.sessionId, std::string(pkt.msg)));
+    }
+
+    void OnPacket(OldProducer& producer, const PacketMove& pkt)
+    {
+        producer.queue->Push(std::make_unique<OldMoveCommand>(producer.sessionId, pkt.vx, pkt.vy));
+    }
+
+    using NewDispatcher = PacketDispatcher<NewProducer, PacketChat, PacketMove>;
+    using OldDispatcher = PacketDispatcher<OldProducer, PacketChat, PacketMove>;
+
+    uint64_t ExecuteNew(const Command& command)
+    {
+        if (command.type == CommandType::CHAT) return command.sessionId + command.GetText(0).size();
+        return command.sessionId + static_cast<uint64_t>(command.move.vx + command.move.vy + 2);
+    }
+
+    // 패킷 스트림 (채팅 40% / 이동 60%, 채팅 길이는 SSO 를 넘는 것도 섞는다)
+    std::vector<char> MakeStream(size_t count, uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::vector<char> stream;
+        for (size_t i = 0; i < count; ++i)
+        {
+            char body[300];
+            PacketWriter writer(body, sizeof(body));
+            uint16_t id;
+            size_t bodySize;
+            if (rng() % 10 < 4)
+            {
+                std::string msg(4 + rng() % 80, static_cast<char>('a' + rng() % 26));
+                PacketChat pkt;
+                pkt.msg = msg;
+                pkt.Write(writer);
+                id = static_cast<uint16_t>(PacketChat::ID);
+                bodySize = pkt.GetSize();
+            }
+            else
+            {
+                PacketMove pkt;
+                pkt.vx = static_cast<float>(rng() % 3) - 1.0f;
+                pkt.vy = static_cast<float>(rng() % 3) - 1.0f;
+                pkt.Write(writer);
+                id = static_cast<uint16_t>(PacketMove::ID);
+                bodySize = pkt.GetSize();
+            }
+
+            GameHeader header{ static_cast<uint16_t>(sizeof(GameHeader) + bodySize), id };
+            const char* headerBytes = reinterpret_cast<const char*>(&header);
+            stream.insert(stream.end(), headerBytes, headerBytes + sizeof(header));
+            stream.insert(stream.end(), body, body + bodySize);
+        }
+        return stream;
+    }
+
+    // 스트림을 OnRecv 처럼 훑는다. burst 개마다 소비자가 따라올 틈을 준다 (0 이면 쉬지 않는다).
+    template <typename Dispatcher, typename Context>
+    void Produce(Context& context, const std::vector<char>& stream, size_t burst)
+    {
+        size_t offset = 0;
+        size_t sent = 0;
+        while (offset + sizeof(GameHeader) <= stream.size())
+        {
+            GameHeader header;
+            std::memcpy(&header, &stream[offset], sizeof(header));
+            Dispatcher::Dispatch(context, header.packetId, &stream[offset + sizeof(GameHeader)], header.packetSize - sizeof(GameHeader));
+            offset += header.packetSize;
+
+            if (burst != 0 && ++sent % burst == 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+
+    struct RunResult
+    {
+        double seconds = 0;
+        uint64_t executed = 0;
+        uint64_t checksum = 0;
+        uint64_t allocations = 0;
+        uint64_t overflowed = 0;
+    };
+
+    RunResult RunNew(const std::vector<std::vector<char>>& streams, size_t total, size_t burst)
+    {
+        CommandQueue queue;
+        RunResult result;
+
+        // 생산자의 세션이 들어갈 링을 먼저 만들어 둔다 (레인당 한 번의 할당, 정상 상태에서 빼고 센다)
+        std::atomic<size_t> ready = 0;
+        std::atomic<bool> go = false;
+        std::vector<std::thread> producers;
+        for (size_t i = 0; i < streams.size(); ++i)
+        {
+            producers.emplace_back([&, i] {
+                NewProducer context{ &queue, static_cast<uint32_t>(i + 1) };
+                queue.Push(Command::Move(context.sessionId, 0, 0));
+                ready++;
+                while (!go.load()) std::this_thread::yield();
+                Produce<NewDispatcher>(context, streams[i], burst);
+            });
+        }
+
+        while (ready.load() < streams.size()) std::this_thread::yield();
+        queue.Drain([](const Command&) {});
+
+        uint64_t allocationsBefore = g_allocations.load();
+        Clock::time_point start = Clock::now();
+        go = true;
+
+        // GLT 처럼 틱마다 비운다
+        while (result.executed < total)
+        {
+            size_t drained = queue.Drain([&result](const Command& command) { result.checksum += ExecuteNew(command); });
+            result.executed += drained;
+            if (burst != 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            else if (drained == 0) std::this_thread::yield();
+        }
+
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.allocations = g_allocations.load() - allocationsBefore;
+        result.overflowed = queue.GetStats().overflowed;
+
+        for (std::thread& t : producers) t.join();
+        return result;
+    }
+
+    RunResult RunOld(const std::vector<std::vector<char>>& streams, size_t total, size_t burst)
+    {
+        OldQueue<std::unique_ptr<OldCommand>> queue;
+        RunResult result;
+
+        std::atomic<size_t> ready = 0;
+        std::atomic<bool> go = false;
+        std::vector<std::thread> producers;
+        for (size_t i = 0; i < streams.size(); ++i)
+        {
+            producers.emplace_back([&, i] {
+                OldProducer context{ &queue, static_cast<uint32_t>(i + 1) };
+                ready++;
+                while (!go.load()) std::this_thread::yield();
+                Produce<OldDispatcher>(context, streams[i], burst);
+            });
+        }
+
+        while (ready.load() < streams.size()) std::this_thread::yield();
+
+        uint64_t allocationsBefore = g_allocations.load();
+        Clock::time_point start = Clock::now();
+        go = true;
+
+        std::unique_ptr<OldCommand> command;
+        while (result.executed < total)
+        {
+            size_t drained = 0;
+            while (queue.Pop(command))
+            {
+                result.checksum += command->Execute();
+                drained++;
+            }
+            command.reset();
+            result.executed += drained;
+            if (burst != 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+            else if (drained == 0) std::this_thread::yield();
+        }
+
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        result.allocations = g_allocations.load() - allocationsBefore;
+
+        for (std::thread& t : producers) t.join();
+        return result;
+    }
+
+    void Print(const char* name, const RunResult& result, bool showTime)
+    {
+        std::cout << name << ": ";
+        if (showTime) std::cout << result.seconds * 1e9 / result.executed << " ns/command, ";
+        std::cout << result.allocations << " allocations (" << static_cast<double>(result.allocations) / result.executed
+            << "/command), overflowed " << result.overflowed << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t producerCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 3;
+    size_t perProducer = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+
+    std::vector<std::vector<char>> streams;
+    for (size_t i = 0; i < producerCount; ++i)
+        streams.push_back(MakeStream(perProducer, static_cast<uint32_t>(i + 1)));
+    size_t total = producerCount * perProducer;
+
+    std::cout << "sizeof(Command) " << sizeof(Command) << " bytes, ring " << CommandQueue::RING_SIZE << " slots ("
+        << sizeof(Command) * CommandQueue::RING_SIZE / 1024 << " KB per lane)" << std::endl;
+    std::cout << producerCount << " producers x " << perProducer << " packets (chat 40% / move 60%)" << std::endl;
+
+    // 1) 정상 상태: 생산자가 조금씩 밀어 넣고 소비자가 틱마다 비운다 (링이 넘치지 않는다)
+    std::cout << "[paced]" << std::endl;
+    RunResult oldPaced = RunOld(streams, total, 256);
+    RunResult newPaced = RunNew(streams, total, 256);
+    Print("old (unique_ptr + string)", oldPaced, false);
+    Print("new (CommandQueue)       ", newPaced, false);
+
+    // 2) 쉬지 않고 밀어 넣기 (처리량. 링이 넘치면 넘침 큐가 할당한다)
+    std::cout << "[flood]" << std::endl;
+    RunResult oldFlood = RunOld(streams, total, 0);
+    RunResult newFlood = RunNew(streams, total, 0);
+    Print("old (unique_ptr + string)", oldFlood, true);
+    Print("new (CommandQueue)       ", newFlood, true);
+
+    bool ok = newPaced.allocations == 0 && newPaced.overflowed == 0
+        && oldPaced.checksum == newPaced.checksum && oldFlood.checksum == newFlood.checksum;
+    std::cout << (ok ? "OK: steady-state pipeline performed no heap allocations" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+// 관심 영역 벤치마크: 방 전체 델타 스냅샷 vs 시야 반경 안만 담은 델타 스냅샷
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target interest_bench
+//   ./build/interest_bench [ticks] [ackLagTicks]
+// 방 인원 500 / 1000 명을 정사각형 맵에 흩어 놓고 70% 가 걷게 한다 (속도 5, 16ms 틱, 맵 끝에서 튕긴다).
+// - 전체: 모든 클라이언트가 방 전체를 받는다 (관심 영역 이전 방식, 한 번 인코딩해서 모두에게 보낸다).
+// - 관심 영역: GameRoom 처럼 SpatialGrid 로 시야 반경 + 여유 안을 찾고, 클라이언트마다 자기 기록으로 델타를 만든다.
+// - ACK 는 모든 클라이언트가 ackLag 틱 뒤에 돌려준다고 본다. 델타는 기준 프레임에 풀어서 매 틱 서버 프레임과 비교한다.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../NetProtocol.h"
+#include "../SnapshotCodec.h"
+#include "../SpatialGrid.h"
+
+namespace
+{
+    constexpr float TICK_SECONDS = 0.016f;
+    constexpr float SPEED = 5.0f;
+    constexpr float VIEW_RADIUS = 30.0f;
+    constexpr float LEAVE_MARGIN = 3.0f;
+    constexpr size_t ENTRIES_CAPACITY = PacketSnapshot::MAX_SIZE - PacketSnapshot::MIN_SIZE;
+
+    struct Player
+    {
+        uint32_t id;
+        Vector2 position;
+        Vector2 velocity;
+    };
+
+    struct Result
+    {
+        uint64_t roomBytes = 0;       // 방 전체 델타 (클라이언트 한 명이 받는 크기의 합)
+        uint64_t interestBytes = 0;   // 관심 영역 델타 (클라이언트 전원 합)
+        uint64_t visible = 0;         // 클라이언트 스냅샷에 담긴 플레이어 수 합
+        uint64_t transitions = 0;     // 들어오고 나간 플레이어 수 합
+        uint64_t cellChanges = 0;
+        uint64_t gridNs = 0;          // 격자 갱신
+        uint64_t interestNs = 0;      // 클라이언트 전원의 조회 + 인코딩
+        bool verified = true;
+    };
+
+    const SnapshotFrame* FindBase(const SnapshotHistory& history, uint32_t tick, int ackLag)
+    {
+        if (tick <= static_cast<uint32_t>(ackLag)) return nullptr;
+        return history.Find(tick - ackLag);
+    }
+
+    // base 가 없거나 델타가 넘치면 전체 스냅샷 (GameRoom::BuildSnapshot 과 같은 순서)
+    size_t Encode(const SnapshotFrame* base, const SnapshotFrame& frame, std::vector<char>& entries, const SnapshotFrame*& usedBase)
+    {
+        static const std::vector<SnapshotEntity> emptyFrame;
+        size_t size = 0;
+        usedBase = base;
+        if (base == nullptr || !SnapshotCodec::Encode(base->entities, frame.entities, entries.data(), entries.size(), size))
+        {
+            usedBase = nullptr;
+            SnapshotCodec::Encode(emptyFrame, frame.entities, entries.data(), entries.size(), size);
+        }
+        return size;
+    }
+
+    bool Verify(const std::vector<char>& entries, size_t size, const SnapshotFrame* base, const SnapshotFrame& frame,
+        std::vector<SnapshotEntity>& decoded)
+    {
+        static const std::vector<SnapshotEntity> emptyFrame;
+        if (frame.truncated) return true;
+        if (!SnapshotCodec::Decode(std::string_view(entries.data(), size), base != nullptr ? base->entities : emptyFrame, decoded))
+            return false;
+        if (decoded.size() != frame.entities.size()) return false;
+        for (size_t i = 0; i < decoded.size(); ++i)
+        {
+            if (decoded[i].id != frame.entities[i].id || decoded[i].x != frame.entities[i].x || decoded[i].y != frame.entities[i].y)
+                return false;
+        }
+        return true;
+    }
+
+    // GameRoom::CollectVisible 과 같다
+    void CollectVisible(const SpatialGrid& grid, Vector2 center, const SnapshotFrame* previous, SnapshotFrame& frame)
+    {
+        const float enterRadiusSq = VIEW_RADIUS * VIEW_RADIUS;
+        grid.Query(center, VIEW_RADIUS + LEAVE_MARGIN, [&](const SpatialGrid::Item& item) {
+            float dx = item.position.x - center.x;
+            float dy = item.position.y - center.y;
+            if (dx * dx + dy * dy > enterRadiusSq)
+            {
+                if (previous == nullptr) return;
+                auto it = std::lower_bound(previous->entities.begin(), previous->entities.end(), item.id,
+                    [](const SnapshotEntity& entity, uint32_t id) { return entity.id < id; });
+                if (it == previous->entities.end() || it->id != item.id) return;
+            }
+            frame.entities.push_back(SnapshotEntity{ item.id,
+                SnapshotCodec::Quantize(item.position.x), SnapshotCodec::Quantize(item.position.y) });
+        });
+        std::sort(frame.entities.begin(), frame.entities.end(),
+            [](const SnapshotEntity& a, const SnapshotEntity& b) { return a.id < b.id; });
+    }
+
+    // 두 프레임 (id 오름차순) 사이에 들어오거나 나간 플레이어 수
+    uint64_t CountTransitions(const SnapshotFrame& before, const SnapshotFrame& after)
+    {
+        uint64_t count = 0;
+        size_t i = 0, j = 0;
+        while (i < before.entities.size() || j < after.entities.size())
+        {
+            if (j == after.entities.size() || (i < before.entities.size() && before.entities[i].id < after.entities[j].id)) { ++count; ++i; }
+            else if (i == before.entities.size() || after.entities[j].id < before.entities[i].id) { ++count; ++j; }
+            else { ++i; ++j; }
+        }
+        return count;
+    }
+
+    Result Run(size_t playerCount, float mapSize, int ticks, int ackLag)
+    {
+        Result result;
+        std::mt19937 rng(static_cast<uint32_t>(playerCount * 31 + mapSize));
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+        std::vector<Player> players(playerCount);
+        SpatialGrid grid(VIEW_RADIUS + LEAVE_MARGIN);
+        for (size_t i = 0; i < playerCount; ++i)
+        {
+            Player& p = players[i];
+            p.id = static_cast<uint32_t>(i + 1);
+            p.position = Vector2{ unit(rng) * mapSize, unit(rng) * mapSize };
+            p.velocity = Vector2{ 0.0f, 0.0f };
+            grid.Insert(p.id, p.position);
+        }
+
+        SnapshotHistory roomHistory;
+        std::vector<SnapshotHistory> histories(playerCount);
+        std::vector<char> entries(ENTRIES_CAPACITY);
+        std::vector<SnapshotEntity> decoded;
+
+        // 이번 틱에 클라이언트마다 보낸 entries 와 그 기준 프레임
+        struct Sent
+        {
+            std::vector<char> entries;
+            const SnapshotFrame* base = nullptr;
+        };
+        std::vector<Sent> sent(playerCount);
+
+        for (uint32_t tick = 1; tick <= static_cast<uint32_t>(ticks); ++tick)
+        {
+            for (Player& p : players)
+            {
+                if (unit(rng) < 0.02f)
+                {
+                    p.velocity = Vector2{ 0.0f, 0.0f };
+                    if (unit(rng) < 0.7f)
+                    {
+                        float angle = unit(rng) * 6.2831853f;
+                        p.velocity = Vector2{ SPEED * std::cos(angle), SPEED * std::sin(angle) };
+                    }
+                }
+                p.position.x += p.velocity.x * TICK_SECONDS;
+                p.position.y += p.velocity.y * TICK_SECONDS;
+                if (p.position.x < 0.0f || p.position.x > mapSize) p.velocity.x = -p.velocity.x;
+                if (p.position.y < 0.0f || p.position.y > mapSize) p.velocity.y = -p.velocity.y;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            for (const Player& p : players)
+                grid.Move(p.id, p.position);
+            auto moved = std::chrono::steady_clock::now();
+            result.gridNs += std::chrono::duration_cast<std::chrono::nanoseconds>(moved - start).count();
+
+            // 전체: 한 번 만들어서 모두에게 보낸다
+            SnapshotFrame& roomFrame = roomHistory.BeginFrame(tick);
+            for (const Player& p : players)
+                roomFrame.entities.push_back(SnapshotEntity{ p.id, SnapshotCodec::Quantize(p.position.x), SnapshotCodec::Quantize(p.position.y) });
+            const SnapshotFrame* roomBase = nullptr;
+            size_t roomSize = Encode(FindBase(roomHistory, tick, ackLag), roomFrame, entries, roomBase);
+            result.roomBytes += (sizeof(GameHeader) + PacketSnapshot::MIN_SIZE + roomSize) * playerCount;
+            if (!Verify(entries, roomSize, roomBase, roomFrame, decoded))
+                result.verified = false;
+
+            // 관심 영역: 클라이언트마다 (시간은 루프 전체로 잰다. 확인은 재지 않도록 따로 한다)
+            auto clientStart = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < playerCount; ++i)
+            {
+                SnapshotHistory& history = histories[i];
+                const SnapshotFrame* previous = tick > 1 ? history.Find(tick - 1) : nullptr;
+                SnapshotFrame& frame = history.BeginFrame(tick);
+                CollectVisible(grid, players[i].position, previous, frame);
+                size_t size = Encode(FindBase(history, tick, ackLag), frame, entries, sent[i].base);
+                sent[i].entries.assign(entries.data(), entries.data() + size);
+            }
+            result.interestNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - clientStart).count();
+
+            for (size_t i = 0; i < playerCount; ++i)
+            {
+                const SnapshotFrame& frame = *histories[i].Find(tick);
+                const SnapshotFrame* previous = tick > 1 ? histories[i].Find(tick - 1) : nullptr;
+                result.interestBytes += sizeof(GameHeader) + PacketSnapshot::MIN_SIZE + sent[i].entries.size();
+                result.visible += frame.entities.size();
+                if (previous != nullptr)
+                    result.transitions += CountTransitions(*previous, frame);
+                if (!Verify(sent[i].entries, sent[i].entries.size(), sent[i].base, frame, decoded))
+                    result.verified = false;
+            }
+        }
+
+        result.cellChanges = grid.GetStats().cellChanges;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 500;
+    int ackLag = argc > 2 ? std::atoi(argv[2]) : 6;
+
+    std::cout << ticks << " ticks (16ms), view radius " << VIEW_RADIUS << " + leave margin " << LEAVE_MARGIN
+        << ", ACK arrives " << ackLag << " ticks after the snapshot, 70% walking" << std::endl;
+    std::cout << "bytes per client per tick (header included). room egress = per client x players x 62.5 ticks/s" << std::endl;
+    std::cout << std::left << std::setw(9) << "players" << std::setw(7) << "map"
+        << std::right << std::setw(9) << "visible" << std::setw(12) << "room delta" << std::setw(10) << "interest"
+        << std::setw(9) << "ratio" << std::setw(15) << "room MB/s" << std::setw(15) << "interest MB/s"
+        << std::setw(12) << "enter+leave" << std::setw(13) << "cell moves" << std::setw(10) << "grid us" << std::setw(14) << "interest us"
+        << "  check" << std::endl;
+
+    bool ok = true;
+    for (size_t players : { 500, 1000 })
+    {
+        // 촘촘한 방 (거의 전원이 보인다) 부터 넓은 맵까지
+        for (float mapSize : { 60.0f, 250.0f, 500.0f, 1000.0f })
+        {
+            Result r = Run(players, mapSize, ticks, ackLag);
+            double clientTicks = static_cast<double>(players) * ticks;
+            double roomPerTick = r.roomBytes / clientTicks;
+            double interestPerTick = r.interestBytes / clientTicks;
+            double roomScale = players * (1.0 / 0.016) / (1024 * 1024);
+
+            std::cout << std::left << std::setw(9) << players << std::setw(7) << static_cast<int>(mapSize)
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(9) << r.visible / clientTicks
+                << std::setw(12) << roomPerTick << std::setw(10) << interestPerTick
+                << std::setw(8) << roomPerTick / interestPerTick << "x"
+                << std::setprecision(2) << std::setw(15) << roomPerTick * roomScale << std::setw(15) << interestPerTick * roomScale
+                << std::setw(12) << r.transitions / clientTicks * 62.5   // 클라이언트 한 명이 초당 받는 입장 + 퇴장
+                << std::setw(13) << static_cast<double>(r.cellChanges) / ticks
+                << std::setw(10) << r.gridNs / 1000.0 / ticks << std::setw(14) << r.interestNs / 1000.0 / ticks
+                << "  " << (r.verified ? "ok" : "MISMATCH") << std::endl;
+            ok = ok && r.verified;
+        }
+    }
+
+    std::cout << (ok ? "OK: every client's decoded snapshot matched its server frame" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,358 @@
+// 이동 + 스냅샷 벤치마크: 플레이어마다 객체 (이전 방식) vs PlayerTable 의 SoA 열 + MovementKernel
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target movement_bench
+//   ./build/movement_bench [players] [ticks] [viewersPerTick]
+// 한 방에 플레이어 (기본 10000 명) 를 시야 반경 안에 40 명 정도가 보이게 흩어 놓고 70% 가 걷게 한다 (속도 5, 16ms 틱).
+// - 커널: 위치 / 속도 배열 적분만. 스칼라 / SSE2 / AVX2 를 각각 돌리고 결과가 비트 단위로 같은지 본다.
+// - 이전: map<id, shared_ptr<플레이어>> 를 돌며 ApplyMovement + 격자 Move, 스냅샷은 격자 Item 의 위치로 모은다.
+// - SoA: GameRoom 처럼 PlayerTable::Integrate 후 칸이 바뀐 플레이어만 격자를 고치고, 스냅샷은 열에서 바로 읽는다.
+// 스냅샷은 틱마다 viewersPerTick 명 (돌아가며) 의 관심 영역을 모아 지난 프레임 대비 델타로 인코딩한다.
+// 두 방식의 최종 위치와 인코딩한 바이트가 같은지도 확인한다.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+#include "../MovementKernel.h"
+#include "../NetProtocol.h"
+#include "../PlayerTable.h"
+#include "../SnapshotCodec.h"
+#include "../SpatialGrid.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr float TICK_SECONDS = 0.016f;
+    constexpr float SPEED = 5.0f;
+    constexpr float VIEW_RADIUS = 30.0f;
+    constexpr float LEAVE_MARGIN = 3.0f;
+    constexpr float VISIBLE_TARGET = 40.0f;   // 시야 반경 안 평균 인원
+    constexpr size_t ENTRIES_CAPACITY = PacketSnapshot::MAX_SIZE - PacketSnapshot::MIN_SIZE;
+
+    // 이전 PlayerState 와 같은 모양 (힙에 하나씩)
+    struct OldPlayer
+    {
+        uint32_t sessionId;
+        Vector2 position;
+        Vector2 velocity;
+
+        void ApplyMovement(float fixedDeltaTime)
+        {
+            position.x += velocity.x * fixedDeltaTime;
+            position.y += velocity.y * fixedDeltaTime;
+        }
+    };
+
+    struct Result
+    {
+        uint64_t updateNs = 0;
+        uint64_t snapshotNs = 0;
+        uint64_t bytes = 0;
+        uint64_t hash = 1469598103934665603ull;   // 인코딩한 바이트 전체의 FNV-1a
+        uint64_t visible = 0;
+    };
+
+    double ElapsedNs(Clock::time_point start, Clock::time_point end)
+    {
+        return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    void HashBytes(Result& result, const char* data, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            result.hash ^= static_cast<unsigned char>(data[i]);
+            result.hash *= 1099511628211ull;
+        }
+        result.bytes += size;
+    }
+
+    // 관심 영역 안을 모아 id 순으로 정렬한다. 시야 반경과 나가는 반경 사이는 지난 프레임에 보이던 플레이어만 남긴다.
+    template <typename Gather>
+    void CollectFrame(Gather&& gather, const std::vector<SnapshotEntity>& previous, std::vector<SnapshotEntity>& frame)
+    {
+        const float enterRadiusSq = VIEW_RADIUS * VIEW_RADIUS;
+        const float leaveRadiusSq = (VIEW_RADIUS + LEAVE_MARGIN) * (VIEW_RADIUS + LEAVE_MARGIN);
+        frame.clear();
+        gather([&](uint32_t id, float x, float y, float distanceSq) {
+            if (!(distanceSq <= leaveRadiusSq)) return;
+            if (distanceSq > enterRadiusSq)
+            {
+                auto it = std::lower_bound(previous.begin(), previous.end(), id,
+                    [](const SnapshotEntity& entity, uint32_t value) { return entity.id < value; });
+                if (it == previous.end() || it->id != id) return;
+            }
+            frame.push_back(SnapshotEntity{ id, SnapshotCodec::Quantize(x), SnapshotCodec::Quantize(y) });
+        });
+        std::sort(frame.begin(), frame.end(), [](const SnapshotEntity& a, const SnapshotEntity& b) { return a.id < b.id; });
+    }
+
+    // 두 방식이 같은 순서로 같은 입력 (속도 변경) 을 받도록 틱마다 미리 만든다
+    struct Input
+    {
+        uint32_t id;
+        Vector2 velocity;
+    };
+
+    std::vector<Input> MakeInputs(std::mt19937& rng, size_t playerCount, float changeRatio)
+    {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Input> inputs;
+        for (size_t i = 0; i < playerCount; ++i)
+        {
+            if (unit(rng) >= changeRatio) continue;
+            Vector2 velocity = { 0.0f, 0.0f };
+            if (unit(rng) < 0.7f)
+            {
+                float angle = unit(rng) * 6.2831853f;
+                velocity = Vector2{ SPEED * std::cos(angle), SPEED * std::sin(angle) };
+            }
+            inputs.push_back(Input{ static_cast<uint32_t>(i + 1), velocity });
+        }
+        return inputs;
+    }
+
+    std::vector<Vector2> MakeSpawns(size_t playerCount, float mapSize)
+    {
+        std::mt19937 rng(static_cast<uint32_t>(playerCount * 31 + 7));
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Vector2> spawns(playerCount);
+        for (Vector2& spawn : spawns)
+            spawn = Vector2{ unit(rng) * mapSize, unit(rng) * mapSize };
+        return spawns;
+    }
+
+    // 이전 방식: GameRoom 이 map<uint32_t, shared_ptr<PlayerState>> 를 들고 있던 때
+    Result RunObjects(const std::vector<Vector2>& spawns, int ticks, size_t viewersPerTick, std::vector<Vector2>& finalPositions)
+    {
+        Result result;
+        const size_t playerCount = spawns.size();
+        std::map<uint32_t, std::shared_ptr<OldPlayer>> players;
+        SpatialGrid grid(VIEW_RADIUS + LEAVE_MARGIN);
+        for (size_t i = 0; i < playerCount; ++i)
+        {
+            auto player = std::make_shared<OldPlayer>(OldPlayer{ static_cast<uint32_t>(i + 1), spawns[i], Vector2{ 0.0f, 0.0f } });
+            players[player->sessionId] = player;
+            grid.Insert(player->sessionId, player->position);
+        }
+
+        std::mt19937 rng(12345);
+        std::vector<std::vector<SnapshotEntity>> lastFrames(playerCount);
+        std::vector<SnapshotEntity> frame;
+        std::vector<char> entries(ENTRIES_CAPACITY);
+        size_t nextViewer = 0;
+
+        for (int tick = 0; tick < ticks; ++tick)
+        {
+            std::vector<Input> inputs = MakeInputs(rng, playerCount, tick == 0 ? 1.0f : 0.02f);
+            for (const Input& input : inputs)
+                players[input.id]->velocity = input.velocity;
+
+            auto start = Clock::now();
+            for (auto& pair : players)
+            {
+                auto& player = pair.second;
+                player->ApplyMovement(TICK_SECONDS);
+                grid.Move(player->sessionId, player->position);
+            }
+            auto updated = Clock::now();
+            result.updateNs += static_cast<uint64_t>(ElapsedNs(start, updated));
+
+            for (size_t n = 0; n < viewersPerTick; ++n)
+            {
+                size_t viewer = nextViewer++ % playerCount;
+                Vector2 center = players.find(static_cast<uint32_t>(viewer + 1))->second->position;
+                CollectFrame([&](auto&& visit) {
+                    grid.Query(center, VIEW_RADIUS + LEAVE_MARGIN, [&](const SpatialGrid::Item& item) {
+                        float dx = item.position.x - center.x;
+                        float dy = item.position.y - center.y;
+                        visit(item.id, item.position.x, item.position.y, dx * dx + dy * dy);
+                    });
+                }, lastFrames[viewer], frame);
+
+                size_t size = 0;
+                SnapshotCodec::Encode(lastFrames[viewer], frame, entries.data(), entries.size(), size);
+                HashBytes(result, entries.data(), size);
+                result.visible += frame.size();
+                lastFrames[viewer].swap(frame);
+            }
+            result.snapshotNs += static_cast<uint64_t>(ElapsedNs(updated, Clock::now()));
+        }
+
+        finalPositions.clear();
+        for (auto& pair : players)
+            finalPositions.push_back(pair.second->position);
+        return result;
+    }
+
+    // SoA: 지금 GameRoom 과 같다 (격자는 자리 번호로 든다)
+    Result RunTable(const std::vector<Vector2>& spawns, int ticks, size_t viewersPerTick, std::vector<Vector2>& finalPositions)
+    {
+        Result result;
+        const size_t playerCount = spawns.size();
+        PlayerTable players;
+        SpatialGrid grid(VIEW_RADIUS + LEAVE_MARGIN);
+        for (size_t i = 0; i < playerCount; ++i)
+        {
+            uint32_t index = players.Add(static_cast<uint32_t>(i + 1), spawns[i], grid.CellKey(spawns[i]));
+            grid.Insert(index, spawns[i]);
+        }
+
+        std::mt19937 rng(12345);
+        std::vector<std::vector<SnapshotEntity>> lastFrames(playerCount);
+        std::vector<SnapshotEntity> frame;
+        std::vector<char> entries(ENTRIES_CAPACITY);
+        size_t nextViewer = 0;
+
+        for (int tick = 0; tick < ticks; ++tick)
+        {
+            std::vector<Input> inputs = MakeInputs(rng, playerCount, tick == 0 ? 1.0f : 0.02f);
+            for (const Input& input : inputs)
+                players.SetVelocity(players.Find(input.id), input.velocity.x, input.velocity.y);
+
+            auto start = Clock::now();
+            players.Integrate(TICK_SECONDS);
+            uint64_t* cells = players.Cells();
+            for (uint32_t index = 0; index < players.Size(); ++index)
+            {
+                Vector2 position = players.GetPosition(index);
+                uint64_t cell = grid.CellKey(position);
+                if (cell == cells[index]) continue;
+
+                cells[index] = cell;
+                grid.Move(index, position);
+            }
+            auto updated = Clock::now();
+            result.updateNs += static_cast<uint64_t>(ElapsedNs(start, updated));
+
+            const uint32_t* ids = players.Ids();
+            const float* positionX = players.PositionX();
+            const float* positionY = players.PositionY();
+            for (size_t n = 0; n < viewersPerTick; ++n)
+            {
+                size_t viewer = nextViewer++ % playerCount;
+                Vector2 center = players.GetPosition(players.Find(static_cast<uint32_t>(viewer + 1)));
+                CollectFrame([&](auto&& visit) {
+                    grid.QueryCells(center, VIEW_RADIUS + LEAVE_MARGIN, [&](uint32_t index) {
+                        float dx = positionX[index] - center.x;
+                        float dy = positionY[index] - center.y;
+                        visit(ids[index], positionX[index], positionY[index], dx * dx + dy * dy);
+                    });
+                }, lastFrames[viewer], frame);
+
+                size_t size = 0;
+                SnapshotCodec::Encode(lastFrames[viewer], frame, entries.data(), entries.size(), size);
+                HashBytes(result, entries.data(), size);
+                result.visible += frame.size();
+                lastFrames[viewer].swap(frame);
+            }
+            result.snapshotNs += static_cast<uint64_t>(ElapsedNs(updated, Clock::now()));
+        }
+
+        finalPositions.clear();
+        for (size_t i = 0; i < playerCount; ++i)
+            finalPositions.push_back(players.GetPosition(players.Find(static_cast<uint32_t>(i + 1))));
+        return result;
+    }
+
+    // 커널만: 같은 배열을 수준별로 ticks 번 적분해서 틱당 시간과 결과를 본다
+    bool RunKernels(size_t playerCount, int ticks)
+    {
+        std::mt19937 rng(99);
+        std::uniform_real_distribution<float> unit(-SPEED, SPEED);
+        std::vector<float> startX(playerCount), startY(playerCount), velocityX(playerCount), velocityY(playerCount);
+        for (size_t i = 0; i < playerCount; ++i)
+        {
+            startX[i] = unit(rng) * 100.0f;
+            startY[i] = unit(rng) * 100.0f;
+            velocityX[i] = unit(rng);
+            velocityY[i] = unit(rng);
+        }
+
+        const MovementKernel::Level supported = MovementKernel::GetSupportedLevel();
+        std::vector<float> referenceX, referenceY;
+        bool identical = true;
+        for (MovementKernel::Level level : { MovementKernel::Level::SCALAR, MovementKernel::Level::SSE2, MovementKernel::Level::AVX2 })
+        {
+            if (level > supported)
+            {
+                std::cout << "  kernel " << std::setw(6) << MovementKernel::GetLevelName(level) << ": not supported\n";
+                continue;
+            }
+
+            std::vector<float> positionX = startX, positionY = startY;
+            auto start = Clock::now();
+            for (int tick = 0; tick < ticks; ++tick)
+                MovementKernel::Integrate(level, positionX.data(), positionY.data(), velocityX.data(), velocityY.data(), playerCount, TICK_SECONDS);
+            double nsPerTick = ElapsedNs(start, Clock::now()) / ticks;
+
+            if (referenceX.empty())
+            {
+                referenceX = positionX;
+                referenceY = positionY;
+            }
+            else if (positionX != referenceX || positionY != referenceY)
+            {
+                identical = false;
+            }
+
+            std::cout << "  kernel " << std::setw(6) << MovementKernel::GetLevelName(level)
+                << ": " << std::setw(9) << nsPerTick << " ns/tick  "
+                << std::setw(6) << nsPerTick / playerCount << " ns/player\n";
+        }
+        return identical;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t playerCount = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : 10000;
+    int ticks = argc > 2 ? std::atoi(argv[2]) : 300;
+    size_t viewersPerTick = argc > 3 ? static_cast<size_t>(std::atoi(argv[3])) : 2500;
+    if (playerCount == 0 || ticks <= 0) return 1;
+
+    const float density = VISIBLE_TARGET / (3.14159265f * VIEW_RADIUS * VIEW_RADIUS);
+    const float mapSize = std::sqrt(static_cast<float>(playerCount) / density);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "players " << playerCount << ", map " << mapSize << " x " << mapSize << ", ticks " << ticks
+        << ", snapshots/tick " << viewersPerTick << ", kernel " << MovementKernel::GetLevelName(MovementKernel::GetSupportedLevel()) << "\n";
+
+    bool kernelsIdentical = RunKernels(playerCount, ticks * 10);
+
+    std::vector<Vector2> spawns = MakeSpawns(playerCount, mapSize);
+    std::vector<Vector2> objectPositions, tablePositions;
+    Result objects = RunObjects(spawns, ticks, viewersPerTick, objectPositions);
+    Result table = RunTable(spawns, ticks, viewersPerTick, tablePositions);
+
+    auto print = [&](const char* name, const Result& result) {
+        double update = static_cast<double>(result.updateNs) / ticks;
+        double snapshot = static_cast<double>(result.snapshotNs) / ticks;
+        std::cout << "  " << std::setw(7) << name
+            << ": update " << std::setw(9) << update / 1000.0 << " us/tick"
+            << "  snapshots " << std::setw(9) << snapshot / 1000.0 << " us/tick"
+            << "  total " << std::setw(9) << (update + snapshot) / 1000.0 << " us/tick"
+            << "  visible/snapshot " << (viewersPerTick != 0 ? static_cast<double>(result.visible) / (static_cast<double>(ticks) * viewersPerTick) : 0.0)
+            << "  bytes " << result.bytes << "\n";
+    };
+    print("objects", objects);
+    print("soa", table);
+
+    bool positionsIdentical = objectPositions.size() == tablePositions.size();
+    for (size_t i = 0; positionsIdentical && i < objectPositions.size(); ++i)
+    {
+        positionsIdentical = std::memcmp(&objectPositions[i], &tablePositions[i], sizeof(Vector2)) == 0;
+    }
+    bool snapshotsIdentical = objects.bytes == table.bytes && objects.hash == table.hash;
+
+    std::cout << "kernels identical: " << (kernelsIdentical ? "yes" : "NO")
+        << ", positions identical: " << (positionsIdentical ? "yes" : "NO")
+        << ", snapshots identical: " << (snapshotsIdentical ? "yes" : "NO") << "\n";
+    return kernelsIdentical && positionsIdentical && snapshotsIdentical ? 0 : 1;
+}
@@ -0,0 +1,233 @@
+// 수신 패킷 파싱 + 분배 벤치마크: 패킷 ID switch vs PacketDispatcher 표
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target packet_dispatch_bench
+//   ./build/packet_dispatch_bench [packets] [rounds]
+// 실제 부하와 비슷한 비율(이동 > 채팅 > 하트비트 > 나머지)로 섞인 패킷 스트림을 OnRecv 처럼
+// 헤더 -> 본문 순서로 훑는다. 핸들러는 값만 모으므로 파싱과 분배 비용만 잰다.
+// 깨진 패킷(짧은 본문 / 모르는 ID / 최대 길이를 넘는 문자열)을 섞은 스트림으로 두 방식의 거절 수도 맞춰 본다.
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../PacketDispatcher.h"
+
+namespace
+{
+    struct Sink
+    {
+        uint64_t packets = 0;
+        uint64_t checksum = 0;
+    };
+
+    void Add(Sink& sink, uint64_t value)
+    {
+        sink.packets++;
+        sink.checksum = sink.checksum * 31 + value;
+    }
+
+    void OnPacket(Sink& sink, const PacketLoginReq& pkt) { Add(sink, pkt.username.size() + pkt.password.size()); }
+    void OnPacket(Sink& sink, const PacketRegisterReq& pkt) { Add(sink, pkt.username.size() + pkt.password.size()); }
+    void OnPacket(Sink& sink, const PacketEnterRoom& pkt) { Add(sink, static_cast<uint64_t>(pkt.roomId)); }
+    void OnPacket(Sink& sink, const PacketChat& pkt) { Add(sink, pkt.msg.size() + static_cast<uint8_t>(pkt.msg[0])); }
+    void OnPacket(Sink& sink, const PacketMove& pkt) { Add(sink, static_cast<uint64_t>(pkt.vx * 100 + pkt.vy)); }
+    void OnPacket(Sink& sink, const PacketWhisperReq& pkt) { Add(sink, pkt.target.size() * 7 + pkt.msg.size()); }
+    void OnPacket(Sink& sink, const PacketCreateRoomReq& pkt) { Add(sink, pkt.title.size()); }
+    void OnPacket(Sink& sink, const PacketRoomListReq&) { Add(sink, 10); }
+    void OnPacket(Sink& sink, const PacketLogoutReq&) { Add(sink, 14); }
+    void OnPacket(Sink& sink, const PacketHeartbeatReq& pkt) { Add(sink, pkt.clientTime); }
+
+    using Dispatcher = PacketDispatcher<Sink,
+        PacketRegisterReq, PacketLoginReq, PacketEnterRoom, PacketChat, PacketMove,
+        PacketWhisperReq, PacketCreateRoomReq, PacketRoomListReq, PacketLogoutReq, PacketHeartbeatReq>;
+
+    // 이전 ClientSession::DeserializeCommand 와 같은 모양 (case 마다 디코딩)
+    template <typename T>
+    bool DecodeAndHandle(Sink& sink, PacketReader& reader)
+    {
+        T pkt;
+        if (!pkt.Read(reader)) return false;
+        OnPacket(sink, pkt);
+        return true;
+    }
+
+    bool DispatchSwitch(Sink& sink, uint16_t packetId, const char* body, size_t bodySize)
+    {
+        PacketReader reader(body, bodySize);
+        switch (static_cast<PacketId>(packetId))
+        {
+        case PacketId::LOGIN_REQ: return DecodeAndHandle<PacketLoginReq>(sink, reader);
+        case PacketId::REGISTER_REQ: return DecodeAndHandle<PacketRegisterReq>(sink, reader);
+        case PacketId::ENTER_ROOM: return DecodeAndHandle<PacketEnterRoom>(sink, reader);
+        case PacketId::CHAT: return DecodeAndHandle<PacketChat>(sink, reader);
+        case PacketId::MOVE: return DecodeAndHandle<PacketMove>(sink, reader);
+        case PacketId::WHISPER_REQ: return DecodeAndHandle<PacketWhisperReq>(sink, reader);
+        case PacketId::CREATE_ROOM_REQ: return DecodeAndHandle<PacketCreateRoomReq>(sink, reader);
+        case PacketId::ROOM_LIST_REQ: return DecodeAndHandle<PacketRoomListReq>(sink, reader);
+        case PacketId::LOGOUT_REQ: return DecodeAndHandle<PacketLogoutReq>(sink, reader);
+        case PacketId::HEARTBEAT_REQ: return DecodeAndHandle<PacketHeartbeatReq>(sink, reader);
+        default: return false;
+        }
+    }
+
+    template <typename T>
+    void Append(std::vector<char>& stream, const T& packet)
+    {
+        size_t bodySize = packet.GetSize();
+        size_t offset = stream.size();
+        stream.resize(offset + sizeof(GameHeader) + bodySize);
+
+        GameHeader header{ static_cast<uint16_t>(sizeof(GameHeader) + bodySize), static_cast<uint16_t>(T::ID) };
+        std::memcpy(&stream[offset], &header, sizeof(header));
+        PacketWriter writer(&stream[offset + sizeof(GameHeader)], bodySize);
+        packet.Write(writer);
+    }
+
+    void AppendRaw(std::vector<char>& stream, uint16_t packetId, const std::string& body)
+    {
+        GameHeader header{ static_cast<uint16_t>(sizeof(GameHeader) + body.size()), packetId };
+        const char* headerBytes = reinterpret_cast<const char*>(&header);
+        stream.insert(stream.end(), headerBytes, headerBytes + sizeof(header));
+        stream.insert(stream.end(), body.begin(), body.end());
+    }
+
+    std::vector<char> MakeStream(size_t count, bool withBroken)
+    {
+        std::mt19937 rng(3);
+        std::vector<std::string> lines;
+        for (int i = 0; i < 16; ++i)
+            lines.push_back(std::string(4 + rng() % 60, static_cast<char>('a' + i)));
+
+        std::vector<char> stream;
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t roll = rng() % 100;
+            if (withBroken && roll < 5)
+            {
+                switch (rng() % 3)
+                {
+                case 0: AppendRaw(stream, static_cast<uint16_t>(PacketId::MOVE), "abc"); break;          // 짧은 본문
+                case 1: AppendRaw(stream, static_cast<uint16_t>(100 + rng() % 1000), "x"); break;        // 모르는 ID
+                default: AppendRaw(stream, static_cast<uint16_t>(PacketId::CHAT), std::string("\0\0\0\0\xff\x00", 6) + "zz"); break;   // 255 를 넘는 문자열 길이
+                }
+                continue;
+            }
+
+            if (roll < 60)
+            {
+                PacketMove pkt;
+                pkt.vx = static_cast<float>(rng() % 3) - 1.0f;
+                pkt.vy = static_cast<float>(rng() % 3) - 1.0f;
+                Append(stream, pkt);
+            }
+            else if (roll < 85)
+            {
+                PacketChat pkt;
+                pkt.msg = lines[rng() % lines.size()];
+                Append(stream, pkt);
+            }
+            else if (roll < 95)
+            {
+                PacketHeartbeatReq pkt;
+                pkt.clientTime = rng();
+                Append(stream, pkt);
+            }
+            else if (roll < 98)
+            {
+                PacketWhisperReq pkt;
+                pkt.target = "user12";
+                pkt.msg = lines[rng() % lines.size()];
+                Append(stream, pkt);
+            }
+            else
+            {
+                PacketEnterRoom pkt;
+                pkt.roomId = static_cast<int32_t>(rng() % 100);
+                Append(stream, pkt);
+            }
+        }
+        return stream;
+    }
+
+    struct Result
+    {
+        double seconds = 0;
+        uint64_t handled = 0;
+        uint64_t rejected = 0;
+        uint64_t checksum = 0;
+    };
+
+    // OnRecv 처럼 헤더를 읽고 본문을 넘긴다. 거절된 패킷은 연결을 끊는 대신 세고 넘어간다.
+    template <typename DispatchFunc>
+    Result Run(const std::vector<char>& stream, int rounds, DispatchFunc dispatch)
+    {
+        Result result;
+        Sink sink;
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            size_t offset = 0;
+            while (offset + sizeof(GameHeader) <= stream.size())
+            {
+                GameHeader header;
+                std::memcpy(&header, &stream[offset], sizeof(header));
+                if (!dispatch(sink, header.packetId, &stream[offset + sizeof(GameHeader)], header.packetSize - sizeof(GameHeader)))
+                    result.rejected++;
+                offset += header.packetSize;
+            }
+        }
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.handled = sink.packets;
+        result.checksum = sink.checksum;
+        return result;
+    }
+
+    void Print(const char* name, const Result& result, size_t streamBytes, int rounds)
+    {
+        uint64_t total = result.handled + result.rejected;
+        std::cout << name << ": " << result.seconds * 1e9 / total << " ns/packet, "
+            << total / result.seconds / 1e6 << " M packets/s, "
+            << streamBytes * rounds / result.seconds / (1024 * 1024) << " MB/s"
+            << " (handled " << result.handled << ", rejected " << result.rejected << ")" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t packetCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    auto bySwitch = [](Sink& sink, uint16_t id, const char* body, size_t size) {
+        return DispatchSwitch(sink, id, body, size);
+    };
+    auto byTable = [](Sink& sink, uint16_t id, const char* body, size_t size) {
+        return Dispatcher::Dispatch(sink, id, body, size) == DispatchResult::OK;
+    };
+
+    bool mismatch = false;
+    for (bool withBroken : { false, true })
+    {
+        std::vector<char> stream = MakeStream(packetCount, withBroken);
+        std::cout << (withBroken ? "[mixed with 5% broken packets] " : "[valid packets] ") << packetCount << " packets, "
+            << stream.size() << " bytes, " << rounds << " rounds" << std::endl;
+
+        // 캐시를 데우고 순서 영향을 줄이기 위해 한 번씩 먼저 돌린다
+        Run(stream, 1, bySwitch);
+        Run(stream, 1, byTable);
+
+        Result switchResult = Run(stream, rounds, bySwitch);
+        Result tableResult = Run(stream, rounds, byTable);
+        Print("switch", switchResult, stream.size(), rounds);
+        Print("table ", tableResult, stream.size(), rounds);
+
+        if (switchResult.handled != tableResult.handled || switchResult.rejected != tableResult.rejected
+            || switchResult.checksum != tableResult.checksum)
+        {
+            std::cout << "MISMATCH between switch and table" << std::endl;
+            mismatch = true;
+        }
+    }
+
+    return mismatch ? 1 : 0;
+}
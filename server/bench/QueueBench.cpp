@@ -0,0 +1,205 @@
+// LockFreeQueue 경합 벤치마크: 이전 잠금 큐 (std::mutex + std::queue) vs 잠금 없는 MPSC 큐
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target queue_bench
+//   ./build/queue_bench [itemsPerProducer] [maxProducers] [capacity]
+// 생산자 1, 2, 4 ... maxProducers 개가 쉬지 않고 넣고 소비 스레드 하나가 계속 비운다 (세션 송신 큐에서 I/O 워커 / 로직 스레드가 넣고
+// isSending_ 을 잡은 스레드가 꺼내는 모양). 항목은 (생산자 번호, 순번) 이고 소비 쪽에서 생산자별 순서와 개수를 확인한다.
+// - mutex: 이전 LockFreeQueue. 항목마다 잠그고 Pop 한다.
+// - lockfree pop: 새 큐를 항목마다 Pop.
+// - lockfree drain: 새 큐를 DrainAll 로 한 번에 비운다.
+// capacity 를 주면 새 큐에 한도를 걸고, 가득 차서 Push 가 실패하면 생산자가 양보한 뒤 다시 넣는다 (거절 수를 같이 낸다).
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../LockFreeQueue.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // 이전 LockFreeQueue 그대로
+    template <typename T>
+    class MutexQueue
+    {
+    public:
+        bool Push(T item)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queue_.push(std::move(item));
+            return true;
+        }
+
+        bool Pop(T& item)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty()) return false;
+            item = std::move(queue_.front());
+            queue_.pop();
+            return true;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::queue<T> queue_;
+    };
+
+    struct RunResult
+    {
+        double seconds = 0.0;
+        uint64_t consumed = 0;
+        uint64_t rejected = 0;   // 한도에 걸려 다시 넣은 수
+        uint64_t emptyPolls = 0; // 소비 쪽이 빈 큐를 본 횟수
+        bool ordered = true;
+    };
+
+    enum class Mode { MUTEX, POP, DRAIN };
+
+    const char* ModeName(Mode mode)
+    {
+        switch (mode)
+        {
+        case Mode::MUTEX: return "mutex";
+        case Mode::POP: return "lockfree pop";
+        case Mode::DRAIN: return "lockfree drain";
+        }
+        return "";
+    }
+
+    // 항목: 위 16 비트 생산자 번호, 아래 48 비트 순번 (1 부터)
+    uint64_t MakeItem(size_t producer, uint64_t seq) { return (static_cast<uint64_t>(producer) << 48) | seq; }
+
+    template <typename Queue, typename ConsumeAll>
+    RunResult Run(Queue& queue, size_t producerCount, uint64_t itemsPerProducer, ConsumeAll consumeAll)
+    {
+        RunResult result;
+        std::vector<uint64_t> lastSeq(producerCount, 0);
+        std::atomic<uint64_t> rejected = 0;
+
+        std::atomic<size_t> ready = 0;
+        std::atomic<bool> go = false;
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < producerCount; ++p)
+        {
+            producers.emplace_back([&, p] {
+                ready++;
+                while (!go.load()) std::this_thread::yield();
+
+                uint64_t localRejected = 0;
+                for (uint64_t seq = 1; seq <= itemsPerProducer; ++seq)
+                {
+                    while (!queue.Push(MakeItem(p, seq)))
+                    {
+                        localRejected++;
+                        std::this_thread::yield();
+                    }
+                }
+                rejected += localRejected;
+            });
+        }
+
+        while (ready.load() < producerCount) std::this_thread::yield();
+
+        const uint64_t total = itemsPerProducer * producerCount;
+        auto consume = [&](uint64_t item) {
+            size_t producer = static_cast<size_t>(item >> 48);
+            uint64_t seq = item & ((1ULL << 48) - 1);
+            if (producer >= producerCount || seq != lastSeq[producer] + 1) result.ordered = false;
+            else lastSeq[producer] = seq;
+        };
+
+        Clock::time_point start = Clock::now();
+        go = true;
+
+        while (result.consumed < total)
+        {
+            size_t count = consumeAll(consume);
+            result.consumed += count;
+            if (count == 0)
+            {
+                result.emptyPolls++;
+                std::this_thread::yield();
+            }
+        }
+
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        for (std::thread& t : producers) t.join();
+        result.rejected = rejected.load();
+        return result;
+    }
+
+    RunResult RunMode(Mode mode, size_t producerCount, uint64_t itemsPerProducer, size_t capacity)
+    {
+        if (mode == Mode::MUTEX)
+        {
+            MutexQueue<uint64_t> queue;
+            return Run(queue, producerCount, itemsPerProducer, [&](auto& consume) {
+                size_t count = 0;
+                uint64_t item;
+                while (queue.Pop(item))
+                {
+                    consume(item);
+                    count++;
+                }
+                return count;
+            });
+        }
+
+        LockFreeQueue<uint64_t> queue(capacity);
+        if (mode == Mode::POP)
+        {
+            return Run(queue, producerCount, itemsPerProducer, [&](auto& consume) {
+                size_t count = 0;
+                uint64_t item;
+                while (queue.Pop(item))
+                {
+                    consume(item);
+                    count++;
+                }
+                return count;
+            });
+        }
+
+        return Run(queue, producerCount, itemsPerProducer, [&](auto& consume) {
+            return queue.DrainAll([&](uint64_t&& item) { consume(item); });
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint64_t itemsPerProducer = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    size_t maxProducers = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 32;
+    size_t capacity = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+
+    std::cout << "items per producer: " << itemsPerProducer << ", max producers: " << maxProducers
+        << ", capacity: " << (capacity ? std::to_string(capacity) : "unbounded")
+        << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    bool ok = true;
+    for (size_t producers = 1; producers <= maxProducers; producers *= 2)
+    {
+        std::cout << "producers " << producers << std::endl;
+        for (Mode mode : { Mode::MUTEX, Mode::POP, Mode::DRAIN })
+        {
+            RunResult result = RunMode(mode, producers, itemsPerProducer, mode == Mode::MUTEX ? 0 : capacity);
+            ok = ok && result.ordered && result.consumed == itemsPerProducer * producers;
+
+            std::cout << "  " << ModeName(mode) << ": "
+                << result.seconds * 1e9 / result.consumed << " ns/item, "
+                << result.consumed / result.seconds / 1e6 << " M items/s"
+                << ", empty polls " << result.emptyPolls;
+            if (capacity != 0 && mode != Mode::MUTEX) std::cout << ", rejected " << result.rejected;
+            std::cout << (result.ordered ? "" : "  ORDER BROKEN") << std::endl;
+        }
+    }
+
+    SendBufferPool::PrintStats();
+    std::cout << (ok ? "all items delivered in per-producer order" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
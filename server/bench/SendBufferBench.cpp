@@ -0,0 +1,134 @@
+// 송신 버퍼 할당 마이크로벤치마크: 예전 std::vector 경로 vs SendBufferPool 경로
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target send_buffer_bench
+//   ./build/send_buffer_bench [iterations] [workerThreads]
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../SendBuffer.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // 실제 트래픽과 비슷한 크기 분포: 스냅샷/채팅/작은 응답
+    const uint16_t kBodySizes[] = { 8, 12, 260, 4 + 12 * 10, 5, 260, 4 + 12 * 50, 8 };
+    const size_t kSizeCount = sizeof(kBodySizes) / sizeof(kBodySizes[0]);
+
+    // 이전 경로 (vector + make_shared): Send 에서 vector 하나, PushSendPacket 에서 make_shared 로 한 번 더
+    std::shared_ptr<std::vector<char>> MakeVectorPacket(const char* body, uint16_t bodySize)
+    {
+        std::vector<char> sendBuffer(sizeof(GameHeader) + bodySize);
+        GameHeader* header = reinterpret_cast<GameHeader*>(sendBuffer.data());
+        header->packetSize = static_cast<uint16_t>(sendBuffer.size());
+        header->packetId = static_cast<uint16_t>(PacketId::SNAPSHOT);
+        std::memcpy(sendBuffer.data() + sizeof(GameHeader), body, bodySize);
+        return std::make_shared<std::vector<char>>(sendBuffer);
+    }
+
+    SendBufferRef MakePoolPacket(const char* body, uint16_t bodySize)
+    {
+        return SendBuffer::Create(PacketId::SNAPSHOT, body, bodySize);
+    }
+
+    // 한 스레드에서 만들고 바로 버림
+    template <typename MakeFn>
+    double RunSingleThread(size_t iterations, MakeFn make)
+    {
+        char body[1024] = {};
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            auto packet = make(body, kBodySizes[i % kSizeCount]);
+            if (packet == nullptr) std::abort();
+        }
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+    }
+
+    // GLT 처럼 한 스레드가 만들고, I/O 워커처럼 다른 스레드들이 송신 완료 후 놓는다
+    template <typename Packet, typename MakeFn>
+    double RunCrossThread(size_t iterations, int workers, MakeFn make)
+    {
+        struct Channel
+        {
+            std::mutex lock;
+            std::vector<Packet> items;
+            bool done = false;
+        };
+
+        std::vector<std::unique_ptr<Channel>> channels;
+        for (int i = 0; i < workers; ++i)
+            channels.push_back(std::make_unique<Channel>());
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < workers; ++i)
+        {
+            threads.emplace_back([&channels, i]() {
+                Channel& ch = *channels[i];
+                std::vector<Packet> local;
+                while (true)
+                {
+                    bool done = false;
+                    {
+                        std::lock_guard<std::mutex> lock(ch.lock);
+                        local.swap(ch.items);
+                        done = ch.done;
+                    }
+                    local.clear();   // 송신 완료 -> 참조 해제
+                    if (done)
+                    {
+                        std::lock_guard<std::mutex> lock(ch.lock);
+                        if (ch.items.empty()) break;
+                    }
+                    std::this_thread::yield();
+                }
+            });
+        }
+
+        char body[1024] = {};
+        auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            Channel& ch = *channels[i % workers];
+            Packet packet = make(body, kBodySizes[i % kSizeCount]);
+            std::lock_guard<std::mutex> lock(ch.lock);
+            ch.items.push_back(std::move(packet));
+        }
+        for (auto& ch : channels)
+        {
+            std::lock_guard<std::mutex> lock(ch->lock);
+            ch->done = true;
+        }
+        for (auto& t : threads)
+            t.join();
+
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    int workers = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    std::cout << "iterations: " << iterations << ", workers: " << workers << std::endl;
+
+    // 풀을 한 번 데워 둔다
+    RunSingleThread(iterations / 10, MakePoolPacket);
+
+    double vecSingle = RunSingleThread(iterations, MakeVectorPacket);
+    double poolSingle = RunSingleThread(iterations, MakePoolPacket);
+    std::cout << "single thread  vector: " << vecSingle << " ns/packet, pool: " << poolSingle << " ns/packet" << std::endl;
+
+    double vecCross = RunCrossThread<std::shared_ptr<std::vector<char>>>(iterations, workers, MakeVectorPacket);
+    double poolCross = RunCrossThread<SendBufferRef>(iterations, workers, MakePoolPacket);
+    std::cout << "cross thread   vector: " << vecCross << " ns/packet, pool: " << poolCross << " ns/packet" << std::endl;
+
+    SendBufferPool::PrintStats();
+    return 0;
+}
@@ -0,0 +1,171 @@
+// 세션 레지스트리 경합 벤치마크: 예전 mutex + std::map vs SessionTable
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target session_table_bench
+//   ./build/session_table_bench [seconds] [ioWorkers] [liveSessions]
+// I/O 워커 스레드는 접속/해제(등록/삭제)와 조회를 섞어 돌리고,
+// GLT 스레드는 커맨드 처리처럼 살아 있는 세션 ID 조회만 계속한다.
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../SessionTable.h"
+
+namespace
+{
+    struct FakeSession
+    {
+        uint32_t id = 0;
+    };
+
+    // 이전 방식: 하나의 mutex 로 감싼 map<id, shared_ptr> 에서 찾는다 (조회마다 잠그고 shared_ptr 를 복사한다)
+    class MapRegistry
+    {
+    public:
+        uint32_t Add()
+        {
+            uint32_t id = nextId_.fetch_add(1);
+            auto session = std::make_shared<FakeSession>();
+            session->id = id;
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.emplace(id, std::move(session));
+            return id;
+        }
+
+        void Remove(uint32_t id)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sessions_.erase(id);
+        }
+
+        std::shared_ptr<FakeSession> Find(uint32_t id)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = sessions_.find(id);
+            return it == sessions_.end() ? nullptr : it->second;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::map<uint32_t, std::shared_ptr<FakeSession>> sessions_;
+        std::atomic<uint32_t> nextId_ = 1;
+    };
+
+    class TableRegistry
+    {
+    public:
+        uint32_t Add()
+        {
+            uint32_t id = table_.Reserve();
+            auto session = std::make_shared<FakeSession>();
+            session->id = id;
+            table_.Publish(id, std::move(session));
+            return id;
+        }
+
+        void Remove(uint32_t id) { table_.Remove(id); }
+        std::shared_ptr<FakeSession> Find(uint32_t id) { return table_.Find(id); }
+
+    private:
+        SessionTable<FakeSession> table_;
+    };
+
+    struct Result
+    {
+        double gltLookupsPerSec;
+        double workerOpsPerSec;
+        uint64_t misses;
+    };
+
+    template <typename Registry>
+    Result Run(double seconds, int workers, int liveSessions)
+    {
+        Registry registry;
+
+        // 워커마다 자기 몫의 세션 ID 를 들고 하나씩 끊고 새로 붙인다
+        std::vector<std::vector<std::atomic<uint32_t>>> ids(workers);
+        for (int w = 0; w < workers; ++w)
+        {
+            ids[w] = std::vector<std::atomic<uint32_t>>(liveSessions / workers);
+            for (auto& id : ids[w]) id = registry.Add();
+        }
+
+        std::atomic<bool> stop = false;
+        std::atomic<uint64_t> workerOps = 0;
+        std::atomic<uint64_t> gltLookups = 0;
+        std::atomic<uint64_t> misses = 0;
+
+        std::vector<std::thread> threads;
+        for (int w = 0; w < workers; ++w)
+        {
+            threads.emplace_back([&, w]() {
+                std::mt19937 rng(w);
+                auto& mine = ids[w];
+                uint64_t ops = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    size_t i = rng() % mine.size();
+                    if (rng() % 8 == 0)
+                    {
+                        // 접속 해제 + 새 접속
+                        registry.Remove(mine[i].load());
+                        mine[i] = registry.Add();
+                        ops += 2;
+                    }
+                    else
+                    {
+                        // recv 처리 중 세션 조회
+                        if (registry.Find(mine[i].load()) == nullptr) misses.fetch_add(1, std::memory_order_relaxed);
+                        ops++;
+                    }
+                }
+                workerOps += ops;
+            });
+        }
+
+        threads.emplace_back([&]() {
+            std::mt19937 rng(1234);
+            uint64_t lookups = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                auto& list = ids[rng() % workers];
+                uint32_t id = list[rng() % list.size()].load(std::memory_order_relaxed);
+                auto session = registry.Find(id);
+                if (session != nullptr && session->id != id) std::abort();   // 다른 세션이 나오면 안 된다
+                lookups++;
+            }
+            gltLookups += lookups;
+        });
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop = true;
+        for (auto& t : threads) t.join();
+
+        return { gltLookups / seconds, workerOps / seconds, misses.load() };
+    }
+
+    void Print(const char* name, const Result& r)
+    {
+        std::cout << name << "  GLT lookups: " << (uint64_t)r.gltLookupsPerSec << "/s"
+            << ", worker ops: " << (uint64_t)r.workerOpsPerSec << "/s"
+            << ", worker misses: " << r.misses << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = argc > 1 ? std::atof(argv[1]) : 3.0;
+    int workers = argc > 2 ? std::atoi(argv[2]) : 4;
+    int liveSessions = argc > 3 ? std::atoi(argv[3]) : 10000;
+
+    std::cout << "seconds: " << seconds << ", I/O workers: " << workers
+        << ", live sessions: " << liveSessions << ", hw threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    Print("mutex + std::map", Run<MapRegistry>(seconds, workers, liveSessions));
+    Print("SessionTable    ", Run<TableRegistry>(seconds, workers, liveSessions));
+    return 0;
+}
@@ -0,0 +1,221 @@
+// 스냅샷 대역폭 벤치마크: 전체 float 스냅샷 (이전 방식) vs 양자화 + 델타 스냅샷
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target snapshot_bench
+//   ./build/snapshot_bench [ticks] [ackLagTicks]
+// 방 인원 10 / 100 / 1000 명, 움직이는 비율을 바꿔 가며 틱마다 클라이언트 한 명이 받는 바이트를 잰다.
+// - 플레이어는 정해진 비율만큼만 움직이고 (속도 5, 16ms 틱), 가끔 멈추거나 다시 걷는다. 가끔 나가고 들어온다.
+// - 클라이언트 ACK 는 ackLag 틱 (RTT) 뒤에 서버에 도착한다. 서버는 GameRoom 처럼 마지막 ACK 를 기준으로 델타를 만든다.
+// - 클라이언트는 받은 델타를 기준 프레임에 적용해서 서버 프레임과 매 틱 똑같은지 확인한다.
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "../NetProtocol.h"
+#include "../SnapshotCodec.h"
+
+namespace
+{
+    constexpr float TICK_SECONDS = 0.016f;
+    constexpr float SPEED = 5.0f;
+    constexpr size_t ENTRIES_CAPACITY = PacketSnapshot::MAX_SIZE - PacketSnapshot::MIN_SIZE;
+
+    struct Player
+    {
+        uint32_t id;
+        float x, y;
+        float vx, vy;
+    };
+
+    struct Result
+    {
+        uint64_t oldBytes = 0;     // 이전 방식: 헤더 + u16 개수 + (u32 id, f32 x, f32 y) x 인원
+        uint64_t fullBytes = 0;    // 양자화 전체 스냅샷 (입장할 때 한 번 받는 크기)
+        uint64_t deltaBytes = 0;   // 델타 스냅샷 (실제로 받는 크기)
+        uint64_t fullResyncs = 0;  // 델타 대신 전체를 보낸 틱
+        uint64_t encodeNs = 0;
+        bool verified = true;
+    };
+
+    class Room
+    {
+    public:
+        Room(size_t players, double movingRatio, uint32_t seed) : rng_(seed), movingRatio_(movingRatio)
+        {
+            for (size_t i = 0; i < players; ++i)
+                Spawn();
+        }
+
+        void Step()
+        {
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            for (Player& p : players_)
+            {
+                // 틱마다 2% 확률로 걷기 / 멈추기를 다시 정한다 (평균적으로 movingRatio 만큼 걷는다)
+                if (unit(rng_) < 0.02f)
+                    SetVelocity(p);
+                p.x += p.vx * TICK_SECONDS;
+                p.y += p.vy * TICK_SECONDS;
+            }
+
+            // 가끔 나가고 들어온다 (1000 명 방에서 초당 몇 명)
+            if (!players_.empty() && unit(rng_) < 0.0002f * players_.size())
+            {
+                players_.erase(players_.begin() + rng_() % players_.size());
+                Spawn();
+            }
+        }
+
+        void Capture(SnapshotFrame& frame) const
+        {
+            // GameRoom 이 프레임을 정렬하는 것처럼 id 순서
+            for (const Player& p : players_)
+                frame.entities.push_back(SnapshotEntity{ p.id, SnapshotCodec::Quantize(p.x), SnapshotCodec::Quantize(p.y) });
+        }
+
+    private:
+        std::mt19937 rng_;
+        double movingRatio_;
+        uint32_t nextId_ = 1;
+        std::vector<Player> players_;
+
+        void SetVelocity(Player& p)
+        {
+            std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+            p.vx = p.vy = 0.0f;
+            if (unit(rng_) < movingRatio_)
+            {
+                float angle = unit(rng_) * 6.2831853f;
+                p.vx = SPEED * std::cos(angle);
+                p.vy = SPEED * std::sin(angle);
+            }
+        }
+
+        void Spawn()
+        {
+            std::uniform_real_distribution<float> pos(-50.0f, 50.0f);
+            Player p{ nextId_++, pos(rng_), pos(rng_), 0.0f, 0.0f };
+            SetVelocity(p);
+            players_.push_back(p);
+        }
+    };
+
+    Result Run(size_t playerCount, double movingRatio, int ticks, int ackLag)
+    {
+        Result result;
+        Room room(playerCount, movingRatio, static_cast<uint32_t>(playerCount * 7 + movingRatio * 100));
+        SnapshotHistory history;
+        std::vector<char> entries(ENTRIES_CAPACITY);
+        static const std::vector<SnapshotEntity> emptyFrame;
+
+        // 클라이언트 쪽: 적용한 프레임 (틱 -> 상태) 과 서버로 가는 중인 ACK
+        std::map<uint32_t, std::vector<SnapshotEntity>> clientFrames;
+        std::deque<std::pair<int, uint32_t>> acksInFlight;   // (서버 도착 틱, ack)
+        uint32_t serverAck = 0;
+        std::vector<SnapshotEntity> decoded;
+
+        for (uint32_t tick = 1; tick <= static_cast<uint32_t>(ticks); ++tick)
+        {
+            room.Step();
+            SnapshotFrame& frame = history.BeginFrame(tick);
+            room.Capture(frame);
+
+            while (!acksInFlight.empty() && acksInFlight.front().first <= static_cast<int>(tick))
+            {
+                serverAck = acksInFlight.front().second;
+                acksInFlight.pop_front();
+            }
+
+            // 서버: GameRoom::BuildSnapshot 과 같은 순서
+            auto start = std::chrono::steady_clock::now();
+            const SnapshotFrame* base = serverAck < tick ? history.Find(serverAck) : nullptr;
+            size_t size = 0;
+            if (base == nullptr || !SnapshotCodec::Encode(base->entities, frame.entities, entries.data(), entries.size(), size))
+            {
+                base = nullptr;
+                SnapshotCodec::Encode(emptyFrame, frame.entities, entries.data(), entries.size(), size);
+                result.fullResyncs++;
+            }
+            result.encodeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+            size_t fullSize = 0;
+            SnapshotCodec::Encode(emptyFrame, frame.entities, entries.data() + size, entries.size() - size, fullSize);
+
+            result.oldBytes += sizeof(GameHeader) + sizeof(uint16_t) + frame.entities.size() * 12;
+            result.deltaBytes += sizeof(GameHeader) + PacketSnapshot::MIN_SIZE + size;
+            result.fullBytes += sizeof(GameHeader) + PacketSnapshot::MIN_SIZE + fullSize;
+
+            // 클라이언트: 기준 프레임에 적용하고 ACK 를 보낸다
+            uint32_t baseTick = base != nullptr ? base->tick : 0;
+            auto baseFrame = clientFrames.find(baseTick);
+            if (baseTick != 0 && baseFrame == clientFrames.end())
+            {
+                result.verified = false;
+                break;
+            }
+
+            bool ok = SnapshotCodec::Decode(std::string_view(entries.data(), size),
+                baseTick != 0 ? baseFrame->second : emptyFrame, decoded);
+            if (!ok || decoded.size() != frame.entities.size())
+            {
+                result.verified = false;
+                break;
+            }
+            for (size_t i = 0; i < decoded.size(); ++i)
+            {
+                const SnapshotEntity& a = decoded[i];
+                const SnapshotEntity& b = frame.entities[i];
+                if (a.id != b.id || a.x != b.x || a.y != b.y)
+                    result.verified = false;
+            }
+
+            clientFrames[tick] = decoded;
+            while (clientFrames.size() > SnapshotHistory::HISTORY_SIZE)
+                clientFrames.erase(clientFrames.begin());
+            acksInFlight.emplace_back(static_cast<int>(tick) + ackLag, tick);
+        }
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 3000;
+    int ackLag = argc > 2 ? std::atoi(argv[2]) : 6;
+
+    std::cout << ticks << " ticks (16ms), ACK arrives " << ackLag << " ticks after the snapshot (~" << ackLag * 16 << "ms RTT)" << std::endl;
+    std::cout << "bytes per client per tick (header included). room egress = per client x players x 62.5 ticks/s" << std::endl;
+    std::cout << std::left << std::setw(9) << "players" << std::setw(8) << "moving"
+        << std::right << std::setw(12) << "old float" << std::setw(12) << "full quant" << std::setw(10) << "delta"
+        << std::setw(9) << "ratio" << std::setw(10) << "resyncs" << std::setw(16) << "old room MB/s" << std::setw(17) << "delta room MB/s"
+        << std::setw(14) << "encode us" << "  check" << std::endl;
+
+    bool ok = true;
+    for (size_t players : { 10, 100, 1000 })
+    {
+        for (double moving : { 0.1, 0.3, 1.0 })
+        {
+            Result r = Run(players, moving, ticks, ackLag);
+            double oldPerTick = static_cast<double>(r.oldBytes) / ticks;
+            double fullPerTick = static_cast<double>(r.fullBytes) / ticks;
+            double deltaPerTick = static_cast<double>(r.deltaBytes) / ticks;
+            double roomScale = players * (1.0 / 0.016) / (1024 * 1024);
+
+            std::cout << std::left << std::setw(9) << players << std::setw(8) << std::to_string(static_cast<int>(moving * 100)) + "%"
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << oldPerTick << std::setw(12) << fullPerTick << std::setw(10) << deltaPerTick
+                << std::setw(8) << oldPerTick / deltaPerTick << "x" << std::setw(10) << r.fullResyncs
+                << std::setprecision(2) << std::setw(16) << oldPerTick * roomScale << std::setw(17) << deltaPerTick * roomScale
+                << std::setw(14) << r.encodeNs / 1000.0 / ticks
+                << "  " << (r.verified ? "ok" : "MISMATCH") << std::endl;
+            ok = ok && r.verified;
+        }
+    }
+
+    std::cout << (ok ? "OK: client state matched the quantized server state every tick" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
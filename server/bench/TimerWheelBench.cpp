@@ -0,0 +1,160 @@
+// 세션 시간 제한 벤치마크: 틱마다 전체 세션 훑기 vs TimerWheel (만료 때 다시 계산해서 다시 걸기)
+//   cmake -S . -B build -DCHAT_BUILD_BENCH=ON && cmake --build build --target timer_wheel_bench
+//   ./build/timer_wheel_bench [sessions] [simulatedSeconds]
+// 세션은 5초마다 하트비트를 보내다가 일부가 중간에 조용해진다 (반쯤 끊긴 연결).
+// 두 방식이 같은 세션을 같은 틱에 끊는지도 함께 확인한다.
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "../TimerWheel.h"
+
+namespace
+{
+    const uint64_t TICK_MS = 16;
+    const uint64_t IDLE_TICKS = 30000 / TICK_MS;        // 30초
+    const uint64_t HEARTBEAT_TICKS = 5000 / TICK_MS;    // 5초
+
+    struct FakeSession
+    {
+        uint64_t phase;          // 하트비트를 보내는 틱 오프셋
+        uint64_t silentFrom;     // 이 틱부터는 아무것도 보내지 않는다
+        uint64_t lastRecvTick = 0;
+        uint64_t kickedTick = 0;
+        bool kicked = false;
+    };
+
+    std::vector<FakeSession> MakeSessions(size_t count, uint64_t totalTicks)
+    {
+        std::mt19937_64 rng(7);
+        std::vector<FakeSession> sessions(count);
+        for (FakeSession& s : sessions)
+        {
+            s.phase = rng() % HEARTBEAT_TICKS;
+            // 20% 는 도중에 조용해진다
+            s.silentFrom = (rng() % 5 == 0) ? rng() % totalTicks : UINT64_MAX;
+        }
+        return sessions;
+    }
+
+    // 틱마다 수신 처리 (두 방식에 똑같이 든다)
+    void Receive(std::vector<FakeSession>& sessions, uint64_t tick)
+    {
+        for (FakeSession& s : sessions)
+        {
+            if (!s.kicked && tick < s.silentFrom && tick % HEARTBEAT_TICKS == s.phase)
+                s.lastRecvTick = tick;
+        }
+    }
+
+    double RunScan(std::vector<FakeSession>& sessions, uint64_t totalTicks, size_t& kicks)
+    {
+        double checkSeconds = 0;
+        for (uint64_t tick = 1; tick <= totalTicks; ++tick)
+        {
+            Receive(sessions, tick);
+
+            auto start = std::chrono::steady_clock::now();
+            for (FakeSession& s : sessions)
+            {
+                if (!s.kicked && tick >= s.lastRecvTick + IDLE_TICKS)
+                {
+                    s.kicked = true;
+                    s.kickedTick = tick;
+                    kicks++;
+                }
+            }
+            checkSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return checkSeconds;
+    }
+
+    double RunWheel(std::vector<FakeSession>& sessions, uint64_t totalTicks, size_t& kicks, size_t& fired)
+    {
+        TimerWheel wheel(0);
+        for (size_t i = 0; i < sessions.size(); ++i)
+            wheel.Schedule(IDLE_TICKS, i);
+
+        std::vector<uint64_t> expired;
+        double checkSeconds = 0;
+        for (uint64_t tick = 1; tick <= totalTicks; ++tick)
+        {
+            Receive(sessions, tick);
+
+            auto start = std::chrono::steady_clock::now();
+            expired.clear();
+            wheel.Advance(tick, expired);
+            for (uint64_t key : expired)
+            {
+                FakeSession& s = sessions[key];
+                fired++;
+
+                uint64_t deadline = s.lastRecvTick + IDLE_TICKS;
+                if (tick >= deadline)
+                {
+                    s.kicked = true;
+                    s.kickedTick = tick;
+                    kicks++;
+                }
+                else
+                {
+                    wheel.Schedule(deadline, key);
+                }
+            }
+            checkSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+        return checkSeconds;
+    }
+
+    // 걸자마자 취소하는 비용 (로그인 직후 끊기는 세션 등)
+    double MeasureScheduleCancel(size_t count)
+    {
+        TimerWheel wheel(0);
+        std::vector<TimerWheel::TimerId> ids(count);
+        std::mt19937_64 rng(11);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < count; ++i)
+            ids[i] = wheel.Schedule(1 + rng() % (IDLE_TICKS * 4), i);
+        for (size_t i = 0; i < count; ++i)
+            wheel.Cancel(ids[i]);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds * 1e9 / (count * 2);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    size_t sessionCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    uint64_t seconds = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 120;
+    uint64_t totalTicks = seconds * 1000 / TICK_MS;
+
+    std::cout << "sessions " << sessionCount << ", simulated " << seconds << " s (" << totalTicks << " ticks of "
+        << TICK_MS << " ms), idle timeout " << IDLE_TICKS * TICK_MS << " ms" << std::endl;
+
+    std::vector<FakeSession> scanSessions = MakeSessions(sessionCount, totalTicks);
+    std::vector<FakeSession> wheelSessions = scanSessions;
+
+    size_t scanKicks = 0;
+    double scanSeconds = RunScan(scanSessions, totalTicks, scanKicks);
+
+    size_t wheelKicks = 0;
+    size_t fired = 0;
+    double wheelSeconds = RunWheel(wheelSessions, totalTicks, wheelKicks, fired);
+
+    size_t mismatched = 0;
+    for (size_t i = 0; i < sessionCount; ++i)
+    {
+        if (scanSessions[i].kicked != wheelSessions[i].kicked || scanSessions[i].kickedTick != wheelSessions[i].kickedTick)
+            mismatched++;
+    }
+
+    std::cout << "scan : " << scanSeconds * 1e6 / totalTicks << " us/tick, kicks " << scanKicks << std::endl;
+    std::cout << "wheel: " << wheelSeconds * 1e6 / totalTicks << " us/tick, kicks " << wheelKicks
+        << ", timer fires " << fired << " (" << (double)fired / totalTicks << "/tick)" << std::endl;
+    std::cout << "kick mismatches: " << mismatched << std::endl;
+    std::cout << "schedule+cancel: " << MeasureScheduleCancel(sessionCount) << " ns/op" << std::endl;
+
+    return mismatched == 0 ? 0 : 1;
+}
@@ -1,14 +1,49 @@
 #include <iostream>
+#include "GameLogic.h"
+#include "GameRoom.h"
 #include "Server.h"
+#include "ThreadTopology.h"
 
 Server* g_Server = nullptr;
 
 int main()
 {
-    const int iocpThreadCount = 4;
-    const int dbThreadCount = 2;
+    // 스레드 수와 코어 배치 (I/O 워커 수는 감지한 물리 코어 수에 맞춘다. CHAT_PIN_THREADS=0 이면 고정 안 함)
+    // 방 샤드 수는 물리 코어의 1/4 (CHAT_LOGIC_THREADS=N 으로 바꾼다)
+    ThreadTopology::Config topology;
+    topology.ioThreads = 0;
+    topology.dbThreads = 2;
+    topology.logicThreads = 0;
+    ThreadTopology::Configure(topology);
+    ThreadTopology::PrintPlan();
 
-    Server gameServer(iocpThreadCount, dbThreadCount);
+    const uint32_t maxSendBatchBytes = 64 * 1024;   // 송신 한 번에 묶을 최대 바이트
+    const bool lendRecvBuffers = true;              // 쉬는 세션은 수신 버퍼를 반납
+    const size_t maxPooledRecvBuffers = 1024;       // 풀에 남겨 둘 수신 버퍼 수
+
+    // 느린 클라이언트 송신 큐 한도 (기본값: high 256KB/512개, low 64KB/128개, hard 4MB/8192개)
+    SendBackpressureConfig backpressure;
+
+    // 로그인 마감 / 유휴 끊기 (기본값: 로그인 10초, 무수신 30초. 클라이언트는 그보다 자주 하트비트를 보낸다)
+    SessionTimeoutConfig timeouts;
+
+    // 스냅샷에 넣을 주변 범위 (기본값: 시야 반경 30, 나갈 때 여유 3)
+    InterestConfig interest;
+
+    // 시뮬레이션 틱 (기본값 60Hz, 밀리면 최대 5 틱까지 따라잡기) 과 스냅샷 송신 속도 (기본값: 방 30Hz, 느린 세션은 5Hz 까지. 큐 32KB / RTT 250ms 가 기준)
+    SimulationConfig simulation;
+    SnapshotRateConfig snapshotRate;
+
+    ClientSession::SetMaxSendBatchBytes(maxSendBatchBytes);
+    ClientSession::SetBackpressureConfig(backpressure);
+    ClientSession::SetLendRecvBuffers(lendRecvBuffers);
+    RecvBufferPool::SetMaxPooled(maxPooledRecvBuffers);
+    SessionTimers::SetConfig(timeouts);
+    GameRoom::SetInterestConfig(interest);
+    GameLogic::SetConfig(simulation);
+    GameRoom::SetSnapshotRateConfig(snapshotRate);
+
+    Server gameServer(ThreadTopology::GetIoThreadCount(), ThreadTopology::GetDbThreadCount(), ThreadTopology::GetLogicThreadCount());
     g_Server = &gameServer;
 
     std::cout << "Server starting..." << std::endl;
@@ -31,6 +66,63 @@ int main()
                 break;
             }
 
+            if (command == "stats") {
+                SendStats& stats = ClientSession::GetSendStats();
+                uint64_t sendCalls = stats.sendCalls.load();
+                uint64_t packets = stats.packets.load();
+                std::cout << "[Stats] send calls: " << sendCalls
+                    << ", batches: " << stats.batches.load()
+                    << ", packets: " << packets
+                    << ", packets/send: " << (sendCalls ? (double)packets / sendCalls : 0.0)
+                    << ", bytes: " << stats.bytes.load()
+                    << ", partial: " << stats.partialSends.load() << std::endl;
+                std::cout << "[Stats] backpressure: congestion events " << stats.congestionEvents.load()
+                    << ", coalesced snapshots: " << stats.coalescedSnapshots.load()
+                    << ", kicked: " << stats.backpressureKicks.load() << std::endl;
+                SendBufferPool::PrintStats();
+
+                SessionTimers::Stats timerStats = gameServer.GetSessionTimers().GetStats();
+                std::cout << "[Stats] session timers: armed " << timerStats.armed
+                    << ", fired " << timerStats.fired
+                    << ", rearmed " << timerStats.rearmed
+                    << ", login timeouts " << timerStats.loginTimeouts
+                    << ", idle kicks " << timerStats.idleKicks << std::endl;
+
+                SnapshotRateStats& snapshotStats = GameRoom::GetSnapshotRateStats();
+                std::cout << "[Stats] snapshots: sent " << snapshotStats.sent.load()
+                    << ", slowdowns " << snapshotStats.slowdowns.load()
+                    << ", speedups " << snapshotStats.speedups.load() << std::endl;
+            }
+
+            if (command == "mem") {
+                gameServer.PrintMemoryReport();
+            }
+
+            if (command == "queues") {
+                gameServer.PrintSendQueueReport();
+            }
+
+            if (command == "ticks") {
+                gameServer.PrintTickReport();
+            }
+
+            if (command == "rooms") {
+                for (size_t i = 0; i < gameServer.GetShardCount(); ++i)
+                    gameServer.GetShardRoomManager(i).PrintSnapshotRateReport();
+            }
+
+            // rate <방 번호> <Hz>: 방 스냅샷 속도를 바꾼다
+            if (command == "rate") {
+                int roomId = 0;
+                uint32_t hz = 0;
+                if (!(std::cin >> roomId >> hz)) {
+                    std::cin.clear();
+                    std::cin.ignore(1024, '\n');
+                }
+                if (hz == 0 || !gameServer.GetRoomManagerOfRoom(roomId).SetSnapshotRate(roomId, hz))
+                    std::cout << "usage: rate <room id> <hz>" << std::endl;
+            }
+
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     }